@@ -5,6 +5,7 @@ include(EnumOption)
 # Define Enum Options
 #--------------------------------------------------------------------
 enum_option(PLATFORM "Desktop;Web" "Select the target platform for the build.")
+enum_option(LOG_MIN_LEVEL "ALL;TRACE;DEBUG;INFO;WARNING;ERROR;FATAL;NONE" "Compile out TRACELOG calls below this level.")
 enum_option(OPENGL_VERSION "Auto;4.3;3.3;2.1;1.1;ES 2.0;ES 3.0" "Specify an OpenGL version, or use Auto to let it be determined automatically.")
 
 #--------------------------------------------------------------------
@@ -16,6 +17,9 @@ option(USE_CCACHE "Enable compiler cache that can drastically improve build time
 option(CCACHE_OPTIONS "Compiler cache options" "CCACHE_CPP2=true;CCACHE_SLOPPINESS=clang_index_store")
 
 option(LOG_SUPPORT "Enable LeveGL logging system" ON)
+option(LOG_BINARY "Write TRACELOG messages as binary records, decoded offline by ledecode" OFF)
+cmake_dependent_option(BUILD_LOG_DECODER "Build ledecode, the binary log decoder" ON "LOG_BINARY" OFF)
+option(PROFILE_SUPPORT "Enable CPU instrumentation zones with Chrome trace-event export" OFF)
 
 #--------------------------------------------------------------------
 # Sanitize Options
@@ -26,17 +26,20 @@ Oscillate( float time, float min, float max, float speed )
 void
 DrawRotatingTriangle( Transform transform, Color fillColor, Color lineColor )
 {
-    float radius = 50 * transform.scale;
+    // Equilateral triangle of radius 50 around the origin, placed by the transform stack
+    const float x1 = 50.0f, y1 = 0.0f;
+    const float x2 = -25.0f, y2 = 43.30127f;
+    const float x3 = -25.0f, y3 = -43.30127f;
 
-    float x1     = transform.x + radius * cos( transform.rotation );
-    float y1     = transform.y + radius * sin( transform.rotation );
-    float x2 = transform.x + radius * cos( transform.rotation + 2.0f * PI / 3 );
-    float y2 = transform.y + radius * sin( transform.rotation + 2.0f * PI / 3 );
-    float x3 = transform.x + radius * cos( transform.rotation + 4.0f * PI / 3 );
-    float y3 = transform.y + radius * sin( transform.rotation + 4.0f * PI / 3 );
+    PushMatrix();
+    Translate( transform.x, transform.y );
+    Rotate( transform.rotation * RAD2DEG );
+    Scale( transform.scale, transform.scale );
 
     DrawTriangle( x1, y1, x2, y2, x3, y3, fillColor );
     DrawTriangleLines( x1, y1, x2, y2, x3, y3, lineColor );
+
+    PopMatrix();
 }
 
 void
@@ -49,12 +52,14 @@ DrawPulsatingCircle( Transform transform, Color fillColor, Color lineColor )
 void
 DrawBreathingRectangle( Transform transform, Color fillColor, Color lineColor )
 {
-    float width  = 80 * transform.scale;
-    float height = 60 * transform.scale;
-    DrawRectangle( transform.x - width / 2, transform.y - height / 2, width,
-                   height, fillColor );
-    DrawRectangleLines( transform.x - width / 2, transform.y - height / 2,
-                        width, height, lineColor );
+    PushMatrix();
+    Translate( transform.x, transform.y );
+    Scale( transform.scale, transform.scale );
+
+    DrawRectangle( -40, -30, 80, 60, fillColor );
+    DrawRectangleLines( -40, -30, 80, 60, lineColor );
+
+    PopMatrix();
 }
 
 void
@@ -91,15 +96,24 @@ UpdateDrawFrame( void )
     DrawBreathingRectangle( rightGroup, DRACULA_YELLOW, DRACULA_ORANGE );
 
     // Draw pixels in a circular pattern around each shape
-    for( float angle = 0; angle < 2 * PI; angle += PI / 8 )
+    const Transform groups[] = { leftGroup, centerGroup, rightGroup };
+    const Color     colors[] = { DRACULA_PURPLE, DRACULA_GREEN, DRACULA_YELLOW };
+    for( int i = 0; i < 3; ++i )
         {
-            float radius = 80 * ( 1 + sin( time * 2 + angle ) * 0.2f );
-            DrawPixel( leftGroup.x + cos( angle ) * radius,
-                       leftGroup.y + sin( angle ) * radius, DRACULA_PURPLE );
-            DrawPixel( centerGroup.x + cos( angle ) * radius,
-                       centerGroup.y + sin( angle ) * radius, DRACULA_GREEN );
-            DrawPixel( rightGroup.x + cos( angle ) * radius,
-                       rightGroup.y + sin( angle ) * radius, DRACULA_YELLOW );
+            PushMatrix();
+            Translate( groups[i].x, groups[i].y );
+
+            for( float angle = 0; angle < 2 * PI; angle += PI / 8 )
+                {
+                    float radius = 80 * ( 1 + sin( time * 2 + angle ) * 0.2f );
+
+                    PushMatrix();
+                    Rotate( angle * RAD2DEG );
+                    DrawPixel( radius, 0, colors[i] );
+                    PopMatrix();
+                }
+
+            PopMatrix();
         }
 
     EndDrawing();
@@ -38,10 +38,109 @@
 
 #include "levegl/leapi.h"
 
+#include <stdbool.h>
+
 //----------------------------------------------------------------------------------------------------------------------
 // Module Defines and Macros
 //----------------------------------------------------------------------------------------------------------------------
-// ...
+// GL 4.3 builds on the 3.3 core path
+#if defined( GRAPHICS_API_OPENGL_43 ) && !defined( GRAPHICS_API_OPENGL_33 )
+#    define GRAPHICS_API_OPENGL_33
+#endif
+
+// Primitive types, matching the GL enum values
+#define LE_POINTS                                  0x0000
+#define LE_LINES                                   0x0001
+#define LE_TRIANGLES                               0x0004
+#define LE_QUADS                                   0x0007 // Recorded by the renderer, drawn as indexed triangles
+
+// Data types, matching the GL enum values
+#define LE_UNSIGNED_BYTE                           0x1401
+#define LE_UNSIGNED_SHORT                          0x1403
+#define LE_UNSIGNED_INT                            0x1405
+#define LE_FLOAT                                   0x1406
+
+// Textures are 2D arrays where available, so atlas pages can share one binding
+#if defined( GRAPHICS_API_OPENGL_33 )
+#    define LE_TEXTURE_ARRAYS 1
+#else
+#    define LE_TEXTURE_ARRAYS 0
+#endif
+
+// Instanced draws and per-instance attributes, lines are expanded on the GPU where available
+#if defined( GRAPHICS_API_OPENGL_33 )
+#    define LE_INSTANCED_LINES 1
+#else
+#    define LE_INSTANCED_LINES 0
+#endif
+
+// Indexed draws offsetting their indices by a base vertex
+#if defined( GRAPHICS_API_OPENGL_33 )
+#    define LE_BASE_VERTEX 1
+#else
+#    define LE_BASE_VERTEX 0
+#endif
+
+// Indexed multi-draws reading their parameters from a GPU buffer, checked again when the context is created
+#if defined( GRAPHICS_API_OPENGL_43 )
+#    define LE_MULTI_DRAW_INDIRECT 1
+#else
+#    define LE_MULTI_DRAW_INDIRECT 0
+#endif
+
+// Compute shaders and shader storage buffers, checked again when the context is created
+#if defined( GRAPHICS_API_OPENGL_43 )
+#    define LE_COMPUTE_SHADERS 1
+#else
+#    define LE_COMPUTE_SHADERS 0
+#endif
+
+// Depth and stencil tests and operations, matching the GL enum values
+#define LE_LESS                                    0x0201
+#define LE_EQUAL                                   0x0202
+#define LE_LEQUAL                                  0x0203
+#define LE_KEEP                                    0x1E00
+#define LE_REPLACE                                 0x1E01
+#define LE_INCR                                    0x1E02
+
+// Buffer bits for leClear, matching the GL enum values
+#define LE_DEPTH_BUFFER_BIT                        0x0100
+#define LE_STENCIL_BUFFER_BIT                      0x0400
+#define LE_COLOR_BUFFER_BIT                        0x4000
+
+// Shader stages, matching the GL enum values
+#define LE_FRAGMENT_SHADER                         0x8B30
+#define LE_VERTEX_SHADER                           0x8B31
+#define LE_COMPUTE_SHADER                          0x91B9
+
+// Uniform data types, same order as ShaderUniformDataType
+#define LE_SHADER_UNIFORM_FLOAT                    0
+#define LE_SHADER_UNIFORM_VEC2                     1
+#define LE_SHADER_UNIFORM_VEC3                     2
+#define LE_SHADER_UNIFORM_VEC4                     3
+#define LE_SHADER_UNIFORM_INT                      4
+#define LE_SHADER_UNIFORM_IVEC2                    5
+#define LE_SHADER_UNIFORM_IVEC3                    6
+#define LE_SHADER_UNIFORM_IVEC4                    7
+#define LE_SHADER_UNIFORM_SAMPLER2D                8
+
+// Default shader interface, attributes are bound to fixed locations before linking
+#define LE_DEFAULT_SHADER_ATTRIB_NAME_POSITION     "vertexPosition"
+#define LE_DEFAULT_SHADER_ATTRIB_NAME_COLOR        "vertexColor"
+#define LE_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD     "vertexTexCoord"
+#define LE_DEFAULT_SHADER_ATTRIB_NAME_LAYER        "vertexLayer"
+#define LE_DEFAULT_SHADER_UNIFORM_NAME_MVP         "mvp"
+
+#define LE_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION 0
+#define LE_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR    1
+#define LE_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD 2
+#define LE_DEFAULT_SHADER_ATTRIB_LOCATION_LAYER    3
+
+// GPU memory kinds reported through LE_TRACK_GPU_MEMORY
+#define LE_GPU_MEMORY_BUFFER                       0
+#define LE_GPU_MEMORY_TEXTURE                      1
+#define LE_GPU_MEMORY_RENDER_TARGET                2
+#define LE_GPU_MEMORY_KINDS                        3
 
 //----------------------------------------------------------------------------------------------------------------------
 // Global Variables Definition
@@ -56,10 +155,101 @@ LEAPI void leLoadExtensions( void * loaderPtr );               // Load the requi
 
 LEAPI void leClearColor( float r, float g, float b, float a ); // Clear the color buffer with the given color
 LEAPI void leClear( unsigned int mask );                       // Clear the given mask
-LEAPI void leClearScreenBuffers( void );                       // Clear both color and depth buffers
+LEAPI void leClearScreenBuffers( void );                       // Clear the color, depth and stencil buffers
 
 LEAPI void leViewport( int x, int y, int width, int height );  // Set the viewport
 
+LEAPI void leEnableColorBlend( void );                         // Enable alpha blending
+LEAPI void leDisableColorBlend( void );                        // Disable blending
+
+LEAPI void leEnableScissorTest( int x, int y, int width, int height ); // Clip to a rectangle, origin at the bottom-left
+LEAPI void leDisableScissorTest( void );                               // Stop clipping
+
+LEAPI void leEnableDepthTest( int func );  // Test fragment depths with `func` against the depth buffer
+LEAPI void leDisableDepthTest( void );     // Stop testing depths
+LEAPI void leDepthMask( bool write );      // Select whether passing fragments write their depth
+
+LEAPI void leEnableStencilTest( int func, int ref, int passOp ); // Test stencil values against `ref`, update on pass
+LEAPI void leDisableStencilTest( void );                         // Stop testing stencil values
+LEAPI void leColorMask( bool red, bool green, bool blue, bool alpha ); // Select the color channels written
+
+// Framebuffers
+LEAPI unsigned int leLoadFramebuffer( int width, int height, unsigned int * textureId ); // RGBA, depth and stencil
+LEAPI void         leUnloadFramebuffer( unsigned int framebufferId, unsigned int textureId ); // Delete both
+LEAPI void         leEnableFramebuffer( unsigned int framebufferId ); // Bind for drawing, 0 is the window
+LEAPI bool         leBlitFramebuffer( unsigned int framebufferId, int width, int height, int dstWidth,
+                                      int dstHeight ); // Stretch the bottom-left area into the window
+
+// Textures, RGBA with 8 bits per channel, `layers` above 1 need LE_TEXTURE_ARRAYS
+LEAPI unsigned int leLoadTexture( const void * data, int width, int height, int layers ); // NULL leaves them undefined
+LEAPI void         leUnloadTexture( unsigned int id );                                     // Delete a texture
+LEAPI void         leEnableTexture( unsigned int id );                                     // Bind to the first unit
+LEAPI bool         leResizeTextureLayers( unsigned int id, int width, int height, int layers,
+                                          int newLayers ); // Keep the pixels and the name, false if unsupported
+LEAPI void         leUpdateTexture( unsigned int id, int x, int y, int layer, int width, int height,
+                                    const void * data, unsigned int pixelBufferId ); // Write an area, PBO when not 0
+LEAPI unsigned int leLoadPixelBuffer( void );                   // Pixel unpack buffer, 0 if unsupported
+LEAPI void         leUnloadPixelBuffer( unsigned int bufferId ); // Delete a pixel unpack buffer
+
+// Shaders
+LEAPI unsigned int leCompileShader( const char * shaderCode, int type );              // Compile a shader stage
+LEAPI unsigned int leLoadShaderProgram( const char * vsCode, const char * fsCode );   // Compile and link a program
+LEAPI void         leUnloadShaderProgram( unsigned int id );                          // Delete a program
+LEAPI void         leEnableShader( unsigned int id );                                 // Bind a program
+LEAPI int          leGetLocationUniform( unsigned int shaderId, const char * name );  // Uniform location, -1 if absent
+LEAPI void         leSetUniform( int locIndex, const void * value, int uniformType, int count ); // Set uniform(s)
+LEAPI void         leSetUniformMatrix( int locIndex, const float * matrix );          // Set a column-major mat4
+
+// Vertex buffers and arrays
+LEAPI unsigned int leLoadVertexArray( void );                                  // Create a VAO, 0 if unsupported
+LEAPI void         leUnloadVertexArray( unsigned int vaoId );                  // Delete a VAO
+LEAPI bool         leEnableVertexArray( unsigned int vaoId );                  // Bind a VAO, false if unsupported
+LEAPI void         leDisableVertexArray( void );                               // Unbind the current VAO
+LEAPI unsigned int leLoadVertexBuffer( const void * data, int size, bool dynamic ); // Create a VBO with storage
+LEAPI void         leUnloadVertexBuffer( unsigned int bufferId );              // Delete a VBO, index or indirect buffer
+LEAPI void         leEnableVertexBuffer( unsigned int bufferId );              // Bind a VBO
+LEAPI void         leSetVertexBufferData( unsigned int bufferId, const void * data, int size ); // Bind, orphan, refill
+LEAPI void         leUpdateVertexBufferData( const void * data, int size, int offset ); // Write part of the bound VBO
+LEAPI void         leSetVertexAttribute( unsigned int index, int compSize, int type, bool normalized, int stride,
+                                         int offset );                         // Describe a bound VBO attribute
+LEAPI void         leEnableVertexAttribute( unsigned int index );              // Enable a vertex attribute
+LEAPI void         leDisableVertexAttribute( unsigned int index );             // Disable a vertex attribute
+LEAPI void         leDrawVertexArray( int mode, int offset, int count );       // Draw non-indexed primitives
+LEAPI void         leSetVertexAttributeDivisor( unsigned int index, int divisor ); // Step per instance, 0 per vertex
+LEAPI void         leDrawVertexArrayInstanced( int mode, int offset, int count, int instances ); // Repeated draw
+LEAPI unsigned int leLoadIndexBuffer( const void * data, int size ); // Static indices, bound to the current VAO
+LEAPI void         leEnableIndexBuffer( unsigned int bufferId );     // Bind an index buffer to the current VAO
+LEAPI void         leDrawElements( int mode, int count, int type, int offset ); // Indexed draw, offset in bytes
+LEAPI void         leDrawElementsBaseVertex( int mode, int count, int type, int offset,
+                                             int baseVertex ); // Indices offset by baseVertex (LE_BASE_VERTEX)
+LEAPI unsigned int leLoadIndirectBuffer( void );                     // Draw command buffer, 0 if unsupported
+LEAPI void         leSetIndirectBufferData( unsigned int bufferId, const void * data, int size ); // Orphan, refill
+LEAPI void         leMultiDrawIndirect( int mode, int type, int offset, int count ); // Indexed draws, indirect buffer
+LEAPI void         leEnableIndirectBuffer( unsigned int bufferId );        // Bind a draw command buffer
+LEAPI void         leDrawVertexArrayIndirect( int mode, int offset );      // Non-indexed draw from the indirect buffer
+
+// Compute shaders and shader storage buffers
+LEAPI unsigned int leLoadComputeShaderProgram( const char * csCode ); // Compile and link, 0 if unsupported
+LEAPI unsigned int leLoadShaderBuffer( const void * data, int size ); // Storage buffer, 0 if unsupported
+LEAPI void         leBindShaderBuffer( unsigned int bufferId, unsigned int index ); // Attach to a binding point
+LEAPI bool         leReadShaderBuffer( unsigned int bufferId, void * data, int size,
+                                       int offset ); // Blocking read back, false if unsupported
+LEAPI void         leDispatchCompute( unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ );
+LEAPI void         leDispatchComputeIndirect( unsigned int bufferId, int offset ); // Group counts read from a buffer
+LEAPI void         leComputeBarrier( void ); // Make storage writes visible to later shaders, draws and dispatches
+
+// Synchronization
+LEAPI void * leFenceSync( void );          // Insert a fence after the queued commands, NULL if unsupported
+LEAPI void   leWaitSync( void * sync );    // Block the calling thread until the GPU reaches the fence
+LEAPI void   leDeleteSync( void * sync );  // Delete a fence
+
+// Timer queries
+LEAPI unsigned int leLoadTimerQuery( void );                 // GPU timer, 0 if unsupported
+LEAPI void         leUnloadTimerQuery( unsigned int queryId ); // Delete a timer
+LEAPI void         leBeginTimerQuery( unsigned int queryId );  // Time the GPU work of the commands that follow
+LEAPI void         leEndTimerQuery( void );                    // Stop the running timer
+LEAPI bool         leGetTimerQueryResult( unsigned int queryId, double * seconds ); // False while the GPU is not done
+
 //**********************************************************************************************************************
 //
 // Module Implementation
@@ -76,6 +266,22 @@ LEAPI void leViewport( int x, int y, int width, int height );  // Set the viewpo
 #        include "glad/gles2.h"
 #    endif
 
+#    include <stdlib.h> /* malloc, free */
+#    include <string.h> /* memcpy */
+
+/* GPU memory accounting, called with the new size of an object and 0 once it is deleted */
+#    ifndef LE_TRACK_GPU_MEMORY
+#        define LE_TRACK_GPU_MEMORY( kind, id, bytes ) ( (void)( 0 ) )
+#    endif
+
+/* Allocation, leutils.h routes it through MemAlloc when included first */
+#    ifndef LE_MALLOC
+#        define LE_MALLOC( size ) malloc( size )
+#    endif
+#    ifndef LE_FREE
+#        define LE_FREE( ptr ) free( ptr )
+#    endif
+
 /* Ensure TRACE macros */
 #    if false == defined( TRACELOG )
 #        define TRACELOG( level, ... ) ( (void)( 0 ) )
@@ -147,11 +353,11 @@ leClear( unsigned int mask )
     glClear( (GLbitfield)mask );
 }
 
-// Clear both color and depth buffers
+// Clear the color, depth and stencil buffers
 void
 leClearScreenBuffers( void )
 {
-    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT );
+    glClear( GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_STENCIL_BUFFER_BIT );
 }
 
 // Set the viewport
@@ -161,5 +367,1003 @@ leViewport( int x, int y, int width, int height )
     glViewport( x, y, width, height );
 }
 
+// Enable alpha blending for straight (non premultiplied) colors
+void
+leEnableColorBlend( void )
+{
+    glEnable( GL_BLEND );
+    glBlendFunc( GL_SRC_ALPHA, GL_ONE_MINUS_SRC_ALPHA );
+}
+
+// Disable blending
+void
+leDisableColorBlend( void )
+{
+    glDisable( GL_BLEND );
+}
+
+// Restrict drawing and clears to a rectangle, in framebuffer pixels from the bottom-left
+void
+leEnableScissorTest( int x, int y, int width, int height )
+{
+    glEnable( GL_SCISSOR_TEST );
+    glScissor( x, y, width, height );
+}
+
+void
+leDisableScissorTest( void )
+{
+    glDisable( GL_SCISSOR_TEST );
+}
+
+// Pass fragments whose depth compares to the stored one with `func`
+void
+leEnableDepthTest( int func )
+{
+    glEnable( GL_DEPTH_TEST );
+    glDepthFunc( (GLenum)func );
+}
+
+void
+leDisableDepthTest( void )
+{
+    glDisable( GL_DEPTH_TEST );
+}
+
+void
+leDepthMask( bool write )
+{
+    glDepthMask( write ? GL_TRUE : GL_FALSE );
+}
+
+// Pass fragments whose stencil value compares to `ref` with `func`, writing `passOp` where they pass
+void
+leEnableStencilTest( int func, int ref, int passOp )
+{
+    glEnable( GL_STENCIL_TEST );
+    glStencilFunc( (GLenum)func, ref, 0xFF );
+    glStencilOp( GL_KEEP, GL_KEEP, (GLenum)passOp );
+}
+
+void
+leDisableStencilTest( void )
+{
+    glDisable( GL_STENCIL_TEST );
+}
+
+void
+leColorMask( bool red, bool green, bool blue, bool alpha )
+{
+    glColorMask( red ? GL_TRUE : GL_FALSE, green ? GL_TRUE : GL_FALSE, blue ? GL_TRUE : GL_FALSE,
+                 alpha ? GL_TRUE : GL_FALSE );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Framebuffers
+//----------------------------------------------------------------------------------------------------------------------
+// Create a framebuffer drawing into a new RGBA texture, with depth for FLAG_LAYERED_DEPTH and a stencil buffer for
+// clip shapes. Returns 0 when it is incomplete
+unsigned int
+leLoadFramebuffer( int width, int height, unsigned int * textureId )
+{
+    GLuint texture = 0;
+    glGenTextures( 1, &texture );
+    glBindTexture( GL_TEXTURE_2D, texture );
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    glTexParameteri( GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+    glBindTexture( GL_TEXTURE_2D, 0 );
+
+    GLuint framebuffer = 0;
+    glGenFramebuffers( 1, &framebuffer );
+    glBindFramebuffer( GL_FRAMEBUFFER, framebuffer );
+    glFramebufferTexture2D( GL_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, GL_TEXTURE_2D, texture, 0 );
+
+    // ES2 has no packed format, depth and stencil get a buffer each
+    GLuint stencil = 0;
+    GLuint depth   = 0;
+    glGenRenderbuffers( 1, &stencil );
+    glBindRenderbuffer( GL_RENDERBUFFER, stencil );
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    glRenderbufferStorage( GL_RENDERBUFFER, GL_DEPTH24_STENCIL8, width, height );
+    glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_STENCIL_ATTACHMENT, GL_RENDERBUFFER, stencil );
+#    else
+    glRenderbufferStorage( GL_RENDERBUFFER, GL_STENCIL_INDEX8, width, height );
+    glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_RENDERBUFFER, stencil );
+    glGenRenderbuffers( 1, &depth );
+    glBindRenderbuffer( GL_RENDERBUFFER, depth );
+    glRenderbufferStorage( GL_RENDERBUFFER, GL_DEPTH_COMPONENT16, width, height );
+    glFramebufferRenderbuffer( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_RENDERBUFFER, depth );
+#    endif
+    glBindRenderbuffer( GL_RENDERBUFFER, 0 );
+
+    const GLenum status = glCheckFramebufferStatus( GL_FRAMEBUFFER );
+    glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+
+    if( GL_FRAMEBUFFER_COMPLETE != status )
+        {
+            TRACELOG( LOG_WARNING, "FBO: [ID %u] Framebuffer incomplete (0x%04x)", framebuffer, status );
+            glDeleteFramebuffers( 1, &framebuffer );
+            glDeleteRenderbuffers( 1, &stencil );
+            if( 0 != depth ) glDeleteRenderbuffers( 1, &depth );
+            glDeleteTextures( 1, &texture );
+            return 0;
+        }
+
+    // Depth and stencil are accounted with the texture
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    const size_t pixelBytes = 4 + 4;
+#    else
+    const size_t pixelBytes = 4 + 1 + 2;
+#    endif
+    LE_TRACK_GPU_MEMORY( LE_GPU_MEMORY_RENDER_TARGET, texture, (size_t)width * (size_t)height * pixelBytes );
+
+    *textureId = texture;
+    return framebuffer;
+}
+
+// Delete a framebuffer, the texture it draws into and its depth and stencil buffers
+void
+leUnloadFramebuffer( unsigned int framebufferId, unsigned int textureId )
+{
+    GLint stencil = 0;
+    GLint depth   = 0;
+    glBindFramebuffer( GL_FRAMEBUFFER, framebufferId );
+    glGetFramebufferAttachmentParameteriv( GL_FRAMEBUFFER, GL_STENCIL_ATTACHMENT, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME,
+                                           &stencil );
+    glGetFramebufferAttachmentParameteriv( GL_FRAMEBUFFER, GL_DEPTH_ATTACHMENT, GL_FRAMEBUFFER_ATTACHMENT_OBJECT_NAME,
+                                           &depth );
+    glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+
+    // Packed depth and stencil report the same buffer twice
+    GLuint renderbuffers[2] = { (GLuint)stencil, (GLuint)depth };
+    glDeleteRenderbuffers( ( depth != stencil ) ? 2 : 1, renderbuffers );
+    glDeleteFramebuffers( 1, &framebufferId );
+    glDeleteTextures( 1, &textureId );
+    LE_TRACK_GPU_MEMORY( LE_GPU_MEMORY_RENDER_TARGET, textureId, 0 );
+}
+
+// Bind a framebuffer for drawing, 0 binds the window
+void
+leEnableFramebuffer( unsigned int framebufferId )
+{
+    glBindFramebuffer( GL_FRAMEBUFFER, framebufferId );
+}
+
+// Copy the bottom-left `width`x`height` of a framebuffer into the window, filtered when stretched.
+// False where blits are unavailable (ES 2.0)
+bool
+leBlitFramebuffer( unsigned int framebufferId, int width, int height, int dstWidth, int dstHeight )
+{
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    const GLenum filter = ( width == dstWidth && height == dstHeight ) ? GL_NEAREST : GL_LINEAR;
+
+    glBindFramebuffer( GL_READ_FRAMEBUFFER, framebufferId );
+    glBindFramebuffer( GL_DRAW_FRAMEBUFFER, 0 );
+    glBlitFramebuffer( 0, 0, width, height, 0, 0, dstWidth, dstHeight, GL_COLOR_BUFFER_BIT, filter );
+    glBindFramebuffer( GL_FRAMEBUFFER, 0 );
+    return true;
+#    else
+    (void)framebufferId;
+    (void)width;
+    (void)height;
+    (void)dstWidth;
+    (void)dstHeight;
+    return false;
+#    endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Textures
+//----------------------------------------------------------------------------------------------------------------------
+#    if LE_TEXTURE_ARRAYS
+#        define LE_TEXTURE_TARGET GL_TEXTURE_2D_ARRAY
+#    else
+#        define LE_TEXTURE_TARGET GL_TEXTURE_2D
+#    endif
+
+// Create an RGBA texture sampled with nearest filtering and clamped edges
+unsigned int
+leLoadTexture( const void * data, int width, int height, int layers )
+{
+    GLuint id = 0;
+    glGenTextures( 1, &id );
+    glBindTexture( LE_TEXTURE_TARGET, id );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+#    if LE_TEXTURE_ARRAYS
+    glTexImage3D( GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, layers, 0, GL_RGBA, GL_UNSIGNED_BYTE, data );
+#    else
+    layers = 1;
+    glTexImage2D( GL_TEXTURE_2D, 0, GL_RGBA, width, height, 0, GL_RGBA, GL_UNSIGNED_BYTE, data );
+#    endif
+    glTexParameteri( LE_TEXTURE_TARGET, GL_TEXTURE_MIN_FILTER, GL_NEAREST );
+    glTexParameteri( LE_TEXTURE_TARGET, GL_TEXTURE_MAG_FILTER, GL_NEAREST );
+    glTexParameteri( LE_TEXTURE_TARGET, GL_TEXTURE_WRAP_S, GL_CLAMP_TO_EDGE );
+    glTexParameteri( LE_TEXTURE_TARGET, GL_TEXTURE_WRAP_T, GL_CLAMP_TO_EDGE );
+    glBindTexture( LE_TEXTURE_TARGET, 0 );
+
+    LE_TRACK_GPU_MEMORY( LE_GPU_MEMORY_TEXTURE, id, (size_t)width * (size_t)height * 4 * (size_t)layers );
+    return id;
+}
+
+// Delete a texture
+void
+leUnloadTexture( unsigned int id )
+{
+    glDeleteTextures( 1, &id );
+    LE_TRACK_GPU_MEMORY( LE_GPU_MEMORY_TEXTURE, id, 0 );
+}
+
+// Bind a texture to the first unit, where the default shader samples
+void
+leEnableTexture( unsigned int id )
+{
+    glActiveTexture( GL_TEXTURE0 );
+    glBindTexture( LE_TEXTURE_TARGET, id );
+}
+
+// Grow or shrink the layers of a texture array, the common layers are copied through a read framebuffer.
+// The name survives, so anything holding it stays valid
+bool
+leResizeTextureLayers( unsigned int id, int width, int height, int layers, int newLayers )
+{
+#    if LE_TEXTURE_ARRAYS
+    const int kept = ( layers < newLayers ) ? layers : newLayers;
+
+    const GLuint copy = ( kept > 0 ) ? leLoadTexture( NULL, width, height, kept ) : 0;
+
+    GLuint framebuffer = 0;
+    glGenFramebuffers( 1, &framebuffer );
+    glBindFramebuffer( GL_READ_FRAMEBUFFER, framebuffer );
+
+    for( int i = 0; i < kept; ++i )
+        {
+            glFramebufferTextureLayer( GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, id, 0, i );
+            glBindTexture( GL_TEXTURE_2D_ARRAY, copy );
+            glCopyTexSubImage3D( GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, 0, 0, width, height );
+        }
+
+    // Respecifying level 0 drops the old storage
+    glBindTexture( GL_TEXTURE_2D_ARRAY, id );
+    glTexImage3D( GL_TEXTURE_2D_ARRAY, 0, GL_RGBA8, width, height, newLayers, 0, GL_RGBA, GL_UNSIGNED_BYTE, NULL );
+
+    for( int i = 0; i < kept; ++i )
+        {
+            glFramebufferTextureLayer( GL_READ_FRAMEBUFFER, GL_COLOR_ATTACHMENT0, copy, 0, i );
+            glCopyTexSubImage3D( GL_TEXTURE_2D_ARRAY, 0, 0, 0, i, 0, 0, width, height );
+        }
+
+    glBindTexture( GL_TEXTURE_2D_ARRAY, 0 );
+    glBindFramebuffer( GL_READ_FRAMEBUFFER, 0 );
+    glDeleteFramebuffers( 1, &framebuffer );
+    if( 0 != copy ) leUnloadTexture( copy );
+
+    LE_TRACK_GPU_MEMORY( LE_GPU_MEMORY_TEXTURE, id, (size_t)width * (size_t)height * 4 * (size_t)newLayers );
+    return true;
+#    else
+    (void)id;
+    (void)width;
+    (void)height;
+    (void)layers;
+    (void)newLayers;
+    return false;
+#    endif
+}
+
+// Write an area of a texture layer. A pixel unpack buffer is orphaned and refilled, so the driver
+// copies into the texture asynchronously instead of stalling on a buffer the GPU still reads
+void
+leUpdateTexture( unsigned int id, int x, int y, int layer, int width, int height, const void * data,
+                 unsigned int pixelBufferId )
+{
+    const void * pixels = data;
+
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    const GLsizeiptr size = (GLsizeiptr)width * height * 4;
+    if( 0 != pixelBufferId )
+        {
+            glBindBuffer( GL_PIXEL_UNPACK_BUFFER, pixelBufferId );
+            glBufferData( GL_PIXEL_UNPACK_BUFFER, size, NULL, GL_STREAM_DRAW );
+
+            void * mapped = glMapBufferRange( GL_PIXEL_UNPACK_BUFFER, 0, size,
+                                              GL_MAP_WRITE_BIT | GL_MAP_INVALIDATE_BUFFER_BIT );
+            if( NULL != mapped )
+                {
+                    memcpy( mapped, data, (size_t)size );
+                    glUnmapBuffer( GL_PIXEL_UNPACK_BUFFER );
+                    pixels = NULL; // Offset 0 into the bound buffer
+                }
+            else
+                {
+                    glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+                }
+
+            LE_TRACK_GPU_MEMORY( LE_GPU_MEMORY_BUFFER, pixelBufferId, (size_t)size );
+        }
+#    else
+    (void)pixelBufferId;
+#    endif
+
+    glBindTexture( LE_TEXTURE_TARGET, id );
+    glPixelStorei( GL_UNPACK_ALIGNMENT, 4 );
+#    if LE_TEXTURE_ARRAYS
+    glTexSubImage3D( GL_TEXTURE_2D_ARRAY, 0, x, y, layer, width, height, 1, GL_RGBA, GL_UNSIGNED_BYTE, pixels );
+#    else
+    (void)layer;
+    glTexSubImage2D( GL_TEXTURE_2D, 0, x, y, width, height, GL_RGBA, GL_UNSIGNED_BYTE, pixels );
+#    endif
+    glBindTexture( LE_TEXTURE_TARGET, 0 );
+
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    if( 0 != pixelBufferId ) glBindBuffer( GL_PIXEL_UNPACK_BUFFER, 0 );
+#    endif
+}
+
+// Create a pixel unpack buffer, 0 where they are unavailable (ES 2.0)
+unsigned int
+leLoadPixelBuffer( void )
+{
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    GLuint id = 0;
+    glGenBuffers( 1, &id );
+    return id;
+#    else
+    return 0;
+#    endif
+}
+
+// Delete a pixel unpack buffer
+void
+leUnloadPixelBuffer( unsigned int bufferId )
+{
+    if( 0 == bufferId ) return;
+
+    glDeleteBuffers( 1, &bufferId );
+    LE_TRACK_GPU_MEMORY( LE_GPU_MEMORY_BUFFER, bufferId, 0 );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Shaders
+//----------------------------------------------------------------------------------------------------------------------
+// Compile a single shader stage, returns 0 on failure
+unsigned int
+leCompileShader( const char * shaderCode, int type )
+{
+    GLuint shader = glCreateShader( (GLenum)type );
+    glShaderSource( shader, 1, &shaderCode, NULL );
+    glCompileShader( shader );
+
+    GLint success = GL_FALSE;
+    glGetShaderiv( shader, GL_COMPILE_STATUS, &success );
+    if( GL_FALSE == success )
+        {
+            GLint length = 0;
+            glGetShaderiv( shader, GL_INFO_LOG_LENGTH, &length );
+
+            char * log = (char *)LE_MALLOC( (size_t)length + 1 );
+            if( NULL != log )
+                {
+                    glGetShaderInfoLog( shader, length, NULL, log );
+                    log[length] = '\0';
+                    TRACELOG( LOG_WARNING, "SHADER: [ID %u] Failed to compile %s shader: %s", shader,
+                              ( GL_VERTEX_SHADER == type )     ? "vertex"
+                              : ( GL_FRAGMENT_SHADER == type ) ? "fragment"
+                                                               : "compute",
+                              log );
+                    LE_FREE( log );
+                }
+
+            glDeleteShader( shader );
+            return 0;
+        }
+
+    TRACELOGD( "SHADER: [ID %u] Compiled successfully", shader );
+    return shader;
+}
+
+// Compile both stages and link them into a program, returns 0 on failure
+unsigned int
+leLoadShaderProgram( const char * vsCode, const char * fsCode )
+{
+    GLuint vertexShader   = leCompileShader( vsCode, GL_VERTEX_SHADER );
+    GLuint fragmentShader = leCompileShader( fsCode, GL_FRAGMENT_SHADER );
+
+    if( 0 == vertexShader || 0 == fragmentShader )
+        {
+            glDeleteShader( vertexShader );
+            glDeleteShader( fragmentShader );
+            return 0;
+        }
+
+    GLuint program = glCreateProgram();
+    glAttachShader( program, vertexShader );
+    glAttachShader( program, fragmentShader );
+
+    // Keep the default attribute layout for every program
+    glBindAttribLocation( program, LE_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, LE_DEFAULT_SHADER_ATTRIB_NAME_POSITION );
+    glBindAttribLocation( program, LE_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, LE_DEFAULT_SHADER_ATTRIB_NAME_COLOR );
+    glBindAttribLocation( program, LE_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, LE_DEFAULT_SHADER_ATTRIB_NAME_TEXCOORD );
+    glBindAttribLocation( program, LE_DEFAULT_SHADER_ATTRIB_LOCATION_LAYER, LE_DEFAULT_SHADER_ATTRIB_NAME_LAYER );
+
+    glLinkProgram( program );
+
+    // Stages are owned by the program from now on
+    glDetachShader( program, vertexShader );
+    glDetachShader( program, fragmentShader );
+    glDeleteShader( vertexShader );
+    glDeleteShader( fragmentShader );
+
+    GLint success = GL_FALSE;
+    glGetProgramiv( program, GL_LINK_STATUS, &success );
+    if( GL_FALSE == success )
+        {
+            GLint length = 0;
+            glGetProgramiv( program, GL_INFO_LOG_LENGTH, &length );
+
+            char * log = (char *)LE_MALLOC( (size_t)length + 1 );
+            if( NULL != log )
+                {
+                    glGetProgramInfoLog( program, length, NULL, log );
+                    log[length] = '\0';
+                    TRACELOG( LOG_WARNING, "SHADER: [ID %u] Failed to link program: %s", program, log );
+                    LE_FREE( log );
+                }
+
+            glDeleteProgram( program );
+            return 0;
+        }
+
+    TRACELOG( LOG_INFO, "SHADER: [ID %u] Program loaded successfully", program );
+    return program;
+}
+
+// Delete a shader program
+void
+leUnloadShaderProgram( unsigned int id )
+{
+    glDeleteProgram( id );
+    TRACELOG( LOG_INFO, "SHADER: [ID %u] Program unloaded", id );
+}
+
+// Bind a shader program
+void
+leEnableShader( unsigned int id )
+{
+    glUseProgram( id );
+}
+
+// Get a uniform location from a program, -1 when not found
+int
+leGetLocationUniform( unsigned int shaderId, const char * name )
+{
+    return glGetUniformLocation( shaderId, name );
+}
+
+// Set uniform value(s) on the bound program
+void
+leSetUniform( int locIndex, const void * value, int uniformType, int count )
+{
+    switch( uniformType )
+        {
+        case LE_SHADER_UNIFORM_FLOAT:     glUniform1fv( locIndex, count, (const GLfloat *)value ); break;
+        case LE_SHADER_UNIFORM_VEC2:      glUniform2fv( locIndex, count, (const GLfloat *)value ); break;
+        case LE_SHADER_UNIFORM_VEC3:      glUniform3fv( locIndex, count, (const GLfloat *)value ); break;
+        case LE_SHADER_UNIFORM_VEC4:      glUniform4fv( locIndex, count, (const GLfloat *)value ); break;
+        case LE_SHADER_UNIFORM_INT:       glUniform1iv( locIndex, count, (const GLint *)value ); break;
+        case LE_SHADER_UNIFORM_IVEC2:     glUniform2iv( locIndex, count, (const GLint *)value ); break;
+        case LE_SHADER_UNIFORM_IVEC3:     glUniform3iv( locIndex, count, (const GLint *)value ); break;
+        case LE_SHADER_UNIFORM_IVEC4:     glUniform4iv( locIndex, count, (const GLint *)value ); break;
+        case LE_SHADER_UNIFORM_SAMPLER2D: glUniform1iv( locIndex, count, (const GLint *)value ); break;
+        default:                          TRACELOG( LOG_WARNING, "SHADER: Unknown uniform type: %d", uniformType );
+        }
+}
+
+// Set a column-major 4x4 matrix on the bound program
+void
+leSetUniformMatrix( int locIndex, const float * matrix )
+{
+    glUniformMatrix4fv( locIndex, 1, GL_FALSE, matrix );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Vertex buffers and arrays
+//----------------------------------------------------------------------------------------------------------------------
+// Create a vertex array object, returns 0 where VAOs are unavailable
+unsigned int
+leLoadVertexArray( void )
+{
+    GLuint vaoId = 0;
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    glGenVertexArrays( 1, &vaoId );
+#    elif defined( GRAPHICS_API_OPENGL_ES2 )
+    if( GLAD_GL_OES_vertex_array_object ) glGenVertexArraysOES( 1, &vaoId );
+#    endif
+    return vaoId;
+}
+
+// Delete a vertex array object
+void
+leUnloadVertexArray( unsigned int vaoId )
+{
+    if( 0 == vaoId ) return;
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    glDeleteVertexArrays( 1, &vaoId );
+#    elif defined( GRAPHICS_API_OPENGL_ES2 )
+    glDeleteVertexArraysOES( 1, &vaoId );
+#    endif
+}
+
+// Bind a vertex array object, false when the attributes must be set up by hand
+bool
+leEnableVertexArray( unsigned int vaoId )
+{
+    if( 0 == vaoId ) return false;
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    glBindVertexArray( vaoId );
+#    elif defined( GRAPHICS_API_OPENGL_ES2 )
+    glBindVertexArrayOES( vaoId );
+#    endif
+    return true;
+}
+
+// Unbind the current vertex array object
+void
+leDisableVertexArray( void )
+{
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    glBindVertexArray( 0 );
+#    elif defined( GRAPHICS_API_OPENGL_ES2 )
+    if( GLAD_GL_OES_vertex_array_object ) glBindVertexArrayOES( 0 );
+#    endif
+}
+
+// Create a vertex buffer and allocate its storage, data may be NULL
+unsigned int
+leLoadVertexBuffer( const void * data, int size, bool dynamic )
+{
+    GLuint id = 0;
+    glGenBuffers( 1, &id );
+    glBindBuffer( GL_ARRAY_BUFFER, id );
+    glBufferData( GL_ARRAY_BUFFER, size, data, dynamic ? GL_DYNAMIC_DRAW : GL_STATIC_DRAW );
+    LE_TRACK_GPU_MEMORY( LE_GPU_MEMORY_BUFFER, id, (size_t)size );
+    return id;
+}
+
+// Delete a vertex buffer
+void
+leUnloadVertexBuffer( unsigned int bufferId )
+{
+    glDeleteBuffers( 1, &bufferId );
+    LE_TRACK_GPU_MEMORY( LE_GPU_MEMORY_BUFFER, bufferId, 0 );
+}
+
+// Bind a vertex buffer
+void
+leEnableVertexBuffer( unsigned int bufferId )
+{
+    glBindBuffer( GL_ARRAY_BUFFER, bufferId );
+}
+
+// Bind a vertex buffer and replace its storage, orphaning the previous contents
+void
+leSetVertexBufferData( unsigned int bufferId, const void * data, int size )
+{
+    glBindBuffer( GL_ARRAY_BUFFER, bufferId );
+    glBufferData( GL_ARRAY_BUFFER, size, data, GL_STREAM_DRAW );
+    LE_TRACK_GPU_MEMORY( LE_GPU_MEMORY_BUFFER, bufferId, (size_t)size );
+}
+
+// Overwrite a range of the bound vertex buffer
+void
+leUpdateVertexBufferData( const void * data, int size, int offset )
+{
+    glBufferSubData( GL_ARRAY_BUFFER, offset, size, data );
+}
+
+// Describe an attribute sourced from the bound vertex buffer
+void
+leSetVertexAttribute( unsigned int index, int compSize, int type, bool normalized, int stride, int offset )
+{
+    glVertexAttribPointer( index, compSize, (GLenum)type, normalized ? GL_TRUE : GL_FALSE, stride,
+                           (const void *)(size_t)offset );
+}
+
+// Enable a vertex attribute
+void
+leEnableVertexAttribute( unsigned int index )
+{
+    glEnableVertexAttribArray( index );
+}
+
+// Disable a vertex attribute
+void
+leDisableVertexAttribute( unsigned int index )
+{
+    glDisableVertexAttribArray( index );
+}
+
+// Draw non-indexed primitives from the bound vertex state
+void
+leDrawVertexArray( int mode, int offset, int count )
+{
+    glDrawArrays( (GLenum)mode, offset, count );
+}
+
+// Step an attribute once every `divisor` instances, 0 steps it per vertex
+void
+leSetVertexAttributeDivisor( unsigned int index, int divisor )
+{
+#    if LE_INSTANCED_LINES
+    glVertexAttribDivisor( index, (GLuint)divisor );
+#    else
+    (void)index;
+    (void)divisor;
+#    endif
+}
+
+// Draw `instances` copies of the primitives, a single one when instancing is unsupported
+void
+leDrawVertexArrayInstanced( int mode, int offset, int count, int instances )
+{
+#    if LE_INSTANCED_LINES
+    glDrawArraysInstanced( (GLenum)mode, offset, count, instances );
+#    else
+    (void)instances;
+    glDrawArrays( (GLenum)mode, offset, count );
+#    endif
+}
+
+// Create a static index buffer and bind it to the current vertex array
+unsigned int
+leLoadIndexBuffer( const void * data, int size )
+{
+    GLuint id = 0;
+    glGenBuffers( 1, &id );
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, id );
+    glBufferData( GL_ELEMENT_ARRAY_BUFFER, size, data, GL_STATIC_DRAW );
+    LE_TRACK_GPU_MEMORY( LE_GPU_MEMORY_BUFFER, id, (size_t)size );
+    return id;
+}
+
+// Bind an index buffer, it belongs to the current vertex array where there is one
+void
+leEnableIndexBuffer( unsigned int bufferId )
+{
+    glBindBuffer( GL_ELEMENT_ARRAY_BUFFER, bufferId );
+}
+
+// Draw `count` indices of `type` read from byte `offset` of the bound index buffer
+void
+leDrawElements( int mode, int count, int type, int offset )
+{
+    glDrawElements( (GLenum)mode, count, (GLenum)type, (const void *)(size_t)offset );
+}
+
+// Draw indices offset by `baseVertex`, which is ignored without LE_BASE_VERTEX
+void
+leDrawElementsBaseVertex( int mode, int count, int type, int offset, int baseVertex )
+{
+#    if LE_BASE_VERTEX
+    glDrawElementsBaseVertex( (GLenum)mode, count, (GLenum)type, (const void *)(size_t)offset, baseVertex );
+#    else
+    (void)baseVertex;
+    glDrawElements( (GLenum)mode, count, (GLenum)type, (const void *)(size_t)offset );
+#    endif
+}
+
+// Create a buffer of draw commands, 0 without GL 4.3 even when built for it
+unsigned int
+leLoadIndirectBuffer( void )
+{
+#    if LE_MULTI_DRAW_INDIRECT
+    if( !GLAD_GL_VERSION_4_3 ) return 0;
+
+    GLuint id = 0;
+    glGenBuffers( 1, &id );
+    return id;
+#    else
+    return 0;
+#    endif
+}
+
+// Bind a draw command buffer and replace its storage, orphaning the previous commands
+void
+leSetIndirectBufferData( unsigned int bufferId, const void * data, int size )
+{
+#    if LE_MULTI_DRAW_INDIRECT
+    glBindBuffer( GL_DRAW_INDIRECT_BUFFER, bufferId );
+    glBufferData( GL_DRAW_INDIRECT_BUFFER, size, data, GL_STREAM_DRAW );
+    LE_TRACK_GPU_MEMORY( LE_GPU_MEMORY_BUFFER, bufferId, (size_t)size );
+#    else
+    (void)bufferId;
+    (void)data;
+    (void)size;
+#    endif
+}
+
+// Run `count` indexed draws described by the bound indirect buffer from byte `offset`, indices of `type`
+void
+leMultiDrawIndirect( int mode, int type, int offset, int count )
+{
+#    if LE_MULTI_DRAW_INDIRECT
+    glMultiDrawElementsIndirect( (GLenum)mode, (GLenum)type, (const void *)(size_t)offset, count, 0 );
+#    else
+    (void)mode;
+    (void)type;
+    (void)offset;
+    (void)count;
+#    endif
+}
+
+// Bind a draw command buffer, its data is read by the indirect draws that follow
+void
+leEnableIndirectBuffer( unsigned int bufferId )
+{
+#    if LE_MULTI_DRAW_INDIRECT
+    glBindBuffer( GL_DRAW_INDIRECT_BUFFER, bufferId );
+#    else
+    (void)bufferId;
+#    endif
+}
+
+// Draw the primitives described by the bound indirect buffer at byte `offset`, vertex and instance counts included
+void
+leDrawVertexArrayIndirect( int mode, int offset )
+{
+#    if LE_MULTI_DRAW_INDIRECT
+    glDrawArraysIndirect( (GLenum)mode, (const void *)(size_t)offset );
+#    else
+    (void)mode;
+    (void)offset;
+#    endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Compute shaders and shader storage buffers
+//----------------------------------------------------------------------------------------------------------------------
+// Compile a compute shader and link it into a program, 0 on failure or without GL 4.3 even when built for it
+unsigned int
+leLoadComputeShaderProgram( const char * csCode )
+{
+#    if LE_COMPUTE_SHADERS
+    if( !GLAD_GL_VERSION_4_3 ) return 0;
+
+    GLuint computeShader = leCompileShader( csCode, GL_COMPUTE_SHADER );
+    if( 0 == computeShader ) return 0;
+
+    GLuint program = glCreateProgram();
+    glAttachShader( program, computeShader );
+    glLinkProgram( program );
+    glDetachShader( program, computeShader );
+    glDeleteShader( computeShader );
+
+    GLint success = GL_FALSE;
+    glGetProgramiv( program, GL_LINK_STATUS, &success );
+    if( GL_FALSE == success )
+        {
+            GLint length = 0;
+            glGetProgramiv( program, GL_INFO_LOG_LENGTH, &length );
+
+            char * log = (char *)LE_MALLOC( (size_t)length + 1 );
+            if( NULL != log )
+                {
+                    glGetProgramInfoLog( program, length, NULL, log );
+                    log[length] = '\0';
+                    TRACELOG( LOG_WARNING, "SHADER: [ID %u] Failed to link compute program: %s", program, log );
+                    LE_FREE( log );
+                }
+
+            glDeleteProgram( program );
+            return 0;
+        }
+
+    TRACELOG( LOG_INFO, "SHADER: [ID %u] Compute program loaded successfully", program );
+    return program;
+#    else
+    (void)csCode;
+    return 0;
+#    endif
+}
+
+// Create a shader storage buffer and allocate its storage, data may be NULL. 0 without GL 4.3 even when built for it
+unsigned int
+leLoadShaderBuffer( const void * data, int size )
+{
+#    if LE_COMPUTE_SHADERS
+    if( !GLAD_GL_VERSION_4_3 ) return 0;
+
+    GLuint id = 0;
+    glGenBuffers( 1, &id );
+    glBindBuffer( GL_SHADER_STORAGE_BUFFER, id );
+    glBufferData( GL_SHADER_STORAGE_BUFFER, size, data, GL_DYNAMIC_COPY );
+    LE_TRACK_GPU_MEMORY( LE_GPU_MEMORY_BUFFER, id, (size_t)size );
+    return id;
+#    else
+    (void)data;
+    (void)size;
+    return 0;
+#    endif
+}
+
+// Attach a storage buffer to the `binding = index` block of the shaders
+void
+leBindShaderBuffer( unsigned int bufferId, unsigned int index )
+{
+#    if LE_COMPUTE_SHADERS
+    glBindBufferBase( GL_SHADER_STORAGE_BUFFER, index, bufferId );
+#    else
+    (void)bufferId;
+    (void)index;
+#    endif
+}
+
+// Copy bytes of a storage buffer back, waiting for the GPU to write them
+bool
+leReadShaderBuffer( unsigned int bufferId, void * data, int size, int offset )
+{
+#    if LE_COMPUTE_SHADERS
+    glBindBuffer( GL_SHADER_STORAGE_BUFFER, bufferId );
+    glGetBufferSubData( GL_SHADER_STORAGE_BUFFER, offset, size, data );
+    return true;
+#    else
+    (void)bufferId;
+    (void)data;
+    (void)size;
+    (void)offset;
+    return false;
+#    endif
+}
+
+// Run the bound compute program over a grid of work groups
+void
+leDispatchCompute( unsigned int groupsX, unsigned int groupsY, unsigned int groupsZ )
+{
+#    if LE_COMPUTE_SHADERS
+    glDispatchCompute( groupsX, groupsY, groupsZ );
+#    else
+    (void)groupsX;
+    (void)groupsY;
+    (void)groupsZ;
+#    endif
+}
+
+// Run the bound compute program over the work groups counted by three integers at byte `offset` of a buffer
+void
+leDispatchComputeIndirect( unsigned int bufferId, int offset )
+{
+#    if LE_COMPUTE_SHADERS
+    glBindBuffer( GL_DISPATCH_INDIRECT_BUFFER, bufferId );
+    glDispatchComputeIndirect( (GLintptr)offset );
+#    else
+    (void)bufferId;
+    (void)offset;
+#    endif
+}
+
+// Order storage buffer writes before the shaders, vertex fetches and indirect commands that follow
+void
+leComputeBarrier( void )
+{
+#    if LE_COMPUTE_SHADERS
+    glMemoryBarrier( GL_SHADER_STORAGE_BARRIER_BIT | GL_VERTEX_ATTRIB_ARRAY_BARRIER_BIT | GL_COMMAND_BARRIER_BIT );
+#    endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Synchronization
+//----------------------------------------------------------------------------------------------------------------------
+// Insert a fence signaled once every command queued so far has completed
+void *
+leFenceSync( void )
+{
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    return (void *)glFenceSync( GL_SYNC_GPU_COMMANDS_COMPLETE, 0 );
+#    else
+    return NULL;
+#    endif
+}
+
+// Block the calling thread until the GPU reaches the fence
+void
+leWaitSync( void * sync )
+{
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    if( NULL == sync ) return;
+
+    // Flush once so the fence is guaranteed to be submitted, then keep waiting in 100ms slices
+    GLbitfield flags  = GL_SYNC_FLUSH_COMMANDS_BIT;
+    GLenum     result = GL_TIMEOUT_EXPIRED;
+    while( GL_TIMEOUT_EXPIRED == result )
+        {
+            result = glClientWaitSync( (GLsync)sync, flags, 100000000 );
+            flags  = 0;
+        }
+
+    if( GL_WAIT_FAILED == result ) TRACELOG( LOG_WARNING, "GL: Failed to wait on fence" );
+#    else
+    (void)sync;
+#    endif
+}
+
+// Delete a fence
+void
+leDeleteSync( void * sync )
+{
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    if( NULL != sync ) glDeleteSync( (GLsync)sync );
+#    else
+    (void)sync;
+#    endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Timer queries
+//----------------------------------------------------------------------------------------------------------------------
+// Create a GPU timer, 0 where timer queries are unavailable (ES 2.0)
+unsigned int
+leLoadTimerQuery( void )
+{
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    GLuint query = 0;
+    glGenQueries( 1, &query );
+    return query;
+#    else
+    return 0;
+#    endif
+}
+
+// Delete a GPU timer
+void
+leUnloadTimerQuery( unsigned int queryId )
+{
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    if( 0 != queryId ) glDeleteQueries( 1, &queryId );
+#    else
+    (void)queryId;
+#    endif
+}
+
+// Start timing the GPU work of the commands that follow, one timer runs at a time
+void
+leBeginTimerQuery( unsigned int queryId )
+{
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    glBeginQuery( GL_TIME_ELAPSED, queryId );
+#    else
+    (void)queryId;
+#    endif
+}
+
+// Stop the running timer
+void
+leEndTimerQuery( void )
+{
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    glEndQuery( GL_TIME_ELAPSED );
+#    endif
+}
+
+// Read a stopped timer without blocking, false while the GPU has not reached its end
+bool
+leGetTimerQueryResult( unsigned int queryId, double * seconds )
+{
+#    if defined( GRAPHICS_API_OPENGL_33 )
+    GLint available = GL_FALSE;
+    glGetQueryObjectiv( queryId, GL_QUERY_RESULT_AVAILABLE, &available );
+    if( GL_FALSE == available ) return false;
+
+    GLuint64 nanoseconds = 0;
+    glGetQueryObjectui64v( queryId, GL_QUERY_RESULT, &nanoseconds );
+    *seconds = (double)nanoseconds * 1e-9;
+    return true;
+#    else
+    (void)queryId;
+    (void)seconds;
+    return false;
+#    endif
+}
+
 #endif // LEGL_IMPLEMENTATION
 #endif // !LEGL_H
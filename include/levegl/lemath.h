@@ -0,0 +1,586 @@
+/******************************** LEMATH *********************************
+ * lemath: Vector and matrix math, SIMD accelerated where available
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ * - DEFINES:
+ *   - LE_MATH_NO_SIMD: Use the scalar implementations only
+ *
+ * - Every function is static inline, the header can be used without the library.
+ * - SSE2 is used on x86/x64 and NEON on ARM, selected at compile time. The scalar
+ *   paths compute the same results and are used everywhere else.
+ * - Matrix is column-major (m0..m3 is the first column), the layout GL expects, and
+ *   transforms column vectors: MatrixMultiply( a, b ) applies b first, then a.
+ * - Matrix2D is the 3x2 affine subset used by 2D shapes:
+ *     x' = m0 * x + m2 * y + m4
+ *     y' = m1 * x + m3 * y + m5
+ * - Batch functions transform whole arrays, two points per SIMD register for Vector2.
+ *   Vector2TransformStrided works in place on interleaved vertex formats.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+#ifndef LEMATH_H
+#define LEMATH_H
+
+//==============================================================================================================
+// INCLUDES
+//==============================================================================================================
+#include <math.h> /* sinf, cosf, sqrtf */
+
+#if !defined( LE_MATH_NO_SIMD )
+#    if defined( __SSE2__ ) || defined( _M_X64 ) || ( defined( _M_IX86_FP ) && _M_IX86_FP >= 2 )
+#        define LE_MATH_SSE2
+#        include <emmintrin.h>
+#    elif defined( __ARM_NEON ) || defined( __ARM_NEON__ ) || defined( _M_ARM64 )
+#        define LE_MATH_NEON
+#        include <arm_neon.h>
+#    endif
+#endif
+
+//==============================================================================================================
+// DEFINES
+//==============================================================================================================
+#ifndef LEMATHDEF
+#    define LEMATHDEF static inline
+#endif
+
+#ifndef PI
+#    define PI 3.14159265358979323846F
+#endif
+
+#ifndef DEG2RAD
+#    define DEG2RAD ( PI / 180.0F )
+#endif
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+// Shared with levegl.h, whichever header comes first defines them
+#ifndef LE_VECTOR2_TYPE
+typedef struct Vector2
+{
+    float x;
+    float y;
+} Vector2;
+#    define LE_VECTOR2_TYPE
+#endif
+
+#ifndef LE_VECTOR4_TYPE
+typedef struct Vector4
+{
+    float x;
+    float y;
+    float z;
+    float w;
+} Vector4;
+#    define LE_VECTOR4_TYPE
+#endif
+
+#ifndef LE_MATRIX_TYPE
+typedef struct Matrix
+{
+    float m0, m1, m2, m3;     // First column
+    float m4, m5, m6, m7;     // Second column
+    float m8, m9, m10, m11;   // Third column
+    float m12, m13, m14, m15; // Fourth column, translation
+} Matrix;
+#    define LE_MATRIX_TYPE
+#endif
+
+#ifndef LE_MATRIX2D_TYPE
+typedef struct Matrix2D
+{
+    float m0, m1; // X axis
+    float m2, m3; // Y axis
+    float m4, m5; // Translation
+} Matrix2D;
+#    define LE_MATRIX2D_TYPE
+#endif
+
+//==============================================================================================================
+// FUNCTIONS: Vector2
+//==============================================================================================================
+LEMATHDEF Vector2
+Vector2Add( Vector2 a, Vector2 b )
+{
+    Vector2 result = { a.x + b.x, a.y + b.y };
+    return result;
+}
+
+LEMATHDEF Vector2
+Vector2Subtract( Vector2 a, Vector2 b )
+{
+    Vector2 result = { a.x - b.x, a.y - b.y };
+    return result;
+}
+
+LEMATHDEF Vector2
+Vector2Scale( Vector2 v, float scale )
+{
+    Vector2 result = { v.x * scale, v.y * scale };
+    return result;
+}
+
+LEMATHDEF float
+Vector2Dot( Vector2 a, Vector2 b )
+{
+    return a.x * b.x + a.y * b.y;
+}
+
+LEMATHDEF float
+Vector2Length( Vector2 v )
+{
+    return sqrtf( v.x * v.x + v.y * v.y );
+}
+
+// Unit vector, zero vectors are returned unchanged
+LEMATHDEF Vector2
+Vector2Normalize( Vector2 v )
+{
+    const float length = Vector2Length( v );
+    if( length <= 0.0F ) return v;
+
+    return Vector2Scale( v, 1.0F / length );
+}
+
+LEMATHDEF Vector2
+Vector2Lerp( Vector2 a, Vector2 b, float t )
+{
+    Vector2 result = { a.x + ( b.x - a.x ) * t, a.y + ( b.y - a.y ) * t };
+    return result;
+}
+
+// Point transformed by a 4x4 matrix, with z = 0 and w = 1
+LEMATHDEF Vector2
+Vector2Transform( Vector2 v, Matrix mat )
+{
+    Vector2 result = { mat.m0 * v.x + mat.m4 * v.y + mat.m12, mat.m1 * v.x + mat.m5 * v.y + mat.m13 };
+    return result;
+}
+
+LEMATHDEF Vector2
+Vector2Transform2D( Vector2 v, Matrix2D mat )
+{
+    Vector2 result = { mat.m0 * v.x + mat.m2 * v.y + mat.m4, mat.m1 * v.x + mat.m3 * v.y + mat.m5 };
+    return result;
+}
+
+//==============================================================================================================
+// FUNCTIONS: Vector4
+//==============================================================================================================
+LEMATHDEF Vector4
+Vector4Add( Vector4 a, Vector4 b )
+{
+    Vector4 result = { a.x + b.x, a.y + b.y, a.z + b.z, a.w + b.w };
+    return result;
+}
+
+LEMATHDEF Vector4
+Vector4Scale( Vector4 v, float scale )
+{
+    Vector4 result = { v.x * scale, v.y * scale, v.z * scale, v.w * scale };
+    return result;
+}
+
+LEMATHDEF float
+Vector4Dot( Vector4 a, Vector4 b )
+{
+    return a.x * b.x + a.y * b.y + a.z * b.z + a.w * b.w;
+}
+
+LEMATHDEF Vector4
+Vector4Transform( Vector4 v, Matrix mat )
+{
+    Vector4 result;
+    result.x = mat.m0 * v.x + mat.m4 * v.y + mat.m8 * v.z + mat.m12 * v.w;
+    result.y = mat.m1 * v.x + mat.m5 * v.y + mat.m9 * v.z + mat.m13 * v.w;
+    result.z = mat.m2 * v.x + mat.m6 * v.y + mat.m10 * v.z + mat.m14 * v.w;
+    result.w = mat.m3 * v.x + mat.m7 * v.y + mat.m11 * v.z + mat.m15 * v.w;
+    return result;
+}
+
+//==============================================================================================================
+// FUNCTIONS: Matrix
+//==============================================================================================================
+LEMATHDEF Matrix
+MatrixIdentity( void )
+{
+    Matrix result = { 1.0F, 0.0F, 0.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F,
+                      0.0F, 0.0F, 1.0F, 0.0F, 0.0F, 0.0F, 0.0F, 1.0F };
+    return result;
+}
+
+// a * b, transforming by the result applies b first
+LEMATHDEF Matrix
+MatrixMultiply( Matrix a, Matrix b )
+{
+    Matrix result;
+
+#if defined( LE_MATH_SSE2 )
+    const __m128 a0 = _mm_loadu_ps( &a.m0 );
+    const __m128 a1 = _mm_loadu_ps( &a.m4 );
+    const __m128 a2 = _mm_loadu_ps( &a.m8 );
+    const __m128 a3 = _mm_loadu_ps( &a.m12 );
+
+    const float * columns = &b.m0;
+    float *       out     = &result.m0;
+    for( int i = 0; i < 4; ++i )
+        {
+            const float * column = columns + i * 4;
+
+            __m128 sum = _mm_mul_ps( a0, _mm_set1_ps( column[0] ) );
+            sum        = _mm_add_ps( sum, _mm_mul_ps( a1, _mm_set1_ps( column[1] ) ) );
+            sum        = _mm_add_ps( sum, _mm_mul_ps( a2, _mm_set1_ps( column[2] ) ) );
+            sum        = _mm_add_ps( sum, _mm_mul_ps( a3, _mm_set1_ps( column[3] ) ) );
+            _mm_storeu_ps( out + i * 4, sum );
+        }
+#elif defined( LE_MATH_NEON )
+    const float32x4_t a0 = vld1q_f32( &a.m0 );
+    const float32x4_t a1 = vld1q_f32( &a.m4 );
+    const float32x4_t a2 = vld1q_f32( &a.m8 );
+    const float32x4_t a3 = vld1q_f32( &a.m12 );
+
+    const float * columns = &b.m0;
+    float *       out     = &result.m0;
+    for( int i = 0; i < 4; ++i )
+        {
+            const float * column = columns + i * 4;
+
+            float32x4_t sum = vmulq_n_f32( a0, column[0] );
+            sum             = vmlaq_n_f32( sum, a1, column[1] );
+            sum             = vmlaq_n_f32( sum, a2, column[2] );
+            sum             = vmlaq_n_f32( sum, a3, column[3] );
+            vst1q_f32( out + i * 4, sum );
+        }
+#else
+    const float * left  = &a.m0;
+    const float * right = &b.m0;
+    float *       out   = &result.m0;
+    for( int column = 0; column < 4; ++column )
+        {
+            for( int row = 0; row < 4; ++row )
+                {
+                    out[column * 4 + row] = left[row] * right[column * 4] + left[4 + row] * right[column * 4 + 1]
+                                          + left[8 + row] * right[column * 4 + 2]
+                                          + left[12 + row] * right[column * 4 + 3];
+                }
+        }
+#endif
+
+    return result;
+}
+
+LEMATHDEF Matrix
+MatrixTranslate( float x, float y, float z )
+{
+    Matrix result = MatrixIdentity();
+    result.m12    = x;
+    result.m13    = y;
+    result.m14    = z;
+    return result;
+}
+
+// Rotation around the Z axis, in radians
+LEMATHDEF Matrix
+MatrixRotateZ( float angle )
+{
+    const float c = cosf( angle );
+    const float s = sinf( angle );
+
+    Matrix result = MatrixIdentity();
+    result.m0     = c;
+    result.m1     = s;
+    result.m4     = -s;
+    result.m5     = c;
+    return result;
+}
+
+LEMATHDEF Matrix
+MatrixScale( float x, float y, float z )
+{
+    Matrix result = MatrixIdentity();
+    result.m0     = x;
+    result.m5     = y;
+    result.m10    = z;
+    return result;
+}
+
+// Orthographic projection mapping the box to clip space
+LEMATHDEF Matrix
+MatrixOrtho( float left, float right, float bottom, float top, float nearPlane, float farPlane )
+{
+    const float width  = right - left;
+    const float height = top - bottom;
+    const float depth  = farPlane - nearPlane;
+
+    Matrix result = MatrixIdentity();
+    result.m0     = 2.0F / width;
+    result.m5     = 2.0F / height;
+    result.m10    = -2.0F / depth;
+    result.m12    = -( right + left ) / width;
+    result.m13    = -( top + bottom ) / height;
+    result.m14    = -( farPlane + nearPlane ) / depth;
+    return result;
+}
+
+// 4x4 form of a 2D affine transform
+LEMATHDEF Matrix
+MatrixFromMatrix2D( Matrix2D mat )
+{
+    Matrix result = MatrixIdentity();
+    result.m0     = mat.m0;
+    result.m1     = mat.m1;
+    result.m4     = mat.m2;
+    result.m5     = mat.m3;
+    result.m12    = mat.m4;
+    result.m13    = mat.m5;
+    return result;
+}
+
+//==============================================================================================================
+// FUNCTIONS: Matrix2D
+//==============================================================================================================
+LEMATHDEF Matrix2D
+Matrix2DIdentity( void )
+{
+    Matrix2D result = { 1.0F, 0.0F, 0.0F, 1.0F, 0.0F, 0.0F };
+    return result;
+}
+
+// a * b, transforming by the result applies b first
+LEMATHDEF Matrix2D
+Matrix2DMultiply( Matrix2D a, Matrix2D b )
+{
+    Matrix2D result;
+    result.m0 = a.m0 * b.m0 + a.m2 * b.m1;
+    result.m1 = a.m1 * b.m0 + a.m3 * b.m1;
+    result.m2 = a.m0 * b.m2 + a.m2 * b.m3;
+    result.m3 = a.m1 * b.m2 + a.m3 * b.m3;
+    result.m4 = a.m0 * b.m4 + a.m2 * b.m5 + a.m4;
+    result.m5 = a.m1 * b.m4 + a.m3 * b.m5 + a.m5;
+    return result;
+}
+
+LEMATHDEF Matrix2D
+Matrix2DTranslate( float x, float y )
+{
+    Matrix2D result = { 1.0F, 0.0F, 0.0F, 1.0F, x, y };
+    return result;
+}
+
+// Rotation in radians, clockwise on screen since Y points down
+LEMATHDEF Matrix2D
+Matrix2DRotate( float angle )
+{
+    const float c = cosf( angle );
+    const float s = sinf( angle );
+
+    Matrix2D result = { c, s, -s, c, 0.0F, 0.0F };
+    return result;
+}
+
+LEMATHDEF Matrix2D
+Matrix2DScale( float x, float y )
+{
+    Matrix2D result = { x, 0.0F, 0.0F, y, 0.0F, 0.0F };
+    return result;
+}
+
+// Inverse transform, identity when the matrix is singular
+LEMATHDEF Matrix2D
+Matrix2DInvert( Matrix2D mat )
+{
+    const float determinant = mat.m0 * mat.m3 - mat.m1 * mat.m2;
+    if( 0.0F == determinant ) return Matrix2DIdentity();
+
+    const float inverse = 1.0F / determinant;
+
+    Matrix2D result;
+    result.m0 = mat.m3 * inverse;
+    result.m1 = -mat.m1 * inverse;
+    result.m2 = -mat.m2 * inverse;
+    result.m3 = mat.m0 * inverse;
+    result.m4 = -( result.m0 * mat.m4 + result.m2 * mat.m5 );
+    result.m5 = -( result.m1 * mat.m4 + result.m3 * mat.m5 );
+    return result;
+}
+
+//==============================================================================================================
+// FUNCTIONS: Batches
+//==============================================================================================================
+// Transform `count` contiguous points by a 2D affine transform, `dst` may alias `src`
+LEMATHDEF void
+Vector2TransformArray2D( Vector2 * dst, const Vector2 * src, int count, Matrix2D mat )
+{
+    int i = 0;
+
+#if defined( LE_MATH_SSE2 )
+    const __m128 axisX       = _mm_setr_ps( mat.m0, mat.m1, mat.m0, mat.m1 );
+    const __m128 axisY       = _mm_setr_ps( mat.m2, mat.m3, mat.m2, mat.m3 );
+    const __m128 translation = _mm_setr_ps( mat.m4, mat.m5, mat.m4, mat.m5 );
+
+    for( ; i + 2 <= count; i += 2 )
+        {
+            const __m128 points = _mm_loadu_ps( &src[i].x );
+            const __m128 xs     = _mm_shuffle_ps( points, points, _MM_SHUFFLE( 2, 2, 0, 0 ) );
+            const __m128 ys     = _mm_shuffle_ps( points, points, _MM_SHUFFLE( 3, 3, 1, 1 ) );
+
+            const __m128 scaled = _mm_add_ps( _mm_mul_ps( xs, axisX ), _mm_mul_ps( ys, axisY ) );
+            const __m128 result = _mm_add_ps( scaled, translation );
+            _mm_storeu_ps( &dst[i].x, result );
+        }
+#elif defined( LE_MATH_NEON )
+    const float32x2_t axisX2       = vld1_f32( &mat.m0 );
+    const float32x2_t axisY2       = vld1_f32( &mat.m2 );
+    const float32x2_t translation2 = vld1_f32( &mat.m4 );
+    const float32x4_t axisX        = vcombine_f32( axisX2, axisX2 );
+    const float32x4_t axisY        = vcombine_f32( axisY2, axisY2 );
+    const float32x4_t translation  = vcombine_f32( translation2, translation2 );
+
+    for( ; i + 2 <= count; i += 2 )
+        {
+            const float32x4_t   points = vld1q_f32( &src[i].x );
+            const float32x4x2_t split  = vtrnq_f32( points, points ); // { x0 x0 x1 x1 }, { y0 y0 y1 y1 }
+
+            float32x4_t result = vmlaq_f32( translation, split.val[0], axisX );
+            result             = vmlaq_f32( result, split.val[1], axisY );
+            vst1q_f32( &dst[i].x, result );
+        }
+#endif
+
+    for( ; i < count; ++i ) dst[i] = Vector2Transform2D( src[i], mat );
+}
+
+// Transform `count` contiguous points by a 4x4 matrix, with z = 0 and w = 1
+LEMATHDEF void
+Vector2TransformArray( Vector2 * dst, const Vector2 * src, int count, Matrix mat )
+{
+    const Matrix2D affine = { mat.m0, mat.m1, mat.m4, mat.m5, mat.m12, mat.m13 };
+    Vector2TransformArray2D( dst, src, count, affine );
+}
+
+// Transform in place `count` points spaced `stride` bytes apart, each starting with two floats
+LEMATHDEF void
+Vector2TransformStrided( void * points, int count, int stride, Matrix2D mat )
+{
+    unsigned char * cursor = (unsigned char *)points;
+    int             i      = 0;
+
+#if defined( LE_MATH_SSE2 )
+    const __m128 axisX       = _mm_setr_ps( mat.m0, mat.m1, mat.m0, mat.m1 );
+    const __m128 axisY       = _mm_setr_ps( mat.m2, mat.m3, mat.m2, mat.m3 );
+    const __m128 translation = _mm_setr_ps( mat.m4, mat.m5, mat.m4, mat.m5 );
+
+    for( ; i + 2 <= count; i += 2, cursor += 2 * stride )
+        {
+            __m64 * first  = (__m64 *)cursor;
+            __m64 * second = (__m64 *)( cursor + stride );
+
+            const __m128 points = _mm_loadh_pi( _mm_loadl_pi( _mm_setzero_ps(), first ), second );
+            const __m128 xs     = _mm_shuffle_ps( points, points, _MM_SHUFFLE( 2, 2, 0, 0 ) );
+            const __m128 ys     = _mm_shuffle_ps( points, points, _MM_SHUFFLE( 3, 3, 1, 1 ) );
+
+            const __m128 scaled = _mm_add_ps( _mm_mul_ps( xs, axisX ), _mm_mul_ps( ys, axisY ) );
+            const __m128 result = _mm_add_ps( scaled, translation );
+            _mm_storel_pi( first, result );
+            _mm_storeh_pi( second, result );
+        }
+#elif defined( LE_MATH_NEON )
+    const float32x2_t axisX2       = vld1_f32( &mat.m0 );
+    const float32x2_t axisY2       = vld1_f32( &mat.m2 );
+    const float32x2_t translation2 = vld1_f32( &mat.m4 );
+    const float32x4_t axisX        = vcombine_f32( axisX2, axisX2 );
+    const float32x4_t axisY        = vcombine_f32( axisY2, axisY2 );
+    const float32x4_t translation  = vcombine_f32( translation2, translation2 );
+
+    for( ; i + 2 <= count; i += 2, cursor += 2 * stride )
+        {
+            float * first  = (float *)cursor;
+            float * second = (float *)( cursor + stride );
+
+            const float32x4_t   points = vcombine_f32( vld1_f32( first ), vld1_f32( second ) );
+            const float32x4x2_t split  = vtrnq_f32( points, points );
+
+            float32x4_t result = vmlaq_f32( translation, split.val[0], axisX );
+            result             = vmlaq_f32( result, split.val[1], axisY );
+            vst1_f32( first, vget_low_f32( result ) );
+            vst1_f32( second, vget_high_f32( result ) );
+        }
+#endif
+
+    for( ; i < count; ++i, cursor += stride )
+        {
+            float *     point = (float *)cursor;
+            const float x     = point[0];
+            const float y     = point[1];
+
+            point[0] = mat.m0 * x + mat.m2 * y + mat.m4;
+            point[1] = mat.m1 * x + mat.m3 * y + mat.m5;
+        }
+}
+
+// Transform `count` contiguous vectors by a 4x4 matrix, `dst` may alias `src`
+LEMATHDEF void
+Vector4TransformArray( Vector4 * dst, const Vector4 * src, int count, Matrix mat )
+{
+#if defined( LE_MATH_SSE2 )
+    const __m128 c0 = _mm_loadu_ps( &mat.m0 );
+    const __m128 c1 = _mm_loadu_ps( &mat.m4 );
+    const __m128 c2 = _mm_loadu_ps( &mat.m8 );
+    const __m128 c3 = _mm_loadu_ps( &mat.m12 );
+
+    for( int i = 0; i < count; ++i )
+        {
+            const __m128 v = _mm_loadu_ps( &src[i].x );
+
+            __m128 sum = _mm_mul_ps( c0, _mm_shuffle_ps( v, v, _MM_SHUFFLE( 0, 0, 0, 0 ) ) );
+            sum        = _mm_add_ps( sum, _mm_mul_ps( c1, _mm_shuffle_ps( v, v, _MM_SHUFFLE( 1, 1, 1, 1 ) ) ) );
+            sum        = _mm_add_ps( sum, _mm_mul_ps( c2, _mm_shuffle_ps( v, v, _MM_SHUFFLE( 2, 2, 2, 2 ) ) ) );
+            sum        = _mm_add_ps( sum, _mm_mul_ps( c3, _mm_shuffle_ps( v, v, _MM_SHUFFLE( 3, 3, 3, 3 ) ) ) );
+            _mm_storeu_ps( &dst[i].x, sum );
+        }
+#elif defined( LE_MATH_NEON )
+    const float32x4_t c0 = vld1q_f32( &mat.m0 );
+    const float32x4_t c1 = vld1q_f32( &mat.m4 );
+    const float32x4_t c2 = vld1q_f32( &mat.m8 );
+    const float32x4_t c3 = vld1q_f32( &mat.m12 );
+
+    for( int i = 0; i < count; ++i )
+        {
+            const float32x4_t v  = vld1q_f32( &src[i].x );
+            const float32x2_t xy = vget_low_f32( v );
+            const float32x2_t zw = vget_high_f32( v );
+
+            // Lane forms of ARMv7, AArch64 accepts them too
+            float32x4_t sum = vmulq_lane_f32( c0, xy, 0 );
+            sum             = vmlaq_lane_f32( sum, c1, xy, 1 );
+            sum             = vmlaq_lane_f32( sum, c2, zw, 0 );
+            sum             = vmlaq_lane_f32( sum, c3, zw, 1 );
+            vst1q_f32( &dst[i].x, sum );
+        }
+#else
+    for( int i = 0; i < count; ++i ) dst[i] = Vector4Transform( src[i], mat );
+#endif
+}
+
+#endif // !LEMATH_H
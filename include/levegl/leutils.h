@@ -6,6 +6,12 @@
  * INFO:
  * - DEFINES:
  *   - LOG_SUPPORT: Enable Logging system
+ *   - PROFILE_SUPPORT: Enable CPU instrumentation zones
+ *   - LE_LOG_QUEUE_SIZE: Records held by the asynchronous log queue, full queues drop
+ *   - LOG_MIN_LEVEL: TRACELOG calls below this level compile to nothing (LOG_ALL)
+ *   - LOG_BINARY: TRACELOG writes binary records to a file, see ledecode
+ *   - LE_MALLOC, LE_CALLOC, LE_REALLOC, LE_FREE: Allocation used by the modules,
+ *     MemAlloc and friends unless defined before including this header
  *
  *                               LICENSE
  * ------------------------------------------------------------------------
@@ -34,11 +40,23 @@
 //----------------------------------------------------------------------------------------------------------------------
 // Logging Macros
 //----------------------------------------------------------------------------------------------------------------------
+// Compile-time threshold, the comparison is constant so filtered calls and their arguments are dropped
+#ifndef LOG_MIN_LEVEL
+#    define LOG_MIN_LEVEL LOG_ALL
+#endif
+
 #if defined( LOG_SUPPORT )
-#    define TRACELOG( level, ... ) TraceLog( level, __VA_ARGS__ )
+#    if defined( LOG_BINARY )
+#        define LE_TRACELOG_SINK TraceLogBinary
+#    else
+#        define LE_TRACELOG_SINK TraceLog
+#    endif
+
+#    define TRACELOG( level, ... ) \
+        ( ( ( level ) >= LOG_MIN_LEVEL ) ? LE_TRACELOG_SINK( level, __VA_ARGS__ ) : (void)( 0 ) )
 
 #    if defined( LOG_SUPPORT_DEBUG )
-#        define TRACELOGD( ... ) TraceLog( LOG_DEBUG, __VA_ARGS__ )
+#        define TRACELOGD( ... ) TRACELOG( LOG_DEBUG, __VA_ARGS__ )
 #    else
 #        define TRACELOGD( ... ) ( (void)0 )
 #    endif
@@ -47,4 +65,70 @@
 #    define TRACELOGD( ... )       ( (void)( 0 ) )
 #endif // LOG_SUPPORT
 
+//----------------------------------------------------------------------------------------------------------------------
+// Memory Macros
+//----------------------------------------------------------------------------------------------------------------------
+// Modules never call the C allocator directly, SetMemoryCallbacks replaces it at startup
+#ifndef LE_MALLOC
+#    define LE_MALLOC( size ) MemAlloc( size )
+#endif
+#ifndef LE_CALLOC
+#    define LE_CALLOC( count, size ) leCalloc( count, size )
+#endif
+#ifndef LE_REALLOC
+#    define LE_REALLOC( ptr, size ) MemRealloc( ptr, size )
+#endif
+#ifndef LE_FREE
+#    define LE_FREE( ptr ) MemFree( ptr )
+#endif
+
+#include "levegl/levegl.h"
+
+#include <string.h> /* memset */
+
+// Zeroed allocation through LE_MALLOC
+static inline void *
+leCalloc( size_t count, size_t size )
+{
+    if( 0 != size && count > (size_t)-1 / size ) return NULL;
+
+    void * ptr = LE_MALLOC( count * size );
+    if( NULL != ptr ) memset( ptr, 0, count * size );
+
+    return ptr;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Profiling Macros
+//----------------------------------------------------------------------------------------------------------------------
+// LE_PROFILE_ZONE closes itself at the end of the enclosing scope (GCC/Clang only),
+// LE_PROFILE_BEGIN/LE_PROFILE_END pairs work on every compiler
+#if defined( PROFILE_SUPPORT )
+#    include "levegl/levegl.h"
+
+#    define LE_PROFILE_BEGIN( name ) ( (void)ProfileZoneBegin( name ) )
+#    define LE_PROFILE_END()         ProfileZoneEnd()
+
+#    if defined( __GNUC__ ) || defined( __clang__ )
+static inline void
+leProfileZoneLeave( int * zone )
+{
+    (void)zone;
+    ProfileZoneEnd();
+}
+
+#        define LE_PROFILE_CONCAT_( a, b ) a##b
+#        define LE_PROFILE_CONCAT( a, b )  LE_PROFILE_CONCAT_( a, b )
+#        define LE_PROFILE_ZONE( name )                                                                              \
+            int LE_PROFILE_CONCAT( leProfileZone, __LINE__ ) __attribute__( ( cleanup( leProfileZoneLeave ), unused ) ) \
+                = ProfileZoneBegin( name )
+#    else
+#        define LE_PROFILE_ZONE( name ) ( (void)0 )
+#    endif
+#else  // !PROFILE_SUPPORT
+#    define LE_PROFILE_BEGIN( name ) ( (void)( 0 ) )
+#    define LE_PROFILE_END()         ( (void)( 0 ) )
+#    define LE_PROFILE_ZONE( name )  ( (void)( 0 ) )
+#endif // PROFILE_SUPPORT
+
 #endif // !LEUTILS_H
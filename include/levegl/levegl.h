@@ -59,6 +59,7 @@
 #include "levegl/leversion.h"
 
 #include <stdarg.h> /* va_list */
+#include <stddef.h> /* size_t */
 
 //==============================================================================================================
 // DEFINES
@@ -148,7 +149,7 @@ typedef enum bool
 #define DARKGREY  DARKGRAY
 #define LIGHTGREY LIGHTGRAY
 
-// TODO: Design and implement lemath.h
+// Math, see lemath.h for vector and matrix functions
 #ifndef PI
 #    define PI 3.14159265358979323846F
 #endif
@@ -180,6 +181,11 @@ typedef enum bool
 
 #define UNUSED( x )         (void)( x )
 
+// Shaders
+#ifndef LE_MAX_SHADER_LOCATIONS
+#    define LE_MAX_SHADER_LOCATIONS 32
+#endif
+
 //==============================================================================================================
 // STRUCTS
 //==============================================================================================================
@@ -202,26 +208,222 @@ typedef struct Transform
     float scale;
 } Transform;
 
+// Vector2, shared with lemath.h
+#ifndef LE_VECTOR2_TYPE
+typedef struct Vector2
+{
+    float x;
+    float y;
+} Vector2;
+#    define LE_VECTOR2_TYPE
+#endif
+
+// Vector4, shared with lemath.h
+#ifndef LE_VECTOR4_TYPE
+typedef struct Vector4
+{
+    float x;
+    float y;
+    float z;
+    float w;
+} Vector4;
+#    define LE_VECTOR4_TYPE
+#endif
+
+// Matrix, column-major 4x4 as uploaded to GL, shared with lemath.h
+#ifndef LE_MATRIX_TYPE
+typedef struct Matrix
+{
+    float m0, m1, m2, m3;     // First column
+    float m4, m5, m6, m7;     // Second column
+    float m8, m9, m10, m11;   // Third column
+    float m12, m13, m14, m15; // Fourth column, translation
+} Matrix;
+#    define LE_MATRIX_TYPE
+#endif
+
+// Matrix2D, 3x2 affine transform of 2D points, shared with lemath.h
+#ifndef LE_MATRIX2D_TYPE
+typedef struct Matrix2D
+{
+    float m0, m1; // X axis
+    float m2, m3; // Y axis
+    float m4, m5; // Translation
+} Matrix2D;
+#    define LE_MATRIX2D_TYPE
+#endif
+
+// Rectangle
+typedef struct Rectangle
+{
+    float x;
+    float y;
+    float width;
+    float height;
+} Rectangle;
+
+// Camera2D, world space seen through the screen
+typedef struct Camera2D
+{
+    Vector2 offset;   // Screen position the target appears at
+    Vector2 target;   // World position the camera looks at
+    float   rotation; // Rotation in degrees
+    float   zoom;     // Scale, 1.0 shows world units as pixels
+} Camera2D;
+
+// Context, a window or surface with its own GL context, batches and timing
+typedef struct LeContext LeContext;
+
+// Scene, retained shapes indexed by a spatial grid
+typedef struct Scene Scene;
+
+// Image, CPU pixels in RGBA with 8 bits per channel
+typedef struct Image
+{
+    void * data; // width * height * 4 bytes, rows from the top
+    int    width;
+    int    height;
+} Image;
+
+// Texture, GPU image owned by the context it was loaded in
+typedef struct Texture
+{
+    unsigned int id;
+    int          width;
+    int          height;
+    int          layer; // Layer of a texture array, the pages of an atlas share one texture where supported
+} Texture;
+
+// Texture load decoding in the background, see LoadTextureAsync
+typedef struct TextureLoad TextureLoad;
+
+// Texture atlas, small images packed into a few large pages
+typedef struct TextureAtlas TextureAtlas;
+
+// Atlas sprite, where an image landed in an atlas
+typedef struct AtlasSprite
+{
+    Texture   texture; // Page holding the image
+    Rectangle source;  // Pixels of the image inside the page
+} AtlasSprite;
+
+// Font, TrueType outlines rasterized into an atlas as strings need them
+typedef struct Font Font;
+
+// Particle system, simulated by compute shaders with GL 4.3 and by worker threads elsewhere
+typedef struct ParticleSystem ParticleSystem;
+
+// Particle emitter, how EmitParticles spawns. Ranges are half extents of uniform random offsets
+typedef struct ParticleEmitter
+{
+    Vector2 position;      // Spawn point
+    Vector2 positionRange; // Offset around the spawn point
+    Vector2 velocity;      // Pixels per second
+    Vector2 velocityRange; // Offset added to the velocity
+    Vector2 acceleration;  // Pixels per second squared, gravity
+    float   lifetime;      // Seconds
+    float   lifetimeRange; // Offset added to the lifetime
+    float   startSize;     // Diameter in pixels when spawned
+    float   endSize;       // Diameter at the end of the lifetime
+    Color   startColor;
+    Color   endColor;      // Reached at the end of the lifetime
+} ParticleEmitter;
+
 // Shader
 typedef struct Shader
 {
-    unsigned int * locations;
-    unsigned int   id;
-    int            locCount;
-    bool           active;
+    int *        locations; // Shader locations array, -1 when not present (LE_MAX_SHADER_LOCATIONS)
+    unsigned int id;
+    int          locCount;
+    bool         active;
 } Shader;
 
+// Memory usage, current and high-water bytes
+typedef struct MemoryUsage
+{
+    size_t bytes;
+    size_t peakBytes;
+} MemoryUsage;
+
+// Memory stats, process wide
+typedef struct MemoryStats
+{
+    MemoryUsage vertexStaging;    // CPU vertices recorded for upload
+    MemoryUsage commandBuffers;   // CPU commands, segments, record streams and frame arenas
+    MemoryUsage fileData;         // CPU file contents being loaded
+    MemoryUsage shaders;          // CPU shader state
+    MemoryUsage scenes;           // CPU retained scene items and grid cells
+    MemoryUsage images;           // CPU decoded pixels, images and pending texture uploads
+    MemoryUsage fonts;            // CPU font files, glyph tables and shaped strings
+    MemoryUsage polygons;         // CPU cached polygon triangulations
+    MemoryUsage particles;        // CPU particles of systems simulated without compute shaders
+    MemoryUsage gpuBuffers;       // GPU vertex and index buffers
+    MemoryUsage gpuTextures;      // GPU textures
+    MemoryUsage gpuRenderTargets; // GPU framebuffer attachments
+} MemoryStats;
+
 //===========================================================================================================
 // ENUMERATORS
 //===========================================================================================================
 typedef enum
 {
-    FLAG_NONE             = 0,
-    FLAG_VSYNC_HINT       = 1 << 0, // 0x01: Enable vertical sync
-    FLAG_WINDOW_RESIZABLE = 1 << 1, // 0x02: Allow window resizing
-    FLAG_MSAA_HINT        = 1 << 2  // 0x04: Enable MSAA (Multi-Sample Anti-Aliasing)
+    FLAG_NONE               = 0,
+    FLAG_VSYNC_HINT         = 1 << 0, // 0x01: Enable vertical sync
+    FLAG_WINDOW_RESIZABLE   = 1 << 1, // 0x02: Allow window resizing
+    FLAG_MSAA_HINT          = 1 << 2, // 0x04: Enable MSAA (Multi-Sample Anti-Aliasing)
+    FLAG_THREADED_RENDERER  = 1 << 3, // 0x08: Execute and present frames on a dedicated render thread
+    FLAG_LOW_LATENCY        = 1 << 4, // 0x10: Wait for the GPU to finish each frame before polling input
+    FLAG_WINDOW_HIDDEN      = 1 << 5, // 0x20: Create the window hidden, for offscreen and headless surfaces
+    FLAG_PARTIAL_REDRAW     = 1 << 6, // 0x40: Only redraw damaged areas, frames without damage are not presented
+    FLAG_EVENT_DRIVEN       = 1 << 7, // 0x80: BeginDrawing sleeps until events or RequestRedraw, drops repeated frames
+    FLAG_DYNAMIC_RESOLUTION = 1 << 8, // 0x100: Lower the drawing resolution while the GPU misses the frame time
+    FLAG_LAYERED_DEPTH      = 1 << 9  // 0x200: Draw opaque shapes front to back with depth testing, then the rest
 } ConfigFlags;
 
+// Shader location index
+typedef enum
+{
+    SHADER_LOC_MATRIX_MVP = 0 // Model-view-projection matrix uniform
+} ShaderLocationIndex;
+
+// Shader uniform data type
+typedef enum
+{
+    SHADER_UNIFORM_FLOAT = 0, // float
+    SHADER_UNIFORM_VEC2,      // vec2 (2 float)
+    SHADER_UNIFORM_VEC3,      // vec3 (3 float)
+    SHADER_UNIFORM_VEC4,      // vec4 (4 float)
+    SHADER_UNIFORM_INT,       // int
+    SHADER_UNIFORM_IVEC2,     // ivec2 (2 int)
+    SHADER_UNIFORM_IVEC3,     // ivec3 (3 int)
+    SHADER_UNIFORM_IVEC4,     // ivec4 (4 int)
+    SHADER_UNIFORM_SAMPLER2D  // sampler2d
+} ShaderUniformDataType;
+
+// Corners between the segments of a stroked path
+typedef enum
+{
+    LINE_JOIN_MITER = 0, // Extended to a point, beveled past the miter limit
+    LINE_JOIN_BEVEL,     // Cut straight across
+    LINE_JOIN_ROUND      // Rounded by an arc
+} LineJoin;
+
+// Scene item shapes, drawn inside the item bounds
+typedef enum
+{
+    SCENE_RECTANGLE = 0,   // DrawRectangle of the bounds
+    SCENE_RECTANGLE_LINES, // DrawRectangleLines of the bounds
+    SCENE_CIRCLE,          // DrawCircle inscribed in the bounds
+    SCENE_CIRCLE_LINES     // DrawCircleLines inscribed in the bounds
+} SceneShape;
+
+// Font glyph rasterization
+typedef enum
+{
+    FONT_DEFAULT = 0, // Coverage, rasterized again for every pixel size drawn
+    FONT_SDF          // Signed distance field, rasterized once and scaled to any size
+} FontType;
+
 // Log levels
 typedef enum
 {
@@ -240,6 +442,10 @@ typedef enum
 //===========================================================================================================
 typedef void ( *TraceLogCallback )( int logLevel, const char * text, va_list args ); // Custom trace log
 
+typedef void * ( *MemAllocCallback )( size_t size );               // Custom allocation, malloc semantics
+typedef void * ( *MemReallocCallback )( void * ptr, size_t size ); // Custom reallocation, realloc semantics
+typedef void ( *MemFreeCallback )( void * ptr );                   // Custom release, free semantics
+
 //===========================================================================================================
 // FUNCTIONS DECLARATIONS
 //===========================================================================================================
@@ -255,6 +461,12 @@ LEAPI void   SetWindowTitle( const char * title );
 LEAPI bool   ShouldQuit( void );
 LEAPI void * GetWindowHandle( void );
 
+// Context functions, every other function acts on the context current on the calling thread
+LEAPI LeContext * CreateContext( int width, int height, const char * title, unsigned int flags );
+LEAPI void        DestroyContext( LeContext * context );
+LEAPI void        MakeContextCurrent( LeContext * context ); // NULL falls back to the InitWindow context
+LEAPI LeContext * GetCurrentContext( void );
+
 // Timing functions
 LEAPI void   SetTargetFPS( int fps );
 LEAPI float  GetFrameTime( void );
@@ -262,11 +474,37 @@ LEAPI double GetTime( void );
 LEAPI int    GetFPS( void );
 LEAPI void   SwapBuffers( void );
 LEAPI void   WaitTime( double seconds );
+LEAPI void   SetMaxFramesInFlight( int frames ); // Limit frames queued ahead of the GPU, 0 leaves it to the driver
+LEAPI float  GetResolutionScale( void );         // Fraction of the window size frames are drawn at
+LEAPI void   RequestRedraw( void );              // Wake a FLAG_EVENT_DRIVEN BeginDrawing, from any thread
+LEAPI void   RequestRedrawIn( double seconds );  // Draw a FLAG_EVENT_DRIVEN frame once `seconds` elapsed, any thread
 
 // Drawing functions
 LEAPI void ClearBackground( Color color );
 LEAPI void BeginDrawing( void );
-LEAPI void EndDrawing( void );
+LEAPI void EndDrawing( void );       // Other threads drawing into the frame must be done before it is called
+LEAPI void SetDrawLayer( int layer ); // Merge order of the calling thread's next draws, lower layers first
+LEAPI void AddDamageArea( Rectangle area ); // Screen area to redraw this frame (FLAG_PARTIAL_REDRAW)
+
+// Camera, per thread like the transform stack, culls shapes outside its view
+LEAPI void     BeginMode2D( Camera2D camera );       // Draw the next shapes through the camera, on the GPU
+LEAPI void     EndMode2D( void );                    // Back to screen space
+LEAPI Matrix2D GetCameraMatrix2D( Camera2D camera ); // World to screen transform of a camera
+
+// Clip areas, per thread and nested, each one inside the previous
+LEAPI void BeginScissorMode( int x, int y, int width, int height ); // Clip the next draws to a screen rectangle
+LEAPI void EndScissorMode( void );                                 // Restore the previous clip area
+LEAPI void BeginScissorShape( void ); // Next draws mark a clip shape instead of showing (stencil)
+LEAPI void EndScissorShape( void );   // Clip the next draws to the marked shape, until EndScissorMode
+
+// Transform stack, per thread and reset every frame
+LEAPI void     PushMatrix( void );            // Save the current transform
+LEAPI void     PopMatrix( void );             // Restore the last saved transform
+LEAPI void     Translate( float x, float y ); // Move the next draws by (x, y)
+LEAPI void     Rotate( float degrees );       // Rotate the next draws around the current origin
+LEAPI void     Scale( float x, float y );     // Scale the next draws from the current origin
+LEAPI void     SetMatrix( Matrix2D matrix );  // Replace the current transform
+LEAPI Matrix2D GetMatrix( void );             // Current transform of the calling thread
 
 // Shader functions
 LEAPI Shader LoadShader( const char * vsFileName, const char * fsFileName );
@@ -279,11 +517,28 @@ LEAPI void   SetShaderValue( Shader shader, int locIndex, const void * value, in
 LEAPI void   SetShaderValueV( Shader shader, int locIndex, const void * value, int uniformType, int count );
 
 // Miscellaneous core functions
-LEAPI void SetTraceLogCallback( TraceLogCallback callback ); // Set custom trace log
-LEAPI void TraceLog( int logLevel, const char * text, ... ); // Display a log message
+LEAPI void SetTraceLogCallback( TraceLogCallback callback );       // Set custom trace log
+LEAPI void SetTraceLogAsync( bool enabled );                       // Queue messages for a background writer thread
+LEAPI void SetTraceLogBinaryFile( const char * fileName );         // Set the LOG_BINARY output file
+LEAPI void TraceLog( int logLevel, const char * text, ... );       // Display a log message
+LEAPI void TraceLogBinary( int logLevel, const char * text, ... ); // Write a binary log record, see ledecode
 
 LEAPI void SetConfigFlags( unsigned int flags );
 
+// Memory functions, every allocation made by the library goes through them. Callbacks are set before InitWindow
+LEAPI void   SetMemoryCallbacks( MemAllocCallback alloc, MemReallocCallback resize, MemFreeCallback release );
+LEAPI void * MemAlloc( size_t size );               // Allocate through the current callbacks
+LEAPI void * MemRealloc( void * ptr, size_t size ); // Reallocate through the current callbacks
+LEAPI void   MemFree( void * ptr );                 // Release through the current callbacks
+
+LEAPI MemoryStats GetMemoryStats( void ); // Bytes held by the library on the CPU and the GPU, with peaks
+
+// Profiling functions, no-op unless built with PROFILE_SUPPORT
+LEAPI int  ProfileZoneBegin( const char * name );        // Open a named CPU zone on the calling thread
+LEAPI void ProfileZoneEnd( void );                       // Close the innermost zone of the calling thread
+LEAPI void SetProfileTraceFile( const char * fileName ); // Set the trace written at CloseWindow (NULL disables)
+LEAPI bool SaveProfileTrace( const char * fileName );    // Dump recorded zones as Chrome trace-event JSON
+
 //---------------------------------------------------------------------------------------------- CORE ---//
 
 //--- SHAPES ------------------------------------------------------------------------------------------------
@@ -298,8 +553,87 @@ LEAPI void DrawRectangleLines( float x, float y, float width, float height, Colo
 LEAPI void DrawCircle( float centerX, float centerY, float radius, Color color );
 LEAPI void DrawCircleLines( float centerX, float centerY, float radius, Color color );
 
+// Thick outlines, anti-aliased and batched as instanced segments where available. Corners are mitered
+LEAPI void DrawLineEx( Vector2 start, Vector2 end, float thickness, Color color );
+LEAPI void DrawTriangleLinesEx( float x1, float y1, float x2, float y2, float x3, float y3, float thickness,
+                                Color color );
+LEAPI void DrawRectangleLinesEx( float x, float y, float width, float height, float thickness, Color color );
+LEAPI void DrawCircleLinesEx( float centerX, float centerY, float radius, float thickness, Color color );
+
+// Polygons and curves. Concave polygons are triangulated once and cached by the content of their points
+LEAPI void DrawPolygon( const Vector2 * points, int pointCount, Color color ); // Filled, any simple outline
+LEAPI void DrawPolygonLines( const Vector2 * points, int pointCount, float thickness, int join, Color color );
+LEAPI void DrawPolyline( const Vector2 * points, int pointCount, float thickness, int join, Color color ); // LineJoin
+LEAPI void DrawBezier( Vector2 start, Vector2 control1, Vector2 control2, Vector2 end, float thickness, Color color );
+LEAPI int  FlattenBezier( Vector2 start, Vector2 control1, Vector2 control2, Vector2 end, Vector2 * points,
+                          int maxPoints ); // Points after `start`, to build DrawPolygon outlines
+
+// Retained scenes, only the items overlapping the view are drawn
+LEAPI Scene * CreateScene( float cellSize ); // Grid cell size in world units, about the size of a typical item
+LEAPI void    DestroyScene( Scene * scene );
+LEAPI int     AddSceneItem( Scene * scene, int shape, Rectangle bounds, Color color ); // Item ID, -1 on failure
+LEAPI void    MoveSceneItem( Scene * scene, int id, Rectangle bounds );
+LEAPI void    SetSceneItemColor( Scene * scene, int id, Color color );
+LEAPI void    RemoveSceneItem( Scene * scene, int id );
+LEAPI int     QueryScene( Scene * scene, Rectangle area, int * ids, int maxIds ); // Items overlapping `area`
+LEAPI int     DrawScene( Scene * scene ); // Draw the items in view of the camera, returns how many
+
 //-------------------------------------------------------------------------------------------- SHAPES ---//
 
+//--- TEXTURES ----------------------------------------------------------------------------------------------
+
+// Image loading, QOI and binary PNM (P5, P6) files
+LEAPI Image LoadImage( const char * fileName );
+LEAPI Image LoadImageFromMemory( const unsigned char * data, int size ); // Format detected from the content
+LEAPI void  UnloadImage( Image image );
+
+// Texture loading
+LEAPI Texture       LoadTexture( const char * fileName );
+LEAPI Texture       LoadTextureFromImage( Image image );
+LEAPI void          UnloadTexture( Texture texture );
+LEAPI TextureLoad * LoadTextureAsync( const char * fileName ); // Decoded by workers, uploaded between frames
+LEAPI bool PollTextureLoad( TextureLoad * load, Texture * texture ); // True once done (id 0 on failure), frees `load`
+
+// Texture atlases, images are packed as they are added
+LEAPI TextureAtlas * CreateTextureAtlas( int pageSize ); // Width and height of every page in pixels
+LEAPI void           DestroyTextureAtlas( TextureAtlas * atlas );
+LEAPI bool           AddAtlasImage( TextureAtlas * atlas, Image image, AtlasSprite * sprite ); // Copies the pixels
+LEAPI int            GetAtlasPageCount( const TextureAtlas * atlas );
+
+// Texture drawing, batched with the shapes. A negative source width or height flips the image
+LEAPI void DrawTexture( Texture texture, int posX, int posY, Color tint );
+LEAPI void DrawTextureRec( Texture texture, Rectangle source, Vector2 position, Color tint );
+LEAPI void DrawTexturePro( Texture texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation,
+                           Color tint ); // Rotated in degrees around `origin`, relative to `dest`
+
+//------------------------------------------------------------------------------------------ TEXTURES ---//
+
+//--- TEXT --------------------------------------------------------------------------------------------------
+
+// Font loading, TrueType files with quadratic outlines
+LEAPI Font * LoadFont( const char * fileName, int type );                         // FontType
+LEAPI Font * LoadFontFromMemory( const unsigned char * data, int size, int type ); // Copies the data
+LEAPI void   UnloadFont( Font * font );
+
+// Text drawing, batched with the shapes. Strings are shaped and their glyphs rasterized once
+LEAPI void    DrawText( Font * font, const char * text, float posX, float posY, float fontSize,
+                        Color color ); // Top-left at (posX, posY), lines split at '\n'
+LEAPI Vector2 MeasureText( Font * font, const char * text, float fontSize );
+
+//---------------------------------------------------------------------------------------------- TEXT ---//
+
+//--- PARTICLES ---------------------------------------------------------------------------------------------
+
+// Particle systems, owned by the context they were loaded in. Emissions wait for the next update
+LEAPI ParticleSystem * LoadParticleSystem( int maxParticles ); // Emissions past `maxParticles` are dropped
+LEAPI void             UnloadParticleSystem( ParticleSystem * system );
+LEAPI void             EmitParticles( ParticleSystem * system, ParticleEmitter emitter, int count );
+LEAPI void             UpdateParticleSystem( ParticleSystem * system, float deltaTime ); // Age, move and spawn
+LEAPI void             DrawParticleSystem( ParticleSystem * system ); // Round sprites, in the current transform
+LEAPI int GetParticleCount( ParticleSystem * system ); // Alive particles, read back from the GPU of the last frame
+
+//----------------------------------------------------------------------------------------- PARTICLES ---//
+
 CXX_GUARD_END
 
 #endif // LEVEGL_H
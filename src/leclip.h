@@ -0,0 +1,242 @@
+/******************************** LECLIP ***********************************
+ * leclip: Cutting batched primitives to an axis aligned clip box, and
+ *         the boxes shapes are culled against
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ *   - Lines are shortened (Liang-Barsky), triangles and quads are cut
+ *     edge by edge (Sutherland-Hodgman) and split back into their kind.
+ *   - Corners made on a border interpolate position, color and texture
+ *     coordinates, the layer of the primitive is kept.
+ *   - Primitives missing the box produce nothing.
+ *   - Culling boxes are conservative: the box of a moved box, the camera
+ *     view padded by a screen pixel. Nothing reaching the screen is
+ *     culled, rotated views keep some shapes that do not.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+#ifndef LEVEGL_CLIP_H
+#define LEVEGL_CLIP_H
+
+#include "lerender.h"
+
+#include "levegl/lemath.h"
+
+#include <math.h> /* fabsf, fminf, fmaxf */
+#include <stdbool.h>
+
+//==============================================================================================================
+// DEFINES
+//==============================================================================================================
+// Vertices written by ClipPrimitive at most: a triangle cut by every border is a fan of five
+#define CLIP_MAX_VERTICES 15
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+typedef struct ClipBox
+{
+    float minX;
+    float minY;
+    float maxX;
+    float maxY;
+} ClipBox;
+
+//==============================================================================================================
+// FUNCTIONS
+//==============================================================================================================
+static RenderVertex
+LerpVertex( const RenderVertex * a, const RenderVertex * b, float t )
+{
+    RenderVertex vertex;
+    vertex.x     = a->x + ( b->x - a->x ) * t;
+    vertex.y     = a->y + ( b->y - a->y ) * t;
+    vertex.u     = a->u + ( b->u - a->u ) * t;
+    vertex.v     = a->v + ( b->v - a->v ) * t;
+    vertex.layer = a->layer;
+    vertex.r     = (unsigned char)( (float)a->r + ( (float)b->r - (float)a->r ) * t + 0.5F );
+    vertex.g     = (unsigned char)( (float)a->g + ( (float)b->g - (float)a->g ) * t + 0.5F );
+    vertex.b     = (unsigned char)( (float)a->b + ( (float)b->b - (float)a->b ) * t + 0.5F );
+    vertex.a     = (unsigned char)( (float)a->a + ( (float)b->a - (float)a->a ) * t + 0.5F );
+    return vertex;
+}
+
+// Keep the part of a convex polygon where `sign * (coordinate - limit) >= 0` (Sutherland-Hodgman)
+static int
+ClipPolygonEdge( const RenderVertex * in, int count, RenderVertex * out, bool vertical, float limit, float sign )
+{
+    int written = 0;
+    for( int i = 0; i < count; ++i )
+        {
+            const RenderVertex * a  = &in[i];
+            const RenderVertex * b  = &in[( i + 1 ) % count];
+            const float          da = sign * ( ( vertical ? a->y : a->x ) - limit );
+            const float          db = sign * ( ( vertical ? b->y : b->x ) - limit );
+
+            if( da >= 0.0F ) out[written++] = *a;
+            if( ( da >= 0.0F ) != ( db >= 0.0F ) ) out[written++] = LerpVertex( a, b, da / ( da - db ) );
+        }
+
+    return written;
+}
+
+// Cut a line (2 corners), triangle (3) or quad (4) to `box`. Writes up to CLIP_MAX_VERTICES to `out` and returns
+// how many: the primitive itself when inside, crossing triangles as a fan, crossing quads as fan triangles paired
+// into quads
+static int
+ClipPrimitive( const RenderVertex * in, int perPrimitive, ClipBox box, RenderVertex * out )
+{
+    if( 2 == perPrimitive )
+        {
+            // Liang-Barsky, the segment runs from t0 to t1 inside the box
+            const float dx = in[1].x - in[0].x, dy = in[1].y - in[0].y;
+            const float p[4] = { -dx, dx, -dy, dy };
+            const float q[4] = { in[0].x - box.minX, box.maxX - in[0].x, in[0].y - box.minY, box.maxY - in[0].y };
+
+            float t0 = 0.0F, t1 = 1.0F;
+            bool  visible = true;
+            for( int k = 0; k < 4 && visible; ++k )
+                {
+                    if( 0.0F == p[k] )
+                        {
+                            visible = q[k] >= 0.0F;
+                            continue;
+                        }
+
+                    const float t = q[k] / p[k];
+                    if( p[k] < 0.0F ) t0 = fmaxf( t0, t );
+                    else t1 = fminf( t1, t );
+                    visible = t0 < t1;
+                }
+            if( !visible ) return 0;
+
+            out[0] = LerpVertex( &in[0], &in[1], t0 );
+            out[1] = LerpVertex( &in[0], &in[1], t1 );
+            return 2;
+        }
+
+    bool inside = true;
+    for( int k = 0; k < perPrimitive; ++k )
+        {
+            inside = inside && in[k].x >= box.minX && in[k].x <= box.maxX && in[k].y >= box.minY
+                  && in[k].y <= box.maxY;
+        }
+    if( inside )
+        {
+            for( int k = 0; k < perPrimitive; ++k ) out[k] = in[k];
+            return perPrimitive;
+        }
+
+    // Every border adds at most one corner
+    RenderVertex polygon[8];
+    RenderVertex clipped[8];
+    int          corners = ClipPolygonEdge( in, perPrimitive, clipped, false, box.minX, 1.0F );
+    corners              = ClipPolygonEdge( clipped, corners, polygon, false, box.maxX, -1.0F );
+    corners              = ClipPolygonEdge( polygon, corners, clipped, true, box.minY, 1.0F );
+    corners              = ClipPolygonEdge( clipped, corners, polygon, true, box.maxY, -1.0F );
+
+    // Corners on a border come out twice, a primitive only touching the box would leave empty triangles
+    int kept = 0;
+    for( int k = 0; k < corners; ++k )
+        {
+            if( kept > 0 && polygon[k].x == polygon[kept - 1].x && polygon[k].y == polygon[kept - 1].y ) continue;
+            polygon[kept++] = polygon[k];
+        }
+    while( kept > 1 && polygon[kept - 1].x == polygon[0].x && polygon[kept - 1].y == polygon[0].y ) --kept;
+    corners = kept;
+
+    int written = 0;
+    if( 4 == perPrimitive )
+        {
+            // Two triangles of the fan per quad, an odd last one repeats its final corner
+            for( int k = 1; k + 1 < corners; k += 2 )
+                {
+                    out[written++] = polygon[0];
+                    out[written++] = polygon[k];
+                    out[written++] = polygon[k + 1];
+                    out[written++] = polygon[( k + 2 < corners ) ? k + 2 : k + 1];
+                }
+            return written;
+        }
+
+    for( int k = 1; k + 1 < corners; ++k )
+        {
+            out[written++] = polygon[0];
+            out[written++] = polygon[k];
+            out[written++] = polygon[k + 1];
+        }
+    return written;
+}
+
+// Box around `box` moved by `m`, from its center and the absolute axes of `m`
+static INLINE ClipBox
+TransformClipBox( ClipBox box, Matrix2D m )
+{
+    const float   extentX = ( box.maxX - box.minX ) * 0.5F;
+    const float   extentY = ( box.maxY - box.minY ) * 0.5F;
+    const Vector2 center  = Vector2Transform2D( ( Vector2 ){ box.minX + extentX, box.minY + extentY }, m );
+    const float   x       = fabsf( m.m0 ) * extentX + fabsf( m.m2 ) * extentY;
+    const float   y       = fabsf( m.m1 ) * extentX + fabsf( m.m3 ) * extentY;
+
+    return ( ClipBox ){ center.x - x, center.y - y, center.x + x, center.y + y };
+}
+
+// Boxes sharing a border overlap
+static INLINE bool
+IsClipBoxOverlapping( ClipBox a, ClipBox b )
+{
+    return a.maxX >= b.minX && a.minX <= b.maxX && a.maxY >= b.minY && a.minY <= b.maxY;
+}
+
+// World area seen through the camera transform `view` on a screen of `width` x `height` pixels, rotation makes
+// it wider than the screen. Lines and outlines are a screen pixel wide, the area is padded by one so the ones
+// touching the border are kept
+static ClipBox
+GetCameraBounds( Matrix2D view, float zoom, float width, float height )
+{
+    const Matrix2D inverse    = Matrix2DInvert( view );
+    const Vector2  corners[4] = {
+        Vector2Transform2D( ( Vector2 ){ 0.0F, 0.0F }, inverse ),
+        Vector2Transform2D( ( Vector2 ){ width, 0.0F }, inverse ),
+        Vector2Transform2D( ( Vector2 ){ 0.0F, height }, inverse ),
+        Vector2Transform2D( ( Vector2 ){ width, height }, inverse ),
+    };
+
+    ClipBox bounds = { corners[0].x, corners[0].y, corners[0].x, corners[0].y };
+    for( int i = 1; i < 4; ++i )
+        {
+            bounds.minX = fminf( bounds.minX, corners[i].x );
+            bounds.minY = fminf( bounds.minY, corners[i].y );
+            bounds.maxX = fmaxf( bounds.maxX, corners[i].x );
+            bounds.maxY = fmaxf( bounds.maxY, corners[i].y );
+        }
+
+    const float padding = ( 0.0F != zoom ) ? 1.0F / fabsf( zoom ) : 0.0F;
+    bounds.minX -= padding;
+    bounds.minY -= padding;
+    bounds.maxX += padding;
+    bounds.maxY += padding;
+    return bounds;
+}
+
+#endif // !LEVEGL_CLIP_H
@@ -40,31 +40,49 @@
 // INCLUDES
 //==============================================================================================================
 #include "lecore_context.h"
+#include "lememory.h"
+#include "lerender.h"
+#include "lesystem.h"
 
 #include "levegl/leutils.h"
 #include "levegl/levegl.h"
 
+// GL objects are accounted per context, names are only unique inside one
+#define LE_TRACK_GPU_MEMORY( kind, id, bytes ) TrackGpuMemory( GetCurrentContext(), kind, id, bytes )
+
 #define LEGL_IMPLEMENTATION
 #include "levegl/legl.h"
 #undef LEGL_IMPLEMENTATION
 
 #include <math.h>
-#include <string.h>
+#include <stdlib.h>
 
 //==============================================================================================================
 // GLOBALS
 //==============================================================================================================
-CoreContext core = { 0 };
+static LE_THREAD_LOCAL LeContext * currentContext = NULL; // Bound with MakeContextCurrent
+static LeContext *                 windowContext  = NULL; // Created by InitWindow, used when nothing is bound
+static unsigned int                windowFlags    = 0;    // SetConfigFlags calls made before InitWindow
+static int                         contextCount   = 0;    // Live contexts, only changed on the platform thread
 
 //==============================================================================================================
 // MODULE FUNCTIONS DECLARATIONS
 //==============================================================================================================
 extern int  InitPlatform();
 extern void ClosePlatform( void );
+extern bool IsPlatformThread( void );
+extern void PollInputEvents( void );
+extern void WaitInputEvents( double timeout );
+extern void PostEmptyEvent( void );
+extern void AcquirePlatformContext( void );
+extern void ReleasePlatformContext( void );
 
 extern void InitShapes( void );
 extern void CleanupShapes( void );
 
+extern void CloseProfiler( void );
+extern void CloseTraceLog( void );
+
 //==============================================================================================================
 // MODULE FUNCTIONS DEFINITONS
 //==============================================================================================================
@@ -73,87 +91,307 @@ InitWindow( int width, int height, const char * title )
 {
     TRACELOG( LOG_INFO, "Initializing LeveGL - %s", LEVEGL_VERSION );
 
-    core.window.screen.height = height;
-    core.window.screen.width  = width;
+    windowContext = CreateContext( width, height, title, windowFlags );
+}
+
+void
+CloseWindow()
+{
+    DestroyContext( windowContext );
+    windowContext = NULL;
+    windowFlags   = 0;
+
+    TRACELOG( LOG_INFO, "Window closed" );
+
+    // Threads of the remaining contexts may still profile and log
+    if( 0 != contextCount ) return;
+
+    CloseProfiler();
+    CloseTraceLog();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Contexts
+//----------------------------------------------------------------------------------------------------------------------
+// Create a window with its own GL context and make it current on the calling thread. Windows are created and
+// destroyed on the thread that created the first one, other threads make them current with MakeContextCurrent
+LeContext *
+CreateContext( int width, int height, const char * title, unsigned int flags )
+{
+    if( !IsPlatformThread() )
+        {
+            TRACELOG( LOG_ERROR, "Contexts are created on the thread owning the other windows" );
+            return NULL;
+        }
+
+    LeContext * context = (LeContext *)LE_CALLOC( 1, sizeof( LeContext ) );
+    if( NULL == context )
+        {
+            TRACELOG( LOG_ERROR, "Failed to allocate context" );
+            return NULL;
+        }
+
+    context->core.window.screen.width  = width;
+    context->core.window.screen.height = height;
+    context->core.window.flags         = flags;
+    context->core.redraw.requested     = 1; // The first frame always draws
+    leMutexInit( &context->core.redraw.lock );
     if( STR_NONEMPTY( title ) )
         {
-            core.window.title = title;
+            context->core.window.title = title;
+        }
+
+    // Modules initialize the state of the current context
+    LeContext * previous = currentContext;
+    BindThreadContext( context );
+
+    if( 0 != InitPlatform() )
+        {
+            leMutexDestroy( &context->core.redraw.lock );
+            LE_FREE( context );
+            MakeContextCurrent( previous );
+            return NULL;
         }
 
-    InitPlatform();
+    StartRenderThread();
+    ++contextCount;
+
+    return context;
 }
 
+// Release everything the context owns, its GL context must not be current on another thread
 void
-CloseWindow()
+DestroyContext( LeContext * context )
 {
+    if( NULL == context ) return;
+    if( !IsPlatformThread() )
+        {
+            TRACELOG( LOG_ERROR, "Contexts are destroyed on the thread that created them" );
+            return;
+        }
+
+    LeContext * previous = currentContext;
+    BindThreadContext( context );
+
+    StopRenderThread();
+    AcquirePlatformContext();
     ClosePlatform();
-    memset( &core, 0, sizeof( core ) );
 
-    TRACELOG( LOG_INFO, "Window closed" );
+    if( windowContext == context ) windowContext = NULL;
+    leMutexDestroy( &context->core.redraw.lock );
+    LE_FREE( context );
+    --contextCount;
+
+    MakeContextCurrent( ( previous == context ) ? NULL : previous );
+}
+
+void
+MakeContextCurrent( LeContext * context )
+{
+    BindThreadContext( context );
+
+    LeContext * current = GetCurrentContext();
+    if( NULL == current )
+        {
+            ReleasePlatformContext();
+            return;
+        }
+
+    // The render thread owns the GL context of a threaded context
+    if( FLAG_CHECK( current->core.window.flags, FLAG_THREADED_RENDERER ) )
+        {
+            ReleasePlatformContext();
+        }
+    else
+        {
+            AcquirePlatformContext();
+        }
+}
+
+LeContext *
+GetCurrentContext( void )
+{
+    return ( NULL != currentContext ) ? currentContext : windowContext;
 }
 
+void
+BindThreadContext( LeContext * context )
+{
+    currentContext = context;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Frame control
+//----------------------------------------------------------------------------------------------------------------------
 void
 SetTargetFPS( int fps )
 {
+    LeContext * context = GetCurrentContext();
+    if( NULL == context ) return;
+
+    CoreContext * core = &context->core;
     if( fps < 1 )
         {
-            core.timing.targetFPS = 0.0;
+            core->timing.targetFPS = 0.0;
         }
     else
         {
-            core.timing.targetFPS = 1.0 / (double)fps;
+            core->timing.targetFPS = 1.0 / (double)fps;
         }
 }
 
 void
 SetConfigFlags( unsigned int flags )
 {
-    FLAG_SET( core.window.flags, flags );
+    LeContext * context = GetCurrentContext();
+    if( NULL == context )
+        {
+            FLAG_SET( windowFlags, flags );
+            return;
+        }
+
+    FLAG_SET( context->core.window.flags, flags );
+}
+
+// Wake a FLAG_EVENT_DRIVEN BeginDrawing, callable from any thread
+void
+RequestRedraw( void )
+{
+    LeContext * context = GetCurrentContext();
+    if( NULL == context ) return;
+
+    leAtomicStore( &context->core.redraw.requested, 1L );
+    PostEmptyEvent();
+}
+
+// Draw a FLAG_EVENT_DRIVEN frame after `seconds`, an earlier request is kept. Callable from any thread
+void
+RequestRedrawIn( double seconds )
+{
+    LeContext * context = GetCurrentContext();
+    if( NULL == context ) return;
+
+    CoreContext * core     = &context->core;
+    const double  deadline = GetTime() + ( ( seconds > 0.0 ) ? seconds : 0.0 );
+
+    leMutexLock( &core->redraw.lock );
+    if( 0.0 == core->redraw.deadline || deadline < core->redraw.deadline ) core->redraw.deadline = deadline;
+    leMutexUnlock( &core->redraw.lock );
+
+    // A wait without a deadline would not see the new one
+    PostEmptyEvent();
+}
+
+// Sleep until input, a resize, a redraw request or the redraw deadline
+static void
+WaitForRedraw( CoreContext * core )
+{
+    LE_PROFILE_BEGIN( "WaitForRedraw" );
+
+    leMutexLock( &core->redraw.lock );
+    const double deadline = core->redraw.deadline;
+    leMutexUnlock( &core->redraw.lock );
+
+    if( leAtomicCompareSwap( &core->redraw.requested, 1L, 0L ) )
+        {
+            // Events queued during the last frame still need their callbacks
+            PollInputEvents();
+        }
+    else if( deadline > 0.0 )
+        {
+            WaitInputEvents( deadline - GetTime() );
+        }
+    else
+        {
+            WaitInputEvents( -1.0 );
+        }
+
+    // Whatever woke the wait is handled by this frame
+    leAtomicStore( &core->redraw.requested, 0L );
+    leMutexLock( &core->redraw.lock );
+    if( core->redraw.deadline > 0.0 && GetTime() >= core->redraw.deadline ) core->redraw.deadline = 0.0;
+    leMutexUnlock( &core->redraw.lock );
+
+    LE_PROFILE_END();
 }
 
 void
 BeginDrawing( void )
 {
-    if( core.timing.targetFPS > 0 )
+    LeContext * context = GetCurrentContext();
+    if( NULL == context ) return;
+
+    CoreContext * core = &context->core;
+
+    LE_PROFILE_BEGIN( "BeginDrawing" );
+
+    if( FLAG_CHECK( core->window.flags, FLAG_EVENT_DRIVEN ) ) WaitForRedraw( core );
+
+    ThrottleFrame();
+    PrepareFrameDamage();
+
+    if( core->timing.targetFPS > 0 )
         {
-            const double elapsedTime = GetTime() - core.timing.lastFrameTime;
+            const double elapsedTime = GetTime() - core->timing.lastFrameTime;
 
             // Wait for remaining frame
-            if( elapsedTime < core.timing.targetFPS )
+            if( elapsedTime < core->timing.targetFPS )
                 {
-                    WaitTime( core.timing.targetFPS - elapsedTime );
+                    WaitTime( core->timing.targetFPS - elapsedTime );
                 }
         }
+
+    LE_PROFILE_END();
 }
 
 void
 EndDrawing( void )
 {
-    SwapBuffers();
+    LeContext * context = GetCurrentContext();
+    if( NULL == context ) return;
+
+    CoreContext * core = &context->core;
+
+    LE_PROFILE_BEGIN( "EndDrawing" );
+
+    SubmitFrame();
 
-    core.timing.lastFrameTime = GetTime();
-    ++core.timing.frameCounter;
+    // Input sampled after the GPU caught up is the freshest the next frame can show
+    if( FLAG_CHECK( core->window.flags, FLAG_LOW_LATENCY ) ) DrainFrames();
+
+    // Event driven frames leave events queued for the wait in BeginDrawing
+    if( !FLAG_CHECK( core->window.flags, FLAG_EVENT_DRIVEN ) ) PollInputEvents();
+
+    core->timing.lastFrameTime = GetTime();
+    ++core->timing.frameCounter;
+
+    LE_PROFILE_END();
 }
 
 void
 ClearBackground( Color color )
 {
-    leClearColor( color.r, color.g, color.b, color.a );
-    leClearScreenBuffers();
+    RecordClear( color );
 }
 
 float
 GetFrameTime( void )
 {
-    static double previousTime = 0.0;
-    double        currentTime  = GetTime();
-    float         deltaTime    = (float)( currentTime - previousTime );
-    previousTime               = currentTime;
+    LeContext * context = GetCurrentContext();
+    if( NULL == context ) return 0.0F;
+
+    CoreContext * core = &context->core;
+
+    double currentTime             = GetTime();
+    float  deltaTime               = (float)( currentTime - core->timing.previousFrameTime );
+    core->timing.previousFrameTime = currentTime;
     return deltaTime;
 }
 
 int
 GetFPS( void )
 {
-    return (int)roundf( 1.0f / GetFrameTime() );
+    const float frameTime = GetFrameTime();
+
+    return ( frameTime > 0.0F ) ? (int)roundf( 1.0f / frameTime ) : 0;
 }
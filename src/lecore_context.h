@@ -24,6 +24,9 @@
 #ifndef LEVEGL_CORE_CONTEXT_H
 #define LEVEGL_CORE_CONTEXT_H
 
+#include "levegl/levegl.h"
+#include "lesystem.h"
+
 typedef struct Coordinate
 {
     int x;
@@ -45,7 +48,7 @@ typedef struct CoreContext
         const char * title; /// Window title string (memory managed externally)
         unsigned int flags;
 
-        Dimension screen;   /// Window Size
+        Dimension screen;   /// Framebuffer size, stored atomically by the platform thread
 
     } window;
 
@@ -53,11 +56,40 @@ typedef struct CoreContext
     struct
     {
         double       lastFrameTime; /// Timestamp of last frame in seconds
-        double       targetFPS;     /// Target FPS for the application
+        double       targetFPS;     /// Seconds per frame set by SetTargetFPS, 0 when unlimited
         unsigned int frameCounter;
+        double       previousFrameTime; /// Timestamp of the previous GetFrameTime call
 
     } timing;
 
+    /// Event driven mode (FLAG_EVENT_DRIVEN)
+    struct
+    {
+        long    requested; /// Set by RequestRedraw and window events, atomic
+        double  deadline;  /// Time of the RequestRedrawIn frame, 0 when none is due
+        leMutex lock;      /// Guards `deadline`, RequestRedrawIn may come from any thread
+
+    } redraw;
+
 } CoreContext;
 
+// Module states, each defined by the module owning it
+typedef struct PlatformContext PlatformContext;
+typedef struct RenderContext   RenderContext;
+typedef struct ShapesState     ShapesState;
+typedef struct TexturesState   TexturesState;
+
+/// @brief Everything a window or surface owns, so several can live in one process
+struct LeContext
+{
+    CoreContext       core;
+    PlatformContext * platform; /// Window and GL context, allocated by InitPlatform
+    RenderContext *   render;   /// Command buffers and GL objects, allocated by InitRenderer
+    ShapesState *     shapes;   /// Default shader and polygon cache, allocated by InitShapes
+    TexturesState *   textures; /// Pending texture uploads, allocated by InitTextures
+};
+
+// Set the context of the calling thread without touching the GL context
+void BindThreadContext( LeContext * context );
+
 #endif // !LEVEGL_CORE_CONTEXT_H
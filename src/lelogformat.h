@@ -0,0 +1,167 @@
+/****************************** LELOGFORMAT ******************************
+ * lelogformat: Binary TraceLog layout shared by the library and ledecode
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ *   - A file starts with LE_LOG_BINARY_MAGIC, followed by records made of a
+ *     LogRecordHeader and `size` payload bytes, in host byte order.
+ *   - A format string is written once, as a FORMAT record, the first time its
+ *     contents are logged. EVENT records then reference it by ID and only
+ *     carry the raw arguments, decoded by walking the same conversions.
+ *   - Arguments: integers and pointers take 8 bytes, floating point values a
+ *     double, strings a 16-bit length followed by the bytes.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+#ifndef LEVEGL_LOG_FORMAT_H
+#define LEVEGL_LOG_FORMAT_H
+
+#include <stdbool.h>
+
+//==============================================================================================================
+// DEFINES
+//==============================================================================================================
+#define LE_LOG_BINARY_MAGIC      "LELOG01"
+#define LE_LOG_BINARY_MAGIC_SIZE 8
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+typedef enum
+{
+    LOG_RECORD_FORMAT = 0, // Payload is the format string of `formatId`
+    LOG_RECORD_EVENT,      // Payload is the raw arguments of `formatId`
+    LOG_RECORD_TEXT        // Payload is an already formatted message
+} LogRecordKind;
+
+typedef struct LogRecordHeader
+{
+    unsigned char      kind;
+    unsigned char      level;
+    unsigned short     size;      // Payload bytes
+    unsigned int       formatId;
+    unsigned long long timestamp; // Monotonic nanoseconds
+} LogRecordHeader;
+
+// Argument classes, one per printf conversion or '*'
+typedef enum
+{
+    LOG_ARG_NONE = 0,
+    LOG_ARG_INT,      // int and smaller, width and precision stars
+    LOG_ARG_LONG,     // long
+    LOG_ARG_LLONG,    // long long, intmax_t
+    LOG_ARG_SIZE,     // size_t, ptrdiff_t
+    LOG_ARG_DOUBLE,   // double
+    LOG_ARG_LDOUBLE,  // long double, stored narrowed to double
+    LOG_ARG_STRING,   // char *
+    LOG_ARG_POINTER   // void *
+} LogArgType;
+
+typedef struct LogConversion
+{
+    int        length;    // Characters of the specification, '%' included
+    int        stars;     // Leading LOG_ARG_INT arguments for '*' width/precision
+    LogArgType type;      // Class of the converted value
+    char       specifier; // Conversion character
+} LogConversion;
+
+//==============================================================================================================
+// FUNCTIONS
+//==============================================================================================================
+// Parse the specification starting at `format[0] == '%'`, LOG_ARG_NONE for "%%" and unknown conversions
+static LogConversion
+ParseLogConversion( const char * format )
+{
+    LogConversion conversion = { 1, 0, LOG_ARG_NONE, 0 };
+    const char *  cursor     = format + 1;
+
+    while( '-' == *cursor || '+' == *cursor || ' ' == *cursor || '#' == *cursor || '0' == *cursor ) ++cursor;
+
+    if( '*' == *cursor )
+        {
+            ++conversion.stars;
+            ++cursor;
+        }
+    while( *cursor >= '0' && *cursor <= '9' ) ++cursor;
+
+    if( '.' == *cursor )
+        {
+            ++cursor;
+            if( '*' == *cursor )
+                {
+                    ++conversion.stars;
+                    ++cursor;
+                }
+            while( *cursor >= '0' && *cursor <= '9' ) ++cursor;
+        }
+
+    // Length modifiers, 'h' and 'hh' promote to int
+    int  longs      = 0;
+    bool sized      = false;
+    bool longDouble = false;
+    while( 'h' == *cursor || 'l' == *cursor || 'L' == *cursor || 'z' == *cursor || 'j' == *cursor || 't' == *cursor )
+        {
+            if( 'l' == *cursor ) ++longs;
+            if( 'j' == *cursor ) longs = 2;
+            if( 'L' == *cursor ) longDouble = true;
+            if( 'z' == *cursor || 't' == *cursor ) sized = true;
+            ++cursor;
+        }
+
+    conversion.specifier = *cursor;
+    conversion.length    = ( '\0' != *cursor ) ? (int)( cursor - format ) + 1 : (int)( cursor - format );
+
+    switch( *cursor )
+        {
+        case 'd':
+        case 'i':
+        case 'u':
+        case 'o':
+        case 'x':
+        case 'X':
+        case 'c':
+            {
+                if( sized ) conversion.type = LOG_ARG_SIZE;
+                else if( 2 == longs ) conversion.type = LOG_ARG_LLONG;
+                else if( 1 == longs ) conversion.type = LOG_ARG_LONG;
+                else conversion.type = LOG_ARG_INT;
+            }
+            break;
+
+        case 'f':
+        case 'F':
+        case 'e':
+        case 'E':
+        case 'g':
+        case 'G':
+        case 'a':
+        case 'A': conversion.type = longDouble ? LOG_ARG_LDOUBLE : LOG_ARG_DOUBLE; break;
+        case 's': conversion.type = LOG_ARG_STRING; break;
+        case 'p': conversion.type = LOG_ARG_POINTER; break;
+        default:  conversion.stars = 0; break;
+        }
+
+    return conversion;
+}
+
+#endif // !LEVEGL_LOG_FORMAT_H
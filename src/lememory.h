@@ -0,0 +1,63 @@
+/******************************* LEMEMORY ********************************
+ * lememory: Accounting behind GetMemoryStats
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ *   - CPU bytes are reported by the modules where they grow or release
+ *     storage, per category.
+ *   - GPU bytes are reported by legl.h through LE_TRACK_GPU_MEMORY with the
+ *     new size of an object, 0 once deleted. Objects are keyed by context,
+ *     kind and GL name, so replacing storage only accounts the difference.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+#ifndef LEVEGL_MEMORY_H
+#define LEVEGL_MEMORY_H
+
+#include <stdbool.h>
+#include <stddef.h> /* size_t */
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+typedef enum
+{
+    MEMORY_VERTEX_STAGING = 0,
+    MEMORY_COMMAND_BUFFERS,
+    MEMORY_FILE_DATA,
+    MEMORY_SHADERS,
+    MEMORY_SCENES,
+    MEMORY_IMAGES,
+    MEMORY_FONTS,
+    MEMORY_POLYGONS,
+    MEMORY_PARTICLES,
+    MEMORY_CPU_CATEGORIES
+} MemoryCategory;
+
+//==============================================================================================================
+// FUNCTIONS DECLARATIONS
+//==============================================================================================================
+void TrackMemory( MemoryCategory category, size_t bytes, bool allocated ); // Account CPU bytes gained or released
+void TrackGpuMemory( const void * owner, int kind, unsigned int id, size_t bytes ); // Set the size of a GPU object
+
+#endif // !LEVEGL_MEMORY_H
@@ -0,0 +1,1145 @@
+/***************************** LEPARTICLES *******************************
+ * leparticles: Particle systems simulated on the GPU or by worker threads
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ * - DEFINES:
+ *   - LE_PARTICLE_WORKERS: Threads simulating CPU particle systems along with the caller
+ *   - LE_PARTICLE_CHUNK: Particles a simulation task ages, moves and compacts at once
+ *
+ * - With LE_COMPUTE_SHADERS (GL 4.3 builds on a 4.3 context) particles live in two shader storage
+ *   buffers and never reach the CPU. UpdateParticleSystem records three compute passes into the
+ *   frame: one takes the particle count and sizes the dispatch of the next, one ages and moves the
+ *   particles of a buffer and appends the survivors to the other through an atomic counter, then one
+ *   per EmitParticles call appends new particles. The counter is the instance count of an indirect
+ *   draw, DrawParticleSystem expands every instance into a quad in the vertex shader.
+ * - Elsewhere particles are a structure of arrays. An update splits them into LE_PARTICLE_CHUNK
+ *   chunks, moved with SSE2/NEON by a process wide pool of threads and the caller, each compacted in
+ *   place before the chunks are slid together. DrawParticleSystem copies the position, size and
+ *   color of every particle into the frame, drawn as instanced quads (LE_INSTANCED_LINES) or points.
+ * - Sprites are round discs faded over their last pixel and alpha blended. GPU survivors are drawn in
+ *   the order they were appended, so overlapping particles of different colors may swap from a frame
+ *   to the next. CPU survivors keep their order.
+ * - A system is updated and drawn by one recording thread at a time. Updates and draws are recorded
+ *   with copies of its GL names, unload it outside of the frames using it.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+//==============================================================================================================
+// INCLUDES
+//==============================================================================================================
+#include "lememory.h"
+#include "lerender.h"
+#include "lesystem.h"
+
+#include "levegl/lemath.h"
+#include "levegl/leutils.h"
+#include "levegl/levegl.h"
+
+#undef LEGL_IMPLEMENTATION
+#include "levegl/legl.h"
+
+#include <math.h>   /* fminf, fmaxf, sqrtf */
+#include <stddef.h> /* offsetof */
+#include <string.h> /* memcpy, memmove, memset */
+
+//==============================================================================================================
+// DEFINES
+//==============================================================================================================
+#ifndef LE_PARTICLE_WORKERS
+#    define LE_PARTICLE_WORKERS 3
+#endif
+
+#ifndef LE_PARTICLE_CHUNK
+#    define LE_PARTICLE_CHUNK 16384
+#endif
+
+// Invocations of a compute work group, matching local_size_x of the shaders
+#define LE_PARTICLE_GROUP_SIZE 256
+
+// Float arrays of a CPU system, colors included
+#define PARTICLE_ARRAYS 12
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+/// One GPU particle, laid out like the std430 array of the shaders
+typedef struct GpuParticle
+{
+    float        x, y;
+    float        vx, vy;
+    float        ax, ay;
+    float        age, lifetime;
+    float        startSize, endSize;
+    unsigned int startColor, endColor; /// RGBA8, red in the low byte
+} GpuParticle;
+
+/// Counters shared by the compute passes: an indirect draw instancing every particle, then an indirect dispatch
+typedef struct ParticleState
+{
+    unsigned int vertexCount;   /// Six, one quad per instance
+    unsigned int particleCount; /// Instance count, the atomic counter of the passes
+    unsigned int firstVertex;
+    unsigned int baseInstance;
+    unsigned int groupsX, groupsY, groupsZ; /// Dispatch of the update pass
+    unsigned int previousCount;             /// Particles the update pass reads
+} ParticleState;
+
+/// What a CPU particle draws, one instance (LE_INSTANCED_LINES) or one point
+typedef struct ParticleSprite
+{
+    float         x, y;
+    float         size;
+    unsigned char r, g, b, a;
+} ParticleSprite;
+
+/// An EmitParticles call waiting for the next update
+typedef struct ParticleEmission
+{
+    ParticleEmitter emitter;
+    int             count;
+    unsigned int    seed;
+} ParticleEmission;
+
+/// GL names and uniform locations, copied into every recorded update and draw
+typedef struct ParticleObjects
+{
+    unsigned int buffers[2];    /// GPU particles, the update reads one and appends to the other
+    unsigned int stateBufferId; /// ParticleState
+    int          capacity;      /// Particles a buffer holds
+    unsigned int prepareShaderId;
+    unsigned int updateShaderId;
+    unsigned int emitShaderId;
+    int          deltaTimeLocation;
+    int          emitterLocation;
+    int          emissionLocation;
+
+    unsigned int drawShaderId;
+    int          mvpLocation;
+    int          pointScaleLocation; /// Points only
+    unsigned int vaoId;
+    unsigned int vboId; /// Sprites of a CPU system, streamed every draw
+} ParticleObjects;
+
+/// Recorded GPU update, the emissions follow
+typedef struct ParticleUpdate
+{
+    ParticleObjects objects;
+    int             source;
+    float           deltaTime;
+    unsigned long   serial; /// Differs every update, so event driven frames keep drawing
+    int             emissionCount;
+} ParticleUpdate;
+
+/// Recorded draw, the sprites of a CPU system follow
+typedef struct ParticleDraw
+{
+    ParticleObjects objects;
+    int             current;
+    unsigned long   serial;
+    int             spriteCount;
+    Matrix2D        transform; /// PushMatrix transform of the caller
+} ParticleDraw;
+
+struct ParticleSystem
+{
+    int             capacity;
+    bool            gpu;
+    ParticleObjects objects; /// Created and deleted where the GL context lives
+
+    int           current; /// GPU buffer holding the particles once the recorded updates ran
+    unsigned long serial;  /// Updates so far
+    unsigned int  seed;
+
+    ParticleEmission * emissions;
+    int                emissionCount;
+    int                emissionCapacity;
+
+    /// CPU particles, a structure of arrays sharing one block
+    struct
+    {
+        float *        block;
+        int            stride; /// Floats per array, the capacity rounded up to a SIMD vector
+        float *        x, *y, *vx, *vy, *ax, *ay, *age, *lifetime, *startSize, *endSize;
+        unsigned int * startColor, *endColor;
+        int            count;
+        int *          chunkCounts; /// Survivors of every chunk of the running update
+        int            chunkCapacity;
+    } cpu;
+};
+
+/// Update shared with the simulation threads
+typedef struct ParticleJob
+{
+    ParticleSystem * system;
+    float            deltaTime;
+    long             chunks;
+    long             nextChunk; /// Atomic, the next chunk to claim
+} ParticleJob;
+
+//==============================================================================================================
+// GLOBALS
+//==============================================================================================================
+// Simulation threads, shared by every CPU particle system
+static struct
+{
+    int           users; /// CPU systems alive, the last one stops the threads
+    int           threadCount;
+    leMutex       runLock; /// One update at a time
+    leMutex       jobLock;
+    leCondition   wake; /// Broadcast when a job is posted
+    leCondition   done; /// Signaled when the last thread working on a job leaves it
+    ParticleJob   job;
+    unsigned long generation; /// Jobs posted so far
+    int           active;     /// Threads working on the job
+    bool          quit;
+    leThread      threads[LE_PARTICLE_WORKERS];
+} simulationPool = { 0 };
+
+static leMutex simulationPoolLock = LE_MUTEX_INITIALIZER; // Guards `users` and starting or stopping the threads
+
+#if LE_COMPUTE_SHADERS
+// Shader code. Random offsets come from a PCG hash of the emission seed, the particle and the draw, shared with
+// the CPU path
+#define PARTICLE_COMPUTE_HEADER                                                                                  \
+    "#version 430\n"                                                                                             \
+    "layout(local_size_x = 256) in;\n"                                                                           \
+    "struct Particle\n"                                                                                          \
+    "{\n"                                                                                                        \
+    "   vec2 position;\n"                                                                                        \
+    "   vec2 velocity;\n"                                                                                        \
+    "   vec2 acceleration;\n"                                                                                    \
+    "   float age;\n"                                                                                            \
+    "   float lifetime;\n"                                                                                       \
+    "   float startSize;\n"                                                                                      \
+    "   float endSize;\n"                                                                                        \
+    "   uint startColor;\n"                                                                                      \
+    "   uint endColor;\n"                                                                                        \
+    "};\n"                                                                                                       \
+    "layout(std430, binding = 0) readonly buffer Source { Particle source[]; };\n"                               \
+    "layout(std430, binding = 1) writeonly buffer Target { Particle target[]; };\n"                              \
+    "layout(std430, binding = 2) buffer State\n"                                                                 \
+    "{\n"                                                                                                        \
+    "   uint vertexCount;\n"                                                                                     \
+    "   uint count;\n"                                                                                           \
+    "   uint firstVertex;\n"                                                                                     \
+    "   uint baseInstance;\n"                                                                                    \
+    "   uint groupsX;\n"                                                                                         \
+    "   uint groupsY;\n"                                                                                         \
+    "   uint groupsZ;\n"                                                                                         \
+    "   uint previous;\n"                                                                                        \
+    "};\n"
+
+static const char * prepareShaderCode = PARTICLE_COMPUTE_HEADER "void main()\n"
+                                                                "{\n"
+                                                                "   if (gl_LocalInvocationIndex != 0u) return;\n"
+                                                                "   previous = count;\n"
+                                                                "   count = 0u;\n"
+                                                                "   groupsX = (previous + 255u) / 256u;\n"
+                                                                "}\n";
+
+static const char * updateShaderCode = PARTICLE_COMPUTE_HEADER "uniform float deltaTime;\n"
+                                                               "void main()\n"
+                                                               "{\n"
+                                                               "   uint i = gl_GlobalInvocationID.x;\n"
+                                                               "   if (i >= previous) return;\n"
+                                                               "   Particle p = source[i];\n"
+                                                               "   p.age += deltaTime;\n"
+                                                               "   if (p.age >= p.lifetime) return;\n"
+                                                               "   p.velocity += p.acceleration * deltaTime;\n"
+                                                               "   p.position += p.velocity * deltaTime;\n"
+                                                               "   target[atomicAdd(count, 1u)] = p;\n"
+                                                               "}\n";
+
+// Slots past the capacity are dropped. Each invocation clamps the counter after its own increment, so the last
+// operation on it is always a clamp
+static const char * emitShaderCode
+    = PARTICLE_COMPUTE_HEADER "uniform vec4 emitter[6];\n" // ParticleEmitter, colors as floats
+                              "uniform ivec4 emission;\n"  // Count, seed, capacity
+                              "uint Hash(uint v)\n"
+                              "{\n"
+                              "   uint state = v * 747796405u + 2891336453u;\n"
+                              "   uint word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;\n"
+                              "   return (word >> 22u) ^ word;\n"
+                              "}\n"
+                              "float Spread(uint i, uint k)\n"
+                              "{\n"
+                              "   uint h = Hash(Hash(uint(emission.y) + i) + k);\n"
+                              "   return float(h >> 8u) * (2.0 / 16777216.0) - 1.0;\n"
+                              "}\n"
+                              "void main()\n"
+                              "{\n"
+                              "   uint i = gl_GlobalInvocationID.x;\n"
+                              "   if (i >= uint(emission.x)) return;\n"
+                              "   uint capacity = uint(emission.z);\n"
+                              "   uint slot = atomicAdd(count, 1u);\n"
+                              "   if (slot < capacity)\n"
+                              "   {\n"
+                              "      Particle p;\n"
+                              "      p.position = emitter[0].xy + vec2(Spread(i, 0u), Spread(i, 1u)) * emitter[0].zw;\n"
+                              "      p.velocity = emitter[1].xy + vec2(Spread(i, 2u), Spread(i, 3u)) * emitter[1].zw;\n"
+                              "      p.acceleration = emitter[2].xy;\n"
+                              "      p.age = 0.0;\n"
+                              "      p.lifetime = emitter[2].z + Spread(i, 4u) * emitter[2].w;\n"
+                              "      p.startSize = emitter[3].x;\n"
+                              "      p.endSize = emitter[3].y;\n"
+                              "      p.startColor = packUnorm4x8(emitter[4]);\n"
+                              "      p.endColor = packUnorm4x8(emitter[5]);\n"
+                              "      target[slot] = p;\n"
+                              "   }\n"
+                              "   atomicMin(count, capacity);\n"
+                              "}\n";
+#endif
+
+// Corners of the quad an instance expands into, and the disc cut from it
+#define PARTICLE_QUAD_CORNERS                                                                                    \
+    "const vec2 corners[6] = vec2[6](vec2(-1.0, -1.0), vec2(1.0, -1.0), vec2(1.0, 1.0),\n"                       \
+    "                                vec2(-1.0, -1.0), vec2(1.0, 1.0), vec2(-1.0, 1.0));\n"
+
+#define PARTICLE_DISC_FRAGMENT                                                                                   \
+    "in vec4 fragColor;\n"                                                                                       \
+    "in vec2 fragCorner;\n"                                                                                      \
+    "out vec4 finalColor;\n"                                                                                     \
+    "void main()\n"                                                                                              \
+    "{\n"                                                                                                        \
+    "   float distance = length(fragCorner);\n"                                                                  \
+    "   float width = max(fwidth(distance), 1.0 / 256.0);\n"                                                     \
+    "   float coverage = 1.0 - smoothstep(1.0 - width, 1.0, distance);\n"                                        \
+    "   finalColor = vec4(fragColor.rgb, fragColor.a * coverage);\n"                                             \
+    "}\n"
+
+#if LE_COMPUTE_SHADERS
+static const char * gpuVertexShaderCode
+    = "#version 430\n"
+      "struct Particle\n"
+      "{\n"
+      "   vec2 position;\n"
+      "   vec2 velocity;\n"
+      "   vec2 acceleration;\n"
+      "   float age;\n"
+      "   float lifetime;\n"
+      "   float startSize;\n"
+      "   float endSize;\n"
+      "   uint startColor;\n"
+      "   uint endColor;\n"
+      "};\n"
+      "layout(std430, binding = 0) readonly buffer Particles { Particle particles[]; };\n"
+      "uniform mat4 mvp;\n"
+      "out vec4 fragColor;\n"
+      "out vec2 fragCorner;\n" PARTICLE_QUAD_CORNERS "void main()\n"
+      "{\n"
+      "   Particle p = particles[gl_InstanceID];\n"
+      "   float t = clamp(p.age / p.lifetime, 0.0, 1.0);\n"
+      "   float size = mix(p.startSize, p.endSize, t);\n"
+      "   fragColor = mix(unpackUnorm4x8(p.startColor), unpackUnorm4x8(p.endColor), t);\n"
+      "   fragCorner = corners[gl_VertexID];\n"
+      "   gl_Position = mvp * vec4(p.position + 0.5 * size * fragCorner, 0.0, 1.0);\n"
+      "}\n";
+
+static const char * gpuFragmentShaderCode = "#version 430\n" PARTICLE_DISC_FRAGMENT;
+#endif
+
+#if defined( GRAPHICS_API_OPENGL_ES2 )
+// Point sprites sized in framebuffer pixels
+static const char * cpuVertexShaderCode = "#version 100\n"
+                                          "attribute vec3 vertexPosition;\n" // Center, z is the diameter
+                                          "attribute vec4 vertexColor;\n"
+                                          "uniform mat4 mvp;\n"
+                                          "uniform float pointScale;\n"
+                                          "varying vec4 fragColor;\n"
+                                          "varying float fragWidth;\n"
+                                          "void main()\n"
+                                          "{\n"
+                                          "   fragColor = vertexColor;\n"
+                                          "   gl_PointSize = max(vertexPosition.z * pointScale, 1.0);\n"
+                                          "   fragWidth = 2.0 / gl_PointSize;\n"
+                                          "   gl_Position = mvp * vec4(vertexPosition.xy, 0.0, 1.0);\n"
+                                          "}\n";
+
+static const char * cpuFragmentShaderCode
+    = "#version 100\n"
+      "precision mediump float;\n"
+      "varying vec4 fragColor;\n"
+      "varying float fragWidth;\n"
+      "void main()\n"
+      "{\n"
+      "   float distance = length(gl_PointCoord * 2.0 - 1.0);\n"
+      "   float coverage = 1.0 - smoothstep(1.0 - fragWidth, 1.0, distance);\n"
+      "   gl_FragColor = vec4(fragColor.rgb, fragColor.a * coverage);\n"
+      "}\n";
+#else
+static const char * cpuVertexShaderCode
+    = "#version 330 core\n"
+      "in vec3 vertexPosition;\n" // Center, z is the diameter
+      "in vec4 vertexColor;\n"
+      "uniform mat4 mvp;\n"
+      "out vec4 fragColor;\n"
+      "out vec2 fragCorner;\n" PARTICLE_QUAD_CORNERS "void main()\n"
+      "{\n"
+      "   fragColor = vertexColor;\n"
+      "   fragCorner = corners[gl_VertexID];\n"
+      "   gl_Position = mvp * vec4(vertexPosition.xy + 0.5 * vertexPosition.z * fragCorner, 0.0, 1.0);\n"
+      "}\n";
+
+static const char * cpuFragmentShaderCode = "#version 330 core\n" PARTICLE_DISC_FRAGMENT;
+#endif
+
+//==============================================================================================================
+// MODULE INTERNAL FUNCTIONS
+//==============================================================================================================
+// PCG hash, the same as the emit shader
+static INLINE unsigned int
+HashParticle( unsigned int v )
+{
+    const unsigned int state = v * 747796405U + 2891336453U;
+    const unsigned int word  = ( ( state >> ( ( state >> 28U ) + 4U ) ) ^ state ) * 277803737U;
+    return ( word >> 22U ) ^ word;
+}
+
+// Uniform offset in [-1, 1) for the random value `k` of particle `i`
+static INLINE float
+SpreadParticle( unsigned int seed, unsigned int i, unsigned int k )
+{
+    const unsigned int hash = HashParticle( HashParticle( seed + i ) + k );
+    return (float)( hash >> 8U ) * ( 2.0F / 16777216.0F ) - 1.0F;
+}
+
+// RGBA8 with red in the low byte, like packUnorm4x8
+static unsigned int
+PackParticleColor( Color color )
+{
+    RenderVertex vertex = { 0 };
+    SetVertexColor( &vertex, color );
+
+    return (unsigned int)vertex.r | ( (unsigned int)vertex.g << 8 ) | ( (unsigned int)vertex.b << 16 )
+         | ( (unsigned int)vertex.a << 24 );
+}
+
+static INLINE unsigned char
+MixChannel( unsigned int start, unsigned int end, int shift, float t )
+{
+    const float a = (float)( ( start >> shift ) & 0xFFU );
+    const float b = (float)( ( end >> shift ) & 0xFFU );
+    return (unsigned char)( a + ( b - a ) * t + 0.5F );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// GL objects
+//----------------------------------------------------------------------------------------------------------------------
+static void
+UnloadParticleObjects( ParticleObjects * objects )
+{
+    for( int i = 0; i < 2; ++i )
+        {
+            if( 0 != objects->buffers[i] ) leUnloadVertexBuffer( objects->buffers[i] );
+        }
+    if( 0 != objects->stateBufferId ) leUnloadVertexBuffer( objects->stateBufferId );
+    if( 0 != objects->prepareShaderId ) leUnloadShaderProgram( objects->prepareShaderId );
+    if( 0 != objects->updateShaderId ) leUnloadShaderProgram( objects->updateShaderId );
+    if( 0 != objects->emitShaderId ) leUnloadShaderProgram( objects->emitShaderId );
+    if( 0 != objects->drawShaderId ) leUnloadShaderProgram( objects->drawShaderId );
+    if( 0 != objects->vaoId ) leUnloadVertexArray( objects->vaoId );
+    if( 0 != objects->vboId ) leUnloadVertexBuffer( objects->vboId );
+
+    memset( objects, 0, sizeof( ParticleObjects ) );
+}
+
+// Storage buffers and compute programs, false when the context lacks GL 4.3 or a shader fails
+static bool
+LoadGpuParticleObjects( ParticleObjects * objects, int capacity )
+{
+#if LE_COMPUTE_SHADERS
+    const ParticleState state = { 6, 0, 0, 0, 0, 1, 1, 0 };
+
+    objects->capacity = capacity;
+
+    objects->stateBufferId = leLoadShaderBuffer( &state, (int)sizeof( ParticleState ) );
+    if( 0 == objects->stateBufferId ) return false;
+
+    for( int i = 0; i < 2; ++i )
+        {
+            objects->buffers[i] = leLoadShaderBuffer( NULL, capacity * (int)sizeof( GpuParticle ) );
+            if( 0 == objects->buffers[i] ) return false;
+        }
+
+    objects->prepareShaderId = leLoadComputeShaderProgram( prepareShaderCode );
+    objects->updateShaderId  = leLoadComputeShaderProgram( updateShaderCode );
+    objects->emitShaderId    = leLoadComputeShaderProgram( emitShaderCode );
+    objects->drawShaderId    = leLoadShaderProgram( gpuVertexShaderCode, gpuFragmentShaderCode );
+    objects->vaoId           = leLoadVertexArray();
+    if( 0 == objects->prepareShaderId || 0 == objects->updateShaderId || 0 == objects->emitShaderId
+        || 0 == objects->drawShaderId || 0 == objects->vaoId )
+        {
+            return false;
+        }
+
+    objects->deltaTimeLocation = leGetLocationUniform( objects->updateShaderId, "deltaTime" );
+    objects->emitterLocation   = leGetLocationUniform( objects->emitShaderId, "emitter" );
+    objects->emissionLocation  = leGetLocationUniform( objects->emitShaderId, "emission" );
+    objects->mvpLocation       = leGetLocationUniform( objects->drawShaderId, LE_DEFAULT_SHADER_UNIFORM_NAME_MVP );
+    return true;
+#else
+    UNUSED( objects );
+    UNUSED( capacity );
+    return false;
+#endif
+}
+
+// Sprite program and stream buffer, the vertex array is 0 where they are unavailable
+static bool
+LoadCpuParticleObjects( ParticleObjects * objects )
+{
+    objects->drawShaderId = leLoadShaderProgram( cpuVertexShaderCode, cpuFragmentShaderCode );
+    if( 0 == objects->drawShaderId ) return false;
+
+    objects->mvpLocation        = leGetLocationUniform( objects->drawShaderId, LE_DEFAULT_SHADER_UNIFORM_NAME_MVP );
+    objects->pointScaleLocation = leGetLocationUniform( objects->drawShaderId, "pointScale" );
+    objects->vaoId              = leLoadVertexArray();
+    objects->vboId              = leLoadVertexBuffer( NULL, 0, true );
+    return true;
+}
+
+// GPU objects when compute shaders run, sprite drawing objects otherwise
+static void
+LoadParticleObjectsTask( void * userData )
+{
+    ParticleSystem * system = (ParticleSystem *)userData;
+
+    system->gpu = LoadGpuParticleObjects( &system->objects, system->capacity );
+    if( system->gpu ) return;
+
+    UnloadParticleObjects( &system->objects );
+    if( !LoadCpuParticleObjects( &system->objects ) ) UnloadParticleObjects( &system->objects );
+}
+
+static void
+UnloadParticleObjectsTask( void * userData )
+{
+    UnloadParticleObjects( (ParticleObjects *)userData );
+}
+
+// Particle count of the GPU system, stored in its CPU count
+static void
+ReadParticleCountTask( void * userData )
+{
+    ParticleSystem * system = (ParticleSystem *)userData;
+
+    unsigned int count = 0;
+    leReadShaderBuffer( system->objects.stateBufferId, &count, (int)sizeof( count ),
+                        (int)offsetof( ParticleState, particleCount ) );
+    system->cpu.count = (int)count;
+}
+
+
+//----------------------------------------------------------------------------------------------------------------------
+// GPU simulation
+//----------------------------------------------------------------------------------------------------------------------
+// Recorded by UpdateParticleSystem: count, age and move, then append the emissions
+static void
+ExecuteParticleUpdate( void * userData, Matrix mvp, Vector2 viewport )
+{
+    UNUSED( mvp );
+    UNUSED( viewport );
+
+    const ParticleUpdate *   update    = (const ParticleUpdate *)userData;
+    const ParticleObjects *  objects   = &update->objects;
+    const ParticleEmission * emissions = (const ParticleEmission *)( update + 1 );
+
+    leBindShaderBuffer( objects->buffers[update->source], 0 );
+    leBindShaderBuffer( objects->buffers[1 - update->source], 1 );
+    leBindShaderBuffer( objects->stateBufferId, 2 );
+
+    leEnableShader( objects->prepareShaderId );
+    leDispatchCompute( 1, 1, 1 );
+    leComputeBarrier();
+
+    leEnableShader( objects->updateShaderId );
+    leSetUniform( objects->deltaTimeLocation, &update->deltaTime, LE_SHADER_UNIFORM_FLOAT, 1 );
+    leDispatchComputeIndirect( objects->stateBufferId, (int)offsetof( ParticleState, groupsX ) );
+    leComputeBarrier();
+
+    if( update->emissionCount > 0 ) leEnableShader( objects->emitShaderId );
+    for( int i = 0; i < update->emissionCount; ++i )
+        {
+            const ParticleEmitter * e = &emissions[i].emitter;
+
+            const float emitter[6][4] = {
+                { e->position.x, e->position.y, e->positionRange.x, e->positionRange.y },
+                { e->velocity.x, e->velocity.y, e->velocityRange.x, e->velocityRange.y },
+                { e->acceleration.x, e->acceleration.y, e->lifetime, e->lifetimeRange },
+                { e->startSize, e->endSize, 0.0F, 0.0F },
+                { e->startColor.r, e->startColor.g, e->startColor.b, e->startColor.a },
+                { e->endColor.r, e->endColor.g, e->endColor.b, e->endColor.a },
+            };
+            const int emission[4] = { emissions[i].count, (int)emissions[i].seed, objects->capacity, 0 };
+
+            leSetUniform( objects->emitterLocation, emitter, LE_SHADER_UNIFORM_VEC4, 6 );
+            leSetUniform( objects->emissionLocation, emission, LE_SHADER_UNIFORM_IVEC4, 1 );
+            const unsigned int groups = (unsigned int)( emissions[i].count + LE_PARTICLE_GROUP_SIZE - 1 );
+            leDispatchCompute( groups / LE_PARTICLE_GROUP_SIZE, 1, 1 );
+            leComputeBarrier();
+        }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// CPU simulation
+//----------------------------------------------------------------------------------------------------------------------
+// Age and move the particles [start, end), four at a time where SIMD is available
+static void
+MoveParticles( ParticleSystem * system, int start, int end, float deltaTime )
+{
+    float * x = system->cpu.x, *y = system->cpu.y, *vx = system->cpu.vx, *vy = system->cpu.vy;
+    float * ax = system->cpu.ax, *ay = system->cpu.ay, *age = system->cpu.age;
+
+    int i = start;
+#if defined( LE_MATH_SSE2 )
+    const __m128 step = _mm_set1_ps( deltaTime );
+    for( ; i + 4 <= end; i += 4 )
+        {
+            const __m128 velocityX = _mm_add_ps( _mm_loadu_ps( vx + i ), _mm_mul_ps( _mm_loadu_ps( ax + i ), step ) );
+            const __m128 velocityY = _mm_add_ps( _mm_loadu_ps( vy + i ), _mm_mul_ps( _mm_loadu_ps( ay + i ), step ) );
+            _mm_storeu_ps( vx + i, velocityX );
+            _mm_storeu_ps( vy + i, velocityY );
+            _mm_storeu_ps( x + i, _mm_add_ps( _mm_loadu_ps( x + i ), _mm_mul_ps( velocityX, step ) ) );
+            _mm_storeu_ps( y + i, _mm_add_ps( _mm_loadu_ps( y + i ), _mm_mul_ps( velocityY, step ) ) );
+            _mm_storeu_ps( age + i, _mm_add_ps( _mm_loadu_ps( age + i ), step ) );
+        }
+#elif defined( LE_MATH_NEON )
+    const float32x4_t step = vdupq_n_f32( deltaTime );
+    for( ; i + 4 <= end; i += 4 )
+        {
+            const float32x4_t velocityX = vmlaq_f32( vld1q_f32( vx + i ), vld1q_f32( ax + i ), step );
+            const float32x4_t velocityY = vmlaq_f32( vld1q_f32( vy + i ), vld1q_f32( ay + i ), step );
+            vst1q_f32( vx + i, velocityX );
+            vst1q_f32( vy + i, velocityY );
+            vst1q_f32( x + i, vmlaq_f32( vld1q_f32( x + i ), velocityX, step ) );
+            vst1q_f32( y + i, vmlaq_f32( vld1q_f32( y + i ), velocityY, step ) );
+            vst1q_f32( age + i, vaddq_f32( vld1q_f32( age + i ), step ) );
+        }
+#endif
+    for( ; i < end; ++i )
+        {
+            vx[i] += ax[i] * deltaTime;
+            vy[i] += ay[i] * deltaTime;
+            x[i] += vx[i] * deltaTime;
+            y[i] += vy[i] * deltaTime;
+            age[i] += deltaTime;
+        }
+}
+
+// Move a chunk and pack its survivors at its start, keeping their order
+static void
+SimulateChunk( ParticleSystem * system, int chunk, float deltaTime )
+{
+    const int start = chunk * LE_PARTICLE_CHUNK;
+    const int end   = ( system->cpu.count - start < LE_PARTICLE_CHUNK ) ? system->cpu.count : start + LE_PARTICLE_CHUNK;
+
+    MoveParticles( system, start, end, deltaTime );
+
+    float *        x = system->cpu.x, *y = system->cpu.y, *vx = system->cpu.vx, *vy = system->cpu.vy;
+    float *        ax = system->cpu.ax, *ay = system->cpu.ay, *age = system->cpu.age, *lifetime = system->cpu.lifetime;
+    float *        startSize = system->cpu.startSize, *endSize = system->cpu.endSize;
+    unsigned int * startColor = system->cpu.startColor, *endColor = system->cpu.endColor;
+
+    int kept = start;
+    for( int i = start; i < end; ++i )
+        {
+            if( age[i] >= lifetime[i] ) continue;
+            if( kept != i )
+                {
+                    x[kept]          = x[i];
+                    y[kept]          = y[i];
+                    vx[kept]         = vx[i];
+                    vy[kept]         = vy[i];
+                    ax[kept]         = ax[i];
+                    ay[kept]         = ay[i];
+                    age[kept]        = age[i];
+                    lifetime[kept]   = lifetime[i];
+                    startSize[kept]  = startSize[i];
+                    endSize[kept]    = endSize[i];
+                    startColor[kept] = startColor[i];
+                    endColor[kept]   = endColor[i];
+                }
+            ++kept;
+        }
+
+    system->cpu.chunkCounts[chunk] = kept - start;
+}
+
+// Claim chunks of the job until none is left
+static void
+RunParticleJob( ParticleJob * job )
+{
+    for( ;; )
+        {
+            const long chunk = leAtomicAdd( &job->nextChunk, 1L );
+            if( chunk >= job->chunks ) break;
+
+            SimulateChunk( job->system, (int)chunk, job->deltaTime );
+        }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Simulation pool
+//----------------------------------------------------------------------------------------------------------------------
+static void
+LockSimulationPool( void )
+{
+    leMutexLock( &simulationPoolLock );
+}
+
+static void
+UnlockSimulationPool( void )
+{
+    leMutexUnlock( &simulationPoolLock );
+}
+
+static void
+SimulationWorker( void * userData )
+{
+    UNUSED( userData );
+
+    unsigned long generation = 0;
+
+    leMutexLock( &simulationPool.jobLock );
+    for( ;; )
+        {
+            while( !simulationPool.quit && generation == simulationPool.generation )
+                {
+                    leConditionWait( &simulationPool.wake, &simulationPool.jobLock );
+                }
+            if( simulationPool.quit ) break;
+
+            // A thread waking after the job is done finds no chunk left
+            generation = simulationPool.generation;
+            ++simulationPool.active;
+            leMutexUnlock( &simulationPool.jobLock );
+
+            RunParticleJob( &simulationPool.job );
+
+            leMutexLock( &simulationPool.jobLock );
+            if( 0 == --simulationPool.active ) leConditionSignal( &simulationPool.done );
+        }
+    leMutexUnlock( &simulationPool.jobLock );
+}
+
+// Spawn the simulation threads, false when none could start
+static bool
+StartSimulationPool( void )
+{
+    LockSimulationPool();
+    if( 0 == simulationPool.threadCount )
+        {
+            leMutexInit( &simulationPool.runLock );
+            leMutexInit( &simulationPool.jobLock );
+            leConditionInit( &simulationPool.wake );
+            leConditionInit( &simulationPool.done );
+            simulationPool.quit = false;
+
+            while( simulationPool.threadCount < LE_PARTICLE_WORKERS
+                   && leThreadCreate( &simulationPool.threads[simulationPool.threadCount], SimulationWorker, NULL ) )
+                {
+                    ++simulationPool.threadCount;
+                }
+
+            if( 0 == simulationPool.threadCount )
+                {
+                    leConditionDestroy( &simulationPool.done );
+                    leConditionDestroy( &simulationPool.wake );
+                    leMutexDestroy( &simulationPool.jobLock );
+                    leMutexDestroy( &simulationPool.runLock );
+                }
+            else
+                {
+                    TRACELOG( LOG_INFO, "PARTICLES: %d simulation threads started", simulationPool.threadCount );
+                }
+        }
+    const bool started = simulationPool.threadCount > 0;
+    UnlockSimulationPool();
+
+    return started;
+}
+
+// Called with the pool locked once no CPU system is left
+static void
+StopSimulationPool( void )
+{
+    leMutexLock( &simulationPool.jobLock );
+    simulationPool.quit = true;
+    leConditionBroadcast( &simulationPool.wake );
+    leMutexUnlock( &simulationPool.jobLock );
+
+    for( int i = 0; i < simulationPool.threadCount; ++i ) leThreadJoin( &simulationPool.threads[i] );
+
+    leConditionDestroy( &simulationPool.done );
+    leConditionDestroy( &simulationPool.wake );
+    leMutexDestroy( &simulationPool.jobLock );
+    leMutexDestroy( &simulationPool.runLock );
+    simulationPool.threadCount = 0;
+}
+
+// Simulate every chunk, on the pool along with the caller when there is more than one
+static void
+SimulateParticles( ParticleSystem * system, float deltaTime )
+{
+    const int chunks = ( system->cpu.count + LE_PARTICLE_CHUNK - 1 ) / LE_PARTICLE_CHUNK;
+    if( 0 == chunks ) return;
+
+    if( chunks > 1 && StartSimulationPool() )
+        {
+            leMutexLock( &simulationPool.runLock );
+            leMutexLock( &simulationPool.jobLock );
+            while( simulationPool.active > 0 ) leConditionWait( &simulationPool.done, &simulationPool.jobLock );
+
+            simulationPool.job.system    = system;
+            simulationPool.job.deltaTime = deltaTime;
+            simulationPool.job.chunks    = chunks;
+            simulationPool.job.nextChunk = 0;
+            ++simulationPool.generation;
+            leConditionBroadcast( &simulationPool.wake );
+            leMutexUnlock( &simulationPool.jobLock );
+
+            RunParticleJob( &simulationPool.job );
+
+            // Chunks claimed by the threads may still be running
+            leMutexLock( &simulationPool.jobLock );
+            while( simulationPool.active > 0 ) leConditionWait( &simulationPool.done, &simulationPool.jobLock );
+            leMutexUnlock( &simulationPool.jobLock );
+            leMutexUnlock( &simulationPool.runLock );
+        }
+    else
+        {
+            for( int chunk = 0; chunk < chunks; ++chunk ) SimulateChunk( system, chunk, deltaTime );
+        }
+
+    // Slide the survivors of every chunk behind those of the previous one
+    void * arrays[PARTICLE_ARRAYS] = { system->cpu.x,         system->cpu.y,          system->cpu.vx,
+                                       system->cpu.vy,        system->cpu.ax,         system->cpu.ay,
+                                       system->cpu.age,       system->cpu.lifetime,   system->cpu.startSize,
+                                       system->cpu.endSize,   system->cpu.startColor, system->cpu.endColor };
+
+    int count = system->cpu.chunkCounts[0];
+    for( int chunk = 1; chunk < chunks; ++chunk )
+        {
+            const int kept = system->cpu.chunkCounts[chunk];
+            if( kept > 0 && count != chunk * LE_PARTICLE_CHUNK )
+                {
+                    for( int a = 0; a < PARTICLE_ARRAYS; ++a )
+                        {
+                            unsigned char * data = (unsigned char *)arrays[a];
+                            memmove( data + (size_t)count * sizeof( float ),
+                                     data + (size_t)chunk * LE_PARTICLE_CHUNK * sizeof( float ),
+                                     (size_t)kept * sizeof( float ) );
+                        }
+                }
+            count += kept;
+        }
+    system->cpu.count = count;
+}
+
+// Append the particles of an emission, those past the capacity are dropped
+static void
+SpawnParticles( ParticleSystem * system, const ParticleEmission * emission )
+{
+    const ParticleEmitter * e          = &emission->emitter;
+    const unsigned int      startColor = PackParticleColor( e->startColor );
+    const unsigned int      endColor   = PackParticleColor( e->endColor );
+
+    for( int i = 0; i < emission->count && system->cpu.count < system->capacity; ++i )
+        {
+            const int          slot = system->cpu.count++;
+            const unsigned int seed = emission->seed;
+            const unsigned int n    = (unsigned int)i;
+
+            system->cpu.x[slot]          = e->position.x + SpreadParticle( seed, n, 0 ) * e->positionRange.x;
+            system->cpu.y[slot]          = e->position.y + SpreadParticle( seed, n, 1 ) * e->positionRange.y;
+            system->cpu.vx[slot]         = e->velocity.x + SpreadParticle( seed, n, 2 ) * e->velocityRange.x;
+            system->cpu.vy[slot]         = e->velocity.y + SpreadParticle( seed, n, 3 ) * e->velocityRange.y;
+            system->cpu.ax[slot]         = e->acceleration.x;
+            system->cpu.ay[slot]         = e->acceleration.y;
+            system->cpu.age[slot]        = 0.0F;
+            system->cpu.lifetime[slot]   = e->lifetime + SpreadParticle( seed, n, 4 ) * e->lifetimeRange;
+            system->cpu.startSize[slot]  = e->startSize;
+            system->cpu.endSize[slot]    = e->endSize;
+            system->cpu.startColor[slot] = startColor;
+            system->cpu.endColor[slot]   = endColor;
+        }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Drawing
+//----------------------------------------------------------------------------------------------------------------------
+// Recorded by DrawParticleSystem: an indirect draw of the GPU particles, or the sprites copied into the frame
+static void
+ExecuteParticleDraw( void * userData, Matrix mvp, Vector2 viewport )
+{
+    const ParticleDraw *    draw    = (const ParticleDraw *)userData;
+    const ParticleObjects * objects = &draw->objects;
+    if( 0 == objects->drawShaderId ) return;
+
+    const Matrix transform = MatrixMultiply( mvp, MatrixFromMatrix2D( draw->transform ) );
+
+    leEnableShader( objects->drawShaderId );
+    leSetUniformMatrix( objects->mvpLocation, &transform.m0 );
+
+    if( 0 != objects->stateBufferId )
+        {
+            leEnableVertexArray( objects->vaoId );
+            leBindShaderBuffer( objects->buffers[draw->current], 0 );
+            leEnableIndirectBuffer( objects->stateBufferId );
+            leDrawVertexArrayIndirect( LE_TRIANGLES, 0 );
+            leDisableVertexArray();
+            return;
+        }
+
+    const ParticleSprite * sprites = (const ParticleSprite *)( draw + 1 );
+    const int              stride  = (int)sizeof( ParticleSprite );
+
+    leEnableVertexArray( objects->vaoId );
+    leSetVertexBufferData( objects->vboId, sprites, draw->spriteCount * stride );
+    leSetVertexAttribute( 0, 3, LE_FLOAT, false, stride, (int)offsetof( ParticleSprite, x ) );
+    leEnableVertexAttribute( 0 );
+    leSetVertexAttribute( 1, 4, LE_UNSIGNED_BYTE, true, stride, (int)offsetof( ParticleSprite, r ) );
+    leEnableVertexAttribute( 1 );
+
+#if LE_INSTANCED_LINES
+    UNUSED( viewport );
+
+    leSetVertexAttributeDivisor( 0, 1 );
+    leSetVertexAttributeDivisor( 1, 1 );
+    leDrawVertexArrayInstanced( LE_TRIANGLES, 0, 6, draw->spriteCount );
+#else
+    // Diameters are in the space of the transform, points in framebuffer pixels
+    const float pointScale = sqrtf( transform.m0 * transform.m0 + transform.m1 * transform.m1 ) * viewport.x * 0.5F;
+    leSetUniform( objects->pointScaleLocation, &pointScale, LE_SHADER_UNIFORM_FLOAT, 1 );
+
+    leDisableVertexAttribute( 2 );
+    leDisableVertexAttribute( 3 );
+    leDrawVertexArray( LE_POINTS, 0, draw->spriteCount );
+#endif
+    leDisableVertexArray();
+}
+
+//==============================================================================================================
+// MODULE FUNCTIONS DEFINITIONS
+//==============================================================================================================
+ParticleSystem *
+LoadParticleSystem( int maxParticles )
+{
+    if( maxParticles <= 0 ) return NULL;
+
+    ParticleSystem * system = (ParticleSystem *)LE_CALLOC( 1, sizeof( ParticleSystem ) );
+    if( NULL == system ) return NULL;
+
+    system->capacity = maxParticles;
+    system->seed     = 0x9E3779B9U;
+    TrackMemory( MEMORY_PARTICLES, sizeof( ParticleSystem ), true );
+
+    InvokeOnRenderThread( LoadParticleObjectsTask, system );
+    if( system->gpu )
+        {
+            TRACELOG( LOG_INFO, "PARTICLES: Loaded %d particles simulated by compute shaders", maxParticles );
+            return system;
+        }
+
+    // Arrays start on a SIMD vector, chunk boundaries too
+    system->cpu.stride        = ( maxParticles + 3 ) & ~3;
+    system->cpu.chunkCapacity = ( maxParticles + LE_PARTICLE_CHUNK - 1 ) / LE_PARTICLE_CHUNK;
+
+    const size_t bytes = (size_t)system->cpu.stride * PARTICLE_ARRAYS * sizeof( float )
+                       + (size_t)system->cpu.chunkCapacity * sizeof( int );
+    system->cpu.block = (float *)LE_MALLOC( bytes );
+    if( NULL == system->cpu.block )
+        {
+            TRACELOG( LOG_ERROR, "PARTICLES: Failed to allocate %d particles", maxParticles );
+            UnloadParticleSystem( system );
+            return NULL;
+        }
+    TrackMemory( MEMORY_PARTICLES, bytes, true );
+
+    float *      block  = system->cpu.block;
+    const size_t stride = (size_t)system->cpu.stride;
+
+    system->cpu.x           = block;
+    system->cpu.y           = block + stride;
+    system->cpu.vx          = block + stride * 2;
+    system->cpu.vy          = block + stride * 3;
+    system->cpu.ax          = block + stride * 4;
+    system->cpu.ay          = block + stride * 5;
+    system->cpu.age         = block + stride * 6;
+    system->cpu.lifetime    = block + stride * 7;
+    system->cpu.startSize   = block + stride * 8;
+    system->cpu.endSize     = block + stride * 9;
+    system->cpu.startColor  = (unsigned int *)( block + stride * 10 );
+    system->cpu.endColor    = (unsigned int *)( block + stride * 11 );
+    system->cpu.chunkCounts = (int *)( block + stride * PARTICLE_ARRAYS );
+
+    LockSimulationPool();
+    ++simulationPool.users;
+    UnlockSimulationPool();
+
+    TRACELOG( LOG_INFO, "PARTICLES: Loaded %d particles simulated on the CPU", maxParticles );
+    return system;
+}
+
+void
+UnloadParticleSystem( ParticleSystem * system )
+{
+    if( NULL == system ) return;
+
+    InvokeOnRenderThread( UnloadParticleObjectsTask, &system->objects );
+
+    if( NULL != system->cpu.block )
+        {
+            TrackMemory( MEMORY_PARTICLES,
+                         (size_t)system->cpu.stride * PARTICLE_ARRAYS * sizeof( float )
+                             + (size_t)system->cpu.chunkCapacity * sizeof( int ),
+                         false );
+            LE_FREE( system->cpu.block );
+
+            LockSimulationPool();
+            if( 0 == --simulationPool.users && simulationPool.threadCount > 0 ) StopSimulationPool();
+            UnlockSimulationPool();
+        }
+
+    if( NULL != system->emissions )
+        {
+            TrackMemory( MEMORY_PARTICLES, (size_t)system->emissionCapacity * sizeof( ParticleEmission ), false );
+            LE_FREE( system->emissions );
+        }
+
+    TrackMemory( MEMORY_PARTICLES, sizeof( ParticleSystem ), false );
+    LE_FREE( system );
+}
+
+// Queue `count` particles for the next update
+void
+EmitParticles( ParticleSystem * system, ParticleEmitter emitter, int count )
+{
+    if( NULL == system || count <= 0 ) return;
+
+    if( system->emissionCount == system->emissionCapacity )
+        {
+            const int          capacity = ( system->emissionCapacity > 0 ) ? system->emissionCapacity * 2 : 8;
+            const size_t       bytes    = (size_t)capacity * sizeof( ParticleEmission );
+            ParticleEmission * emissions = (ParticleEmission *)LE_REALLOC( system->emissions, bytes );
+            if( NULL == emissions ) return;
+
+            TrackMemory( MEMORY_PARTICLES,
+                         (size_t)( capacity - system->emissionCapacity ) * sizeof( ParticleEmission ), true );
+            system->emissions        = emissions;
+            system->emissionCapacity = capacity;
+        }
+
+    // Every emission draws its own random offsets
+    system->seed = HashParticle( system->seed );
+
+    ParticleEmission * emission = &system->emissions[system->emissionCount++];
+    emission->emitter           = emitter;
+    emission->count             = ( count < system->capacity ) ? count : system->capacity;
+    emission->seed              = system->seed;
+}
+
+void
+UpdateParticleSystem( ParticleSystem * system, float deltaTime )
+{
+    if( NULL == system ) return;
+
+    LE_PROFILE_ZONE( "UpdateParticleSystem" );
+
+    if( system->gpu )
+        {
+            const size_t     emissions = (size_t)system->emissionCount * sizeof( ParticleEmission );
+            const size_t     size      = sizeof( ParticleUpdate ) + emissions;
+            ParticleUpdate * update    = (ParticleUpdate *)RecordCallback( ExecuteParticleUpdate, size, false );
+            if( NULL == update ) return; // Outside of a frame, emissions wait for the next update
+
+            memset( update, 0, sizeof( ParticleUpdate ) ); // Padding is hashed with the frame
+            update->objects       = system->objects;
+            update->source        = system->current;
+            update->deltaTime     = deltaTime;
+            update->serial        = ++system->serial;
+            update->emissionCount = system->emissionCount;
+            if( emissions > 0 ) memcpy( update + 1, system->emissions, emissions );
+
+            system->current       = 1 - system->current;
+            system->emissionCount = 0;
+            return;
+        }
+
+    if( NULL == system->cpu.block ) return;
+
+    SimulateParticles( system, deltaTime );
+    for( int i = 0; i < system->emissionCount; ++i ) SpawnParticles( system, &system->emissions[i] );
+
+    ++system->serial;
+    system->emissionCount = 0;
+}
+
+void
+DrawParticleSystem( ParticleSystem * system )
+{
+    if( NULL == system ) return;
+
+    const int count = system->gpu ? 0 : system->cpu.count;
+    if( !system->gpu && 0 == count ) return;
+
+    const size_t   size = sizeof( ParticleDraw ) + (size_t)count * sizeof( ParticleSprite );
+    ParticleDraw * draw = (ParticleDraw *)RecordCallback( ExecuteParticleDraw, size, true );
+    if( NULL == draw ) return;
+
+    memset( draw, 0, sizeof( ParticleDraw ) );
+    draw->objects     = system->objects;
+    draw->current     = system->current;
+    draw->serial      = system->serial;
+    draw->spriteCount = count;
+    draw->transform   = GetMatrix();
+
+    ParticleSprite * sprites = (ParticleSprite *)( draw + 1 );
+    for( int i = 0; i < count; ++i )
+        {
+            const float age      = system->cpu.age[i];
+            const float lifetime = system->cpu.lifetime[i];
+            const float t        = ( lifetime > 0.0F ) ? fminf( fmaxf( age / lifetime, 0.0F ), 1.0F ) : 1.0F;
+
+            const unsigned int start = system->cpu.startColor[i];
+            const unsigned int end   = system->cpu.endColor[i];
+
+            sprites[i].x    = system->cpu.x[i];
+            sprites[i].y    = system->cpu.y[i];
+            sprites[i].size = system->cpu.startSize[i] + ( system->cpu.endSize[i] - system->cpu.startSize[i] ) * t;
+            sprites[i].r    = MixChannel( start, end, 0, t );
+            sprites[i].g    = MixChannel( start, end, 8, t );
+            sprites[i].b    = MixChannel( start, end, 16, t );
+            sprites[i].a    = MixChannel( start, end, 24, t );
+        }
+}
+
+int
+GetParticleCount( ParticleSystem * system )
+{
+    if( NULL == system ) return 0;
+
+    if( system->gpu ) InvokeOnRenderThread( ReadParticleCountTask, system );
+    return system->cpu.count;
+}
@@ -0,0 +1,381 @@
+/****************************** LEPOLYGON *********************************
+ * lepolygon: Winding, convexity and triangulation of simple polygons
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ *   - Outlines may wind either way, the sign of their area decides which
+ *     turns are convex.
+ *   - Triangles keep the winding of the outline and index its points.
+ *   - Triangulations are cached by the content of their outline, up to
+ *     POLYGON_CACHE_SIZE. A full cache evicts one outline not drawn during
+ *     the current frame per new one; when every cached outline was drawn
+ *     this frame, new outlines are triangulated without being kept.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+#ifndef LEVEGL_POLYGON_H
+#define LEVEGL_POLYGON_H
+
+#include "lememory.h"
+
+#include "levegl/leutils.h"
+#include "levegl/levegl.h"
+
+#include <math.h>   /* fminf, fmaxf */
+#include <stdbool.h>
+#include <string.h> /* memcmp, memcpy */
+
+//==============================================================================================================
+// DEFINES
+//==============================================================================================================
+// Triangulated polygons kept per context
+#ifndef POLYGON_CACHE_SIZE
+#    define POLYGON_CACHE_SIZE 4096
+#endif
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+/// Triangulation of a concave polygon, found again by the hash of its points
+typedef struct PolygonEntry
+{
+    unsigned int   hash; /// 0 for an empty slot
+    unsigned int   frame; /// Last frame drawing it
+    int            pointCount;
+    Vector2 *      points; /// Copy compared on lookup
+    unsigned int * indices; /// Triangle list into `points`
+    int            indexCount;
+    float          minX;
+    float          minY;
+    float          maxX;
+    float          maxY;
+} PolygonEntry;
+
+typedef struct PolygonCache
+{
+    PolygonEntry * entries; /// Open addressing table keyed by content
+    int            capacity;
+    int            used;
+    int            hand;      /// Next slot considered for eviction
+    bool           saturated; /// Every entry was drawn during `saturatedFrame`, none can be evicted
+    unsigned int   saturatedFrame;
+} PolygonCache;
+
+//==============================================================================================================
+// FUNCTIONS
+//==============================================================================================================
+static INLINE float
+Cross( Vector2 a, Vector2 b, Vector2 c )
+{
+    return ( b.x - a.x ) * ( c.y - b.y ) - ( b.y - a.y ) * ( c.x - b.x );
+}
+
+// Twice the signed area, its sign gives the winding
+static float
+GetPolygonArea( const Vector2 * points, int count )
+{
+    float area = 0.0F;
+    for( int i = 0, j = count - 1; i < count; j = i++ )
+        {
+            area += points[j].x * points[i].y - points[i].x * points[j].y;
+        }
+    return area;
+}
+
+static bool
+IsPolygonConvex( const Vector2 * points, int count )
+{
+    float winding = 0.0F;
+    for( int i = 0; i < count; ++i )
+        {
+            const float turn = Cross( points[i], points[( i + 1 ) % count], points[( i + 2 ) % count] );
+            if( 0.0F == turn ) continue;
+            if( turn * winding < 0.0F ) return false;
+            winding = turn;
+        }
+    return true;
+}
+
+static bool
+IsPointInTriangle( Vector2 p, Vector2 a, Vector2 b, Vector2 c, float winding )
+{
+    return Cross( a, b, p ) * winding >= 0.0F && Cross( b, c, p ) * winding >= 0.0F
+        && Cross( c, a, p ) * winding >= 0.0F;
+}
+
+// Ear clipping: a convex corner without another point inside is cut off until one triangle is
+// left. Self-intersecting outlines have no ear at some point, a corner is then cut regardless.
+// Returns the index count, 3 * (count - 2) at most
+static int
+TriangulatePolygon( const Vector2 * points, int count, unsigned int * indices )
+{
+    int * links = (int *)LE_MALLOC( (size_t)count * 2 * sizeof( int ) );
+    if( NULL == links ) return 0;
+
+    int * next = links;
+    int * prev = links + count;
+    for( int i = 0; i < count; ++i )
+        {
+            next[i] = ( i + 1 ) % count;
+            prev[i] = ( i + count - 1 ) % count;
+        }
+
+    const float winding    = ( GetPolygonArea( points, count ) >= 0.0F ) ? 1.0F : -1.0F;
+    int         indexCount = 0;
+    int         remaining  = count;
+    int         current    = 0;
+    int         misses     = 0;
+    while( remaining > 3 )
+        {
+            const int     a    = prev[current];
+            const int     c    = next[current];
+            const Vector2 pa   = points[a];
+            const Vector2 pb   = points[current];
+            const Vector2 pc   = points[c];
+            const float   turn = Cross( pa, pb, pc ) * winding;
+
+            bool ear = ( turn > 0.0F );
+            for( int i = next[c]; ear && i != a; i = next[i] )
+                {
+                    const Vector2 p = points[i];
+                    if( ( p.x == pa.x && p.y == pa.y ) || ( p.x == pc.x && p.y == pc.y ) ) continue;
+                    ear = !IsPointInTriangle( p, pa, pb, pc, winding );
+                }
+
+            // Collinear corners are dropped without a triangle
+            if( ear || 0.0F == turn || misses > remaining )
+                {
+                    if( 0.0F != turn )
+                        {
+                            indices[indexCount++] = (unsigned int)a;
+                            indices[indexCount++] = (unsigned int)current;
+                            indices[indexCount++] = (unsigned int)c;
+                        }
+
+                    next[a] = c;
+                    prev[c] = a;
+                    current = c;
+                    misses  = 0;
+                    --remaining;
+                    continue;
+                }
+
+            current = next[current];
+            ++misses;
+        }
+
+    indices[indexCount++] = (unsigned int)prev[current];
+    indices[indexCount++] = (unsigned int)current;
+    indices[indexCount++] = (unsigned int)next[current];
+
+    LE_FREE( links );
+    return indexCount;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Cache
+//----------------------------------------------------------------------------------------------------------------------
+// FNV-1a over the coordinates
+static unsigned int
+HashPolygon( const Vector2 * points, int count )
+{
+    const unsigned char * bytes = (const unsigned char *)points;
+    const size_t          size  = (size_t)count * sizeof( Vector2 );
+
+    unsigned int hash = 2166136261U;
+    for( size_t i = 0; i < size; ++i ) hash = ( hash ^ bytes[i] ) * 16777619U;
+    return ( 0 != hash ) ? hash : 1;
+}
+
+static INLINE size_t
+GetPolygonEntrySize( const PolygonEntry * entry )
+{
+    return (size_t)entry->pointCount * sizeof( Vector2 ) + (size_t)entry->indexCount * sizeof( unsigned int );
+}
+
+static void
+ReleasePolygonCache( PolygonCache * cache )
+{
+    size_t bytes = (size_t)cache->capacity * sizeof( PolygonEntry );
+    for( int i = 0; i < cache->capacity; ++i )
+        {
+            PolygonEntry * entry = &cache->entries[i];
+            if( 0 == entry->hash ) continue;
+
+            bytes += GetPolygonEntrySize( entry );
+            LE_FREE( entry->points );
+            LE_FREE( entry->indices );
+        }
+
+    LE_FREE( cache->entries );
+    TrackMemory( MEMORY_POLYGONS, bytes, false );
+    memset( cache, 0, sizeof( PolygonCache ) );
+}
+
+static bool
+GrowPolygonCache( PolygonCache * cache )
+{
+    const int      capacity = ( 0 == cache->capacity ) ? 64 : cache->capacity * 2;
+    PolygonEntry * entries  = (PolygonEntry *)LE_CALLOC( (size_t)capacity, sizeof( PolygonEntry ) );
+    if( NULL == entries ) return false;
+
+    for( int i = 0; i < cache->capacity; ++i )
+        {
+            const PolygonEntry * entry = &cache->entries[i];
+            if( 0 == entry->hash ) continue;
+
+            unsigned int slot = entry->hash & (unsigned int)( capacity - 1 );
+            while( 0 != entries[slot].hash ) slot = ( slot + 1 ) & (unsigned int)( capacity - 1 );
+            entries[slot] = *entry;
+        }
+
+    LE_FREE( cache->entries );
+    TrackMemory( MEMORY_POLYGONS, (size_t)( capacity - cache->capacity ) * sizeof( PolygonEntry ), true );
+    cache->entries  = entries;
+    cache->capacity = capacity;
+    cache->hand     = 0;
+    return true;
+}
+
+// Free the entry in `slot`, shifting back the entries of its probe chain so lookups still reach them
+static void
+ErasePolygonEntry( PolygonCache * cache, unsigned int slot )
+{
+    const unsigned int mask  = (unsigned int)( cache->capacity - 1 );
+    PolygonEntry *     entry = &cache->entries[slot];
+
+    TrackMemory( MEMORY_POLYGONS, GetPolygonEntrySize( entry ), false );
+    LE_FREE( entry->points );
+    LE_FREE( entry->indices );
+    --cache->used;
+
+    unsigned int hole = slot;
+    for( unsigned int next = ( slot + 1 ) & mask; 0 != cache->entries[next].hash; next = ( next + 1 ) & mask )
+        {
+            // Entries whose home lies cyclically in (hole, next] stay where they are
+            const unsigned int home = cache->entries[next].hash & mask;
+            if( ( ( next - home ) & mask ) < ( ( next - hole ) & mask ) ) continue;
+
+            cache->entries[hole] = cache->entries[next];
+            hole                 = next;
+        }
+
+    cache->entries[hole] = (PolygonEntry){ 0 };
+}
+
+// Evict one entry not drawn during `frame`, sweeping the table like a clock. False when all were
+static bool
+EvictPolygonEntry( PolygonCache * cache, unsigned int frame )
+{
+    if( cache->saturated && frame == cache->saturatedFrame ) return false;
+
+    const unsigned int mask = (unsigned int)( cache->capacity - 1 );
+    for( int step = 0; step < cache->capacity; ++step )
+        {
+            const unsigned int slot = (unsigned int)cache->hand;
+            cache->hand             = (int)( ( slot + 1 ) & mask );
+
+            const PolygonEntry * entry = &cache->entries[slot];
+            if( 0 == entry->hash || frame == entry->frame ) continue;
+
+            ErasePolygonEntry( cache, slot );
+            cache->saturated = false;
+            return true;
+        }
+
+    cache->saturated      = true;
+    cache->saturatedFrame = frame;
+    return false;
+}
+
+static PolygonEntry *
+FindPolygonEntry( PolygonCache * cache, const Vector2 * points, int count, unsigned int hash, unsigned int frame )
+{
+    if( 0 == cache->capacity ) return NULL;
+
+    const unsigned int mask = (unsigned int)( cache->capacity - 1 );
+    for( unsigned int slot = hash & mask; 0 != cache->entries[slot].hash; slot = ( slot + 1 ) & mask )
+        {
+            PolygonEntry * entry = &cache->entries[slot];
+            if( hash != entry->hash || count != entry->pointCount ) continue;
+            if( 0 != memcmp( points, entry->points, (size_t)count * sizeof( Vector2 ) ) ) continue;
+
+            entry->frame = frame;
+            return entry;
+        }
+
+    return NULL;
+}
+
+static PolygonEntry *
+AddPolygonEntry( PolygonCache * cache, const Vector2 * points, int count, unsigned int hash, unsigned int frame )
+{
+    if( cache->used >= POLYGON_CACHE_SIZE && !EvictPolygonEntry( cache, frame ) ) return NULL;
+    if( ( cache->used + 1 ) * 4 > cache->capacity * 3 && !GrowPolygonCache( cache ) ) return NULL;
+
+    const size_t size  = (size_t)count * sizeof( Vector2 );
+    PolygonEntry entry = { 0 };
+    entry.points       = (Vector2 *)LE_MALLOC( size );
+    entry.indices      = (unsigned int *)LE_MALLOC( (size_t)( count - 2 ) * 3 * sizeof( unsigned int ) );
+    if( NULL == entry.points || NULL == entry.indices )
+        {
+            LE_FREE( entry.points );
+            LE_FREE( entry.indices );
+            return NULL;
+        }
+
+    memcpy( entry.points, points, size );
+    entry.hash       = hash;
+    entry.frame      = frame;
+    entry.pointCount = count;
+    entry.indexCount = TriangulatePolygon( points, count, entry.indices );
+    entry.minX = entry.maxX = points[0].x;
+    entry.minY = entry.maxY = points[0].y;
+    for( int i = 1; i < count; ++i )
+        {
+            entry.minX = fminf( entry.minX, points[i].x );
+            entry.minY = fminf( entry.minY, points[i].y );
+            entry.maxX = fmaxf( entry.maxX, points[i].x );
+            entry.maxY = fmaxf( entry.maxY, points[i].y );
+        }
+
+    const unsigned int mask = (unsigned int)( cache->capacity - 1 );
+    unsigned int       slot = hash & mask;
+    while( 0 != cache->entries[slot].hash ) slot = ( slot + 1 ) & mask;
+
+    cache->entries[slot] = entry;
+    ++cache->used;
+    TrackMemory( MEMORY_POLYGONS, GetPolygonEntrySize( &entry ), true );
+    return &cache->entries[slot];
+}
+
+// Triangulation of a polygon drawn during `frame`, computed and cached on first use. NULL when it cannot be kept
+static const PolygonEntry *
+GetPolygonEntry( PolygonCache * cache, const Vector2 * points, int count, unsigned int frame )
+{
+    const unsigned int   hash  = HashPolygon( points, count );
+    const PolygonEntry * entry = FindPolygonEntry( cache, points, count, hash, frame );
+    return ( NULL != entry ) ? entry : AddPolygonEntry( cache, points, count, hash, frame );
+}
+
+#endif // !LEVEGL_POLYGON_H
@@ -0,0 +1,289 @@
+/******************************* LEPROFILE *******************************
+ * leprofile: CPU instrumentation zones with Chrome trace-event export
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ * - DEFINES:
+ *   - PROFILE_SUPPORT: Enable zone recording, otherwise every function is a no-op
+ *   - LE_PROFILE_MAX_EVENTS: Completed zones kept per thread before dropping
+ *   - LE_PROFILE_OUTPUT: Trace written at CloseWindow, unless changed by SetProfileTraceFile
+ *
+ * - Every thread records into its own buffer, so the hot path never takes a lock.
+ *   Buffers are linked into a global list with a compare-and-swap on first use.
+ * - CloseProfiler frees every buffer and starts a new capture generation, threads still holding
+ *   a buffer of the old one allocate a fresh buffer on their next zone. No zone may be open across it.
+ * - Zone names are stored by pointer: use string literals or storage that outlives the capture.
+ * - The output loads in chrome://tracing and https://ui.perfetto.dev
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+//==============================================================================================================
+// INCLUDES
+//==============================================================================================================
+#include "lesystem.h"
+
+#include "levegl/leutils.h"
+#include "levegl/levegl.h"
+
+#include <stdio.h> /* FILE, fopen, fprintf */
+
+//==============================================================================================================
+// DEFINES
+//==============================================================================================================
+#ifndef LE_PROFILE_MAX_EVENTS
+#    define LE_PROFILE_MAX_EVENTS 65536
+#endif
+
+#ifndef LE_PROFILE_MAX_DEPTH
+#    define LE_PROFILE_MAX_DEPTH 64
+#endif
+
+#ifndef LE_PROFILE_OUTPUT
+#    define LE_PROFILE_OUTPUT "levegl_trace.json"
+#endif
+
+#if defined( PROFILE_SUPPORT )
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+typedef struct ProfileEvent
+{
+    const char *       name;
+    unsigned long long begin; /// Nanoseconds
+    unsigned long long end;   /// Nanoseconds
+} ProfileEvent;
+
+/// Zones recorded by a single thread. Only the owner writes, exporters read up to `count`.
+typedef struct ProfileThreadBuffer
+{
+    struct ProfileThreadBuffer * next;
+    long                         threadId;
+    long                         count;   /// Published events, stored after the event is written
+    long                         dropped; /// Zones lost because the buffer was full
+    int                          depth;
+
+    struct
+    {
+        const char *       name;
+        unsigned long long begin;
+    } open[LE_PROFILE_MAX_DEPTH];
+
+    ProfileEvent events[LE_PROFILE_MAX_EVENTS];
+} ProfileThreadBuffer;
+
+//==============================================================================================================
+// GLOBALS
+//==============================================================================================================
+static ProfileThreadBuffer * profileBuffers     = NULL; // Lock-free list of every recording thread
+static long                  profileThreadCount = 0;
+static long                  profileGeneration  = 1;    // Bumped when CloseProfiler frees the buffers
+static const char *          profileTraceFile   = LE_PROFILE_OUTPUT;
+
+static LE_THREAD_LOCAL ProfileThreadBuffer * threadBuffer     = NULL;
+static LE_THREAD_LOCAL long                  threadGeneration = 0; // Capture `threadBuffer` belongs to
+
+//==============================================================================================================
+// MODULE INTERNAL FUNCTIONS
+//==============================================================================================================
+static ProfileThreadBuffer *
+GetThreadBuffer( void )
+{
+    const long generation = leAtomicLoad( &profileGeneration );
+    if( LIKELY( NULL != threadBuffer && generation == threadGeneration ) ) return threadBuffer;
+
+    ProfileThreadBuffer * buffer = (ProfileThreadBuffer *)LE_CALLOC( 1, sizeof( ProfileThreadBuffer ) );
+    if( NULL == buffer ) return NULL;
+
+    buffer->threadId = leAtomicAdd( &profileThreadCount, 1 ) + 1;
+
+    // Publish the buffer to the exporter
+    ProfileThreadBuffer * head;
+    do
+        {
+            head         = (ProfileThreadBuffer *)leAtomicLoadPtr( &profileBuffers );
+            buffer->next = head;
+        }
+    while( !leAtomicCompareSwapPtr( &profileBuffers, head, buffer ) );
+
+    threadBuffer     = buffer;
+    threadGeneration = generation;
+    return buffer;
+}
+
+static void
+WriteEscapedString( FILE * file, const char * text )
+{
+    for( ; '\0' != *text; ++text )
+        {
+            if( '"' == *text || '\\' == *text ) fputc( '\\', file );
+            fputc( *text, file );
+        }
+}
+
+#endif // PROFILE_SUPPORT
+
+//==============================================================================================================
+// MODULE FUNCTIONS DEFINITIONS
+//==============================================================================================================
+// Open a named zone on the calling thread, returns the nesting depth
+int
+ProfileZoneBegin( const char * name )
+{
+#if defined( PROFILE_SUPPORT )
+    ProfileThreadBuffer * buffer = GetThreadBuffer();
+    if( UNLIKELY( NULL == buffer ) ) return 0;
+
+    const int depth = buffer->depth++;
+    if( LIKELY( depth < LE_PROFILE_MAX_DEPTH ) )
+        {
+            buffer->open[depth].name  = name;
+            buffer->open[depth].begin = leGetClockNs();
+        }
+
+    return depth;
+#else
+    UNUSED( name );
+    return 0;
+#endif
+}
+
+// Close the innermost zone opened by the calling thread
+void
+ProfileZoneEnd( void )
+{
+#if defined( PROFILE_SUPPORT )
+    // A buffer of a previous capture was already freed
+    if( UNLIKELY( threadGeneration != leAtomicLoad( &profileGeneration ) ) ) return;
+
+    ProfileThreadBuffer * buffer = threadBuffer;
+    if( UNLIKELY( NULL == buffer || 0 == buffer->depth ) ) return;
+
+    const int depth = --buffer->depth;
+    if( UNLIKELY( depth >= LE_PROFILE_MAX_DEPTH ) ) return;
+
+    const long index = buffer->count;
+    if( UNLIKELY( index >= LE_PROFILE_MAX_EVENTS ) )
+        {
+            ++buffer->dropped;
+            return;
+        }
+
+    buffer->events[index].name  = buffer->open[depth].name;
+    buffer->events[index].begin = buffer->open[depth].begin;
+    buffer->events[index].end   = leGetClockNs();
+
+    leAtomicStore( &buffer->count, index + 1 );
+#endif
+}
+
+// Set the file written at CloseWindow, NULL disables the automatic dump
+void
+SetProfileTraceFile( const char * fileName )
+{
+#if defined( PROFILE_SUPPORT )
+    profileTraceFile = fileName;
+#else
+    UNUSED( fileName );
+#endif
+}
+
+// Dump every recorded zone as Chrome trace-event JSON
+bool
+SaveProfileTrace( const char * fileName )
+{
+#if defined( PROFILE_SUPPORT )
+    if( !STR_NONEMPTY( fileName ) ) return false;
+
+    FILE * file = fopen( fileName, "w" );
+    if( NULL == file )
+        {
+            TRACELOG( LOG_WARNING, "PROFILE: Failed to open trace file: %s", fileName );
+            return false;
+        }
+
+    long written = 0;
+    long dropped = 0;
+
+    fprintf( file, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[" );
+
+    ProfileThreadBuffer * buffer = (ProfileThreadBuffer *)leAtomicLoadPtr( &profileBuffers );
+    for( ; NULL != buffer; buffer = buffer->next )
+        {
+            const long count = leAtomicLoad( &buffer->count );
+
+            fprintf( file,
+                     "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%ld,"
+                     "\"args\":{\"name\":\"%s %ld\"}}",
+                     ( 0 == written ) ? "" : ",", buffer->threadId, ( 1 == buffer->threadId ) ? "Main" : "Thread",
+                     buffer->threadId );
+            ++written;
+
+            for( long i = 0; i < count; ++i )
+                {
+                    const ProfileEvent * event = &buffer->events[i];
+
+                    fprintf( file, ",{\"name\":\"" );
+                    WriteEscapedString( file, event->name );
+                    fprintf( file, "\",\"cat\":\"levegl\",\"ph\":\"X\",\"pid\":1,\"tid\":%ld,\"ts\":%.3f,\"dur\":%.3f}",
+                             buffer->threadId, (double)event->begin / 1000.0,
+                             (double)( event->end - event->begin ) / 1000.0 );
+                }
+
+            written += count;
+            dropped += buffer->dropped;
+        }
+
+    fprintf( file, "]}\n" );
+    fclose( file );
+
+    if( dropped > 0 ) TRACELOG( LOG_WARNING, "PROFILE: %ld zones dropped, raise LE_PROFILE_MAX_EVENTS", dropped );
+    TRACELOG( LOG_INFO, "PROFILE: Trace saved to %s", fileName );
+
+    return true;
+#else
+    UNUSED( fileName );
+    return false;
+#endif
+}
+
+// Write the pending capture and release every thread buffer, called when the last context closes
+void
+CloseProfiler( void )
+{
+#if defined( PROFILE_SUPPORT )
+    if( STR_NONEMPTY( profileTraceFile ) ) SaveProfileTrace( profileTraceFile );
+
+    // Threads drop their stale buffer before the list is freed
+    leAtomicAdd( &profileGeneration, 1 );
+    leAtomicStore( &profileThreadCount, 0 );
+
+    ProfileThreadBuffer * buffer = (ProfileThreadBuffer *)leAtomicExchangePtr( &profileBuffers, NULL );
+    while( NULL != buffer )
+        {
+            ProfileThreadBuffer * next = buffer->next;
+            LE_FREE( buffer );
+            buffer = next;
+        }
+#endif
+}
@@ -0,0 +1,3501 @@
+/******************************* LERENDER ********************************
+ * lerender: Frame command recording and submission
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ * - DEFINES:
+ *   - LE_RENDER_BATCH_VERTICES: Initial vertex capacity of a command buffer
+ *   - LE_RENDER_BATCH_LINES: Initial line segment capacity of a command buffer
+ *   - LE_RENDER_BATCH_COMMANDS: Initial command capacity of a command buffer
+ *   - LE_RENDER_BATCH_QUADS: Quads the shared index buffer covers, at most 16384, larger draws are split
+ *   - LE_MAX_FRAMES_IN_FLIGHT: Upper bound accepted by SetMaxFramesInFlight
+ *   - LE_FRAME_ARENA_SIZE: Initial bytes of a command buffer frame arena
+ *   - LE_MAX_MATRIX_STACK: Depth of the PushMatrix stack of each thread
+ *   - LE_MAX_SCISSOR_STACK: Depth of the BeginScissorMode stack of each thread
+ *   - LE_RESOLUTION_MIN_SCALE: Lowest scale FLAG_DYNAMIC_RESOLUTION may reach
+ *   - LE_RESOLUTION_INTERVAL: Timed frames averaged before the scale changes
+ *
+ * - Consecutive primitives of the same kind are merged into a single draw command,
+ *   so a frame costs one vertex upload plus one draw call per state change.
+ * - Rectangles, sprites, glyphs and fans are recorded as LE_QUADS, four vertices around each quad
+ *   instead of six. Their draws read a static index buffer repeating 0, 1, 2, 0, 2, 3, shared by
+ *   every quad draw and offset by a base vertex. Without base vertices (ES 2.0) the attributes start
+ *   at the first vertex instead. Fans pair their triangles, each quad holds two of them.
+ * - Every vertex samples a texture, solid colors a white texel. Texture changes split draws, but
+ *   textures registering a white texel (atlases) keep shapes drawn after their sprites in the same
+ *   draw, and with texture arrays every page of an atlas is a layer of one texture.
+ * - Threaded mode keeps two command buffers: the application records into one while
+ *   the render thread executes and presents the other. EndDrawing only blocks when the
+ *   render thread is still busy with the previous frame.
+ * - Frames-in-flight limiting fences every presented frame and waits on the fence from
+ *   n frames ago before the next one starts, so drivers cannot queue frames ahead of vsync.
+ * - Every thread drawing into a context records into its own stream without locking.
+ *   Streams are split into segments by SetDrawLayer and merged at execution, ordered by
+ *   layer and then by the order in which threads first drew into the context.
+ * - Producers must be done recording a frame before the thread calling EndDrawing flips it, the
+ *   application orders the two (joining or signaling its workers). Nothing checks it: a draw
+ *   racing the flip may land in either frame or in a stream being released.
+ * - Streams are keyed by leGetThreadId. A stream that recorded nothing for a whole frame is
+ *   released at the flip, so threads that stopped drawing or exited give their buffers back.
+ *   Their next draw registers a new stream, last in the merge order and back on layer 0.
+ * - Data living for one frame (uniform values, tessellation scratch) comes from the frame
+ *   arena of the recording buffer, rewound when the buffer records again. An arena that
+ *   overflowed is merged into one block at that point, so steady frames never allocate.
+ * - The PushMatrix/Translate/Rotate/Scale transform lives in the stream of the calling thread
+ *   and is applied to vertices as they are recorded. Every frame starts from the identity.
+ * - BeginMode2D records the camera as a view command, combined with the projection when the
+ *   frame executes, so the camera never touches vertices on the CPU. While it is active, shapes
+ *   whose bounds miss the visible world rectangle are dropped before they are tessellated.
+ * - Thick lines (LE_INSTANCED_LINES) are recorded as one RenderLine per segment into a second
+ *   stream of the buffer. Consecutive segments become one instanced draw whose vertex shader
+ *   expands every instance into its quad and the join at its end, and whose fragment shader
+ *   fades the edges over a pixel. They use an internal program, not the one of BeginShaderMode.
+ * - BeginScissorMode keeps a stack of screen rectangles per thread, each one inside the last.
+ *   While the camera keeps them axis-aligned they are clipped on the CPU: triangles and lines
+ *   crossing the border are cut as they are recorded, with their texture coordinates, so a
+ *   clip never splits a draw. Rotated cameras and instanced lines fall back to a GL scissor.
+ * - BeginScissorShape clips to whatever is drawn until EndScissorShape, through the stencil
+ *   buffer: each nested shape increments it inside the enclosing one, and the matching
+ *   EndScissorMode draws a cover quad bringing it back down. Shapes do not survive SetDrawLayer
+ *   merges with other threads using shapes.
+ * - FLAG_PARTIAL_REDRAW keeps a copy of the presented image in a framebuffer. Only the union of
+ *   the areas damaged during a frame is redrawn into it, under a scissor, before the copy is
+ *   blitted to the window and presented with the damaged area when EGL can. A frame without
+ *   damage is neither executed nor presented. Without blits (ES 2.0) damage covers the screen.
+ * - FLAG_EVENT_DRIVEN hashes the commands, vertices and damage of every frame before it executes.
+ *   A frame hashing like the last one would draw the image already on screen and is dropped.
+ * - FLAG_DYNAMIC_RESOLUTION draws frames into the corner of a screen sized framebuffer and
+ *   stretches them to the window with a filtered blit. GPU timer queries measure every frame,
+ *   and every LE_RESOLUTION_INTERVAL frames the scale moves so the GPU time settles at 80% of
+ *   the frame budget (the target FPS, or 60 Hz when unlimited). Partial redraw is bypassed.
+ * - FLAG_LAYERED_DEPTH gives every draw command a depth from its place in the merged frame, later
+ *   ones nearer. Primitives of a solid color at full alpha, drawn with the default program and
+ *   outside clip shapes, are recorded into opaque draws. They execute first, from the last one
+ *   back, without blending and writing depth, so fragments they hide are rejected before shading.
+ *   Everything else follows in the usual order, depth tested without writing. Draws before the
+ *   last ClearBackground are skipped, it is applied up front.
+ * - With LE_MULTI_DRAW_INDIRECT (GL 4.3 builds on a 4.3 context) the draw commands of a frame
+ *   become one buffer of indexed draw parameters, all sourcing the shared vertex upload through a
+ *   static 0, 1, 2... index buffer, or the quad one, and their base vertex. Segments share the GL
+ *   state they leave, so draws of the same mode and texture that follow each other, across segments
+ *   and threads, go out as one glMultiDrawElementsIndirect. Other builds and layered passes draw
+ *   each command.
+ * - Modules with GL objects of their own (particle systems) record callbacks run at their place in
+ *   the frame with the projection of the recording thread. The renderer state is restored after.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+//==============================================================================================================
+// INCLUDES
+//==============================================================================================================
+#include "leclip.h"
+#include "lecore_context.h"
+#include "lememory.h"
+#include "lerender.h"
+#include "lesystem.h"
+
+#include "levegl/leutils.h"
+#include "levegl/levegl.h"
+
+#undef LEGL_IMPLEMENTATION
+#include "levegl/legl.h"
+#include "levegl/lemath.h"
+
+#include <float.h>  /* FLT_MAX */
+#include <math.h>   /* fabsf, fminf, fmaxf, floorf, ceilf, sqrtf */
+#include <stddef.h> /* offsetof */
+#include <stdlib.h> /* qsort */
+#include <string.h> /* memcpy, memset */
+
+//==============================================================================================================
+// DEFINES
+//==============================================================================================================
+#ifndef LE_RENDER_BATCH_VERTICES
+#    define LE_RENDER_BATCH_VERTICES 8192
+#endif
+
+#ifndef LE_RENDER_BATCH_LINES
+#    define LE_RENDER_BATCH_LINES 1024
+#endif
+
+#ifndef LE_RENDER_BATCH_COMMANDS
+#    define LE_RENDER_BATCH_COMMANDS 256
+#endif
+
+#ifndef LE_RENDER_BATCH_QUADS
+#    define LE_RENDER_BATCH_QUADS 16384
+#endif
+
+#ifndef LE_MAX_FRAMES_IN_FLIGHT
+#    define LE_MAX_FRAMES_IN_FLIGHT 8
+#endif
+
+#ifndef LE_FRAME_ARENA_SIZE
+#    define LE_FRAME_ARENA_SIZE 65536
+#endif
+
+#ifndef LE_MAX_MATRIX_STACK
+#    define LE_MAX_MATRIX_STACK 32
+#endif
+
+#ifndef LE_MAX_SCISSOR_STACK
+#    define LE_MAX_SCISSOR_STACK 16
+#endif
+
+#ifndef LE_RESOLUTION_MIN_SCALE
+#    define LE_RESOLUTION_MIN_SCALE 0.5F
+#endif
+
+#ifndef LE_RESOLUTION_INTERVAL
+#    define LE_RESOLUTION_INTERVAL 8
+#endif
+
+// Timer queries kept in flight, results are read a few frames late
+#define LE_RESOLUTION_QUERIES 4
+
+// Vertices of one line instance: the segment quad, then a fan of three triangles for the join
+#define LE_LINE_INSTANCE_VERTICES 15
+
+// Alignment of every frame arena allocation, enough for any scalar or SIMD vector
+#define LE_FRAME_ARENA_ALIGNMENT 16
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+typedef enum
+{
+    RENDER_COMMAND_CLEAR = 0,
+    RENDER_COMMAND_DRAW,
+    RENDER_COMMAND_SHADER,
+    RENDER_COMMAND_UNIFORM,
+    RENDER_COMMAND_VIEW,
+    RENDER_COMMAND_LINES,
+    RENDER_COMMAND_SCISSOR,
+    RENDER_COMMAND_STENCIL,
+    RENDER_COMMAND_CALLBACK
+} RenderCommandType;
+
+/// What a stencil command does to the draws that follow it
+typedef enum
+{
+    STENCIL_WRITE = 0, /// Raise the level inside the enclosing shape, colors are not written
+    STENCIL_TEST,      /// Draw where the level is reached, 0 stops testing
+    STENCIL_RESET      /// Lower everything above the level, colors are not written
+} StencilMode;
+
+typedef struct RenderCommand
+{
+    RenderCommandType type;
+
+    union
+    {
+        struct
+        {
+            float r, g, b, a;
+        } clear;
+
+        struct
+        {
+            int          mode;
+            int          first;
+            int          count;
+            unsigned int texture; /// 0 samples the white texture
+            int          opaque;  /// Solid colors only, drawn front to back by FLAG_LAYERED_DEPTH
+        } draw;
+
+        struct
+        {
+            unsigned int id;
+            int          mvpLocation;
+        } shader;
+
+        struct
+        {
+            unsigned int shaderId;
+            int          location;
+            int          uniformType;
+            int          count;
+            const void * value; /// Copy in the frame arena
+        } uniform;
+
+        struct
+        {
+            int first;
+            int count;
+        } lines;
+
+        struct
+        {
+            float minX, minY, maxX, maxY; /// Screen pixels, minX > maxX restores the frame scissor
+        } scissor;
+
+        struct
+        {
+            int mode; /// StencilMode
+            int level;
+        } stencil;
+
+        struct
+        {
+            RenderCallbackFunc func;
+            void *             data; /// Payload in the frame arena
+            size_t             size;
+            bool               draws; /// Placed among the draws by FLAG_LAYERED_DEPTH, hidden by later clears
+        } callback;
+
+        Matrix2D view; /// Camera applied before the screen projection
+    } params;
+} RenderCommand;
+
+/// Linear allocator block, the bytes follow the header
+typedef struct FrameArenaBlock
+{
+    struct FrameArenaBlock * next; /// Older block of the same frame
+    size_t                   capacity;
+    size_t                   used;
+} FrameArenaBlock;
+
+/// Commands recorded under one draw layer
+typedef struct RenderSegment
+{
+    int layer;
+    int firstCommand;
+} RenderSegment;
+
+/// Everything needed to replay one frame without touching application state
+typedef struct CommandBuffer
+{
+    RenderVertex * vertices;
+    int            vertexCount;
+    int            vertexCapacity;
+
+    RenderCommand * commands;
+    int             commandCount;
+    int             commandCapacity;
+
+    FrameArenaBlock * arena; /// Newest block first
+
+    RenderSegment * segments;
+    int             segmentCount;
+    int             segmentCapacity;
+
+    RenderLine * lines;
+    int          lineCount;
+    int          lineCapacity;
+
+    int baseVertex; /// Offset of the vertices inside the merged upload
+    int baseLine;   /// Offset of the lines inside their merged upload
+
+    unsigned int shader; /// Program of the next draws, 0 for the default one
+
+    /// GL scissor left set by the commands recorded so far in the current segment
+    struct
+    {
+        bool  enabled;
+        float minX, minY, maxX, maxY;
+    } scissor;
+
+    /// Texture the next vertices sample, and a white texel inside it for solid colors
+    struct
+    {
+        unsigned int id;
+        bool         white; /// False when shapes must switch to the white texture
+        float        u, v, layer;
+    } texture;
+} CommandBuffer;
+
+/// Level of the BeginScissorMode stack, its screen area already inside the enclosing levels
+typedef struct ScissorEntry
+{
+    float minX, minY, maxX, maxY;
+    bool  shape; /// Pushed by BeginScissorShape
+} ScissorEntry;
+
+/// Per-thread recording state, double-buffered like the frame itself
+typedef struct RecordStream
+{
+    CommandBuffer   buffers[2];
+    CommandBuffer * recording; /// Written by the owning thread only
+    CommandBuffer * executing; /// Read by the thread owning the GL context
+
+    unsigned long         owner; /// leGetThreadId of the recording thread
+    int                   layer; /// Current SetDrawLayer value
+    int                   order; /// Registration index, breaks ties between layers
+    struct RecordStream * next;
+
+    /// Transform stack, touched by the owning thread only
+    struct
+    {
+        Matrix2D current;
+        Matrix2D stack[LE_MAX_MATRIX_STACK];
+        int      depth;
+        bool     identity; /// Lets untransformed draws skip the vertex pass
+    } transform;
+
+    /// BeginShaderMode program, carried into new segments, touched by the owning thread only
+    struct
+    {
+        unsigned int id; /// 0 for the default program
+        int          mvpLocation;
+    } shader;
+
+    /// BeginMode2D state, touched by the owning thread only
+    struct
+    {
+        bool     active;
+        Matrix2D view;
+        ClipBox  bounds; /// Visible world rectangle, padded by a screen pixel
+    } camera;
+
+    /// BeginScissorMode stack, touched by the owning thread only
+    struct
+    {
+        ScissorEntry stack[LE_MAX_SCISSOR_STACK];
+        int          depth;
+        int          shapes;   /// Stencil level, shape entries on the stack
+        bool         defining; /// Between BeginScissorShape and EndScissorShape
+        bool         cpu;      /// The area is a box before the camera too, clipped as vertices are recorded
+        float        minX, minY, maxX, maxY; /// Box of the area before the camera
+
+        RenderVertex * scratch; /// Copy of the vertices being clipped
+        int            scratchCapacity;
+    } scissor;
+} RecordStream;
+
+/// Screen area in pixels, empty while minX > maxX
+typedef struct DamageArea
+{
+    float minX, minY, maxX, maxY;
+} DamageArea;
+
+/// Texture holding a white texel, shapes drawn after its sprites keep the batch
+typedef struct WhiteTexel
+{
+    unsigned int textureId;
+    float        u, v, layer;
+} WhiteTexel;
+
+/// A segment placed in the merged frame order
+typedef struct MergeEntry
+{
+    const CommandBuffer * buffer;
+    int                   layer;
+    int                   order;
+    int                   segment;
+    int                   depth; /// Draw commands merged before the segment (FLAG_LAYERED_DEPTH)
+} MergeEntry;
+
+/// Indexed draw parameters, as glMultiDrawElementsIndirect reads them
+typedef struct IndirectDraw
+{
+    unsigned int count;
+    unsigned int instanceCount;
+    unsigned int firstIndex;
+    int          baseVertex;
+    unsigned int baseInstance;
+} IndirectDraw;
+
+/// Draw commands an ExecuteSegment call replays
+typedef enum
+{
+    RENDER_PASS_ALL = 0,
+    RENDER_PASS_OPAQUE,     /// Opaque draws only, depth written
+    RENDER_PASS_TRANSLUCENT /// Everything else, depth tested
+} RenderPass;
+
+struct RenderContext
+{
+    RecordStream * streams;     /// Registration order, appended atomically
+    RecordStream * streamsTail;
+    int            streamCount; /// Registrations so far, the order of the next stream
+    leMutex        streamLock;  /// Serializes registrations and flips
+    unsigned long  serial;      /// Distinguishes renderers reusing a freed address, renewed as streams are released
+
+    MergeEntry * merge;
+    int          mergeCapacity;
+
+    Dimension    screen;        /// Framebuffer size of the executing frame
+    unsigned int flags;         /// Window flags of the executing frame
+    double       frameBudget;   /// Seconds per frame the executing frame aims at, 0 when unlimited
+
+    /// GL scissor around the whole executing frame, clip scissors are intersected with it
+    struct
+    {
+        bool enabled;
+        int  x, y, width, height; /// Framebuffer pixels from the bottom-left
+    } frameScissor;
+
+    /// Layered depth (FLAG_LAYERED_DEPTH) of the executing frame
+    struct
+    {
+        int pass;         /// RenderPass being replayed
+        int total;        /// Draw commands in the frame
+        int firstCommand; /// Commands of the replayed segment hidden by the last clear end before it
+    } depth;
+
+    /// GL state left by the segments replayed so far, and the draws queued to go out as one multi-draw
+    struct
+    {
+        unsigned int shaderId;
+        int          mvpLocation;
+        Matrix2D     view;
+        unsigned int textureId;
+        bool         dirty;         /// Program or projection differ from the ones a segment starts with
+        bool         indirect;      /// The frame has its draws in the indirect buffer
+        unsigned int indexBufferId; /// Bound to the vertex array, kept across frames
+        int          nextDraw;      /// Indirect draw of the next draw command
+        int          mode;
+        int          first;
+        int          pending;
+    } execution;
+
+    /// Multi-draw submission (LE_MULTI_DRAW_INDIRECT), touched only by the thread owning the GL context
+    struct
+    {
+        unsigned int   bufferId;      /// 0 when the context lacks GL 4.3
+        unsigned int   indexBufferId; /// 0, 1, 2... offset by the base vertex of every draw
+        int            indexCount;
+        IndirectDraw * draws;
+        int            drawCapacity;
+    } indirect;
+
+    unsigned long long frameHash; /// Last frame hashed in event driven mode, 0 outside of it
+
+    /// Partial redraw (FLAG_PARTIAL_REDRAW)
+    struct
+    {
+        leMutex    lock;         /// Guards `pending`, every recording thread may add to it
+        DamageArea pending;      /// Damage of the frame being recorded
+        DamageArea frame;        /// Damage of the executing frame
+        bool       enabled;      /// Mode of the frame being recorded
+        bool       frameEnabled; /// Mode of the executing frame
+        long       partial;      /// Areas may be redrawn alone, cleared when the copy cannot be kept
+        Dimension  screen;       /// Screen of the last recorded frame, a change damages everything
+
+        unsigned int framebufferId; /// Copy of the presented image, touched only by the thread owning the GL context
+        unsigned int textureId;
+        Dimension    framebufferSize;
+    } damage;
+
+    /// Dynamic resolution (FLAG_DYNAMIC_RESOLUTION), touched only by the thread owning the GL context
+    struct
+    {
+        unsigned int framebufferId;
+        unsigned int textureId;
+        Dimension    framebufferSize;
+
+        unsigned int  queries[LE_RESOLUTION_QUERIES];
+        unsigned long issued; /// Timers started so far
+        unsigned long read;   /// Timers whose result was collected
+        double        gpuTime;
+        int           samples;
+
+        long scale;       /// Per mille of the screen size, atomic, read by GetResolutionScale
+        bool unsupported; /// No blits or no timers, frames are drawn at full size
+    } resolution;
+
+    unsigned int vaoId;
+    unsigned int vboId;
+    unsigned int quadIndexBufferId; /// 16-bit 0, 1, 2, 0, 2, 3... for LE_RENDER_BATCH_QUADS quads
+    unsigned int whiteTextureId;    /// 1x1 white, sampled by solid colors
+
+    /// Instanced line pipeline (LE_INSTANCED_LINES)
+    struct
+    {
+        unsigned int vaoId;
+        unsigned int vboId;
+        unsigned int shaderId;
+        int          mvpLocation;
+        int          viewportLocation;
+    } lines;
+
+    /// Registered white texels, read by every recording thread on texture switches
+    struct
+    {
+        leMutex      lock;
+        WhiteTexel * entries;
+        int          count;
+        int          capacity;
+    } whiteTexels;
+
+    unsigned int defaultShaderId;
+    int          defaultMvpLocation;
+
+    /// Fences of presented frames, touched only by the thread owning the GL context
+    struct
+    {
+        void *        fences[LE_MAX_FRAMES_IN_FLIGHT];
+        unsigned long presented;         /// Frames fenced so far
+        unsigned long retired;           /// Frames known to be finished by the GPU
+        long          maxFramesInFlight; /// 0 leaves queuing to the driver
+    } sync;
+
+    struct
+    {
+        leThread    thread;
+        leMutex     lock;
+        leCondition wake; /// Signaled when a frame or a task is posted
+        leCondition idle; /// Broadcast when a frame or a task is done
+
+        bool           active;
+        bool           quit;
+        bool           framePending;
+        RenderTaskFunc task;
+        void *         taskData;
+    } worker;
+};
+
+//==============================================================================================================
+// GLOBALS
+//==============================================================================================================
+static unsigned long rendererSerial = 0;
+
+// Last stream used by the calling thread, skips the registry on the hot path
+static LE_THREAD_LOCAL struct
+{
+    RenderContext * render;
+    unsigned long   serial;
+    RecordStream *  stream;
+} threadStream = { NULL, 0, NULL };
+
+#if LE_INSTANCED_LINES
+// Line program. Vertices 0-5 span the segment quad, lengthened past open ends for the fringe of their butt
+// caps, and 6-14 fan out over the outer side of the turn at the segment end, collapsed when there is none.
+// Coverage is the distance to the nearest edge in pixels, lines thinner than a pixel fade instead
+static const char * lineVertexShaderCode
+    = "#version 330 core\n"
+      "layout(location = 0) in vec4 linePoints;\n"
+      "layout(location = 1) in vec4 lineNeighbors;\n"
+      "layout(location = 2) in vec4 lineColor;\n"
+      "layout(location = 3) in vec2 lineParams;\n"
+      "uniform mat4 mvp;\n"
+      "uniform vec2 viewportSize;\n"
+      "out vec4 fragColor;\n"
+      "out vec2 fragOffset;\n"
+      "flat out vec4 fragAxes;\n"
+      "flat out vec4 fragShape;\n"
+      "const vec2 corners[6] = vec2[6](vec2(0.0, -1.0), vec2(0.0, 1.0), vec2(1.0, 1.0),\n"
+      "                                vec2(0.0, -1.0), vec2(1.0, 1.0), vec2(1.0, -1.0));\n"
+      "const int fan[9] = int[9](0, 1, 2, 0, 2, 3, 0, 3, 4);\n"
+      "void main()\n"
+      "{\n"
+      "   vec2 p0 = linePoints.xy;\n"
+      "   vec2 p1 = linePoints.zw;\n"
+      "   vec2 next = lineNeighbors.zw;\n"
+      "   float len = length(p1 - p0);\n"
+      "   vec2 dir = (len > 0.0) ? (p1 - p0) / len : vec2(1.0, 0.0);\n"
+      "   vec2 normal = vec2(-dir.y, dir.x);\n"
+      "   float pixel = 1.0 / max(length(vec2(mvp[0][0], mvp[0][1]) * viewportSize * 0.5), 1e-6);\n"
+      "   float halfWidth = max(lineParams.x, 0.5 * pixel);\n"
+      "   float outer = halfWidth + pixel;\n"
+      "   fragColor = vec4(lineColor.rgb, lineColor.a * min(lineParams.x / halfWidth, 1.0));\n"
+      "   vec2 position = p1;\n"
+      "   fragOffset = vec2(0.0);\n"
+      "   fragAxes = vec4(dir, normal);\n"
+      "   fragShape = vec4(-1.0, halfWidth, len, 0.0);\n"
+      "   if (gl_VertexID < 6)\n"
+      "   {\n"
+      "      bool capStart = lineNeighbors.xy == p0;\n"
+      "      bool capEnd = next == p1;\n"
+      "      vec2 corner = corners[gl_VertexID];\n"
+      "      float along = (corner.x == 0.0) ? (capStart ? -pixel : 0.0) : len + (capEnd ? pixel : 0.0);\n"
+      "      position = p0 + dir * along + normal * corner.y * outer;\n"
+      "      fragOffset = position - p0;\n"
+      "      fragShape.w = (capStart ? 1.0 : 0.0) + (capEnd ? 2.0 : 0.0);\n"
+      "   }\n"
+      "   else if (len > 0.0 && next != p1)\n"
+      "   {\n"
+      "      vec2 dirNext = normalize(next - p1);\n"
+      "      vec2 normalNext = vec2(-dirNext.y, dirNext.x);\n"
+      "      float turn = normal.x * normalNext.y - normal.y * normalNext.x;\n"
+      "      float cosine = dot(normal, normalNext);\n"
+      "      float side = (turn > 0.0) ? -1.0 : 1.0;\n"
+      "      vec2 edge0 = side * normal;\n"
+      "      vec2 edge1 = side * normalNext;\n"
+      "      bool straight = abs(turn) < 1e-6 && cosine > 0.0;\n"
+      "      bool reverse = length(edge0 + edge1) < 1e-4 && lineParams.y < 1.5;\n"
+      "      if (!straight && !reverse)\n"
+      "      {\n"
+      "         float tip = outer * abs(turn) / max(1.0 + cosine, 1e-6);\n"
+      "         float reach = (lineParams.y < 0.5) ? min(tip, 16.0 * outer) : min(tip, outer);\n"
+      "         vec2 points[5] = vec2[5](p1, p1 + edge0 * outer, p1 + edge0 * outer + dir * reach,\n"
+      "                                  p1 + edge1 * outer - dirNext * reach, p1 + edge1 * outer);\n"
+      "         position = points[fan[gl_VertexID - 6]];\n"
+      "         fragOffset = position - p1;\n"
+      "         fragAxes = vec4(edge0, edge1);\n"
+      "         fragShape = vec4(lineParams.y, halfWidth, 0.0, 0.0);\n"
+      "      }\n"
+      "   }\n"
+      "   gl_Position = mvp * vec4(position, 0.0, 1.0);\n"
+      "}\n";
+
+static const char * lineFragmentShaderCode
+    = "#version 330 core\n"
+      "in vec4 fragColor;\n"
+      "in vec2 fragOffset;\n"
+      "flat in vec4 fragAxes;\n"
+      "flat in vec4 fragShape;\n"
+      "out vec4 finalColor;\n"
+      "void main()\n"
+      "{\n"
+      "   float pixel = max(length(dFdx(fragOffset)), 1e-6);\n"
+      "   float halfWidth = fragShape.y;\n"
+      "   float coverage;\n"
+      "   if (fragShape.x < 0.0)\n"
+      "   {\n"
+      "      float along = dot(fragOffset, fragAxes.xy);\n"
+      "      int caps = int(fragShape.w);\n"
+      "      coverage = clamp((halfWidth - abs(dot(fragOffset, fragAxes.zw))) / pixel + 0.5, 0.0, 1.0);\n"
+      "      if ((caps & 1) != 0) coverage *= clamp(along / pixel + 0.5, 0.0, 1.0);\n"
+      "      if ((caps & 2) != 0) coverage *= clamp((fragShape.z - along) / pixel + 0.5, 0.0, 1.0);\n"
+      "   }\n"
+      "   else if (fragShape.x > 1.5)\n"
+      "   {\n"
+      "      coverage = clamp((halfWidth - length(fragOffset)) / pixel + 0.5, 0.0, 1.0);\n"
+      "   }\n"
+      "   else if (fragShape.x > 0.5)\n"
+      "   {\n"
+      "      vec2 bisector = normalize(fragAxes.xy + fragAxes.zw);\n"
+      "      float chord = halfWidth * dot(fragAxes.xy, bisector);\n"
+      "      coverage = clamp((chord - dot(fragOffset, bisector)) / pixel + 0.5, 0.0, 1.0);\n"
+      "   }\n"
+      "   else\n"
+      "   {\n"
+      "      float edge = min(halfWidth - dot(fragOffset, fragAxes.xy), halfWidth - dot(fragOffset, fragAxes.zw));\n"
+      "      coverage = clamp(edge / pixel + 0.5, 0.0, 1.0);\n"
+      "   }\n"
+      "   finalColor = vec4(fragColor.rgb, fragColor.a * coverage);\n"
+      "}\n";
+#endif
+
+//==============================================================================================================
+// MODULE FUNCTIONS DECLARATIONS
+//==============================================================================================================
+extern void AcquirePlatformContext( void );
+extern void ReleasePlatformContext( void );
+extern void SwapBuffersWithDamage( int x, int y, int width, int height );
+extern void ProcessTextureUploads( void );
+
+//==============================================================================================================
+// MODULE INTERNAL FUNCTIONS
+//==============================================================================================================
+static void
+ResetTransform( RecordStream * stream )
+{
+    stream->transform.current  = Matrix2DIdentity();
+    stream->transform.depth    = 0;
+    stream->transform.identity = true;
+    stream->shader.id          = 0;
+    stream->shader.mvpLocation = -1;
+    stream->camera.active      = false;
+    stream->scissor.depth      = 0;
+    stream->scissor.shapes     = 0;
+    stream->scissor.defining   = false;
+    stream->scissor.cpu        = false;
+}
+
+// Grow `*array` to hold at least `required` elements, doubling the capacity
+static bool
+ReserveArray( void ** array, int * capacity, int required, size_t elementSize, int minimum, MemoryCategory category )
+{
+    if( LIKELY( required <= *capacity ) ) return true;
+
+    int newCapacity = ( *capacity > 0 ) ? *capacity : minimum;
+    while( newCapacity < required ) newCapacity *= 2;
+
+    void * grown = LE_REALLOC( *array, (size_t)newCapacity * elementSize );
+    if( NULL == grown )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: Failed to grow command buffer to %d elements", newCapacity );
+            return false;
+        }
+
+    TrackMemory( category, (size_t)( newCapacity - *capacity ) * elementSize, true );
+
+    *array    = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+static RenderCommand *
+PushCommand( CommandBuffer * buffer, RenderCommandType type )
+{
+    if( !ReserveArray( (void **)&buffer->commands, &buffer->commandCapacity, buffer->commandCount + 1,
+                       sizeof( RenderCommand ), LE_RENDER_BATCH_COMMANDS, MEMORY_COMMAND_BUFFERS ) )
+        {
+            return NULL;
+        }
+
+    RenderCommand * command = &buffer->commands[buffer->commandCount++];
+    command->type           = type;
+    return command;
+}
+
+// Switch the program of the next draws, 0 selects the default one
+static void
+PushShader( const RenderContext * render, CommandBuffer * buffer, unsigned int shaderId, int mvpLocation )
+{
+    RenderCommand * command = PushCommand( buffer, RENDER_COMMAND_SHADER );
+    if( NULL == command ) return;
+
+    buffer->shader                     = shaderId;
+    command->params.shader.id          = ( 0 != shaderId ) ? shaderId : render->defaultShaderId;
+    command->params.shader.mvpLocation = ( 0 != shaderId ) ? mvpLocation : render->defaultMvpLocation;
+}
+
+static void
+RecordView( CommandBuffer * buffer, Matrix2D view )
+{
+    RenderCommand * command = PushCommand( buffer, RENDER_COMMAND_VIEW );
+    if( NULL != command ) command->params.view = view;
+}
+
+// Open a segment for the commands that follow, reusing the last one while it is still empty
+static void
+BeginSegment( CommandBuffer * buffer, int layer )
+{
+    buffer->shader          = 0;
+    buffer->scissor.enabled = false;
+
+    RenderSegment * last = ( buffer->segmentCount > 0 ) ? &buffer->segments[buffer->segmentCount - 1] : NULL;
+    if( NULL != last && last->firstCommand == buffer->commandCount )
+        {
+            last->layer = layer;
+            return;
+        }
+
+    if( !ReserveArray( (void **)&buffer->segments, &buffer->segmentCapacity, buffer->segmentCount + 1,
+                       sizeof( RenderSegment ), 8, MEMORY_COMMAND_BUFFERS ) )
+        {
+            return;
+        }
+
+    buffer->segments[buffer->segmentCount].layer        = layer;
+    buffer->segments[buffer->segmentCount].firstCommand = buffer->commandCount;
+    ++buffer->segmentCount;
+}
+
+static int
+GetSegmentEnd( const CommandBuffer * buffer, int segment )
+{
+    return ( segment + 1 < buffer->segmentCount ) ? buffer->segments[segment + 1].firstCommand : buffer->commandCount;
+}
+
+// Header size keeping the block bytes aligned
+#define FRAME_ARENA_HEADER_SIZE \
+    ( ( sizeof( FrameArenaBlock ) + LE_FRAME_ARENA_ALIGNMENT - 1 ) & ~(size_t)( LE_FRAME_ARENA_ALIGNMENT - 1 ) )
+
+static FrameArenaBlock *
+CreateArenaBlock( size_t capacity, FrameArenaBlock * next )
+{
+    FrameArenaBlock * block = (FrameArenaBlock *)LE_MALLOC( FRAME_ARENA_HEADER_SIZE + capacity );
+    if( NULL == block )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: Failed to grow frame arena to %zu bytes", capacity );
+            return NULL;
+        }
+
+    TrackMemory( MEMORY_COMMAND_BUFFERS, FRAME_ARENA_HEADER_SIZE + capacity, true );
+
+    block->next     = next;
+    block->capacity = capacity;
+    block->used     = 0;
+    return block;
+}
+
+static void *
+AllocArena( FrameArenaBlock ** arena, size_t size )
+{
+    size = ( size + LE_FRAME_ARENA_ALIGNMENT - 1 ) & ~(size_t)( LE_FRAME_ARENA_ALIGNMENT - 1 );
+
+    FrameArenaBlock * block = *arena;
+    if( UNLIKELY( NULL == block || block->used + size > block->capacity ) )
+        {
+            size_t capacity = ( NULL != block ) ? block->capacity * 2 : LE_FRAME_ARENA_SIZE;
+            while( capacity < size ) capacity *= 2;
+
+            // Earlier blocks stay alive, pointers handed out this frame remain valid
+            block = CreateArenaBlock( capacity, block );
+            if( NULL == block ) return NULL;
+            *arena = block;
+        }
+
+    void * memory = (unsigned char *)block + FRAME_ARENA_HEADER_SIZE + block->used;
+    block->used += size;
+    return memory;
+}
+
+static void
+FreeArena( FrameArenaBlock ** arena )
+{
+    FrameArenaBlock * block = *arena;
+    while( NULL != block )
+        {
+            FrameArenaBlock * next = block->next;
+            TrackMemory( MEMORY_COMMAND_BUFFERS, FRAME_ARENA_HEADER_SIZE + block->capacity, false );
+            LE_FREE( block );
+            block = next;
+        }
+
+    *arena = NULL;
+}
+
+// Rewind for the next frame, replacing a chain by a single block large enough for all of it
+static void
+ResetArena( FrameArenaBlock ** arena )
+{
+    FrameArenaBlock * block = *arena;
+    if( NULL == block ) return;
+
+    if( NULL != block->next )
+        {
+            size_t capacity = 0;
+            for( ; NULL != block; block = block->next ) capacity += block->capacity;
+
+            FreeArena( arena );
+            *arena = CreateArenaBlock( capacity, NULL );
+            return;
+        }
+
+    block->used = 0;
+}
+
+// Sample the white texture, centered on its only texel
+static void
+ResetRecordTexture( CommandBuffer * buffer )
+{
+    buffer->texture.id    = 0;
+    buffer->texture.white = true;
+    buffer->texture.u     = 0.5F;
+    buffer->texture.v     = 0.5F;
+    buffer->texture.layer = 0.0F;
+}
+
+static void
+ResetCommandBuffer( CommandBuffer * buffer, int layer )
+{
+    buffer->vertexCount  = 0;
+    buffer->lineCount    = 0;
+    buffer->commandCount = 0;
+    buffer->segmentCount = 0;
+    ResetArena( &buffer->arena );
+    ResetRecordTexture( buffer );
+    BeginSegment( buffer, layer );
+}
+
+static void
+FreeCommandBuffer( CommandBuffer * buffer )
+{
+    TrackMemory( MEMORY_VERTEX_STAGING, (size_t)buffer->vertexCapacity * sizeof( RenderVertex ), false );
+    TrackMemory( MEMORY_VERTEX_STAGING, (size_t)buffer->lineCapacity * sizeof( RenderLine ), false );
+    TrackMemory( MEMORY_COMMAND_BUFFERS, (size_t)buffer->commandCapacity * sizeof( RenderCommand ), false );
+    TrackMemory( MEMORY_COMMAND_BUFFERS, (size_t)buffer->segmentCapacity * sizeof( RenderSegment ), false );
+
+    LE_FREE( buffer->vertices );
+    LE_FREE( buffer->lines );
+    LE_FREE( buffer->commands );
+    LE_FREE( buffer->segments );
+    FreeArena( &buffer->arena );
+    memset( buffer, 0, sizeof( CommandBuffer ) );
+}
+
+// Register a stream for the calling thread, visible to readers once fully built
+static RecordStream *
+CreateRecordStream( RenderContext * render, unsigned long owner )
+{
+    RecordStream * stream = (RecordStream *)LE_CALLOC( 1, sizeof( RecordStream ) );
+    if( NULL == stream )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: Failed to allocate record stream" );
+            return NULL;
+        }
+
+    TrackMemory( MEMORY_COMMAND_BUFFERS, sizeof( RecordStream ), true );
+
+    stream->recording = &stream->buffers[0];
+    stream->executing = &stream->buffers[1];
+    stream->owner     = owner;
+    ResetTransform( stream );
+    ResetCommandBuffer( stream->recording, 0 );
+    ResetCommandBuffer( stream->executing, 0 );
+
+    stream->order = render->streamCount++;
+    if( NULL == render->streamsTail )
+        {
+            leAtomicStorePtr( &render->streams, stream );
+        }
+    else
+        {
+            leAtomicStorePtr( &render->streamsTail->next, stream );
+        }
+    render->streamsTail = stream;
+
+    return stream;
+}
+
+// Producers may register while the GL thread walks the list
+static INLINE RecordStream *
+FirstStream( RenderContext * render )
+{
+    return (RecordStream *)leAtomicLoadPtr( &render->streams );
+}
+
+static INLINE RecordStream *
+NextStream( RecordStream * stream )
+{
+    return (RecordStream *)leAtomicLoadPtr( &stream->next );
+}
+
+static void
+FreeRecordStream( RecordStream * stream )
+{
+    FreeCommandBuffer( &stream->buffers[0] );
+    FreeCommandBuffer( &stream->buffers[1] );
+    TrackMemory( MEMORY_VERTEX_STAGING, (size_t)stream->scissor.scratchCapacity * sizeof( RenderVertex ), false );
+    LE_FREE( stream->scissor.scratch );
+    TrackMemory( MEMORY_COMMAND_BUFFERS, sizeof( RecordStream ), false );
+    LE_FREE( stream );
+}
+
+static void
+FreeRecordStreams( RenderContext * render )
+{
+    RecordStream * stream = render->streams;
+    while( NULL != stream )
+        {
+            RecordStream * next = stream->next;
+            FreeRecordStream( stream );
+            stream = next;
+        }
+
+    render->streams     = NULL;
+    render->streamsTail = NULL;
+    render->streamCount = 0;
+}
+
+// Renderer of the current context, NULL before InitWindow or on a thread without a context
+static INLINE RenderContext *
+GetCurrentRender( void )
+{
+    LeContext * context = GetCurrentContext();
+
+    return ( NULL != context ) ? context->render : NULL;
+}
+
+// Stream of the calling thread, registered on its first draw into the context
+static RecordStream *
+GetThreadStream( RenderContext * render )
+{
+    if( LIKELY( threadStream.render == render && threadStream.serial == render->serial ) ) return threadStream.stream;
+
+    const unsigned long owner  = leGetThreadId();
+    RecordStream *      stream = NULL;
+
+    leMutexLock( &render->streamLock );
+    for( stream = FirstStream( render ); NULL != stream; stream = NextStream( stream ) )
+        {
+            if( stream->owner == owner ) break;
+        }
+    if( NULL == stream ) stream = CreateRecordStream( render, owner );
+    leMutexUnlock( &render->streamLock );
+
+    if( NULL != stream )
+        {
+            threadStream.render = render;
+            threadStream.serial = render->serial;
+            threadStream.stream = stream;
+        }
+
+    return stream;
+}
+
+static CommandBuffer *
+GetRecordingBuffer( void )
+{
+    RenderContext * render = GetCurrentRender();
+    if( UNLIKELY( NULL == render ) ) return NULL;
+
+    RecordStream * stream = GetThreadStream( render );
+    return ( NULL != stream ) ? stream->recording : NULL;
+}
+
+// Make the GL scissor of the recording buffer match what the next draw needs: the clip area when it
+// cannot be clipped on the CPU, otherwise none or an equal one left over from an earlier draw
+static void
+SyncScissor( RecordStream * stream, bool gpu )
+{
+    CommandBuffer *      buffer = stream->recording;
+    const ScissorEntry * entry  = ( stream->scissor.depth > 0 ) ? &stream->scissor.stack[stream->scissor.depth - 1]
+                                                                : NULL;
+
+    const bool matches = buffer->scissor.enabled && NULL != entry && entry->minX == buffer->scissor.minX
+                      && entry->minY == buffer->scissor.minY && entry->maxX == buffer->scissor.maxX
+                      && entry->maxY == buffer->scissor.maxY;
+    if( matches || ( !gpu && !buffer->scissor.enabled ) ) return;
+
+    RenderCommand * command = PushCommand( buffer, RENDER_COMMAND_SCISSOR );
+    if( NULL == command ) return;
+
+    buffer->scissor.enabled = gpu;
+    if( gpu )
+        {
+            buffer->scissor.minX = command->params.scissor.minX = entry->minX;
+            buffer->scissor.minY = command->params.scissor.minY = entry->minY;
+            buffer->scissor.maxX = command->params.scissor.maxX = entry->maxX;
+            buffer->scissor.maxY = command->params.scissor.maxY = entry->maxY;
+        }
+    else
+        {
+            command->params.scissor.minX = command->params.scissor.minY = 1.0F;
+            command->params.scissor.maxX = command->params.scissor.maxY = 0.0F;
+        }
+}
+
+static void
+RecordStencil( RecordStream * stream, StencilMode mode, int level )
+{
+    RenderCommand * command = PushCommand( stream->recording, RENDER_COMMAND_STENCIL );
+    if( NULL == command ) return;
+
+    command->params.stencil.mode  = mode;
+    command->params.stencil.level = level;
+}
+
+// Box of the top scissor area in the space vertices are recorded in, before the camera
+static void
+UpdateScissorArea( RecordStream * stream )
+{
+    if( 0 == stream->scissor.depth )
+        {
+            stream->scissor.cpu = false;
+            return;
+        }
+
+    const ScissorEntry * entry = &stream->scissor.stack[stream->scissor.depth - 1];
+    if( !stream->camera.active )
+        {
+            stream->scissor.minX = entry->minX;
+            stream->scissor.minY = entry->minY;
+            stream->scissor.maxX = entry->maxX;
+            stream->scissor.maxY = entry->maxY;
+            stream->scissor.cpu  = true;
+            return;
+        }
+
+    const Matrix2D view       = stream->camera.view;
+    const Matrix2D inverse    = Matrix2DInvert( view );
+    const Vector2  corners[4] = {
+        Vector2Transform2D( ( Vector2 ){ entry->minX, entry->minY }, inverse ),
+        Vector2Transform2D( ( Vector2 ){ entry->maxX, entry->minY }, inverse ),
+        Vector2Transform2D( ( Vector2 ){ entry->minX, entry->maxY }, inverse ),
+        Vector2Transform2D( ( Vector2 ){ entry->maxX, entry->maxY }, inverse ),
+    };
+
+    stream->scissor.minX = stream->scissor.maxX = corners[0].x;
+    stream->scissor.minY = stream->scissor.maxY = corners[0].y;
+    for( int i = 1; i < 4; ++i )
+        {
+            stream->scissor.minX = fminf( stream->scissor.minX, corners[i].x );
+            stream->scissor.minY = fminf( stream->scissor.minY, corners[i].y );
+            stream->scissor.maxX = fmaxf( stream->scissor.maxX, corners[i].x );
+            stream->scissor.maxY = fmaxf( stream->scissor.maxY, corners[i].y );
+        }
+
+    // Only a camera keeping the axes, quarter turns included, maps the area to a box
+    stream->scissor.cpu = ( 0.0F == view.m1 && 0.0F == view.m2 ) || ( 0.0F == view.m0 && 0.0F == view.m3 );
+}
+
+static bool
+AppendVertices( CommandBuffer * buffer, const RenderVertex * vertices, int count )
+{
+    if( !ReserveArray( (void **)&buffer->vertices, &buffer->vertexCapacity, buffer->vertexCount + count,
+                       sizeof( RenderVertex ), LE_RENDER_BATCH_VERTICES, MEMORY_VERTEX_STAGING ) )
+        {
+            return false;
+        }
+
+    memcpy( &buffer->vertices[buffer->vertexCount], vertices, (size_t)count * sizeof( RenderVertex ) );
+    buffer->vertexCount += count;
+    return true;
+}
+
+// Cut the primitives just recorded at the end of the buffer to the scissor box, see ClipPrimitive
+static void
+ClipRecordedVertices( RecordStream * stream, const RenderVertex * vertices, int count )
+{
+    CommandBuffer * buffer = stream->recording;
+    RenderCommand * last   = ( buffer->commandCount > 0 ) ? &buffer->commands[buffer->commandCount - 1] : NULL;
+    if( NULL == last || RENDER_COMMAND_DRAW != last->type
+        || vertices + count != buffer->vertices + buffer->vertexCount )
+        {
+            return;
+        }
+
+    const ClipBox box = { stream->scissor.minX, stream->scissor.minY, stream->scissor.maxX, stream->scissor.maxY };
+
+    float lowX = vertices[0].x, lowY = vertices[0].y, highX = vertices[0].x, highY = vertices[0].y;
+    for( int i = 1; i < count; ++i )
+        {
+            lowX  = fminf( lowX, vertices[i].x );
+            lowY  = fminf( lowY, vertices[i].y );
+            highX = fmaxf( highX, vertices[i].x );
+            highY = fmaxf( highY, vertices[i].y );
+        }
+    if( lowX >= box.minX && lowY >= box.minY && highX <= box.maxX && highY <= box.maxY ) return;
+
+    const int  first   = buffer->vertexCount - count;
+    const bool outside = highX <= box.minX || lowX >= box.maxX || highY <= box.minY || lowY >= box.maxY;
+    if( !outside )
+        {
+            if( !ReserveArray( (void **)&stream->scissor.scratch, &stream->scissor.scratchCapacity, count,
+                               sizeof( RenderVertex ), 64, MEMORY_VERTEX_STAGING ) )
+                {
+                    return;
+                }
+            memcpy( stream->scissor.scratch, vertices, (size_t)count * sizeof( RenderVertex ) );
+        }
+    buffer->vertexCount = first;
+
+    const int mode         = last->params.draw.mode;
+    const int perPrimitive = ( LE_LINES == mode ) ? 2 : ( LE_QUADS == mode ) ? 4 : 3;
+    for( int i = 0; !outside && i + perPrimitive <= count; i += perPrimitive )
+        {
+            RenderVertex pieces[CLIP_MAX_VERTICES];
+            const int    written = ClipPrimitive( &stream->scissor.scratch[i], perPrimitive, box, pieces );
+            if( written > 0 ) AppendVertices( buffer, pieces, written );
+        }
+
+    // The draw was extended or pushed for these vertices, drop it when nothing is left
+    last->params.draw.count += buffer->vertexCount - first - count;
+    if( 0 == last->params.draw.count ) --buffer->commandCount;
+}
+
+// FLAG_LAYERED_DEPTH: move the primitives just recorded at the end of the buffer to a draw of their class. Solid
+// colors at full alpha through the default program hide what is behind them, unless a clip shape is involved
+static void
+ClassifyRecordedVertices( RecordStream * stream, const RenderVertex * vertices, int count )
+{
+    CommandBuffer * buffer = stream->recording;
+    RenderCommand * last   = ( buffer->commandCount > 0 ) ? &buffer->commands[buffer->commandCount - 1] : NULL;
+    if( NULL == last || RENDER_COMMAND_DRAW != last->type
+        || vertices + count != buffer->vertices + buffer->vertexCount )
+        {
+            return;
+        }
+
+    bool opaque = 0 == buffer->shader && buffer->texture.white && 0 == stream->scissor.shapes;
+    for( int i = 0; opaque && i < count; ++i )
+        {
+            opaque = 255 == vertices[i].a && buffer->texture.u == vertices[i].u && buffer->texture.v == vertices[i].v
+                  && buffer->texture.layer == vertices[i].layer;
+        }
+
+    if( (int)opaque == last->params.draw.opaque ) return;
+    if( last->params.draw.count == count )
+        {
+            last->params.draw.opaque = opaque;
+            return;
+        }
+
+    const int          mode    = last->params.draw.mode;
+    const unsigned int texture = last->params.draw.texture;
+    last->params.draw.count -= count;
+
+    RenderCommand * command = PushCommand( buffer, RENDER_COMMAND_DRAW );
+    if( NULL == command )
+        {
+            buffer->commands[buffer->commandCount - 1].params.draw.count += count;
+            return;
+        }
+
+    command->params.draw.mode    = mode;
+    command->params.draw.first   = buffer->vertexCount - count;
+    command->params.draw.count   = count;
+    command->params.draw.texture = texture;
+    command->params.draw.opaque  = opaque;
+}
+
+// The recorded frame becomes the executing one, callers ensure the previous frame is done and the producers are
+// done recording. Streams that recorded nothing are released, threads caching them see the renewed serial
+static void
+FlipRecordStreams( RenderContext * render )
+{
+    leMutexLock( &render->streamLock );
+
+    RecordStream * previous = NULL;
+    RecordStream * stream   = render->streams;
+    bool           released = false;
+    while( NULL != stream )
+        {
+            RecordStream * next = stream->next;
+            if( 0 == stream->recording->commandCount )
+                {
+                    if( NULL == previous )
+                        {
+                            leAtomicStorePtr( &render->streams, next );
+                        }
+                    else
+                        {
+                            leAtomicStorePtr( &previous->next, next );
+                        }
+                    if( render->streamsTail == stream ) render->streamsTail = previous;
+
+                    FreeRecordStream( stream );
+                    released = true;
+                    stream   = next;
+                    continue;
+                }
+
+            CommandBuffer * executed = stream->executing;
+            stream->executing        = stream->recording;
+            stream->recording        = executed;
+            ResetCommandBuffer( stream->recording, stream->layer );
+            ResetTransform( stream );
+
+            previous = stream;
+            stream   = next;
+        }
+    if( released ) render->serial = (unsigned long)leAtomicAdd( &rendererSerial, 1 ) + 1;
+
+    leMutexUnlock( &render->streamLock );
+}
+
+static int
+CompareMergeEntries( const void * a, const void * b )
+{
+    const MergeEntry * left  = (const MergeEntry *)a;
+    const MergeEntry * right = (const MergeEntry *)b;
+
+    if( left->layer != right->layer ) return ( left->layer < right->layer ) ? -1 : 1;
+    if( left->order != right->order ) return ( left->order < right->order ) ? -1 : 1;
+    return ( left->segment < right->segment ) ? -1 : ( left->segment > right->segment );
+}
+
+// Order every non-empty segment of the executing frame, returns the entry count
+static int
+MergeRecordStreams( RenderContext * render )
+{
+    int count = 0;
+
+    for( RecordStream * stream = FirstStream( render ); NULL != stream; stream = NextStream( stream ) )
+        {
+            const CommandBuffer * buffer = stream->executing;
+
+            for( int i = 0; i < buffer->segmentCount; ++i )
+                {
+                    if( GetSegmentEnd( buffer, i ) == buffer->segments[i].firstCommand ) continue;
+
+                    if( !ReserveArray( (void **)&render->merge, &render->mergeCapacity, count + 1,
+                                       sizeof( MergeEntry ), 16, MEMORY_COMMAND_BUFFERS ) )
+                        {
+                            return count;
+                        }
+
+                    render->merge[count].buffer  = buffer;
+                    render->merge[count].layer   = buffer->segments[i].layer;
+                    render->merge[count].order   = stream->order;
+                    render->merge[count].segment = i;
+                    render->merge[count].depth   = 0;
+                    ++count;
+                }
+        }
+
+    if( count > 1 ) qsort( render->merge, (size_t)count, sizeof( MergeEntry ), CompareMergeEntries );
+
+    return count;
+}
+
+static int
+GetUniformSize( int uniformType )
+{
+    switch( uniformType )
+        {
+        case SHADER_UNIFORM_VEC2:
+        case SHADER_UNIFORM_IVEC2: return 2 * 4;
+        case SHADER_UNIFORM_VEC3:
+        case SHADER_UNIFORM_IVEC3: return 3 * 4;
+        case SHADER_UNIFORM_VEC4:
+        case SHADER_UNIFORM_IVEC4: return 4 * 4;
+        default:                   return 4;
+        }
+}
+
+// Orthographic projection mapping pixels to clip space, origin at the top-left, after the camera `view`.
+// Vertices sit at z = 0, they all land on `depth`
+static Matrix
+GetScreenProjection( Dimension screen, Matrix2D view, float depth )
+{
+    const float width  = ( screen.width > 0 ) ? (float)screen.width : 1.0F;
+    const float height = ( screen.height > 0 ) ? (float)screen.height : 1.0F;
+
+    const Matrix projection = MatrixOrtho( 0.0F, width, height, 0.0F, -1.0F, 1.0F );
+    Matrix       mvp        = MatrixMultiply( projection, MatrixFromMatrix2D( view ) );
+    mvp.m14                 = depth;
+
+    return mvp;
+}
+
+static void
+SetScreenProjection( int mvpLocation, Dimension screen, Matrix2D view, float depth )
+{
+    if( mvpLocation < 0 ) return;
+
+    const Matrix mvp = GetScreenProjection( screen, view, depth );
+    leSetUniformMatrix( mvpLocation, &mvp.m0 );
+}
+
+// Describe RenderVertex for the bound vertex buffer, the first vertex starting at byte `offset`
+static void
+SetVertexLayout( int offset )
+{
+    leSetVertexAttribute( LE_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION, 2, LE_FLOAT, false, sizeof( RenderVertex ),
+                          offset + (int)offsetof( RenderVertex, x ) );
+    leEnableVertexAttribute( LE_DEFAULT_SHADER_ATTRIB_LOCATION_POSITION );
+    leSetVertexAttribute( LE_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR, 4, LE_UNSIGNED_BYTE, true, sizeof( RenderVertex ),
+                          offset + (int)offsetof( RenderVertex, r ) );
+    leEnableVertexAttribute( LE_DEFAULT_SHADER_ATTRIB_LOCATION_COLOR );
+    leSetVertexAttribute( LE_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD, 2, LE_FLOAT, false, sizeof( RenderVertex ),
+                          offset + (int)offsetof( RenderVertex, u ) );
+    leEnableVertexAttribute( LE_DEFAULT_SHADER_ATTRIB_LOCATION_TEXCOORD );
+    leSetVertexAttribute( LE_DEFAULT_SHADER_ATTRIB_LOCATION_LAYER, 1, LE_FLOAT, false, sizeof( RenderVertex ),
+                          offset + (int)offsetof( RenderVertex, layer ) );
+    leEnableVertexAttribute( LE_DEFAULT_SHADER_ATTRIB_LOCATION_LAYER );
+}
+
+static void
+EnableVertexLayout( void )
+{
+    RenderContext * render = GetCurrentRender();
+
+    if( leEnableVertexArray( render->vaoId ) ) return;
+
+    // No VAO support, describe the attributes on every use
+    leEnableVertexBuffer( render->vboId );
+    SetVertexLayout( 0 );
+}
+
+// Static 0, 1, 2, 0, 2, 3 pattern of LE_RENDER_BATCH_QUADS quads, bound to the current vertex array
+static unsigned int
+LoadQuadIndexBuffer( void )
+{
+    const int        count   = LE_RENDER_BATCH_QUADS * 6;
+    unsigned short * indices = (unsigned short *)LE_MALLOC( (size_t)count * sizeof( unsigned short ) );
+    if( NULL == indices )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: Failed to allocate %d quad indices", count );
+            return 0;
+        }
+
+    for( int i = 0; i < LE_RENDER_BATCH_QUADS; ++i )
+        {
+            const unsigned short first = (unsigned short)( i * 4 );
+            unsigned short *     quad  = &indices[i * 6];
+
+            quad[0] = first;
+            quad[1] = (unsigned short)( first + 1 );
+            quad[2] = (unsigned short)( first + 2 );
+            quad[3] = first;
+            quad[4] = (unsigned short)( first + 2 );
+            quad[5] = (unsigned short)( first + 3 );
+        }
+
+    const unsigned int id = leLoadIndexBuffer( indices, count * (int)sizeof( unsigned short ) );
+    LE_FREE( indices );
+    return id;
+}
+
+// Describe RenderLine for the bound line buffer, one instance per segment starting at byte `offset`
+static void
+SetLineLayout( int offset )
+{
+    leSetVertexAttribute( 0, 4, LE_FLOAT, false, sizeof( RenderLine ), offset + (int)offsetof( RenderLine, x0 ) );
+    leSetVertexAttribute( 1, 4, LE_FLOAT, false, sizeof( RenderLine ), offset + (int)offsetof( RenderLine, prevX ) );
+    leSetVertexAttribute( 2, 4, LE_UNSIGNED_BYTE, true, sizeof( RenderLine ), offset + (int)offsetof( RenderLine, r ) );
+    leSetVertexAttribute( 3, 2, LE_FLOAT, false, sizeof( RenderLine ),
+                          offset + (int)offsetof( RenderLine, halfWidth ) );
+}
+
+// Draw `count` segments of the line upload with the line program, then restore the vertex layout
+static void
+DrawLineInstances( const RenderContext * render, int first, int count, Dimension viewport, Matrix2D view,
+                   float depth )
+{
+    if( 0 == render->lines.shaderId || !leEnableVertexArray( render->lines.vaoId ) ) return;
+
+    const float size[2] = { (float)viewport.width, (float)viewport.height };
+    leEnableShader( render->lines.shaderId );
+    SetScreenProjection( render->lines.mvpLocation, render->screen, view, depth );
+    leSetUniform( render->lines.viewportLocation, size, LE_SHADER_UNIFORM_VEC2, 1 );
+
+    // Base instances need GL 4.2, the attributes start at the first segment instead
+    leEnableVertexBuffer( render->lines.vboId );
+    SetLineLayout( first * (int)sizeof( RenderLine ) );
+    leDrawVertexArrayInstanced( LE_TRIANGLES, 0, LE_LINE_INSTANCE_VERTICES, count );
+
+    EnableVertexLayout();
+}
+
+// Back to the scissor of the whole frame, if any
+static void
+RestoreFrameScissor( const RenderContext * render )
+{
+    if( render->frameScissor.enabled )
+        {
+            leEnableScissorTest( render->frameScissor.x, render->frameScissor.y, render->frameScissor.width,
+                                 render->frameScissor.height );
+        }
+    else
+        {
+            leDisableScissorTest();
+        }
+}
+
+// Scissor to a clip area in screen pixels, inside the frame scissor
+static void
+SetClipScissor( const RenderContext * render, Dimension viewport, const RenderCommand * command )
+{
+    if( command->params.scissor.minX > command->params.scissor.maxX )
+        {
+            RestoreFrameScissor( render );
+            return;
+        }
+
+    // Dynamic resolution draws the screen into a smaller corner of the framebuffer
+    const float scaleX = (float)viewport.width / (float)( ( render->screen.width > 0 ) ? render->screen.width : 1 );
+    const float scaleY = (float)viewport.height / (float)( ( render->screen.height > 0 ) ? render->screen.height : 1 );
+
+    // GL rectangles start at the bottom-left
+    int left   = (int)floorf( command->params.scissor.minX * scaleX );
+    int right  = (int)ceilf( command->params.scissor.maxX * scaleX );
+    int bottom = (int)viewport.height - (int)ceilf( command->params.scissor.maxY * scaleY );
+    int top    = (int)viewport.height - (int)floorf( command->params.scissor.minY * scaleY );
+
+    if( render->frameScissor.enabled )
+        {
+            left   = ( left > render->frameScissor.x ) ? left : render->frameScissor.x;
+            bottom = ( bottom > render->frameScissor.y ) ? bottom : render->frameScissor.y;
+            right  = ( right < render->frameScissor.x + render->frameScissor.width )
+                       ? right
+                       : render->frameScissor.x + render->frameScissor.width;
+            top    = ( top < render->frameScissor.y + render->frameScissor.height )
+                       ? top
+                       : render->frameScissor.y + render->frameScissor.height;
+        }
+
+    leEnableScissorTest( left, bottom, ( right > left ) ? right - left : 0, ( top > bottom ) ? top - bottom : 0 );
+}
+
+static void
+SetStencilMode( int mode, int level )
+{
+    const bool color = ( STENCIL_TEST == mode );
+    leColorMask( color, color, color, color );
+
+    switch( mode )
+        {
+        case STENCIL_WRITE: leEnableStencilTest( LE_EQUAL, level - 1, LE_INCR ); break;
+        case STENCIL_RESET: leEnableStencilTest( LE_LESS, level, LE_REPLACE ); break;
+        default:
+            if( level > 0 )
+                {
+                    leEnableStencilTest( LE_EQUAL, level, LE_KEEP );
+                }
+            else
+                {
+                    leDisableStencilTest();
+                }
+            break;
+        }
+}
+
+// FLAG_LAYERED_DEPTH depth of the draw command at `index` in merged order, later ones nearer
+static float
+GetCommandDepth( const RenderContext * render, int index )
+{
+    return 1.0F - 2.0F * (float)( index + 1 ) / (float)( render->depth.total + 1 );
+}
+
+// Bind `bufferId` as the index buffer of the vertex array
+static void
+BindIndexBuffer( RenderContext * render, unsigned int bufferId )
+{
+    if( bufferId == render->execution.indexBufferId ) return;
+
+    leEnableIndexBuffer( bufferId );
+    render->execution.indexBufferId = bufferId;
+}
+
+// Indexed draws a draw command becomes, quads are split where the quad index buffer ends
+static INLINE int
+GetDrawParts( const RenderCommand * command )
+{
+    if( LE_QUADS != command->params.draw.mode ) return 1;
+
+    return ( command->params.draw.count / 4 + LE_RENDER_BATCH_QUADS - 1 ) / LE_RENDER_BATCH_QUADS;
+}
+
+// Quads of the part of a quad draw `offset` vertices in, at most what the quad index buffer covers
+static INLINE int
+GetPartQuads( int count, int offset )
+{
+    const int vertices = count - offset;
+    return ( ( vertices < LE_RENDER_BATCH_QUADS * 4 ) ? vertices : LE_RENDER_BATCH_QUADS * 4 ) / 4;
+}
+
+// Draw `count` vertices of quads from vertex `first` as triangles indexed by the quad index buffer
+static void
+DrawQuads( RenderContext * render, int first, int count )
+{
+    if( 0 == render->quadIndexBufferId ) return;
+
+    BindIndexBuffer( render, render->quadIndexBufferId );
+    for( int offset = 0; offset < count; offset += LE_RENDER_BATCH_QUADS * 4 )
+        {
+            const int quads = GetPartQuads( count, offset );
+#if LE_BASE_VERTEX
+            leDrawElementsBaseVertex( LE_TRIANGLES, quads * 6, LE_UNSIGNED_SHORT, 0, first + offset );
+#else
+            // Base vertices need GL 3.2, the attributes start at the first vertex instead
+            leEnableVertexBuffer( render->vboId );
+            SetVertexLayout( ( first + offset ) * (int)sizeof( RenderVertex ) );
+            leDrawElements( LE_TRIANGLES, quads * 6, LE_UNSIGNED_SHORT, 0 );
+#endif
+        }
+
+#if !LE_BASE_VERTEX
+    SetVertexLayout( 0 );
+#endif
+}
+
+// Submit the queued draws as one multi-draw
+static void
+FlushDraws( RenderContext * render )
+{
+    if( 0 == render->execution.pending ) return;
+
+    // Quads read the quad pattern, the other modes the 0, 1, 2... indices
+    const bool quads = LE_QUADS == render->execution.mode;
+    BindIndexBuffer( render, quads ? render->quadIndexBufferId : render->indirect.indexBufferId );
+    leMultiDrawIndirect( quads ? LE_TRIANGLES : render->execution.mode, quads ? LE_UNSIGNED_SHORT : LE_UNSIGNED_INT,
+                         render->execution.first * (int)sizeof( IndirectDraw ), render->execution.pending );
+    render->execution.pending = 0;
+}
+
+// Bind `texture` for the next draws, submitting the queued ones first
+static void
+BindDrawTexture( RenderContext * render, unsigned int texture )
+{
+    if( texture == render->execution.textureId ) return;
+
+    FlushDraws( render );
+    leEnableTexture( texture );
+    render->execution.textureId = texture;
+}
+
+// Replay one segment from the default state, so producers never inherit each other's shader. Layered passes only
+// draw their share of the commands, each at its own depth
+static void
+ExecuteSegment( RenderContext * render, const MergeEntry * entry, Dimension viewport )
+{
+    const CommandBuffer * buffer = entry->buffer;
+    const int             first  = buffer->segments[entry->segment].firstCommand;
+    const int             end    = GetSegmentEnd( buffer, entry->segment );
+    const int             pass   = render->depth.pass;
+
+    // The state the last segment left is kept when it is the default one, queued draws keep going
+    if( render->execution.dirty || RENDER_PASS_ALL != pass )
+        {
+            FlushDraws( render );
+            render->execution.shaderId    = render->defaultShaderId;
+            render->execution.mvpLocation = render->defaultMvpLocation;
+            render->execution.view        = Matrix2DIdentity();
+            render->execution.dirty       = false;
+            leEnableShader( render->execution.shaderId );
+            SetScreenProjection( render->execution.mvpLocation, render->screen, render->execution.view, 0.0F );
+        }
+
+    bool scissored  = false;
+    bool stenciled  = false;
+    int  depthIndex = entry->depth;
+
+    for( int i = first; i < end; ++i )
+        {
+            const RenderCommand * command = &buffer->commands[i];
+            if( RENDER_COMMAND_DRAW != command->type ) FlushDraws( render );
+
+            switch( command->type )
+                {
+                case RENDER_COMMAND_CLEAR:
+                    {
+                        // Layered passes apply the last clear before them
+                        if( RENDER_PASS_ALL != pass ) break;
+
+                        leClearColor( command->params.clear.r, command->params.clear.g, command->params.clear.b,
+                                      command->params.clear.a );
+                        leClearScreenBuffers();
+                    }
+                    break;
+
+                case RENDER_COMMAND_DRAW:
+                    {
+                        const int index = depthIndex++;
+                        if( RENDER_PASS_ALL != pass )
+                            {
+                                const bool opaque = ( 0 != command->params.draw.opaque );
+                                if( opaque != ( RENDER_PASS_OPAQUE == pass ) || i < render->depth.firstCommand ) break;
+
+                                SetScreenProjection( render->execution.mvpLocation, render->screen,
+                                                     render->execution.view, GetCommandDepth( render, index ) );
+                            }
+
+                        BindDrawTexture( render, ( 0 != command->params.draw.texture ) ? command->params.draw.texture
+                                                                                       : render->whiteTextureId );
+
+                        if( !render->execution.indirect || RENDER_PASS_ALL != pass )
+                            {
+                                const int firstVertex = buffer->baseVertex + command->params.draw.first;
+                                if( LE_QUADS == command->params.draw.mode )
+                                    {
+                                        DrawQuads( render, firstVertex, command->params.draw.count );
+                                    }
+                                else
+                                    {
+                                        leDrawVertexArray( command->params.draw.mode, firstVertex,
+                                                           command->params.draw.count );
+                                    }
+                                break;
+                            }
+
+                        // Draws keep their merged order in the indirect buffer, a queue is always a contiguous run
+                        const int draw  = render->execution.nextDraw;
+                        const int parts = GetDrawParts( command );
+                        render->execution.nextDraw += parts;
+                        if( render->execution.pending > 0 && command->params.draw.mode != render->execution.mode )
+                            {
+                                FlushDraws( render );
+                            }
+                        if( 0 == render->execution.pending )
+                            {
+                                render->execution.mode  = command->params.draw.mode;
+                                render->execution.first = draw;
+                            }
+                        render->execution.pending += parts;
+                    }
+                    break;
+
+                case RENDER_COMMAND_SHADER:
+                    {
+                        render->execution.shaderId    = command->params.shader.id;
+                        render->execution.mvpLocation = command->params.shader.mvpLocation;
+                        render->execution.dirty       = true;
+                        leEnableShader( render->execution.shaderId );
+                        SetScreenProjection( render->execution.mvpLocation, render->screen, render->execution.view,
+                                             0.0F );
+                    }
+                    break;
+
+                case RENDER_COMMAND_VIEW:
+                    {
+                        render->execution.view  = command->params.view;
+                        render->execution.dirty = true;
+                        SetScreenProjection( render->execution.mvpLocation, render->screen, render->execution.view,
+                                             0.0F );
+                    }
+                    break;
+
+                case RENDER_COMMAND_LINES:
+                    {
+                        // Faded edges always blend
+                        const int index = depthIndex++;
+                        float     depth = 0.0F;
+                        if( RENDER_PASS_ALL != pass )
+                            {
+                                if( RENDER_PASS_OPAQUE == pass || i < render->depth.firstCommand ) break;
+                                depth = GetCommandDepth( render, index );
+                            }
+
+                        DrawLineInstances( render, buffer->baseLine + command->params.lines.first,
+                                           command->params.lines.count, viewport, render->execution.view, depth );
+                        leEnableShader( render->execution.shaderId );
+                    }
+                    break;
+
+                case RENDER_COMMAND_SCISSOR:
+                    {
+                        SetClipScissor( render, viewport, command );
+                        scissored = true;
+                    }
+                    break;
+
+                case RENDER_COMMAND_STENCIL:
+                    {
+                        SetStencilMode( command->params.stencil.mode, command->params.stencil.level );
+                        stenciled = true;
+
+                        // Shapes mark the stencil whatever is in front of them
+                        if( RENDER_PASS_ALL == pass ) break;
+                        if( STENCIL_TEST == command->params.stencil.mode )
+                            {
+                                leEnableDepthTest( LE_LEQUAL );
+                            }
+                        else
+                            {
+                                leDisableDepthTest();
+                            }
+                    }
+                    break;
+
+                case RENDER_COMMAND_CALLBACK:
+                    {
+                        // Work that draws nothing runs once, with the translucent draws
+                        float depth = 0.0F;
+                        if( command->params.callback.draws )
+                            {
+                                const int index = depthIndex++;
+                                if( RENDER_PASS_ALL != pass )
+                                    {
+                                        if( RENDER_PASS_OPAQUE == pass || i < render->depth.firstCommand ) break;
+                                        depth = GetCommandDepth( render, index );
+                                    }
+                            }
+                        else if( RENDER_PASS_OPAQUE == pass )
+                            {
+                                break;
+                            }
+
+                        const Vector2 size = { (float)viewport.width, (float)viewport.height };
+                        command->params.callback.func( command->params.callback.data,
+                                                       GetScreenProjection( render->screen, render->execution.view,
+                                                                            depth ),
+                                                       size );
+
+                        // Callbacks bind their own program, vertex arrays and buffers
+                        leEnableShader( render->execution.shaderId );
+                        EnableVertexLayout();
+                        render->execution.textureId = 0;
+                        if( render->execution.indirect ) leEnableIndirectBuffer( render->indirect.bufferId );
+                    }
+                    break;
+
+                case RENDER_COMMAND_UNIFORM:
+                    {
+                        // Uniforms belong to a program, bind it only for the update
+                        const unsigned int shaderId = render->execution.shaderId;
+                        if( command->params.uniform.shaderId != shaderId )
+                            leEnableShader( command->params.uniform.shaderId );
+
+                        leSetUniform( command->params.uniform.location, command->params.uniform.value,
+                                      command->params.uniform.uniformType, command->params.uniform.count );
+
+                        if( command->params.uniform.shaderId != shaderId ) leEnableShader( shaderId );
+
+                        // Later segments may use the default program with other values
+                        render->execution.dirty = true;
+                    }
+                    break;
+                }
+        }
+
+    // The next segment may come from another thread, leave the state as it was found
+    if( scissored || stenciled ) FlushDraws( render );
+    if( scissored ) RestoreFrameScissor( render );
+    if( stenciled ) SetStencilMode( STENCIL_TEST, 0 );
+    if( stenciled && RENDER_PASS_ALL != pass ) leEnableDepthTest( LE_LEQUAL );
+}
+
+// Write the draw commands of the merged frame as indexed draws, false when they cannot be drawn that way
+static bool
+BuildIndirectDraws( RenderContext * render, int entries )
+{
+    int count    = 0;
+    int maxCount = 0;
+    for( int e = 0; e < entries; ++e )
+        {
+            const MergeEntry *    entry  = &render->merge[e];
+            const CommandBuffer * buffer = entry->buffer;
+            const int             end    = GetSegmentEnd( buffer, entry->segment );
+
+            for( int i = buffer->segments[entry->segment].firstCommand; i < end; ++i )
+                {
+                    const RenderCommand * command = &buffer->commands[i];
+                    if( RENDER_COMMAND_DRAW != command->type ) continue;
+
+                    const int parts = GetDrawParts( command );
+                    if( !ReserveArray( (void **)&render->indirect.draws, &render->indirect.drawCapacity, count + parts,
+                                       sizeof( IndirectDraw ), 64, MEMORY_COMMAND_BUFFERS ) )
+                        {
+                            return false;
+                        }
+
+                    const int firstVertex = buffer->baseVertex + command->params.draw.first;
+                    if( LE_QUADS != command->params.draw.mode )
+                        {
+                            IndirectDraw * draw = &render->indirect.draws[count++];
+                            draw->count         = (unsigned int)command->params.draw.count;
+                            draw->instanceCount = 1;
+                            draw->firstIndex    = 0;
+                            draw->baseVertex    = firstVertex;
+                            draw->baseInstance  = 0;
+                            if( command->params.draw.count > maxCount ) maxCount = command->params.draw.count;
+                            continue;
+                        }
+
+                    // Every part of a quad draw starts at the beginning of the quad indices
+                    if( 0 == render->quadIndexBufferId ) return false;
+                    for( int offset = 0; offset < command->params.draw.count; offset += LE_RENDER_BATCH_QUADS * 4 )
+                        {
+                            IndirectDraw * draw = &render->indirect.draws[count++];
+                            draw->count         = (unsigned int)GetPartQuads( command->params.draw.count, offset ) * 6;
+                            draw->instanceCount = 1;
+                            draw->firstIndex    = 0;
+                            draw->baseVertex    = firstVertex + offset;
+                            draw->baseInstance  = 0;
+                        }
+                }
+        }
+
+    if( 0 == count ) return false;
+
+    // Every draw reads the indices from the start, the buffer only grows
+    if( maxCount > render->indirect.indexCount )
+        {
+            int indexCount = ( render->indirect.indexCount > 0 ) ? render->indirect.indexCount
+                                                                  : LE_RENDER_BATCH_VERTICES;
+            while( indexCount < maxCount ) indexCount *= 2;
+
+            unsigned int * indices = (unsigned int *)LE_MALLOC( (size_t)indexCount * sizeof( unsigned int ) );
+            if( NULL == indices )
+                {
+                    TRACELOG( LOG_WARNING, "RENDER: Failed to allocate %d draw indices", indexCount );
+                    return false;
+                }
+            for( int i = 0; i < indexCount; ++i ) indices[i] = (unsigned int)i;
+
+            // Bound to the vertex array enabled by the caller
+            if( 0 != render->indirect.indexBufferId ) leUnloadVertexBuffer( render->indirect.indexBufferId );
+            render->indirect.indexBufferId  = leLoadIndexBuffer( indices, indexCount * (int)sizeof( unsigned int ) );
+            render->indirect.indexCount     = indexCount;
+            render->execution.indexBufferId = render->indirect.indexBufferId;
+            LE_FREE( indices );
+        }
+
+    leSetIndirectBufferData( render->indirect.bufferId, render->indirect.draws, count * (int)sizeof( IndirectDraw ) );
+    return true;
+}
+
+// FLAG_LAYERED_DEPTH: number the draw commands in merged order, apply the last clear, then replay the opaque draws
+// front to back and the others back to front
+static void
+ExecuteLayeredFrame( RenderContext * render, int entries, Dimension viewport )
+{
+    int total        = 0;
+    int clearEntry   = 0;
+    int clearCommand = -1;
+    for( int e = 0; e < entries; ++e )
+        {
+            MergeEntry *          entry  = &render->merge[e];
+            const CommandBuffer * buffer = entry->buffer;
+            const int             end    = GetSegmentEnd( buffer, entry->segment );
+
+            entry->depth = total;
+            for( int i = buffer->segments[entry->segment].firstCommand; i < end; ++i )
+                {
+                    const RenderCommandType type = buffer->commands[i].type;
+                    if( RENDER_COMMAND_DRAW == type || RENDER_COMMAND_LINES == type
+                        || ( RENDER_COMMAND_CALLBACK == type && buffer->commands[i].params.callback.draws ) )
+                        {
+                            ++total;
+                        }
+                    else if( RENDER_COMMAND_CLEAR == type )
+                        {
+                            clearEntry   = e;
+                            clearCommand = i;
+                        }
+                }
+        }
+    render->depth.total = total;
+
+    // Without a clear the frame draws over the last one, only the depths go
+    if( clearCommand >= 0 )
+        {
+            const RenderCommand * clear = &render->merge[clearEntry].buffer->commands[clearCommand];
+            leClearColor( clear->params.clear.r, clear->params.clear.g, clear->params.clear.b, clear->params.clear.a );
+            leClearScreenBuffers();
+        }
+    else
+        {
+            leClear( LE_DEPTH_BUFFER_BIT );
+        }
+
+    // Nearest first, the depth they write rejects the hidden fragments of the ones behind
+    leEnableDepthTest( LE_LEQUAL );
+    leDisableColorBlend();
+    render->depth.pass = RENDER_PASS_OPAQUE;
+    for( int e = entries - 1; e >= clearEntry; --e )
+        {
+            render->depth.firstCommand = ( e == clearEntry ) ? clearCommand + 1 : 0;
+            ExecuteSegment( render, &render->merge[e], viewport );
+        }
+
+    leDepthMask( false );
+    leEnableColorBlend();
+    render->depth.pass = RENDER_PASS_TRANSLUCENT;
+    for( int e = clearEntry; e < entries; ++e )
+        {
+            render->depth.firstCommand = ( e == clearEntry ) ? clearCommand + 1 : 0;
+            ExecuteSegment( render, &render->merge[e], viewport );
+        }
+
+    // Depth writes also gate depth clears
+    leDepthMask( true );
+    leDisableDepthTest();
+    render->depth.pass = RENDER_PASS_ALL;
+}
+
+// Replay the executing frame of every stream in merged order into `viewport`, where the GL context is current
+static void
+ExecuteFrame( RenderContext * render, Dimension viewport )
+{
+    LE_PROFILE_BEGIN( "DrawRenderBatch" );
+
+    leViewport( 0, 0, (int)viewport.width, (int)viewport.height );
+
+    // Streams are uploaded back to back into one orphaned buffer
+    int vertexCount = 0;
+    for( RecordStream * stream = FirstStream( render ); NULL != stream; stream = NextStream( stream ) )
+        {
+            stream->executing->baseVertex = vertexCount;
+            vertexCount += stream->executing->vertexCount;
+        }
+
+    if( vertexCount > 0 )
+        {
+            leSetVertexBufferData( render->vboId, NULL, vertexCount * (int)sizeof( RenderVertex ) );
+
+            for( RecordStream * stream = FirstStream( render ); NULL != stream; stream = NextStream( stream ) )
+                {
+                    const CommandBuffer * buffer = stream->executing;
+                    if( 0 == buffer->vertexCount ) continue;
+
+                    leUpdateVertexBufferData( buffer->vertices, buffer->vertexCount * (int)sizeof( RenderVertex ),
+                                              buffer->baseVertex * (int)sizeof( RenderVertex ) );
+                }
+        }
+
+    int lineCount = 0;
+    for( RecordStream * stream = FirstStream( render ); NULL != stream; stream = NextStream( stream ) )
+        {
+            stream->executing->baseLine = lineCount;
+            lineCount += stream->executing->lineCount;
+        }
+
+    if( lineCount > 0 )
+        {
+            leSetVertexBufferData( render->lines.vboId, NULL, lineCount * (int)sizeof( RenderLine ) );
+
+            for( RecordStream * stream = FirstStream( render ); NULL != stream; stream = NextStream( stream ) )
+                {
+                    const CommandBuffer * buffer = stream->executing;
+                    if( 0 == buffer->lineCount ) continue;
+
+                    leUpdateVertexBufferData( buffer->lines, buffer->lineCount * (int)sizeof( RenderLine ),
+                                              buffer->baseLine * (int)sizeof( RenderLine ) );
+                }
+        }
+
+    EnableVertexLayout();
+
+    render->execution.dirty     = true;
+    render->execution.indirect  = false;
+    render->execution.textureId = 0;
+    render->execution.nextDraw  = 0;
+    render->execution.pending   = 0;
+
+    const int entries = MergeRecordStreams( render );
+    if( FLAG_CHECK( render->flags, FLAG_LAYERED_DEPTH ) )
+        {
+            ExecuteLayeredFrame( render, entries, viewport );
+        }
+    else
+        {
+            render->execution.indirect = 0 != render->indirect.bufferId && BuildIndirectDraws( render, entries );
+            for( int i = 0; i < entries; ++i ) ExecuteSegment( render, &render->merge[i], viewport );
+            FlushDraws( render );
+        }
+
+    leDisableVertexArray();
+
+    LE_PROFILE_END();
+}
+
+// Mix `size` bytes into `hash`, eight at a time
+static unsigned long long
+HashBytes( unsigned long long hash, const void * data, size_t size )
+{
+    const unsigned char * bytes = (const unsigned char *)data;
+
+    for( ; size >= 8; size -= 8, bytes += 8 )
+        {
+            unsigned long long word;
+            memcpy( &word, bytes, sizeof( word ) );
+            hash = ( hash ^ word ) * 0x100000001B3ULL;
+            hash ^= hash >> 29;
+        }
+
+    for( ; size > 0; --size ) hash = ( hash ^ *bytes++ ) * 0x100000001B3ULL;
+
+    return hash;
+}
+
+// Hash of everything the executing frame draws, equal hashes draw equal images
+static unsigned long long
+HashFrame( RenderContext * render )
+{
+    unsigned long long hash = 0xCBF29CE484222325ULL;
+    hash                    = HashBytes( hash, &render->screen, sizeof( render->screen ) );
+    if( render->damage.frameEnabled ) hash = HashBytes( hash, &render->damage.frame, sizeof( DamageArea ) );
+
+    for( RecordStream * stream = FirstStream( render ); NULL != stream; stream = NextStream( stream ) )
+        {
+            const CommandBuffer * buffer = stream->executing;
+
+            for( int i = 0; i < buffer->segmentCount; ++i )
+                {
+                    const RenderSegment * segment = &buffer->segments[i];
+                    const int             key[3]  = { segment->layer, segment->firstCommand, stream->order };
+                    hash                          = HashBytes( hash, key, sizeof( key ) );
+                }
+
+            // Field by field, uniform values live behind a pointer
+            for( int i = 0; i < buffer->commandCount; ++i )
+                {
+                    const RenderCommand * command = &buffer->commands[i];
+                    hash                          = HashBytes( hash, &command->type, sizeof( command->type ) );
+
+                    switch( command->type )
+                        {
+                        case RENDER_COMMAND_CLEAR:
+                            hash = HashBytes( hash, &command->params.clear, sizeof( command->params.clear ) );
+                            break;
+                        case RENDER_COMMAND_DRAW:
+                            hash = HashBytes( hash, &command->params.draw, sizeof( command->params.draw ) );
+                            break;
+                        case RENDER_COMMAND_SHADER:
+                            hash = HashBytes( hash, &command->params.shader, sizeof( command->params.shader ) );
+                            break;
+                        case RENDER_COMMAND_UNIFORM:
+                            {
+                                const int uniform[4] = { (int)command->params.uniform.shaderId,
+                                                         command->params.uniform.location,
+                                                         command->params.uniform.uniformType,
+                                                         command->params.uniform.count };
+                                const size_t size    = (size_t)GetUniformSize( uniform[2] ) * (size_t)uniform[3];
+                                hash                 = HashBytes( hash, uniform, sizeof( uniform ) );
+                                hash                 = HashBytes( hash, command->params.uniform.value, size );
+                            }
+                            break;
+                        case RENDER_COMMAND_VIEW:
+                            hash = HashBytes( hash, &command->params.view, sizeof( command->params.view ) );
+                            break;
+                        case RENDER_COMMAND_LINES:
+                            hash = HashBytes( hash, &command->params.lines, sizeof( command->params.lines ) );
+                            break;
+                        case RENDER_COMMAND_SCISSOR:
+                            hash = HashBytes( hash, &command->params.scissor, sizeof( command->params.scissor ) );
+                            break;
+                        case RENDER_COMMAND_STENCIL:
+                            hash = HashBytes( hash, &command->params.stencil, sizeof( command->params.stencil ) );
+                            break;
+                        case RENDER_COMMAND_CALLBACK:
+                            {
+                                const RenderCallbackFunc func = command->params.callback.func;
+                                hash = HashBytes( hash, &func, sizeof( func ) );
+                                hash = HashBytes( hash, command->params.callback.data, command->params.callback.size );
+                            }
+                            break;
+                        }
+                }
+
+            hash = HashBytes( hash, buffer->vertices, (size_t)buffer->vertexCount * sizeof( RenderVertex ) );
+            hash = HashBytes( hash, buffer->lines, (size_t)buffer->lineCount * sizeof( RenderLine ) );
+        }
+
+    return hash;
+}
+
+static INLINE DamageArea
+EmptyDamage( void )
+{
+    DamageArea area = { FLT_MAX, FLT_MAX, -FLT_MAX, -FLT_MAX };
+    return area;
+}
+
+// Hand the damage recorded so far to the frame about to execute
+static void
+TakeFrameDamage( RenderContext * render )
+{
+    leMutexLock( &render->damage.lock );
+    render->damage.frame        = render->damage.pending;
+    render->damage.frameEnabled = render->damage.enabled;
+    render->damage.pending      = EmptyDamage();
+    leMutexUnlock( &render->damage.lock );
+}
+
+// (Re)create the copy of the presented image at the screen size, false when it cannot be kept
+static bool
+PrepareDamageFramebuffer( RenderContext * render )
+{
+    if( !leAtomicLoad( &render->damage.partial ) ) return false;
+
+    if( 0 != render->damage.framebufferId && render->damage.framebufferSize.width == render->screen.width
+        && render->damage.framebufferSize.height == render->screen.height )
+        {
+            return true;
+        }
+
+    if( 0 != render->damage.framebufferId )
+        {
+            leUnloadFramebuffer( render->damage.framebufferId, render->damage.textureId );
+            render->damage.framebufferId = 0;
+        }
+
+    render->damage.framebufferId   = leLoadFramebuffer( (int)render->screen.width, (int)render->screen.height,
+                                                        &render->damage.textureId );
+    render->damage.framebufferSize = render->screen;
+
+    if( 0 == render->damage.framebufferId )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: Partial redraw unavailable, redrawing whole frames" );
+            leAtomicStore( &render->damage.partial, 0L );
+            return false;
+        }
+
+    return true;
+}
+
+// (Re)create the screen sized target and the timers of dynamic resolution, false when unsupported
+static bool
+PrepareResolutionTarget( RenderContext * render )
+{
+    if( render->resolution.unsupported ) return false;
+
+    if( 0 == render->resolution.queries[0] )
+        {
+            for( int i = 0; i < LE_RESOLUTION_QUERIES; ++i ) render->resolution.queries[i] = leLoadTimerQuery();
+        }
+
+    if( 0 != render->resolution.framebufferId && render->resolution.framebufferSize.width == render->screen.width
+        && render->resolution.framebufferSize.height == render->screen.height )
+        {
+            return true;
+        }
+
+    if( 0 != render->resolution.framebufferId )
+        {
+            leUnloadFramebuffer( render->resolution.framebufferId, render->resolution.textureId );
+            render->resolution.framebufferId = 0;
+        }
+
+    if( 0 != render->resolution.queries[0] )
+        {
+            render->resolution.framebufferId   = leLoadFramebuffer( (int)render->screen.width,
+                                                                    (int)render->screen.height,
+                                                                    &render->resolution.textureId );
+            render->resolution.framebufferSize = render->screen;
+        }
+
+    // Blits and timer queries come together with GL 3.3
+    if( 0 == render->resolution.framebufferId || !leBlitFramebuffer( 0, 0, 0, 0, 0 ) )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: Dynamic resolution unavailable, drawing at full size" );
+            render->resolution.unsupported = true;
+            return false;
+        }
+
+    return true;
+}
+
+// Fold finished timers into the average, moving the scale once enough frames were timed
+static void
+UpdateResolutionScale( RenderContext * render )
+{
+    while( render->resolution.read < render->resolution.issued )
+        {
+            const unsigned int query = render->resolution.queries[render->resolution.read % LE_RESOLUTION_QUERIES];
+
+            double seconds = 0.0;
+            if( !leGetTimerQueryResult( query, &seconds ) ) break;
+
+            render->resolution.gpuTime += seconds;
+            ++render->resolution.samples;
+            ++render->resolution.read;
+        }
+
+    if( render->resolution.samples < LE_RESOLUTION_INTERVAL ) return;
+
+    const double budget  = ( render->frameBudget > 0.0 ) ? render->frameBudget : 1.0 / 60.0;
+    const double average = render->resolution.gpuTime / (double)render->resolution.samples;
+    render->resolution.gpuTime = 0.0;
+    render->resolution.samples = 0;
+
+    // GPU time follows the pixel count, the square of the scale. Steps are bounded so one slow
+    // frame cannot collapse the resolution and recovery stays gradual
+    float factor = ( average > 0.0 ) ? sqrtf( (float)( 0.8 * budget / average ) ) : 2.0F;
+    factor       = fminf( fmaxf( factor, 0.75F ), 1.1F );
+
+    const float scale = (float)leAtomicLoad( &render->resolution.scale ) * 0.001F;
+    const float next  = fminf( fmaxf( scale * factor, LE_RESOLUTION_MIN_SCALE ), 1.0F );
+
+    // Small corrections would only shimmer
+    if( fabsf( next - scale ) >= 0.02F || ( 1.0F == next && scale < 1.0F ) )
+        {
+            leAtomicStore( &render->resolution.scale, (long)( next * 1000.0F + 0.5F ) );
+        }
+}
+
+// Draw the frame at the current scale and stretch it to the window, false when unsupported
+static bool
+PresentScaledFrame( RenderContext * render )
+{
+    if( !PrepareResolutionTarget( render ) ) return false;
+
+    const float scale    = (float)leAtomicLoad( &render->resolution.scale ) * 0.001F;
+    Dimension   viewport = { (unsigned int)( (float)render->screen.width * scale + 0.5F ),
+                             (unsigned int)( (float)render->screen.height * scale + 0.5F ) };
+    if( 0 == viewport.width ) viewport.width = 1;
+    if( 0 == viewport.height ) viewport.height = 1;
+
+    // A frame goes untimed while every timer still waits on the GPU
+    const bool         timed = render->resolution.issued - render->resolution.read < LE_RESOLUTION_QUERIES;
+    const unsigned int query = render->resolution.queries[render->resolution.issued % LE_RESOLUTION_QUERIES];
+
+    leEnableFramebuffer( render->resolution.framebufferId );
+    if( timed ) leBeginTimerQuery( query );
+    ExecuteFrame( render, viewport );
+    if( timed )
+        {
+            leEndTimerQuery();
+            ++render->resolution.issued;
+        }
+    leEnableFramebuffer( 0 );
+
+    leBlitFramebuffer( render->resolution.framebufferId, (int)viewport.width, (int)viewport.height,
+                       (int)render->screen.width, (int)render->screen.height );
+    SwapBuffers();
+
+    UpdateResolutionScale( render );
+    return true;
+}
+
+// Execute and present the frame, false when there was nothing to present
+static bool
+PresentFrame( RenderContext * render )
+{
+    // A frame equal to the last one would present the same image
+    if( FLAG_CHECK( render->flags, FLAG_EVENT_DRIVEN ) )
+        {
+            const unsigned long long hash = HashFrame( render );
+            if( hash == render->frameHash ) return false;
+
+            render->frameHash = hash;
+        }
+    else
+        {
+            render->frameHash = 0;
+        }
+
+    if( FLAG_CHECK( render->flags, FLAG_DYNAMIC_RESOLUTION ) && PresentScaledFrame( render ) ) return true;
+
+    if( !render->damage.frameEnabled )
+        {
+            ExecuteFrame( render, render->screen );
+            SwapBuffers();
+            return true;
+        }
+
+    // Nothing changed, the image on screen stays valid
+    const DamageArea damage = render->damage.frame;
+    const float      width  = (float)render->screen.width;
+    const float      height = (float)render->screen.height;
+
+    const int left   = (int)floorf( fmaxf( damage.minX, 0.0F ) );
+    const int top    = (int)floorf( fmaxf( damage.minY, 0.0F ) );
+    const int right  = (int)ceilf( fminf( damage.maxX, width ) );
+    const int bottom = (int)ceilf( fminf( damage.maxY, height ) );
+    if( right <= left || bottom <= top ) return false;
+
+    if( !PrepareDamageFramebuffer( render ) )
+        {
+            ExecuteFrame( render, render->screen );
+            SwapBuffers();
+            return true;
+        }
+
+    // GL rectangles start at the bottom-left
+    const int scissorY = (int)render->screen.height - bottom;
+
+    render->frameScissor.enabled = true;
+    render->frameScissor.x       = left;
+    render->frameScissor.y       = scissorY;
+    render->frameScissor.width   = right - left;
+    render->frameScissor.height  = bottom - top;
+
+    leEnableFramebuffer( render->damage.framebufferId );
+    leEnableScissorTest( left, scissorY, right - left, bottom - top );
+    ExecuteFrame( render, render->screen );
+    leDisableScissorTest();
+    leEnableFramebuffer( 0 );
+
+    render->frameScissor.enabled = false;
+
+    leBlitFramebuffer( render->damage.framebufferId, (int)width, (int)height, (int)width, (int)height );
+    SwapBuffersWithDamage( left, scissorY, right - left, bottom - top );
+
+    return true;
+}
+
+static bool
+IsFencingEnabled( void )
+{
+    LeContext * context = GetCurrentContext();
+
+    return ( leAtomicLoad( &context->render->sync.maxFramesInFlight ) > 0 )
+        || FLAG_CHECK( context->core.window.flags, FLAG_LOW_LATENCY );
+}
+
+// Block until at most `frames` presented frames are still queued on the GPU
+static void
+WaitFramesInFlight( unsigned long frames )
+{
+    RenderContext * render = GetCurrentRender();
+
+    if( render->sync.presented - render->sync.retired <= frames ) return;
+
+    LE_PROFILE_BEGIN( "WaitFrameFence" );
+
+    while( render->sync.presented - render->sync.retired > frames )
+        {
+            void ** fence = &render->sync.fences[render->sync.retired % LE_MAX_FRAMES_IN_FLIGHT];
+
+            leWaitSync( *fence );
+            leDeleteSync( *fence );
+            *fence = NULL;
+
+            ++render->sync.retired;
+        }
+
+    LE_PROFILE_END();
+}
+
+// Wait for the fence from n frames ago before a new frame starts
+static void
+ThrottleFramesInFlight( void )
+{
+    RenderContext * render = GetCurrentRender();
+
+    const long maxFrames = leAtomicLoad( &render->sync.maxFramesInFlight );
+    if( maxFrames > 0 ) WaitFramesInFlight( (unsigned long)( maxFrames - 1 ) );
+}
+
+// Fence the frame just presented
+static void
+FencePresentedFrame( void )
+{
+    RenderContext * render = GetCurrentRender();
+
+    if( !IsFencingEnabled() ) return;
+
+    // Never overwrite a fence still in the ring
+    WaitFramesInFlight( LE_MAX_FRAMES_IN_FLIGHT - 1 );
+
+    render->sync.fences[render->sync.presented % LE_MAX_FRAMES_IN_FLIGHT] = leFenceSync();
+    ++render->sync.presented;
+}
+
+static void
+DrainFramesTask( void * userData )
+{
+    UNUSED( userData );
+    WaitFramesInFlight( 0 );
+}
+
+static void
+RenderThreadLoop( void * userData )
+{
+    // The render thread acts on behalf of the context that spawned it
+    LeContext *     context = (LeContext *)userData;
+    RenderContext * render  = context->render;
+    BindThreadContext( context );
+
+    AcquirePlatformContext();
+
+    leMutexLock( &render->worker.lock );
+    for( ;; )
+        {
+            while( !render->worker.quit && !render->worker.framePending && NULL == render->worker.task )
+                {
+                    leConditionWait( &render->worker.wake, &render->worker.lock );
+                }
+
+            // Pending work always drains before quitting
+            if( NULL != render->worker.task )
+                {
+                    RenderTaskFunc task = render->worker.task;
+                    void *         data = render->worker.taskData;
+
+                    leMutexUnlock( &render->worker.lock );
+                    task( data );
+                    leMutexLock( &render->worker.lock );
+
+                    render->worker.task = NULL;
+                    leConditionBroadcast( &render->worker.idle );
+                }
+            else if( render->worker.framePending )
+                {
+                    leMutexUnlock( &render->worker.lock );
+                    ThrottleFramesInFlight();
+                    ProcessTextureUploads();
+                    if( PresentFrame( render ) ) FencePresentedFrame();
+                    leMutexLock( &render->worker.lock );
+
+                    render->worker.framePending = false;
+                    leConditionBroadcast( &render->worker.idle );
+                }
+            else
+                {
+                    break;
+                }
+        }
+    leMutexUnlock( &render->worker.lock );
+
+    ReleasePlatformContext();
+    BindThreadContext( NULL );
+}
+
+//==============================================================================================================
+// MODULE FUNCTIONS DEFINITIONS
+//==============================================================================================================
+bool
+InitRenderer( void )
+{
+    RenderContext * render = (RenderContext *)LE_CALLOC( 1, sizeof( RenderContext ) );
+    if( NULL == render )
+        {
+            TRACELOG( LOG_ERROR, "RENDER: Failed to allocate renderer state" );
+            return false;
+        }
+
+    GetCurrentContext()->render = render;
+
+    // The initializing thread records first, its stream leads the merge order
+    render->serial = (unsigned long)leAtomicAdd( &rendererSerial, 1 ) + 1;
+    leMutexInit( &render->streamLock );
+    GetThreadStream( render );
+
+    leMutexInit( &render->damage.lock );
+    render->damage.pending = EmptyDamage();
+    render->damage.frame   = EmptyDamage();
+#if defined( GRAPHICS_API_OPENGL_33 )
+    render->damage.partial = 1;
+#endif
+    render->resolution.scale = 1000;
+
+    render->vaoId = leLoadVertexArray();
+    render->vboId = leLoadVertexBuffer( NULL, LE_RENDER_BATCH_VERTICES * (int)sizeof( RenderVertex ), true );
+
+    // VAOs capture the layout and the quad indices once, without them the indices stay bound
+    if( leEnableVertexArray( render->vaoId ) )
+        {
+            leEnableVertexBuffer( render->vboId );
+            SetVertexLayout( 0 );
+            render->quadIndexBufferId = LoadQuadIndexBuffer();
+            leDisableVertexArray();
+            render->indirect.bufferId = leLoadIndirectBuffer();
+        }
+    else
+        {
+            render->quadIndexBufferId = LoadQuadIndexBuffer();
+        }
+    render->execution.indexBufferId = render->quadIndexBufferId;
+
+#if LE_INSTANCED_LINES
+    render->lines.shaderId = leLoadShaderProgram( lineVertexShaderCode, lineFragmentShaderCode );
+    render->lines.vaoId    = ( 0 != render->lines.shaderId ) ? leLoadVertexArray() : 0;
+    if( leEnableVertexArray( render->lines.vaoId ) )
+        {
+            render->lines.vboId = leLoadVertexBuffer( NULL, LE_RENDER_BATCH_LINES * (int)sizeof( RenderLine ), true );
+            SetLineLayout( 0 );
+            for( unsigned int i = 0; i < 4; ++i )
+                {
+                    leEnableVertexAttribute( i );
+                    leSetVertexAttributeDivisor( i, 1 );
+                }
+            leDisableVertexArray();
+
+            const unsigned int shaderId    = render->lines.shaderId;
+            render->lines.mvpLocation      = leGetLocationUniform( shaderId, LE_DEFAULT_SHADER_UNIFORM_NAME_MVP );
+            render->lines.viewportLocation = leGetLocationUniform( shaderId, "viewportSize" );
+        }
+#endif
+
+    static const unsigned char white[4] = { 255, 255, 255, 255 };
+    render->whiteTextureId              = leLoadTexture( white, 1, 1, 1 );
+    leMutexInit( &render->whiteTexels.lock );
+
+    leEnableColorBlend();
+
+    TRACELOG( LOG_INFO, "RENDER: Batch renderer initialized (VAO %u, VBO %u)", render->vaoId, render->vboId );
+    return true;
+}
+
+void
+CloseRenderer( void )
+{
+    RenderContext * render = GetCurrentRender();
+    if( NULL == render ) return;
+
+    for( int i = 0; i < LE_MAX_FRAMES_IN_FLIGHT; ++i ) leDeleteSync( render->sync.fences[i] );
+
+    leUnloadVertexArray( render->vaoId );
+    leUnloadVertexBuffer( render->vboId );
+    if( 0 != render->quadIndexBufferId ) leUnloadVertexBuffer( render->quadIndexBufferId );
+    if( 0 != render->indirect.bufferId ) leUnloadVertexBuffer( render->indirect.bufferId );
+    if( 0 != render->indirect.indexBufferId ) leUnloadVertexBuffer( render->indirect.indexBufferId );
+    TrackMemory( MEMORY_COMMAND_BUFFERS, (size_t)render->indirect.drawCapacity * sizeof( IndirectDraw ), false );
+    LE_FREE( render->indirect.draws );
+    if( 0 != render->lines.shaderId )
+        {
+            leUnloadVertexArray( render->lines.vaoId );
+            leUnloadVertexBuffer( render->lines.vboId );
+            leUnloadShaderProgram( render->lines.shaderId );
+        }
+    leUnloadTexture( render->whiteTextureId );
+    leMutexDestroy( &render->whiteTexels.lock );
+    TrackMemory( MEMORY_COMMAND_BUFFERS, (size_t)render->whiteTexels.capacity * sizeof( WhiteTexel ), false );
+    LE_FREE( render->whiteTexels.entries );
+    if( 0 != render->damage.framebufferId )
+        {
+            leUnloadFramebuffer( render->damage.framebufferId, render->damage.textureId );
+        }
+    leMutexDestroy( &render->damage.lock );
+    if( 0 != render->resolution.framebufferId )
+        {
+            leUnloadFramebuffer( render->resolution.framebufferId, render->resolution.textureId );
+        }
+    for( int i = 0; i < LE_RESOLUTION_QUERIES; ++i ) leUnloadTimerQuery( render->resolution.queries[i] );
+
+    FreeRecordStreams( render );
+    leMutexDestroy( &render->streamLock );
+    TrackMemory( MEMORY_COMMAND_BUFFERS, (size_t)render->mergeCapacity * sizeof( MergeEntry ), false );
+    LE_FREE( render->merge );
+
+    LE_FREE( render );
+    GetCurrentContext()->render = NULL;
+}
+
+void
+SetRendererDefaultShader( unsigned int shaderId, int mvpLocation )
+{
+    RenderContext * render = GetCurrentRender();
+
+    render->defaultShaderId    = shaderId;
+    render->defaultMvpLocation = mvpLocation;
+}
+
+// Hand the GL context over to a dedicated render thread
+bool
+StartRenderThread( void )
+{
+    LeContext *     context = GetCurrentContext();
+    RenderContext * render  = context->render;
+
+    if( !FLAG_CHECK( context->core.window.flags, FLAG_THREADED_RENDERER ) || render->worker.active ) return false;
+
+    leMutexInit( &render->worker.lock );
+    leConditionInit( &render->worker.wake );
+    leConditionInit( &render->worker.idle );
+    render->worker.quit         = false;
+    render->worker.framePending = false;
+    render->worker.task         = NULL;
+
+    // A context is current on a single thread at a time
+    ReleasePlatformContext();
+
+    if( !leThreadCreate( &render->worker.thread, RenderThreadLoop, context ) )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: Failed to start render thread, rendering on the caller thread" );
+
+            AcquirePlatformContext();
+            leConditionDestroy( &render->worker.idle );
+            leConditionDestroy( &render->worker.wake );
+            leMutexDestroy( &render->worker.lock );
+            return false;
+        }
+
+    render->worker.active = true;
+    TRACELOG( LOG_INFO, "RENDER: Render thread started" );
+    return true;
+}
+
+// Finish pending work, join the render thread and take the GL context back
+void
+StopRenderThread( void )
+{
+    RenderContext * render = GetCurrentRender();
+
+    if( !render->worker.active ) return;
+
+    leMutexLock( &render->worker.lock );
+    render->worker.quit = true;
+    leConditionSignal( &render->worker.wake );
+    leMutexUnlock( &render->worker.lock );
+
+    leThreadJoin( &render->worker.thread );
+
+    AcquirePlatformContext();
+
+    leConditionDestroy( &render->worker.idle );
+    leConditionDestroy( &render->worker.wake );
+    leMutexDestroy( &render->worker.lock );
+    render->worker.active = false;
+
+    TRACELOG( LOG_INFO, "RENDER: Render thread stopped" );
+}
+
+void
+InvokeOnRenderThread( RenderTaskFunc func, void * userData )
+{
+    RenderContext * render = GetCurrentRender();
+
+    if( !render->worker.active )
+        {
+            func( userData );
+            return;
+        }
+
+    // Frames submitted earlier may still reference the resources this task touches
+    leMutexLock( &render->worker.lock );
+    while( render->worker.framePending || NULL != render->worker.task )
+        {
+            leConditionWait( &render->worker.idle, &render->worker.lock );
+        }
+
+    render->worker.task     = func;
+    render->worker.taskData = userData;
+    leConditionSignal( &render->worker.wake );
+
+    while( NULL != render->worker.task ) leConditionWait( &render->worker.idle, &render->worker.lock );
+    leMutexUnlock( &render->worker.lock );
+}
+
+RenderVertex *
+RecordVertices( int mode, int count )
+{
+    CommandBuffer * buffer = GetRecordingBuffer();
+    if( UNLIKELY( NULL == buffer ) ) return NULL;
+
+    // Clip areas the CPU cannot cut fall back to the GL scissor
+    RecordStream * stream = threadStream.stream;
+    if( UNLIKELY( stream->scissor.depth > 0 || buffer->scissor.enabled ) )
+        {
+            SyncScissor( stream, stream->scissor.depth > 0 && !stream->scissor.cpu );
+        }
+
+    if( !ReserveArray( (void **)&buffer->vertices, &buffer->vertexCapacity, buffer->vertexCount + count,
+                       sizeof( RenderVertex ), LE_RENDER_BATCH_VERTICES, MEMORY_VERTEX_STAGING ) )
+        {
+            return NULL;
+        }
+
+    // Extend the previous draw when nothing changed in between, segments never share a command
+    const int segmentStart = ( buffer->segmentCount > 0 ) ? buffer->segments[buffer->segmentCount - 1].firstCommand : 0;
+    RenderCommand * last = ( buffer->commandCount > segmentStart ) ? &buffer->commands[buffer->commandCount - 1] : NULL;
+    if( NULL != last && RENDER_COMMAND_DRAW == last->type && mode == last->params.draw.mode
+        && buffer->texture.id == last->params.draw.texture )
+        {
+            last->params.draw.count += count;
+        }
+    else
+        {
+            RenderCommand * command = PushCommand( buffer, RENDER_COMMAND_DRAW );
+            if( NULL == command ) return NULL;
+
+            command->params.draw.mode    = mode;
+            command->params.draw.first   = buffer->vertexCount;
+            command->params.draw.count   = count;
+            command->params.draw.texture = buffer->texture.id;
+            command->params.draw.opaque  = 0;
+        }
+
+    RenderVertex * vertices = &buffer->vertices[buffer->vertexCount];
+    buffer->vertexCount += count;
+    return vertices;
+}
+
+// Texture sampled by the vertices recorded next, 0 for the white texture
+void
+RecordTexture( unsigned int textureId )
+{
+    CommandBuffer * buffer = GetRecordingBuffer();
+    if( UNLIKELY( NULL == buffer ) || textureId == buffer->texture.id ) return;
+
+    if( 0 == textureId )
+        {
+            ResetRecordTexture( buffer );
+            return;
+        }
+
+    buffer->texture.id    = textureId;
+    buffer->texture.white = false;
+
+    RenderContext * render = GetCurrentRender();
+    leMutexLock( &render->whiteTexels.lock );
+    for( int i = 0; i < render->whiteTexels.count; ++i )
+        {
+            const WhiteTexel * texel = &render->whiteTexels.entries[i];
+            if( texel->textureId != textureId ) continue;
+
+            buffer->texture.white = true;
+            buffer->texture.u     = texel->u;
+            buffer->texture.v     = texel->v;
+            buffer->texture.layer = texel->layer;
+            break;
+        }
+    leMutexUnlock( &render->whiteTexels.lock );
+}
+
+// Template vertex sampling white, inside the current texture when it has a white texel
+RenderVertex
+GetWhiteVertex( void )
+{
+    RenderVertex vertex = { 0 };
+
+    CommandBuffer * buffer = GetRecordingBuffer();
+    if( UNLIKELY( NULL == buffer ) ) return vertex;
+
+    if( !buffer->texture.white ) ResetRecordTexture( buffer );
+
+    vertex.u     = buffer->texture.u;
+    vertex.v     = buffer->texture.v;
+    vertex.layer = buffer->texture.layer;
+    return vertex;
+}
+
+// Register a white texel at normalized `u`, `v` of a texture layer, solid colors drawn after it stay in the batch
+void
+AddWhiteTexel( unsigned int textureId, float u, float v, float layer )
+{
+    RenderContext * render = GetCurrentRender();
+    if( UNLIKELY( NULL == render ) ) return;
+
+    leMutexLock( &render->whiteTexels.lock );
+    if( ReserveArray( (void **)&render->whiteTexels.entries, &render->whiteTexels.capacity,
+                      render->whiteTexels.count + 1, sizeof( WhiteTexel ), 8, MEMORY_COMMAND_BUFFERS ) )
+        {
+            WhiteTexel * texel = &render->whiteTexels.entries[render->whiteTexels.count++];
+            texel->textureId   = textureId;
+            texel->u           = u;
+            texel->v           = v;
+            texel->layer       = layer;
+        }
+    leMutexUnlock( &render->whiteTexels.lock );
+}
+
+void
+RemoveWhiteTexel( unsigned int textureId )
+{
+    RenderContext * render = GetCurrentRender();
+    if( UNLIKELY( NULL == render ) ) return;
+
+    leMutexLock( &render->whiteTexels.lock );
+    for( int i = 0; i < render->whiteTexels.count; ++i )
+        {
+            if( render->whiteTexels.entries[i].textureId != textureId ) continue;
+
+            render->whiteTexels.entries[i] = render->whiteTexels.entries[--render->whiteTexels.count];
+            break;
+        }
+    leMutexUnlock( &render->whiteTexels.lock );
+}
+
+void
+RecordClear( Color color )
+{
+    CommandBuffer * buffer = GetRecordingBuffer();
+    if( UNLIKELY( NULL == buffer ) ) return;
+
+    RenderCommand * command = PushCommand( buffer, RENDER_COMMAND_CLEAR );
+    if( NULL == command ) return;
+
+    command->params.clear.r = color.r;
+    command->params.clear.g = color.g;
+    command->params.clear.b = color.b;
+    command->params.clear.a = color.a;
+}
+
+// Program of the calling thread's next draws, kept across SetDrawLayer until the frame ends
+void
+RecordShader( unsigned int shaderId, int mvpLocation )
+{
+    CommandBuffer * buffer = GetRecordingBuffer();
+    if( UNLIKELY( NULL == buffer ) ) return;
+
+    RecordStream * stream      = threadStream.stream;
+    stream->shader.id          = shaderId;
+    stream->shader.mvpLocation = mvpLocation;
+
+    if( shaderId != buffer->shader ) PushShader( threadStream.render, buffer, shaderId, mvpLocation );
+}
+
+void
+RecordUniform( unsigned int shaderId, int locIndex, const void * value, int uniformType, int count )
+{
+    CommandBuffer * buffer = GetRecordingBuffer();
+    if( UNLIKELY( NULL == buffer ) || locIndex < 0 || count < 1 ) return;
+
+    // Values are copied, the caller storage may change before the frame executes
+    const size_t size = (size_t)GetUniformSize( uniformType ) * (size_t)count;
+    void *       copy = AllocArena( &buffer->arena, size );
+    if( NULL == copy ) return;
+
+    RenderCommand * command = PushCommand( buffer, RENDER_COMMAND_UNIFORM );
+    if( NULL == command ) return;
+
+    memcpy( copy, value, size );
+
+    command->params.uniform.shaderId    = shaderId;
+    command->params.uniform.location    = locIndex;
+    command->params.uniform.uniformType = uniformType;
+    command->params.uniform.count       = count;
+    command->params.uniform.value       = copy;
+}
+
+// Run `func` where the frame executes, with the GL context current, after the draws recorded before it. The
+// returned `size` bytes are handed to it and hashed by FLAG_EVENT_DRIVEN, `draws` callbacks are clipped like lines
+void *
+RecordCallback( RenderCallbackFunc func, size_t size, bool draws )
+{
+    CommandBuffer * buffer = GetRecordingBuffer();
+    if( UNLIKELY( NULL == buffer ) ) return NULL;
+
+    RecordStream * stream = threadStream.stream;
+    if( draws && UNLIKELY( stream->scissor.depth > 0 || buffer->scissor.enabled ) )
+        {
+            SyncScissor( stream, stream->scissor.depth > 0 );
+        }
+
+    void * data = AllocArena( &buffer->arena, ( size > 0 ) ? size : 1 );
+    if( NULL == data ) return NULL;
+
+    RenderCommand * command = PushCommand( buffer, RENDER_COMMAND_CALLBACK );
+    if( NULL == command ) return NULL;
+
+    command->params.callback.func  = func;
+    command->params.callback.data  = data;
+    command->params.callback.size  = size;
+    command->params.callback.draws = draws;
+    return data;
+}
+
+// Scratch memory of the calling thread, valid until the frame recorded now has executed
+void *
+AllocFrameMemory( size_t size )
+{
+    CommandBuffer * buffer = GetRecordingBuffer();
+    if( UNLIKELY( NULL == buffer ) ) return NULL;
+
+    return AllocArena( &buffer->arena, size );
+}
+
+void
+SubmitFrame( void )
+{
+    LeContext *     context = GetCurrentContext();
+    RenderContext * render  = context->render;
+    if( UNLIKELY( NULL == render ) ) return;
+
+    if( !render->worker.active )
+        {
+            render->screen      = context->core.window.screen;
+            render->flags       = context->core.window.flags;
+            render->frameBudget = context->core.timing.targetFPS;
+            FlipRecordStreams( render );
+            TakeFrameDamage( render );
+            ProcessTextureUploads();
+            if( PresentFrame( render ) ) FencePresentedFrame();
+            return;
+        }
+
+    // Only blocks when the render thread is still presenting the previous frame
+    leMutexLock( &render->worker.lock );
+    while( render->worker.framePending ) leConditionWait( &render->worker.idle, &render->worker.lock );
+
+    render->screen      = context->core.window.screen;
+    render->flags       = context->core.window.flags;
+    render->frameBudget = context->core.timing.targetFPS;
+    FlipRecordStreams( render );
+    TakeFrameDamage( render );
+    render->worker.framePending = true;
+    leConditionSignal( &render->worker.wake );
+    leMutexUnlock( &render->worker.lock );
+}
+
+// Draw calls of the calling thread that follow are merged after every lower layer
+void
+SetDrawLayer( int layer )
+{
+    RenderContext * render = GetCurrentRender();
+    if( UNLIKELY( NULL == render ) ) return;
+
+    RecordStream * stream = GetThreadStream( render );
+    if( NULL == stream ) return;
+
+    stream->layer = layer;
+    BeginSegment( stream->recording, layer );
+
+    // Segments replay from the default state, the program, the camera and the clip shapes carry over
+    if( 0 != stream->shader.id ) PushShader( render, stream->recording, stream->shader.id, stream->shader.mvpLocation );
+    if( stream->camera.active ) RecordView( stream->recording, stream->camera.view );
+    if( stream->scissor.shapes > 0 )
+        {
+            RecordStencil( stream, stream->scissor.defining ? STENCIL_WRITE : STENCIL_TEST, stream->scissor.shapes );
+        }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Transform stack
+//----------------------------------------------------------------------------------------------------------------------
+// Stream of the calling thread in the current context, NULL before InitWindow
+static RecordStream *
+GetCallerStream( void )
+{
+    LeContext * context = GetCurrentContext();
+    if( UNLIKELY( NULL == context || NULL == context->render ) ) return NULL;
+
+    return GetThreadStream( context->render );
+}
+
+// Post-multiply, so `matrix` applies to the next draws before the current transform
+static void
+ApplyTransform( const Matrix2D matrix )
+{
+    RecordStream * stream = GetCallerStream();
+    if( NULL == stream ) return;
+
+    stream->transform.current  = Matrix2DMultiply( stream->transform.current, matrix );
+    stream->transform.identity = false;
+}
+
+void
+PushMatrix( void )
+{
+    RecordStream * stream = GetCallerStream();
+    if( NULL == stream ) return;
+
+    if( stream->transform.depth >= LE_MAX_MATRIX_STACK )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: Matrix stack overflow (LE_MAX_MATRIX_STACK: %d)", LE_MAX_MATRIX_STACK );
+            return;
+        }
+
+    stream->transform.stack[stream->transform.depth++] = stream->transform.current;
+}
+
+void
+PopMatrix( void )
+{
+    RecordStream * stream = GetCallerStream();
+    if( NULL == stream ) return;
+
+    if( 0 == stream->transform.depth )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: PopMatrix without a matching PushMatrix" );
+            return;
+        }
+
+    stream->transform.current  = stream->transform.stack[--stream->transform.depth];
+    stream->transform.identity = false;
+}
+
+void
+Translate( float x, float y )
+{
+    ApplyTransform( Matrix2DTranslate( x, y ) );
+}
+
+void
+Rotate( float degrees )
+{
+    ApplyTransform( Matrix2DRotate( degrees * DEG2RAD ) );
+}
+
+void
+Scale( float x, float y )
+{
+    ApplyTransform( Matrix2DScale( x, y ) );
+}
+
+void
+SetMatrix( Matrix2D matrix )
+{
+    RecordStream * stream = GetCallerStream();
+    if( NULL == stream ) return;
+
+    stream->transform.current  = matrix;
+    stream->transform.identity = false;
+}
+
+Matrix2D
+GetMatrix( void )
+{
+    RecordStream * stream = GetCallerStream();
+    return ( NULL != stream ) ? stream->transform.current : Matrix2DIdentity();
+}
+
+// Move freshly written vertices of the calling thread into the space of its current transform, then cut them to
+// its clip area. `vertices` must be the latest RecordVertices reservation
+void
+TransformVertices( RenderVertex * vertices, int count )
+{
+    RecordStream * stream = threadStream.stream;
+    if( NULL == stream || count < 1 ) return;
+
+    if( !stream->transform.identity )
+        {
+            Vector2TransformStrided( &vertices[0].x, count, (int)sizeof( RenderVertex ), stream->transform.current );
+        }
+
+    if( UNLIKELY( FLAG_CHECK( GetCurrentContext()->core.window.flags, FLAG_LAYERED_DEPTH ) ) )
+        {
+            ClassifyRecordedVertices( stream, vertices, count );
+        }
+
+    if( stream->scissor.depth > 0 && stream->scissor.cpu ) ClipRecordedVertices( stream, vertices, count );
+}
+
+// Reserve segments of the instanced line batch, extending the previous line draw when nothing changed in between.
+// NULL without LE_INSTANCED_LINES, callers tessellate the lines into vertices instead
+RenderLine *
+RecordLines( int count )
+{
+    RenderContext * render = GetCurrentRender();
+    if( UNLIKELY( NULL == render ) || 0 == render->lines.shaderId ) return NULL;
+
+    CommandBuffer * buffer = GetRecordingBuffer();
+    if( UNLIKELY( NULL == buffer ) ) return NULL;
+
+    // Segments are expanded on the GPU, their clip is always the GL scissor
+    RecordStream * stream = threadStream.stream;
+    if( UNLIKELY( stream->scissor.depth > 0 || buffer->scissor.enabled ) )
+        {
+            SyncScissor( stream, stream->scissor.depth > 0 );
+        }
+
+    if( !ReserveArray( (void **)&buffer->lines, &buffer->lineCapacity, buffer->lineCount + count,
+                       sizeof( RenderLine ), LE_RENDER_BATCH_LINES, MEMORY_VERTEX_STAGING ) )
+        {
+            return NULL;
+        }
+
+    const int segmentStart = ( buffer->segmentCount > 0 ) ? buffer->segments[buffer->segmentCount - 1].firstCommand : 0;
+    RenderCommand * last = ( buffer->commandCount > segmentStart ) ? &buffer->commands[buffer->commandCount - 1] : NULL;
+    if( NULL != last && RENDER_COMMAND_LINES == last->type )
+        {
+            last->params.lines.count += count;
+        }
+    else
+        {
+            RenderCommand * command = PushCommand( buffer, RENDER_COMMAND_LINES );
+            if( NULL == command ) return NULL;
+
+            command->params.lines.first = buffer->lineCount;
+            command->params.lines.count = count;
+        }
+
+    RenderLine * lines = &buffer->lines[buffer->lineCount];
+    buffer->lineCount += count;
+    return lines;
+}
+
+// Move freshly written segments of the calling thread into the space of its current transform, widths follow
+// the average scale
+void
+TransformLines( RenderLine * lines, int count )
+{
+    RecordStream * stream = threadStream.stream;
+    if( NULL == stream || stream->transform.identity || count < 1 ) return;
+
+    const Matrix2D matrix = stream->transform.current;
+    const float    scale  = sqrtf( fabsf( matrix.m0 * matrix.m3 - matrix.m1 * matrix.m2 ) );
+
+    Vector2TransformStrided( &lines[0].x0, count, (int)sizeof( RenderLine ), matrix );
+    Vector2TransformStrided( &lines[0].x1, count, (int)sizeof( RenderLine ), matrix );
+    Vector2TransformStrided( &lines[0].prevX, count, (int)sizeof( RenderLine ), matrix );
+    Vector2TransformStrided( &lines[0].nextX, count, (int)sizeof( RenderLine ), matrix );
+    for( int i = 0; i < count; ++i ) lines[i].halfWidth *= scale;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Camera
+//----------------------------------------------------------------------------------------------------------------------
+// World to screen transform of `camera`: around `target`, scaled, rotated, then placed at `offset`
+Matrix2D
+GetCameraMatrix2D( Camera2D camera )
+{
+    Matrix2D matrix = Matrix2DTranslate( camera.offset.x, camera.offset.y );
+    matrix          = Matrix2DMultiply( matrix, Matrix2DRotate( camera.rotation * DEG2RAD ) );
+    matrix          = Matrix2DMultiply( matrix, Matrix2DScale( camera.zoom, camera.zoom ) );
+    return Matrix2DMultiply( matrix, Matrix2DTranslate( -camera.target.x, -camera.target.y ) );
+}
+
+void
+BeginMode2D( Camera2D camera )
+{
+    LeContext *    context = GetCurrentContext();
+    RecordStream * stream  = GetCallerStream();
+    if( NULL == stream ) return;
+
+    const Matrix2D view   = GetCameraMatrix2D( camera );
+    const float    width  = (float)context->core.window.screen.width;
+    const float    height = (float)context->core.window.screen.height;
+
+    stream->camera.bounds = GetCameraBounds( view, camera.zoom, width, height );
+    stream->camera.active = true;
+    stream->camera.view   = view;
+    RecordView( stream->recording, view );
+    UpdateScissorArea( stream );
+}
+
+void
+EndMode2D( void )
+{
+    RecordStream * stream = GetCallerStream();
+    if( NULL == stream || !stream->camera.active ) return;
+
+    stream->camera.active = false;
+    RecordView( stream->recording, Matrix2DIdentity() );
+    UpdateScissorArea( stream );
+}
+
+// Whether a shape bounded by the given box, before the PushMatrix transform, may reach the camera view and the
+// clip area
+bool
+IsAreaVisible( float minX, float minY, float maxX, float maxY )
+{
+    RecordStream * stream = GetCallerStream();
+    if( NULL == stream || ( !stream->camera.active && 0 == stream->scissor.depth ) ) return true;
+
+    ClipBox area = { minX, minY, maxX, maxY };
+    if( !stream->transform.identity ) area = TransformClipBox( area, stream->transform.current );
+
+    if( stream->camera.active && !IsClipBoxOverlapping( area, stream->camera.bounds ) ) return false;
+
+    const ClipBox scissor = { stream->scissor.minX, stream->scissor.minY, stream->scissor.maxX, stream->scissor.maxY };
+    return 0 == stream->scissor.depth || IsClipBoxOverlapping( area, scissor );
+}
+
+// Area reached by the next draws of the calling thread, in the space of its PushMatrix transform
+Rectangle
+GetVisibleArea( void )
+{
+    LeContext *    context = GetCurrentContext();
+    RecordStream * stream  = GetCallerStream();
+
+    if( NULL == stream ) return ( Rectangle ){ 0.0F, 0.0F, 0.0F, 0.0F };
+
+    ClipBox area = { 0.0F, 0.0F, (float)context->core.window.screen.width,
+                     (float)context->core.window.screen.height };
+    if( stream->camera.active ) area = stream->camera.bounds;
+
+    if( stream->scissor.depth > 0 )
+        {
+            area.minX = fmaxf( area.minX, stream->scissor.minX );
+            area.minY = fmaxf( area.minY, stream->scissor.minY );
+            area.maxX = fmaxf( area.minX, fminf( area.maxX, stream->scissor.maxX ) );
+            area.maxY = fmaxf( area.minY, fminf( area.maxY, stream->scissor.maxY ) );
+        }
+
+    // Box of the area mapped back through the inverse transform
+    if( !stream->transform.identity ) area = TransformClipBox( area, Matrix2DInvert( stream->transform.current ) );
+
+    return ( Rectangle ){ area.minX, area.minY, area.maxX - area.minX, area.maxY - area.minY };
+}
+
+// World to screen transform of the calling thread's next draws, the camera applied after PushMatrix
+Matrix2D
+GetDrawMatrix( void )
+{
+    RecordStream * stream = GetCallerStream();
+    if( NULL == stream ) return Matrix2DIdentity();
+
+    if( !stream->camera.active ) return stream->transform.current;
+    return Matrix2DMultiply( stream->camera.view, stream->transform.current );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Clip areas
+//----------------------------------------------------------------------------------------------------------------------
+// Limit the next draws of the calling thread to a screen rectangle, inside the current clip area
+void
+BeginScissorMode( int x, int y, int width, int height )
+{
+    RecordStream * stream = GetCallerStream();
+    if( NULL == stream ) return;
+
+    if( stream->scissor.depth >= LE_MAX_SCISSOR_STACK )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: Scissor stack overflow (LE_MAX_SCISSOR_STACK: %d)", LE_MAX_SCISSOR_STACK );
+            return;
+        }
+
+    ScissorEntry entry = { (float)x, (float)y, (float)x + (float)width, (float)y + (float)height, false };
+    if( stream->scissor.depth > 0 )
+        {
+            const ScissorEntry * parent = &stream->scissor.stack[stream->scissor.depth - 1];
+            entry.minX                  = fmaxf( entry.minX, parent->minX );
+            entry.minY                  = fmaxf( entry.minY, parent->minY );
+            entry.maxX                  = fminf( entry.maxX, parent->maxX );
+            entry.maxY                  = fminf( entry.maxY, parent->maxY );
+        }
+
+    // An empty area still clips everything
+    entry.maxX = fmaxf( entry.maxX, entry.minX );
+    entry.maxY = fmaxf( entry.maxY, entry.minY );
+
+    stream->scissor.stack[stream->scissor.depth++] = entry;
+    UpdateScissorArea( stream );
+}
+
+// Restore the clip area of the matching BeginScissorMode or BeginScissorShape
+void
+EndScissorMode( void )
+{
+    RecordStream * stream = GetCallerStream();
+    if( NULL == stream ) return;
+
+    if( 0 == stream->scissor.depth )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: EndScissorMode without a matching BeginScissorMode" );
+            return;
+        }
+
+    if( stream->scissor.stack[stream->scissor.depth - 1].shape )
+        {
+            // Bring the stencil back to the parent level over the area the shape could have reached
+            const int level = stream->scissor.shapes - 1;
+            RecordStencil( stream, STENCIL_RESET, level );
+
+            RenderVertex * v = RecordVertices( LE_QUADS, 4 );
+            if( NULL != v )
+                {
+                    const RenderVertex base = GetWhiteVertex();
+                    for( int i = 0; i < 4; ++i ) v[i] = base;
+
+                    v[0].x = v[3].x = stream->scissor.minX;
+                    v[1].x = v[2].x = stream->scissor.maxX;
+                    v[0].y = v[1].y = stream->scissor.minY;
+                    v[2].y = v[3].y = stream->scissor.maxY;
+                }
+
+            stream->scissor.defining = false;
+            stream->scissor.shapes = level;
+            RecordStencil( stream, STENCIL_TEST, level );
+        }
+
+    --stream->scissor.depth;
+    UpdateScissorArea( stream );
+}
+
+// Start a clip shape: the next draws of the calling thread are not shown, they mark the pixels the draws after
+// EndScissorShape stay in. EndScissorMode removes the shape
+void
+BeginScissorShape( void )
+{
+    LeContext *    context = GetCurrentContext();
+    RecordStream * stream  = GetCallerStream();
+    if( NULL == stream ) return;
+
+    if( stream->scissor.defining )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: BeginScissorShape while a clip shape is being drawn" );
+            return;
+        }
+
+    if( stream->scissor.depth >= LE_MAX_SCISSOR_STACK )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: Scissor stack overflow (LE_MAX_SCISSOR_STACK: %d)", LE_MAX_SCISSOR_STACK );
+            return;
+        }
+
+    ScissorEntry entry = { 0.0F, 0.0F, (float)context->core.window.screen.width,
+                           (float)context->core.window.screen.height, true };
+    if( stream->scissor.depth > 0 )
+        {
+            entry       = stream->scissor.stack[stream->scissor.depth - 1];
+            entry.shape = true;
+        }
+
+    stream->scissor.stack[stream->scissor.depth++] = entry;
+    stream->scissor.defining                        = true;
+    ++stream->scissor.shapes;
+    UpdateScissorArea( stream );
+    RecordStencil( stream, STENCIL_WRITE, stream->scissor.shapes );
+}
+
+// Finish the clip shape, the next draws only reach the pixels it covered
+void
+EndScissorShape( void )
+{
+    RecordStream * stream = GetCallerStream();
+    if( NULL == stream ) return;
+
+    if( !stream->scissor.defining )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: EndScissorShape without a matching BeginScissorShape" );
+            return;
+        }
+
+    stream->scissor.defining = false;
+    RecordStencil( stream, STENCIL_TEST, stream->scissor.shapes );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Damage
+//----------------------------------------------------------------------------------------------------------------------
+// Called at BeginDrawing, damages everything when the mode starts or the screen changed size
+void
+PrepareFrameDamage( void )
+{
+    LeContext *     context = GetCurrentContext();
+    RenderContext * render  = context->render;
+    if( UNLIKELY( NULL == render ) ) return;
+
+    const Dimension screen     = context->core.window.screen;
+    const bool      enabled    = FLAG_CHECK( context->core.window.flags, FLAG_PARTIAL_REDRAW );
+    const bool      wasEnabled = render->damage.enabled;
+    const bool      resized    = screen.width != render->damage.screen.width
+                       || screen.height != render->damage.screen.height;
+
+    render->damage.enabled = enabled;
+    render->damage.screen  = screen;
+
+    if( enabled && ( !wasEnabled || resized ) )
+        {
+            AddContextDamage( context, 0.0F, 0.0F, (float)screen.width, (float)screen.height );
+        }
+}
+
+// Grow the damage of the frame `context` is recording, in screen pixels
+void
+AddContextDamage( LeContext * context, float minX, float minY, float maxX, float maxY )
+{
+    RenderContext * render = ( NULL != context ) ? context->render : NULL;
+    if( NULL == render || !render->damage.enabled ) return;
+
+    // Without a kept copy, anything damaged means a whole frame
+    if( !leAtomicLoad( &render->damage.partial ) )
+        {
+            minX = 0.0F;
+            minY = 0.0F;
+            maxX = (float)render->damage.screen.width;
+            maxY = (float)render->damage.screen.height;
+        }
+
+    leMutexLock( &render->damage.lock );
+    render->damage.pending.minX = fminf( render->damage.pending.minX, minX );
+    render->damage.pending.minY = fminf( render->damage.pending.minY, minY );
+    render->damage.pending.maxX = fmaxf( render->damage.pending.maxX, maxX );
+    render->damage.pending.maxY = fmaxf( render->damage.pending.maxY, maxY );
+    leMutexUnlock( &render->damage.lock );
+}
+
+// Damage of the frame being recorded, false when the whole screen is redrawn (FLAG_PARTIAL_REDRAW off)
+bool
+GetFrameDamage( Rectangle * area )
+{
+    RenderContext * render = GetCurrentRender();
+    if( NULL == render || !render->damage.enabled ) return false;
+
+    leMutexLock( &render->damage.lock );
+    const DamageArea damage = render->damage.pending;
+    leMutexUnlock( &render->damage.lock );
+
+    area->x      = ( damage.minX <= damage.maxX ) ? damage.minX : 0.0F;
+    area->y      = ( damage.minX <= damage.maxX ) ? damage.minY : 0.0F;
+    area->width  = ( damage.minX <= damage.maxX ) ? damage.maxX - damage.minX : 0.0F;
+    area->height = ( damage.minX <= damage.maxX ) ? damage.maxY - damage.minY : 0.0F;
+    return true;
+}
+
+// Redraw a screen area this frame, draws outside every damaged area keep the previous image
+void
+AddDamageArea( Rectangle area )
+{
+    AddContextDamage( GetCurrentContext(), fminf( area.x, area.x + area.width ), fminf( area.y, area.y + area.height ),
+                      fmaxf( area.x, area.x + area.width ), fmaxf( area.y, area.y + area.height ) );
+}
+
+// Called at BeginDrawing, the render thread throttles itself before executing each frame
+void
+ThrottleFrame( void )
+{
+    RenderContext * render = GetCurrentRender();
+    if( NULL == render ) return;
+
+    if( !render->worker.active ) ThrottleFramesInFlight();
+}
+
+// Wait until the GPU has finished every submitted frame
+void
+DrainFrames( void )
+{
+    InvokeOnRenderThread( DrainFramesTask, NULL );
+}
+
+// Limit how many frames may be queued ahead of the GPU, 0 leaves it to the driver
+void
+SetMaxFramesInFlight( int frames )
+{
+    RenderContext * render = GetCurrentRender();
+    if( NULL == render ) return;
+
+    if( frames < 0 ) frames = 0;
+    if( frames > LE_MAX_FRAMES_IN_FLIGHT )
+        {
+            TRACELOG( LOG_WARNING, "RENDER: Frames in flight clamped to %d", LE_MAX_FRAMES_IN_FLIGHT );
+            frames = LE_MAX_FRAMES_IN_FLIGHT;
+        }
+
+    leAtomicStore( &render->sync.maxFramesInFlight, (long)frames );
+}
+
+// Fraction of the window size frames are drawn at, 1 unless FLAG_DYNAMIC_RESOLUTION lowered it
+float
+GetResolutionScale( void )
+{
+    LeContext * context = GetCurrentContext();
+    if( NULL == context || NULL == context->render ) return 1.0F;
+    if( !FLAG_CHECK( context->core.window.flags, FLAG_DYNAMIC_RESOLUTION ) ) return 1.0F;
+
+    return (float)leAtomicLoad( &context->render->resolution.scale ) * 0.001F;
+}
@@ -0,0 +1,134 @@
+/******************************* LERENDER ********************************
+ * lerender: Frame command recording and submission
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ *   - Draw calls never touch GL directly: they append vertices and commands
+ *     to the recording buffer, which EndDrawing hands to SubmitFrame.
+ *   - With FLAG_THREADED_RENDERER the buffers are double-buffered and a
+ *     render thread owning the GL context executes and presents them.
+ *   - Any thread may record between BeginDrawing and EndDrawing, each one
+ *     into its own stream. Producers must be done before EndDrawing.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+#ifndef LEVEGL_RENDER_H
+#define LEVEGL_RENDER_H
+
+#include "levegl/levegl.h"
+
+#include <math.h> /* fminf, fmaxf */
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+/// Vertex layout shared by every batched primitive
+typedef struct RenderVertex
+{
+    float         x;
+    float         y;
+    unsigned char r;
+    unsigned char g;
+    unsigned char b;
+    unsigned char a;
+    float         u;     /// Normalized texture coordinates
+    float         v;
+    float         layer; /// Texture array layer (LE_TEXTURE_ARRAYS), -1 - layer for distance field glyphs
+} RenderVertex;
+
+/// One segment of a thick line, expanded into a quad and the join at its end by the GPU (LE_INSTANCED_LINES)
+typedef struct RenderLine
+{
+    float         x0, y0, x1, y1; /// Segment
+    float         prevX, prevY;   /// Point before the segment, equal to x0,y0 at an open end
+    float         nextX, nextY;   /// Point after the segment, equal to x1,y1 at an open end
+    unsigned char r, g, b, a;
+    float         halfWidth;
+    float         join; /// LineJoin at x1,y1
+} RenderLine;
+
+typedef void ( *RenderTaskFunc )( void * userData );
+
+// GL work run at its place in the executing frame. `mvp` maps the space of the recording thread to clip space,
+// `viewport` is the framebuffer size in pixels. The default program, vertex layout and texture are restored after
+typedef void ( *RenderCallbackFunc )( void * userData, Matrix mvp, Vector2 viewport );
+
+//==============================================================================================================
+// INLINE FUNCTIONS
+//==============================================================================================================
+// Quantize a color into a vertex, clamped to [0, 1]
+static INLINE void
+SetVertexColor( RenderVertex * vertex, Color color )
+{
+    vertex->r = (unsigned char)( fminf( fmaxf( color.r, 0.0F ), 1.0F ) * 255.0F + 0.5F );
+    vertex->g = (unsigned char)( fminf( fmaxf( color.g, 0.0F ), 1.0F ) * 255.0F + 0.5F );
+    vertex->b = (unsigned char)( fminf( fmaxf( color.b, 0.0F ), 1.0F ) * 255.0F + 0.5F );
+    vertex->a = (unsigned char)( fminf( fmaxf( color.a, 0.0F ), 1.0F ) * 255.0F + 0.5F );
+}
+
+//==============================================================================================================
+// FUNCTIONS DECLARATIONS
+//==============================================================================================================
+// Lifetime, called with the GL context current on the calling thread
+bool InitRenderer( void );
+void CloseRenderer( void );
+void SetRendererDefaultShader( unsigned int shaderId, int mvpLocation );
+
+// Render thread, only started with FLAG_THREADED_RENDERER
+bool StartRenderThread( void );
+void StopRenderThread( void );
+void InvokeOnRenderThread( RenderTaskFunc func, void * userData ); // Run GL work where the context lives, blocking
+
+// Recording
+RenderVertex * RecordVertices( int mode, int count ); // Reserve `count` vertices of a batch, 4 around each LE_QUADS
+void           RecordTexture( unsigned int textureId ); // Texture sampled by the next vertices, 0 for white
+RenderVertex   GetWhiteVertex( void );                  // Template vertex sampling white, for solid colors
+void           RecordClear( Color color );
+void           RecordShader( unsigned int shaderId, int mvpLocation ); // 0 restores the default shader
+void           RecordUniform( unsigned int shaderId, int locIndex, const void * value, int uniformType, int count );
+void *         AllocFrameMemory( size_t size ); // Per-frame scratch, rewound once the recorded frame has executed
+void           TransformVertices( RenderVertex * vertices, int count ); // Apply the PushMatrix transform of the caller
+RenderLine *   RecordLines( int count ); // Reserve `count` instanced segments, NULL without LE_INSTANCED_LINES
+void           TransformLines( RenderLine * lines, int count ); // Apply the PushMatrix transform, widths included
+void *         RecordCallback( RenderCallbackFunc func, size_t size, bool draws ); // Payload of `size` bytes
+bool           IsAreaVisible( float minX, float minY, float maxX, float maxY ); // Cull test against BeginMode2D
+Rectangle      GetVisibleArea( void ); // Camera or screen bounds in the space of the caller's transform
+Matrix2D       GetDrawMatrix( void );  // World to screen transform of the caller, camera included
+
+// White texels inside textures, so solid colors batch with their sprites
+void AddWhiteTexel( unsigned int textureId, float u, float v, float layer );
+void RemoveWhiteTexel( unsigned int textureId );
+
+// Submission, executes or hands off the recorded frame and presents it
+void SubmitFrame( void );
+
+// Partial redraw (FLAG_PARTIAL_REDRAW), areas in screen pixels
+void PrepareFrameDamage( void ); // Called at BeginDrawing
+void AddContextDamage( LeContext * context, float minX, float minY, float maxX, float maxY );
+bool GetFrameDamage( Rectangle * area ); // Damage recorded so far, false when whole frames are drawn
+
+// Frame pacing
+void ThrottleFrame( void ); // Wait on the fence from n frames ago (SetMaxFramesInFlight)
+void DrainFrames( void );   // Wait until the GPU has finished every submitted frame
+
+#endif // !LEVEGL_RENDER_H
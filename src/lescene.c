@@ -0,0 +1,749 @@
+/******************************** LESCENE ********************************
+ * lescene: Retained shapes with a spatial grid, drawn by visibility
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ * - DEFINES:
+ *   - LE_SCENE_MAX_ITEM_CELLS: Cells an item may span before it is kept aside and tested on every query
+ *   - LE_SCENE_INITIAL_CELLS: Initial slots of the cell hash table, a power of two
+ *
+ * - Items are stored as a structure of arrays, so a query only streams bounds and stamps.
+ * - Cells form a sparse uniform grid, hashed by coordinate, holding the IDs of the items
+ *   overlapping them. An item spanning several cells is listed in each and visited once per
+ *   query thanks to its stamp.
+ * - Insert, move and remove only touch the cells of the item. A move staying inside the same
+ *   cells only rewrites its bounds. A cell is erased once its last item leaves, so the table
+ *   follows the occupied area instead of every cell ever touched.
+ * - DrawScene queries the camera view of the calling thread (or the screen), so the cost of a
+ *   frame follows what is visible instead of the size of the scene.
+ * - With FLAG_PARTIAL_REDRAW, changing a drawn item damages its old and new screen bounds, seen
+ *   through the transform of the last DrawScene, and DrawScene only queries the damaged area.
+ *   Items must be changed before the scene is drawn in a frame for their damage to count in it.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+//==============================================================================================================
+// INCLUDES
+//==============================================================================================================
+#include "lecore_context.h"
+#include "lememory.h"
+#include "lerender.h"
+
+#include "levegl/lemath.h"
+#include "levegl/leutils.h"
+#include "levegl/levegl.h"
+
+#include <math.h>   /* fabsf, floorf, fminf, fmaxf */
+#include <string.h> /* memcpy, memset */
+
+//==============================================================================================================
+// DEFINES
+//==============================================================================================================
+#ifndef LE_SCENE_MAX_ITEM_CELLS
+#    define LE_SCENE_MAX_ITEM_CELLS 64
+#endif
+
+#ifndef LE_SCENE_INITIAL_CELLS
+#    define LE_SCENE_INITIAL_CELLS 256
+#endif
+
+// Cell coordinates are clamped so ranges never overflow an int
+#define LE_SCENE_MAX_CELL_COORDINATE ( 1 << 28 )
+
+// Shape of a released item ID
+#define SCENE_ITEM_FREE 0xFF
+
+// Bytes of one item across every array of the structure
+#define SCENE_ITEM_SIZE ( 4 * sizeof( float ) + sizeof( Color ) + sizeof( unsigned int ) + sizeof( unsigned char ) )
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+/// Slot of the cell hash table
+typedef struct SceneCell
+{
+    int   x;
+    int   y;
+    int * items; /// IDs of the items overlapping the cell
+    int   count;
+    int   capacity;
+    bool  used;
+} SceneCell;
+
+/// Inclusive range of cell coordinates
+typedef struct CellRange
+{
+    int minX;
+    int minY;
+    int maxX;
+    int maxY;
+} CellRange;
+
+typedef void ( *SceneVisitFunc )( Scene * scene, int id, void * userData );
+
+struct Scene
+{
+    float cellSize;
+    float inverseCellSize;
+
+    /// Items, one array per field carved from `itemMemory`, indexed by ID
+    void *          itemMemory;
+    float *         minX;
+    float *         minY;
+    float *         maxX;
+    float *         maxY;
+    Color *         colors;
+    unsigned int *  stamps; /// Query that last visited the item
+    unsigned char * shapes; /// SceneShape, SCENE_ITEM_FREE once removed
+    int             itemCount;
+    int             itemCapacity;
+
+    int * freeIds;
+    int   freeCount;
+    int   freeCapacity;
+
+    SceneCell * cells;
+    int         cellCount;
+    int         cellCapacity;
+
+    int * oversized; /// Items spanning more than LE_SCENE_MAX_ITEM_CELLS cells
+    int   oversizedCount;
+    int   oversizedCapacity;
+
+    unsigned int stamp;
+
+    /// Last DrawScene, its screen holds the items seen through `view`
+    LeContext * context;
+    Matrix2D    view;
+    bool        presented;
+};
+
+//==============================================================================================================
+// MODULE INTERNAL FUNCTIONS
+//==============================================================================================================
+// Grow `*array` to hold at least `required` elements, doubling the capacity
+static bool
+GrowArray( void ** array, int * capacity, int required, size_t elementSize, int minimum )
+{
+    if( LIKELY( required <= *capacity ) ) return true;
+
+    int newCapacity = ( *capacity > 0 ) ? *capacity * 2 : minimum;
+    while( newCapacity < required ) newCapacity *= 2;
+
+    void * grown = LE_REALLOC( *array, (size_t)newCapacity * elementSize );
+    if( NULL == grown )
+        {
+            TRACELOG( LOG_WARNING, "SCENE: Failed to grow array to %d elements", newCapacity );
+            return false;
+        }
+
+    TrackMemory( MEMORY_SCENES, (size_t)( newCapacity - *capacity ) * elementSize, true );
+
+    *array    = grown;
+    *capacity = newCapacity;
+    return true;
+}
+
+// Reallocate the item arrays together, so a failure never leaves them with different capacities
+static bool
+ReserveItems( Scene * scene, int required )
+{
+    if( LIKELY( required <= scene->itemCapacity ) ) return true;
+
+    int capacity = ( scene->itemCapacity > 0 ) ? scene->itemCapacity * 2 : 256;
+    while( capacity < required ) capacity *= 2;
+
+    unsigned char * memory = (unsigned char *)LE_MALLOC( (size_t)capacity * SCENE_ITEM_SIZE );
+    if( NULL == memory )
+        {
+            TRACELOG( LOG_WARNING, "SCENE: Failed to grow items to %d", capacity );
+            return false;
+        }
+
+    TrackMemory( MEMORY_SCENES, (size_t)( capacity - scene->itemCapacity ) * SCENE_ITEM_SIZE, true );
+
+    // Widest alignment first
+    float *         minX   = (float *)memory;
+    float *         minY   = minX + capacity;
+    float *         maxX   = minY + capacity;
+    float *         maxY   = maxX + capacity;
+    Color *         colors = (Color *)( maxY + capacity );
+    unsigned int *  stamps = (unsigned int *)( colors + capacity );
+    unsigned char * shapes = (unsigned char *)( stamps + capacity );
+
+    const size_t count = (size_t)scene->itemCount;
+    if( count > 0 )
+        {
+            memcpy( minX, scene->minX, count * sizeof( float ) );
+            memcpy( minY, scene->minY, count * sizeof( float ) );
+            memcpy( maxX, scene->maxX, count * sizeof( float ) );
+            memcpy( maxY, scene->maxY, count * sizeof( float ) );
+            memcpy( colors, scene->colors, count * sizeof( Color ) );
+            memcpy( stamps, scene->stamps, count * sizeof( unsigned int ) );
+            memcpy( shapes, scene->shapes, count * sizeof( unsigned char ) );
+        }
+
+    LE_FREE( scene->itemMemory );
+    scene->itemMemory   = memory;
+    scene->minX         = minX;
+    scene->minY         = minY;
+    scene->maxX         = maxX;
+    scene->maxY         = maxY;
+    scene->colors       = colors;
+    scene->stamps       = stamps;
+    scene->shapes       = shapes;
+    scene->itemCapacity = capacity;
+
+    return true;
+}
+
+static INLINE bool
+IsValidItem( const Scene * scene, int id )
+{
+    return ( NULL != scene ) && ( id >= 0 ) && ( id < scene->itemCount ) && ( SCENE_ITEM_FREE != scene->shapes[id] );
+}
+
+static INLINE int
+GetCellCoordinate( const Scene * scene, float value )
+{
+    const float cell = floorf( value * scene->inverseCellSize );
+
+    // fmaxf/fminf also turn NaN into a bound
+    return (int)fminf( fmaxf( cell, (float)-LE_SCENE_MAX_CELL_COORDINATE ), (float)LE_SCENE_MAX_CELL_COORDINATE );
+}
+
+static CellRange
+GetCellRange( const Scene * scene, float minX, float minY, float maxX, float maxY )
+{
+    CellRange range;
+    range.minX = GetCellCoordinate( scene, minX );
+    range.minY = GetCellCoordinate( scene, minY );
+    range.maxX = GetCellCoordinate( scene, maxX );
+    range.maxY = GetCellCoordinate( scene, maxY );
+    return range;
+}
+
+static INLINE long long
+GetCellRangeSize( CellRange range )
+{
+    return (long long)( range.maxX - range.minX + 1 ) * (long long)( range.maxY - range.minY + 1 );
+}
+
+static INLINE CellRange
+GetItemRange( const Scene * scene, int id )
+{
+    return GetCellRange( scene, scene->minX[id], scene->minY[id], scene->maxX[id], scene->maxY[id] );
+}
+
+static INLINE unsigned int
+HashCell( int x, int y )
+{
+    return ( (unsigned int)x * 73856093U ) ^ ( (unsigned int)y * 19349663U );
+}
+
+// Rehash into a table twice as large, cells keep their item arrays
+static bool
+GrowCells( Scene * scene )
+{
+    const int   capacity = ( scene->cellCapacity > 0 ) ? scene->cellCapacity * 2 : LE_SCENE_INITIAL_CELLS;
+    SceneCell * cells    = (SceneCell *)LE_CALLOC( (size_t)capacity, sizeof( SceneCell ) );
+    if( NULL == cells )
+        {
+            TRACELOG( LOG_WARNING, "SCENE: Failed to grow cell table to %d", capacity );
+            return false;
+        }
+
+    TrackMemory( MEMORY_SCENES, (size_t)( capacity - scene->cellCapacity ) * sizeof( SceneCell ), true );
+
+    const unsigned int mask = (unsigned int)capacity - 1;
+    for( int i = 0; i < scene->cellCapacity; ++i )
+        {
+            if( !scene->cells[i].used ) continue;
+
+            unsigned int slot = HashCell( scene->cells[i].x, scene->cells[i].y ) & mask;
+            while( cells[slot].used ) slot = ( slot + 1 ) & mask;
+            cells[slot] = scene->cells[i];
+        }
+
+    LE_FREE( scene->cells );
+    scene->cells        = cells;
+    scene->cellCapacity = capacity;
+
+    return true;
+}
+
+// Cell at (x, y), created when `create` is set, NULL when missing
+static SceneCell *
+FindCell( Scene * scene, int x, int y, bool create )
+{
+    if( create && ( scene->cellCount + 1 ) * 2 > scene->cellCapacity && !GrowCells( scene ) ) return NULL;
+    if( 0 == scene->cellCapacity ) return NULL;
+
+    const unsigned int mask = (unsigned int)scene->cellCapacity - 1;
+    unsigned int       slot = HashCell( x, y ) & mask;
+
+    // Erased cells shift their probe chain back, so probing stops at the first unused slot
+    while( scene->cells[slot].used )
+        {
+            if( scene->cells[slot].x == x && scene->cells[slot].y == y ) return &scene->cells[slot];
+            slot = ( slot + 1 ) & mask;
+        }
+
+    if( !create ) return NULL;
+
+    SceneCell * cell = &scene->cells[slot];
+    cell->x          = x;
+    cell->y          = y;
+    cell->used       = true;
+    ++scene->cellCount;
+
+    return cell;
+}
+
+// Remove an empty cell without tombstones, shifting back the cells of its probe chain
+static void
+EraseCell( Scene * scene, SceneCell * cell )
+{
+    TrackMemory( MEMORY_SCENES, (size_t)cell->capacity * sizeof( int ), false );
+    LE_FREE( cell->items );
+
+    const unsigned int mask = (unsigned int)scene->cellCapacity - 1;
+    unsigned int       hole = (unsigned int)( cell - scene->cells );
+
+    for( unsigned int slot = ( hole + 1 ) & mask; scene->cells[slot].used; slot = ( slot + 1 ) & mask )
+        {
+            const SceneCell *  next = &scene->cells[slot];
+            const unsigned int home = HashCell( next->x, next->y ) & mask;
+
+            // Move it when the hole lies between its home slot and where it sits now
+            if( ( ( slot - home ) & mask ) >= ( ( slot - hole ) & mask ) )
+                {
+                    scene->cells[hole] = *next;
+                    hole               = slot;
+                }
+        }
+
+    memset( &scene->cells[hole], 0, sizeof( SceneCell ) );
+    --scene->cellCount;
+}
+
+static bool
+AppendId( int ** ids, int * count, int * capacity, int id )
+{
+    if( !GrowArray( (void **)ids, capacity, *count + 1, sizeof( int ), 4 ) ) return false;
+
+    ( *ids )[( *count )++] = id;
+    return true;
+}
+
+// Swap-remove `id`, order inside a cell does not matter
+static void
+RemoveId( int * ids, int * count, int id )
+{
+    for( int i = 0; i < *count; ++i )
+        {
+            if( ids[i] != id ) continue;
+
+            ids[i] = ids[--( *count )];
+            return;
+        }
+}
+
+static bool
+LinkItem( Scene * scene, int id, CellRange range )
+{
+    if( GetCellRangeSize( range ) > LE_SCENE_MAX_ITEM_CELLS )
+        {
+            return AppendId( &scene->oversized, &scene->oversizedCount, &scene->oversizedCapacity, id );
+        }
+
+    for( int y = range.minY; y <= range.maxY; ++y )
+        {
+            for( int x = range.minX; x <= range.maxX; ++x )
+                {
+                    SceneCell * cell = FindCell( scene, x, y, true );
+                    if( NULL == cell || !AppendId( &cell->items, &cell->count, &cell->capacity, id ) ) return false;
+                }
+        }
+
+    return true;
+}
+
+// Also cleans up after a LinkItem that failed halfway
+static void
+UnlinkItem( Scene * scene, int id, CellRange range )
+{
+    if( GetCellRangeSize( range ) > LE_SCENE_MAX_ITEM_CELLS )
+        {
+            RemoveId( scene->oversized, &scene->oversizedCount, id );
+            return;
+        }
+
+    for( int y = range.minY; y <= range.maxY; ++y )
+        {
+            for( int x = range.minX; x <= range.maxX; ++x )
+                {
+                    SceneCell * cell = FindCell( scene, x, y, false );
+                    if( NULL == cell ) continue;
+
+                    RemoveId( cell->items, &cell->count, id );
+                    if( 0 == cell->count ) EraseCell( scene, cell );
+                }
+        }
+}
+
+static void
+SetItemBounds( Scene * scene, int id, Rectangle bounds )
+{
+    scene->minX[id] = fminf( bounds.x, bounds.x + bounds.width );
+    scene->minY[id] = fminf( bounds.y, bounds.y + bounds.height );
+    scene->maxX[id] = fmaxf( bounds.x, bounds.x + bounds.width );
+    scene->maxY[id] = fmaxf( bounds.y, bounds.y + bounds.height );
+}
+
+// Screen box of a world box seen through `m`
+static Rectangle
+MapArea( Matrix2D m, float minX, float minY, float maxX, float maxY )
+{
+    const float   extentX = ( maxX - minX ) * 0.5F;
+    const float   extentY = ( maxY - minY ) * 0.5F;
+    const Vector2 center  = Vector2Transform2D( ( Vector2 ){ minX + extentX, minY + extentY }, m );
+    const float   x       = fabsf( m.m0 ) * extentX + fabsf( m.m2 ) * extentY;
+    const float   y       = fabsf( m.m1 ) * extentX + fabsf( m.m3 ) * extentY;
+
+    Rectangle area = { center.x - x, center.y - y, 2.0F * x, 2.0F * y };
+    return area;
+}
+
+// Redraw the screen area of an item in the next frame, when the scene is on screen
+static void
+DamageItem( const Scene * scene, int id )
+{
+    if( !scene->presented || scene->context != GetCurrentContext() ) return;
+
+    // A pixel more covers the rasterization of edges and outlines
+    const Rectangle area = MapArea( scene->view, scene->minX[id], scene->minY[id], scene->maxX[id], scene->maxY[id] );
+    AddContextDamage( scene->context, area.x - 1.0F, area.y - 1.0F, area.x + area.width + 1.0F,
+                      area.y + area.height + 1.0F );
+}
+
+static INLINE bool
+IsItemInArea( const Scene * scene, int id, float minX, float minY, float maxX, float maxY )
+{
+    return ( scene->maxX[id] >= minX ) && ( scene->minX[id] <= maxX ) && ( scene->maxY[id] >= minY )
+        && ( scene->minY[id] <= maxY );
+}
+
+static void
+VisitCell( Scene * scene, const SceneCell * cell, const float area[4], SceneVisitFunc visit, void * userData )
+{
+    for( int i = 0; i < cell->count; ++i )
+        {
+            const int id = cell->items[i];
+            if( scene->stamps[id] == scene->stamp ) continue;
+
+            scene->stamps[id] = scene->stamp;
+            if( IsItemInArea( scene, id, area[0], area[1], area[2], area[3] ) ) visit( scene, id, userData );
+        }
+}
+
+// Call `visit` once for every item overlapping `area`
+static void
+VisitItems( Scene * scene, Rectangle area, SceneVisitFunc visit, void * userData )
+{
+    const float bounds[4] = {
+        fminf( area.x, area.x + area.width ),
+        fminf( area.y, area.y + area.height ),
+        fmaxf( area.x, area.x + area.width ),
+        fmaxf( area.y, area.y + area.height ),
+    };
+
+    // A new stamp per query, stale stamps are cleared once the counter wraps
+    if( 0 == ++scene->stamp )
+        {
+            if( scene->itemCount > 0 ) memset( scene->stamps, 0, (size_t)scene->itemCount * sizeof( unsigned int ) );
+            scene->stamp = 1;
+        }
+
+    for( int i = 0; i < scene->oversizedCount; ++i )
+        {
+            const int id = scene->oversized[i];
+            if( IsItemInArea( scene, id, bounds[0], bounds[1], bounds[2], bounds[3] ) ) visit( scene, id, userData );
+        }
+
+    const CellRange range = GetCellRange( scene, bounds[0], bounds[1], bounds[2], bounds[3] );
+
+    // Zoomed far out, walking the occupied cells is cheaper than probing every coordinate
+    if( GetCellRangeSize( range ) > (long long)scene->cellCount )
+        {
+            for( int i = 0; i < scene->cellCapacity; ++i )
+                {
+                    const SceneCell * cell = &scene->cells[i];
+                    if( !cell->used || cell->x < range.minX || cell->x > range.maxX || cell->y < range.minY
+                        || cell->y > range.maxY )
+                        {
+                            continue;
+                        }
+
+                    VisitCell( scene, cell, bounds, visit, userData );
+                }
+            return;
+        }
+
+    for( int y = range.minY; y <= range.maxY; ++y )
+        {
+            for( int x = range.minX; x <= range.maxX; ++x )
+                {
+                    const SceneCell * cell = FindCell( scene, x, y, false );
+                    if( NULL != cell ) VisitCell( scene, cell, bounds, visit, userData );
+                }
+        }
+}
+
+static void
+DrawSceneItem( Scene * scene, int id, void * userData )
+{
+    const float x      = scene->minX[id];
+    const float y      = scene->minY[id];
+    const float width  = scene->maxX[id] - x;
+    const float height = scene->maxY[id] - y;
+    const float radius = 0.5F * fminf( width, height );
+    const Color color  = scene->colors[id];
+
+    switch( scene->shapes[id] )
+        {
+        case SCENE_RECTANGLE:       DrawRectangle( x, y, width, height, color ); break;
+        case SCENE_RECTANGLE_LINES: DrawRectangleLines( x, y, width, height, color ); break;
+        case SCENE_CIRCLE:          DrawCircle( x + 0.5F * width, y + 0.5F * height, radius, color ); break;
+        case SCENE_CIRCLE_LINES:    DrawCircleLines( x + 0.5F * width, y + 0.5F * height, radius, color ); break;
+        default:                    break;
+        }
+
+    ++*(int *)userData;
+}
+
+/// Output of QueryScene
+typedef struct SceneQuery
+{
+    int * ids;
+    int   maxIds;
+    int   count;
+} SceneQuery;
+
+static void
+CollectSceneItem( Scene * scene, int id, void * userData )
+{
+    UNUSED( scene );
+
+    SceneQuery * query = (SceneQuery *)userData;
+    if( query->count < query->maxIds ) query->ids[query->count] = id;
+    ++query->count;
+}
+
+//==============================================================================================================
+// MODULE FUNCTIONS DEFINITIONS
+//==============================================================================================================
+Scene *
+CreateScene( float cellSize )
+{
+    if( !( cellSize > 0.0F ) )
+        {
+            TRACELOG( LOG_WARNING, "SCENE: Invalid cell size %f", cellSize );
+            return NULL;
+        }
+
+    Scene * scene = (Scene *)LE_CALLOC( 1, sizeof( Scene ) );
+    if( NULL == scene )
+        {
+            TRACELOG( LOG_ERROR, "SCENE: Failed to allocate scene" );
+            return NULL;
+        }
+
+    TrackMemory( MEMORY_SCENES, sizeof( Scene ), true );
+
+    scene->cellSize        = cellSize;
+    scene->inverseCellSize = 1.0F / cellSize;
+
+    return scene;
+}
+
+void
+DestroyScene( Scene * scene )
+{
+    if( NULL == scene ) return;
+
+    size_t bytes = sizeof( Scene ) + (size_t)scene->itemCapacity * SCENE_ITEM_SIZE
+                 + (size_t)scene->freeCapacity * sizeof( int ) + (size_t)scene->oversizedCapacity * sizeof( int )
+                 + (size_t)scene->cellCapacity * sizeof( SceneCell );
+
+    for( int i = 0; i < scene->cellCapacity; ++i )
+        {
+            bytes += (size_t)scene->cells[i].capacity * sizeof( int );
+            LE_FREE( scene->cells[i].items );
+        }
+
+    LE_FREE( scene->cells );
+    LE_FREE( scene->oversized );
+    LE_FREE( scene->freeIds );
+    LE_FREE( scene->itemMemory );
+    LE_FREE( scene );
+
+    TrackMemory( MEMORY_SCENES, bytes, false );
+}
+
+int
+AddSceneItem( Scene * scene, int shape, Rectangle bounds, Color color )
+{
+    if( NULL == scene || shape < SCENE_RECTANGLE || shape > SCENE_CIRCLE_LINES ) return -1;
+
+    int id = -1;
+    if( scene->freeCount > 0 )
+        {
+            id = scene->freeIds[--scene->freeCount];
+        }
+    else
+        {
+            if( !ReserveItems( scene, scene->itemCount + 1 ) ) return -1;
+            id = scene->itemCount++;
+        }
+
+    SetItemBounds( scene, id, bounds );
+    scene->colors[id] = color;
+    scene->stamps[id] = 0;
+    scene->shapes[id] = (unsigned char)shape;
+    DamageItem( scene, id );
+
+    const CellRange range = GetItemRange( scene, id );
+    if( !LinkItem( scene, id, range ) )
+        {
+            RemoveSceneItem( scene, id );
+            return -1;
+        }
+
+    return id;
+}
+
+void
+MoveSceneItem( Scene * scene, int id, Rectangle bounds )
+{
+    if( !IsValidItem( scene, id ) ) return;
+
+    const CellRange previous = GetItemRange( scene, id );
+    DamageItem( scene, id );
+    SetItemBounds( scene, id, bounds );
+    DamageItem( scene, id );
+    const CellRange current = GetItemRange( scene, id );
+
+    if( 0 == memcmp( &previous, &current, sizeof( CellRange ) ) ) return;
+
+    UnlinkItem( scene, id, previous );
+    if( !LinkItem( scene, id, current ) )
+        {
+            TRACELOG( LOG_WARNING, "SCENE: Failed to move item %d, removing it", id );
+            RemoveSceneItem( scene, id );
+        }
+}
+
+void
+SetSceneItemColor( Scene * scene, int id, Color color )
+{
+    if( !IsValidItem( scene, id ) ) return;
+
+    scene->colors[id] = color;
+    DamageItem( scene, id );
+}
+
+void
+RemoveSceneItem( Scene * scene, int id )
+{
+    if( !IsValidItem( scene, id ) ) return;
+
+    DamageItem( scene, id );
+    UnlinkItem( scene, id, GetItemRange( scene, id ) );
+    scene->shapes[id] = SCENE_ITEM_FREE;
+
+    // The ID is lost when the free list cannot grow, the item stays released
+    AppendId( &scene->freeIds, &scene->freeCount, &scene->freeCapacity, id );
+}
+
+// Store up to `maxIds` items overlapping `area` into `ids`, returns how many overlap in total
+int
+QueryScene( Scene * scene, Rectangle area, int * ids, int maxIds )
+{
+    if( NULL == scene ) return 0;
+
+    SceneQuery query = { ids, ( NULL != ids ) ? maxIds : 0, 0 };
+    VisitItems( scene, area, CollectSceneItem, &query );
+
+    return query.count;
+}
+
+// Draw the items overlapping the camera view (or the screen) of the calling thread, or its damage
+int
+DrawScene( Scene * scene )
+{
+    if( NULL == scene ) return 0;
+
+    LE_PROFILE_BEGIN( "DrawScene" );
+
+    LeContext *    context = GetCurrentContext();
+    const float    width   = (float)context->core.window.screen.width;
+    const float    height  = (float)context->core.window.screen.height;
+    const Matrix2D view    = GetDrawMatrix();
+
+    // Seen from elsewhere, every pixel of the scene may have changed
+    if( !scene->presented || scene->context != context || 0 != memcmp( &scene->view, &view, sizeof( Matrix2D ) ) )
+        {
+            AddContextDamage( context, 0.0F, 0.0F, width, height );
+        }
+
+    scene->context   = context;
+    scene->view      = view;
+    scene->presented = true;
+
+    int       drawn = 0;
+    Rectangle area  = GetVisibleArea();
+    Rectangle damage;
+    if( GetFrameDamage( &damage ) )
+        {
+            const float minX = fmaxf( damage.x, 0.0F );
+            const float minY = fmaxf( damage.y, 0.0F );
+            const float maxX = fminf( damage.x + damage.width, width );
+            const float maxY = fminf( damage.y + damage.height, height );
+
+            // Nothing damaged, the previous image of the scene stays on screen
+            if( maxX <= minX || maxY <= minY )
+                {
+                    LE_PROFILE_END();
+                    return 0;
+                }
+
+            area = MapArea( Matrix2DInvert( view ), minX, minY, maxX, maxY );
+        }
+
+    VisitItems( scene, area, DrawSceneItem, &drawn );
+
+    LE_PROFILE_END();
+
+    return drawn;
+}
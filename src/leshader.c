@@ -1,15 +1,108 @@
+#include "lememory.h"
+#include "lerender.h"
+
 #include "levegl/leutils.h"
 #include "levegl/levegl.h"
 
+#undef LEGL_IMPLEMENTATION
+#include "levegl/legl.h"
+
 #include <stdio.h>
 #include <stdlib.h>
 #include <string.h>
 
-static Shader currentShader = { 0 };
+// Default shader code, used for the shapes batch and for any NULL stage. Every vertex samples
+// the bound texture, solid colors sample a white texel. A negative layer marks distance field
+// glyphs, whose alpha is a distance thresholded at 0.5 over about one pixel
+#if defined( GRAPHICS_API_OPENGL_ES2 )
+static const char * defaultVertexShaderCode = "#version 100\n"
+                                              "attribute vec2 vertexPosition;\n"
+                                              "attribute vec4 vertexColor;\n"
+                                              "attribute vec2 vertexTexCoord;\n"
+                                              "attribute float vertexLayer;\n"
+                                              "uniform mat4 mvp;\n"
+                                              "varying vec4 fragColor;\n"
+                                              "varying vec2 fragTexCoord;\n"
+                                              "varying float fragDistance;\n"
+                                              "void main()\n"
+                                              "{\n"
+                                              "   fragColor = vertexColor;\n"
+                                              "   fragTexCoord = vertexTexCoord;\n"
+                                              "   fragDistance = (vertexLayer < 0.0) ? 1.0 : 0.0;\n"
+                                              "   gl_Position = mvp * vec4(vertexPosition, 0.0, 1.0);\n"
+                                              "}\n";
+
+static const char * defaultFragmentShaderCode = "#version 100\n"
+                                                "#ifdef GL_OES_standard_derivatives\n"
+                                                "#extension GL_OES_standard_derivatives : enable\n"
+                                                "#endif\n"
+                                                "precision mediump float;\n"
+                                                "varying vec4 fragColor;\n"
+                                                "varying vec2 fragTexCoord;\n"
+                                                "varying float fragDistance;\n"
+                                                "uniform sampler2D texture0;\n"
+                                                "void main()\n"
+                                                "{\n"
+                                                "   vec4 texel = texture2D(texture0, fragTexCoord);\n"
+                                                "#ifdef GL_OES_standard_derivatives\n"
+                                                "   float width = max(0.5 * fwidth(texel.a), 1.0 / 256.0);\n"
+                                                "#else\n"
+                                                "   float width = 0.0625;\n"
+                                                "#endif\n"
+                                                "   float coverage = smoothstep(0.5 - width, 0.5 + width, texel.a);\n"
+                                                "   texel.a = mix(texel.a, coverage, fragDistance);\n"
+                                                "   gl_FragColor = texel * fragColor;\n"
+                                                "}\n";
+#else
+static const char * defaultVertexShaderCode = "#version 330 core\n"
+                                              "in vec2 vertexPosition;\n"
+                                              "in vec4 vertexColor;\n"
+                                              "in vec2 vertexTexCoord;\n"
+                                              "in float vertexLayer;\n"
+                                              "uniform mat4 mvp;\n"
+                                              "out vec4 fragColor;\n"
+                                              "out vec3 fragTexCoord;\n"
+                                              "out float fragDistance;\n"
+                                              "void main()\n"
+                                              "{\n"
+                                              "   fragColor = vertexColor;\n"
+                                              "   fragDistance = (vertexLayer < 0.0) ? 1.0 : 0.0;\n"
+                                              "   fragTexCoord = vec3(vertexTexCoord, abs(vertexLayer + 0.5) - 0.5);\n"
+                                              "   gl_Position = mvp * vec4(vertexPosition, 0.0, 1.0);\n"
+                                              "}\n";
+
+static const char * defaultFragmentShaderCode = "#version 330 core\n"
+                                                "in vec4 fragColor;\n"
+                                                "in vec3 fragTexCoord;\n"
+                                                "in float fragDistance;\n"
+                                                "uniform sampler2DArray texture0;\n"
+                                                "out vec4 finalColor;\n"
+                                                "void main()\n"
+                                                "{\n"
+                                                "   vec4 texel = texture(texture0, fragTexCoord);\n"
+                                                "   float width = max(0.5 * fwidth(texel.a), 1.0 / 256.0);\n"
+                                                "   float coverage = smoothstep(0.5 - width, 0.5 + width, texel.a);\n"
+                                                "   texel.a = mix(texel.a, coverage, fragDistance);\n"
+                                                "   finalColor = texel * fragColor;\n"
+                                                "}\n";
+#endif
+
+// Arguments of the GL work forwarded to the render thread
+typedef struct ShaderTask
+{
+    const char * vsCode;
+    const char * fsCode;
+    const char * uniformName;
+    Shader *     shader;
+    int          location;
+} ShaderTask;
 
+// Whole file as a string, `bytes` receives the allocation size for UnloadFileText
 static char *
-LoadFileText( const char * fileName )
+LoadFileText( const char * fileName, size_t * bytes )
 {
+    *bytes = 0;
+
     FILE * file = fopen( fileName, "rt" );
     if( !file )
         {
@@ -21,51 +114,156 @@ LoadFileText( const char * fileName )
     int size = ftell( file );
     fseek( file, 0, SEEK_SET );
 
-    char * text  = (char *)malloc( ( size + 1 ) * sizeof( char ) );
-    int    count = fread( text, sizeof( char ), size, file );
-    text[count]  = '\0';
+    char * text = (char *)LE_MALLOC( ( size + 1 ) * sizeof( char ) );
+    if( !text )
+        {
+            fclose( file );
+            return NULL;
+        }
+
+    int count   = fread( text, sizeof( char ), size, file );
+    text[count] = '\0';
+
+    *bytes = (size_t)size + 1;
+    TrackMemory( MEMORY_FILE_DATA, *bytes, true );
 
     fclose( file );
     return text;
 }
 
-static bool
-CompileShader( int id, const char * shaderCode, int type )
+static void
+UnloadFileText( char * text, size_t bytes )
+{
+    if( NULL == text ) return;
+
+    TrackMemory( MEMORY_FILE_DATA, bytes, false );
+    LE_FREE( text );
+}
+
+static void
+LoadShaderTask( void * userData )
+{
+    ShaderTask * task = (ShaderTask *)userData;
+
+    task->shader->id = leLoadShaderProgram( task->vsCode, task->fsCode );
+    if( 0 != task->shader->id )
+        {
+            task->shader->locations[SHADER_LOC_MATRIX_MVP]
+                = leGetLocationUniform( task->shader->id, LE_DEFAULT_SHADER_UNIFORM_NAME_MVP );
+        }
+}
+
+static void
+UnloadShaderTask( void * userData )
+{
+    ShaderTask * task = (ShaderTask *)userData;
+    leUnloadShaderProgram( task->shader->id );
+}
+
+static void
+GetShaderLocationTask( void * userData )
 {
-    return false;
+    ShaderTask * task = (ShaderTask *)userData;
+    task->location    = leGetLocationUniform( task->shader->id, task->uniformName );
 }
 
 Shader
 LoadShader( const char * vsFileName, const char * fsFileName )
 {
-    return (Shader) { 0 };
+    LE_PROFILE_ZONE( "LoadShader" );
+
+    size_t vsBytes = 0;
+    size_t fsBytes = 0;
+    char * vsCode  = STR_NONEMPTY( vsFileName ) ? LoadFileText( vsFileName, &vsBytes ) : NULL;
+    char * fsCode  = STR_NONEMPTY( fsFileName ) ? LoadFileText( fsFileName, &fsBytes ) : NULL;
+
+    Shader shader = LoadShaderFromMemory( vsCode, fsCode );
+
+    UnloadFileText( vsCode, vsBytes );
+    UnloadFileText( fsCode, fsBytes );
+
+    return shader;
 }
 
 Shader
 LoadShaderFromMemory( const char * vsCode, const char * fsCode )
 {
-    return (Shader) { 0 };
+    LE_PROFILE_ZONE( "LoadShaderFromMemory" );
+
+    Shader shader = { 0 };
+
+    shader.locations = (int *)LE_MALLOC( LE_MAX_SHADER_LOCATIONS * sizeof( int ) );
+    if( NULL == shader.locations ) return shader;
+
+    for( int i = 0; i < LE_MAX_SHADER_LOCATIONS; ++i ) shader.locations[i] = -1;
+
+    ShaderTask task = { 0 };
+    task.vsCode     = ( NULL != vsCode ) ? vsCode : defaultVertexShaderCode;
+    task.fsCode     = ( NULL != fsCode ) ? fsCode : defaultFragmentShaderCode;
+    task.shader     = &shader;
+
+    InvokeOnRenderThread( LoadShaderTask, &task );
+
+    if( 0 == shader.id )
+        {
+            TRACELOG( LOG_WARNING, "SHADER: Failed to load shader" );
+            LE_FREE( shader.locations );
+            shader.locations = NULL;
+            return shader;
+        }
+
+    shader.locCount = LE_MAX_SHADER_LOCATIONS;
+    shader.active   = true;
+
+    TrackMemory( MEMORY_SHADERS, LE_MAX_SHADER_LOCATIONS * sizeof( int ), true );
+
+    return shader;
 }
 
 void
 UnloadShader( Shader shader )
 {
+    if( 0 != shader.id )
+        {
+            ShaderTask task = { 0 };
+            task.shader     = &shader;
+
+            InvokeOnRenderThread( UnloadShaderTask, &task );
+        }
+
+    if( NULL != shader.locations ) TrackMemory( MEMORY_SHADERS, (size_t)shader.locCount * sizeof( int ), false );
+    LE_FREE( shader.locations );
 }
 
+// The program is state of the calling thread's stream, calls repeating it record nothing
 void
 BeginShaderMode( Shader shader )
 {
+    if( !shader.active ) return;
+
+    RecordShader( shader.id, shader.locations[SHADER_LOC_MATRIX_MVP] );
 }
 
 void
 EndShaderMode( void )
 {
+    RecordShader( 0, -1 );
 }
 
 int
 GetShaderLocation( Shader shader, const char * uniformName )
 {
-    return 0;
+    if( 0 == shader.id ) return -1;
+
+    ShaderTask task  = { 0 };
+    task.shader      = &shader;
+    task.uniformName = uniformName;
+    task.location    = -1;
+
+    InvokeOnRenderThread( GetShaderLocationTask, &task );
+
+    if( task.location < 0 ) TRACELOG( LOG_WARNING, "SHADER: [ID %u] Uniform not found: %s", shader.id, uniformName );
+    return task.location;
 }
 
 void
@@ -77,4 +275,5 @@ SetShaderValue( Shader shader, int locIndex, const void * value, int uniformType
 void
 SetShaderValueV( Shader shader, int locIndex, const void * value, int uniformType, int count )
 {
+    RecordUniform( shader.id, locIndex, value, uniformType, count );
 }
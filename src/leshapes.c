@@ -1,109 +1,747 @@
 #include "lecore_context.h"
+#include "lememory.h"
+#include "lepolygon.h"
+#include "lerender.h"
+#include "lesystem.h"
 
+#include "levegl/leutils.h"
 #include "levegl/levegl.h"
 
+#undef LEGL_IMPLEMENTATION
+#include "levegl/legl.h"
+
 #include <math.h>
-#include <string.h>
-
-extern CoreContext core;
-
-// Basic shapes shader code
-static const char * basicShapesVS = "#version 330 core\n"
-                                    "layout (location = 0) in vec2 aPos;\n"
-                                    "uniform vec4 uColor;\n"
-                                    "out vec4 vertexColor;\n"
-                                    "void main()\n"
-                                    "{\n"
-                                    "   gl_Position = vec4(aPos.x, aPos.y, 0.0, 1.0);\n"
-                                    "   vertexColor = uColor;\n"
-                                    "}\0";
-
-static const char * basicShapesFS = "#version 330 core\n"
-                                    "in vec4 vertexColor;\n"
-                                    "out vec4 FragColor;\n"
-                                    "void main()\n"
-                                    "{\n"
-                                    "   FragColor = vertexColor;\n"
-                                    "}\0";
+
+// Maximum distance, in pixels, between a circle and its polygon approximation
+#ifndef SMOOTH_CIRCLE_ERROR_RATE
+#    define SMOOTH_CIRCLE_ERROR_RATE 0.5F
+#endif
+
+#ifndef MAX_CIRCLE_SEGMENTS
+#    define MAX_CIRCLE_SEGMENTS 256
+#endif
+
+// Maximum distance, in pixels, between a Bezier curve and its flattened polyline
+#ifndef SMOOTH_BEZIER_ERROR_RATE
+#    define SMOOTH_BEZIER_ERROR_RATE 0.25F
+#endif
+
+#ifndef MAX_BEZIER_SEGMENTS
+#    define MAX_BEZIER_SEGMENTS 512
+#endif
+
+// Miter length, in line widths, past which a miter join is beveled
+#ifndef LINE_MITER_LIMIT
+#    define LINE_MITER_LIMIT 4.0F
+#endif
 
 // Internal state for shapes rendering
-typedef struct
+struct ShapesState
 {
     Shader shader;
-    //GLuint VAO;
-    //GLuint VBO;
-    int currentBufferSize;
-    int colorLocation;
-} ShapesState;
 
-static ShapesState shapesState = { 0 };
-
-static void
-InitShapesBuffers( void )
-{
-}
+    leMutex      polygonLock; /// Guards the cache, polygons may be drawn from several threads
+    PolygonCache polygons;
+};
 
 void
 InitShapes( void )
 {
+    ShapesState * shapes = (ShapesState *)LE_CALLOC( 1, sizeof( ShapesState ) );
+    if( NULL == shapes )
+        {
+            TRACELOG( LOG_ERROR, "SHAPES: Failed to allocate shapes state" );
+            return;
+        }
+
+    GetCurrentContext()->shapes = shapes;
+    leMutexInit( &shapes->polygonLock );
+
+    shapes->shader = LoadShaderFromMemory( NULL, NULL );
+    if( NULL != shapes->shader.locations )
+        {
+            SetRendererDefaultShader( shapes->shader.id, shapes->shader.locations[SHADER_LOC_MATRIX_MVP] );
+        }
 }
 
 void
 CleanupShapes( void )
 {
+    ShapesState * shapes = GetCurrentContext()->shapes;
+    if( NULL == shapes ) return;
+
+    UnloadShader( shapes->shader );
+
+    ReleasePolygonCache( &shapes->polygons );
+    leMutexDestroy( &shapes->polygonLock );
+
+    LE_FREE( shapes );
+    GetCurrentContext()->shapes = NULL;
 }
 
-static void
-UpdateVertexBuffer( const float * vertices, int size )
+// Template vertex carrying the color and a white texel, converted once per primitive
+static RenderVertex
+ShapeVertex( Color color )
 {
+    RenderVertex vertex = GetWhiteVertex();
+    SetVertexColor( &vertex, color );
+    return vertex;
 }
 
-static void
-ScreenToNDC( float x, float y, float * ndcX, float * ndcY )
+static INLINE void
+SetVertex( RenderVertex * vertex, RenderVertex base, float x, float y )
 {
+    *vertex   = base;
+    vertex->x = x;
+    vertex->y = y;
+}
+
+// Segments needed to keep the chord error under SMOOTH_CIRCLE_ERROR_RATE
+static int
+GetCircleSegments( float radius )
+{
+    if( radius <= SMOOTH_CIRCLE_ERROR_RATE ) return 8;
+
+    const float ratio = 1.0F - SMOOTH_CIRCLE_ERROR_RATE / radius;
+    const float theta = acosf( 2.0F * ratio * ratio - 1.0F );
+
+    int segments = (int)ceilf( TAU / theta );
+    if( segments < 8 ) segments = 8;
+    if( segments > MAX_CIRCLE_SEGMENTS ) segments = MAX_CIRCLE_SEGMENTS;
+
+    return segments;
+}
+
+static INLINE bool
+IsTriangleVisible( float x1, float y1, float x2, float y2, float x3, float y3 )
+{
+    return IsAreaVisible( fminf( x1, fminf( x2, x3 ) ), fminf( y1, fminf( y2, y3 ) ), fmaxf( x1, fmaxf( x2, x3 ) ),
+                          fmaxf( y1, fmaxf( y2, y3 ) ) );
 }
 
 static void
-SetShapeColor( Color color )
+DrawQuad( float x, float y, float width, float height, RenderVertex base )
 {
+    if( !IsAreaVisible( fminf( x, x + width ), fminf( y, y + height ), fmaxf( x, x + width ), fmaxf( y, y + height ) ) )
+        return;
+
+    RenderVertex * v = RecordVertices( LE_QUADS, 4 );
+    if( NULL == v ) return;
+
+    SetVertex( &v[0], base, x, y );
+    SetVertex( &v[1], base, x, y + height );
+    SetVertex( &v[2], base, x + width, y + height );
+    SetVertex( &v[3], base, x + width, y );
+
+    TransformVertices( v, 4 );
 }
 
 void
 DrawPixel( int x, int y, Color color )
 {
+    DrawQuad( (float)x, (float)y, 1.0F, 1.0F, ShapeVertex( color ) );
 }
 
 void
 DrawLine( int startX, int startY, int endX, int endY, Color color )
 {
+    const float x1 = (float)startX, y1 = (float)startY;
+    const float x2 = (float)endX, y2 = (float)endY;
+    if( !IsAreaVisible( fminf( x1, x2 ), fminf( y1, y2 ), fmaxf( x1, x2 ) + 1.0F, fmaxf( y1, y2 ) + 1.0F ) ) return;
+
+    RenderVertex * v = RecordVertices( LE_LINES, 2 );
+    if( NULL == v ) return;
+
+    // Pixel centers, so integer coordinates rasterize predictably
+    const RenderVertex base = ShapeVertex( color );
+    SetVertex( &v[0], base, x1 + 0.5F, y1 + 0.5F );
+    SetVertex( &v[1], base, x2 + 0.5F, y2 + 0.5F );
+
+    TransformVertices( v, 2 );
 }
 
 void
 DrawTriangle( float x1, float y1, float x2, float y2, float x3, float y3, Color color )
 {
+    if( !IsTriangleVisible( x1, y1, x2, y2, x3, y3 ) ) return;
+
+    RenderVertex * v = RecordVertices( LE_TRIANGLES, 3 );
+    if( NULL == v ) return;
+
+    const RenderVertex base = ShapeVertex( color );
+    SetVertex( &v[0], base, x1, y1 );
+    SetVertex( &v[1], base, x2, y2 );
+    SetVertex( &v[2], base, x3, y3 );
+
+    TransformVertices( v, 3 );
 }
 
 void
 DrawTriangleLines( float x1, float y1, float x2, float y2, float x3, float y3, Color color )
 {
+    if( !IsTriangleVisible( x1, y1, x2, y2, x3, y3 ) ) return;
+
+    RenderVertex * v = RecordVertices( LE_LINES, 6 );
+    if( NULL == v ) return;
+
+    const RenderVertex base = ShapeVertex( color );
+    SetVertex( &v[0], base, x1, y1 );
+    SetVertex( &v[1], base, x2, y2 );
+    SetVertex( &v[2], base, x2, y2 );
+    SetVertex( &v[3], base, x3, y3 );
+    SetVertex( &v[4], base, x3, y3 );
+    SetVertex( &v[5], base, x1, y1 );
+
+    TransformVertices( v, 6 );
 }
 
 void
 DrawRectangle( float x, float y, float width, float height, Color color )
 {
+    DrawQuad( x, y, width, height, ShapeVertex( color ) );
 }
 
 void
 DrawRectangleLines( float x, float y, float width, float height, Color color )
 {
+    if( !IsAreaVisible( fminf( x, x + width ), fminf( y, y + height ), fmaxf( x, x + width ), fmaxf( y, y + height ) ) )
+        return;
+
+    RenderVertex * v = RecordVertices( LE_LINES, 8 );
+    if( NULL == v ) return;
+
+    // Outline through the centers of the border pixels
+    const float left   = x + 0.5F;
+    const float top    = y + 0.5F;
+    const float right  = x + width - 0.5F;
+    const float bottom = y + height - 0.5F;
+
+    const RenderVertex base = ShapeVertex( color );
+    SetVertex( &v[0], base, left, top );
+    SetVertex( &v[1], base, right, top );
+    SetVertex( &v[2], base, right, top );
+    SetVertex( &v[3], base, right, bottom );
+    SetVertex( &v[4], base, right, bottom );
+    SetVertex( &v[5], base, left, bottom );
+    SetVertex( &v[6], base, left, bottom );
+    SetVertex( &v[7], base, left, top );
+
+    TransformVertices( v, 8 );
 }
 
 void
 DrawCircle( float centerX, float centerY, float radius, Color color )
 {
+    if( !IsAreaVisible( centerX - radius, centerY - radius, centerX + radius, centerY + radius ) ) return;
+
+    const int segments = GetCircleSegments( radius );
+    const int quads    = ( segments + 1 ) / 2;
+
+    // Two fan triangles per quad around the center, an odd last one repeats its final rim point
+    RenderVertex * vertices = RecordVertices( LE_QUADS, quads * 4 );
+    if( NULL == vertices ) return;
+
+    const RenderVertex base = ShapeVertex( color );
+    const float        step = TAU / (float)segments;
+
+    RenderVertex * v = vertices;
+    for( int i = 0; i < segments; i += 2, v += 4 )
+        {
+            const int last = ( i + 2 < segments ) ? i + 2 : segments;
+
+            SetVertex( &v[0], base, centerX, centerY );
+            SetVertex( &v[1], base, centerX + cosf( step * (float)i ) * radius,
+                       centerY + sinf( step * (float)i ) * radius );
+            SetVertex( &v[2], base, centerX + cosf( step * (float)( i + 1 ) ) * radius,
+                       centerY + sinf( step * (float)( i + 1 ) ) * radius );
+            SetVertex( &v[3], base, centerX + cosf( step * (float)last ) * radius,
+                       centerY + sinf( step * (float)last ) * radius );
+        }
+
+    TransformVertices( vertices, quads * 4 );
 }
 
 void
 DrawCircleLines( float centerX, float centerY, float radius, Color color )
 {
+    if( !IsAreaVisible( centerX - radius, centerY - radius, centerX + radius, centerY + radius ) ) return;
+
+    const int segments = GetCircleSegments( radius );
+
+    RenderVertex * vertices = RecordVertices( LE_LINES, segments * 2 );
+    if( NULL == vertices ) return;
+
+    const RenderVertex base = ShapeVertex( color );
+    const float        step = TAU / (float)segments;
+
+    float previousX = centerX + radius;
+    float previousY = centerY;
+
+    RenderVertex * v = vertices;
+    for( int i = 1; i <= segments; ++i, v += 2 )
+        {
+            const float x = centerX + cosf( step * (float)i ) * radius;
+            const float y = centerY + sinf( step * (float)i ) * radius;
+
+            SetVertex( &v[0], base, previousX, previousY );
+            SetVertex( &v[1], base, x, y );
+
+            previousX = x;
+            previousY = y;
+        }
+
+    TransformVertices( vertices, segments * 2 );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Polygons
+//----------------------------------------------------------------------------------------------------------------------
+static bool
+IsPolygonVisible( const Vector2 * points, int count )
+{
+    float minX = points[0].x, minY = points[0].y, maxX = points[0].x, maxY = points[0].y;
+    for( int i = 1; i < count; ++i )
+        {
+            minX = fminf( minX, points[i].x );
+            minY = fminf( minY, points[i].y );
+            maxX = fmaxf( maxX, points[i].x );
+            maxY = fmaxf( maxY, points[i].y );
+        }
+    return IsAreaVisible( minX, minY, maxX, maxY );
+}
+
+static void
+DrawPolygonTriangles( RenderVertex base, const Vector2 * points, const unsigned int * indices, int indexCount )
+{
+    RenderVertex * v = RecordVertices( LE_TRIANGLES, indexCount );
+    if( NULL == v ) return;
+
+    for( int i = 0; i < indexCount; ++i )
+        {
+            const Vector2 point = points[indices[i]];
+            SetVertex( &v[i], base, point.x, point.y );
+        }
+    TransformVertices( v, indexCount );
+}
+
+// Convex polygons fan from their first point, others are triangulated once and cached by content
+void
+DrawPolygon( const Vector2 * points, int pointCount, Color color )
+{
+    if( NULL == points || pointCount < 3 ) return;
+
+    const RenderVertex base = ShapeVertex( color );
+
+    if( IsPolygonConvex( points, pointCount ) )
+        {
+            if( !IsPolygonVisible( points, pointCount ) ) return;
+
+            // Fan triangles paired into quads, an odd last one repeats its final point
+            const int      count    = ( pointCount - 1 ) / 2 * 4;
+            RenderVertex * vertices = RecordVertices( LE_QUADS, count );
+            if( NULL == vertices ) return;
+
+            RenderVertex * v = vertices;
+            for( int i = 1; i < pointCount - 1; i += 2, v += 4 )
+                {
+                    const int last = ( i + 2 < pointCount ) ? i + 2 : i + 1;
+
+                    SetVertex( &v[0], base, points[0].x, points[0].y );
+                    SetVertex( &v[1], base, points[i].x, points[i].y );
+                    SetVertex( &v[2], base, points[i + 1].x, points[i + 1].y );
+                    SetVertex( &v[3], base, points[last].x, points[last].y );
+                }
+
+            TransformVertices( vertices, count );
+            return;
+        }
+
+    LeContext *   context = GetCurrentContext();
+    ShapesState * shapes  = ( NULL != context ) ? context->shapes : NULL;
+    if( NULL == shapes ) return;
+
+    leMutexLock( &shapes->polygonLock );
+
+    const PolygonEntry * entry
+        = GetPolygonEntry( &shapes->polygons, points, pointCount, context->core.timing.frameCounter );
+    if( NULL != entry )
+        {
+            if( IsAreaVisible( entry->minX, entry->minY, entry->maxX, entry->maxY ) )
+                {
+                    DrawPolygonTriangles( base, entry->points, entry->indices, entry->indexCount );
+                }
+            leMutexUnlock( &shapes->polygonLock );
+            return;
+        }
+
+    leMutexUnlock( &shapes->polygonLock );
+
+    // Every cached outline was drawn this frame, this one is triangulated without being kept
+    if( !IsPolygonVisible( points, pointCount ) ) return;
+
+    unsigned int * indices = (unsigned int *)LE_MALLOC( (size_t)( pointCount - 2 ) * 3 * sizeof( unsigned int ) );
+    if( NULL == indices ) return;
+
+    DrawPolygonTriangles( base, points, indices, TriangulatePolygon( points, pointCount, indices ) );
+    LE_FREE( indices );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Strokes
+//----------------------------------------------------------------------------------------------------------------------
+static INLINE Vector2
+GetSegmentNormal( Vector2 from, Vector2 to )
+{
+    const float dx     = to.x - from.x;
+    const float dy     = to.y - from.y;
+    const float length = sqrtf( dx * dx + dy * dy );
+    return (Vector2){ -dy / length, dx / length };
+}
+
+// Pie slices of a round join turning `angle` radians
+static INLINE int
+GetRoundJoinSegments( float angle, float halfWidth )
+{
+    const int segments = (int)ceilf( fabsf( angle ) * (float)GetCircleSegments( halfWidth ) / TAU );
+    return ( segments > 0 ) ? segments : 1;
+}
+
+// Vertices filling the outer side of the corner between two segments, written when `v` is not NULL.
+// The inner sides of the segment quads overlap
+static int
+AddStrokeJoin( RenderVertex * v, RenderVertex base, Vector2 p, Vector2 n0, Vector2 n1, float halfWidth, int join )
+{
+    const float turn = n0.x * n1.y - n0.y * n1.x;
+    const float dot  = n0.x * n1.x + n0.y * n1.y;
+    if( fabsf( turn ) < 1e-6F && dot > 0.0F ) return 0;
+
+    // The outer side is the one the path turns away from
+    const float   side   = ( turn > 0.0F ) ? -1.0F : 1.0F;
+    const Vector2 outerA = { p.x + side * n0.x * halfWidth, p.y + side * n0.y * halfWidth };
+    const Vector2 outerB = { p.x + side * n1.x * halfWidth, p.y + side * n1.y * halfWidth };
+
+    if( LINE_JOIN_ROUND == join )
+        {
+            const float start    = atan2f( side * n0.y, side * n0.x );
+            float       sweep    = atan2f( side * n1.y, side * n1.x ) - start;
+            sweep                = ( sweep > PI ) ? sweep - TAU : ( sweep < -PI ) ? sweep + TAU : sweep;
+            const int   segments = GetRoundJoinSegments( sweep, halfWidth );
+            if( NULL == v ) return segments * 3;
+
+            Vector2 previous = outerA;
+            for( int i = 1; i <= segments; ++i, v += 3 )
+                {
+                    const float   angle = start + sweep * (float)i / (float)segments;
+                    const Vector2 point = ( i == segments ) ? outerB
+                                                           : (Vector2){ p.x + cosf( angle ) * halfWidth,
+                                                                        p.y + sinf( angle ) * halfWidth };
+                    SetVertex( &v[0], base, p.x, p.y );
+                    SetVertex( &v[1], base, previous.x, previous.y );
+                    SetVertex( &v[2], base, point.x, point.y );
+                    previous = point;
+                }
+            return segments * 3;
+        }
+
+    // The miter tip lies along the bisector, 1 / cos(half the turn) half widths away
+    const float mx     = n0.x + n1.x;
+    const float my     = n0.y + n1.y;
+    const float length = sqrtf( mx * mx + my * my );
+    if( LINE_JOIN_MITER != join || length < 2.0F / LINE_MITER_LIMIT )
+        {
+            if( NULL != v )
+                {
+                    SetVertex( &v[0], base, p.x, p.y );
+                    SetVertex( &v[1], base, outerA.x, outerA.y );
+                    SetVertex( &v[2], base, outerB.x, outerB.y );
+                }
+            return 3;
+        }
+
+    if( NULL != v )
+        {
+            const float scale = side * halfWidth * 2.0F / ( length * length );
+            const float tipX  = p.x + mx * scale;
+            const float tipY  = p.y + my * scale;
+            SetVertex( &v[0], base, p.x, p.y );
+            SetVertex( &v[1], base, outerA.x, outerA.y );
+            SetVertex( &v[2], base, tipX, tipY );
+            SetVertex( &v[3], base, p.x, p.y );
+            SetVertex( &v[4], base, tipX, tipY );
+            SetVertex( &v[5], base, outerB.x, outerB.y );
+        }
+    return 6;
+}
+
+// One instanced segment per edge of a deduplicated path, the GPU builds the quads and joins.
+// Miters past LINE_MITER_LIMIT are beveled here, so the renderer never needs the limit
+static bool
+RecordPathLines( const Vector2 * path, int count, bool closed, float halfWidth, int join, Color color )
+{
+    const int    segments = closed ? count : count - 1;
+    RenderLine * lines    = RecordLines( segments );
+    if( NULL == lines ) return false;
+
+    RenderVertex colorVertex = { 0 };
+    SetVertexColor( &colorVertex, color );
+
+    for( int i = 0; i < segments; ++i )
+        {
+            const Vector2 a    = path[i];
+            const Vector2 b    = path[( i + 1 ) % count];
+            const Vector2 prev = ( closed || i > 0 ) ? path[( i + count - 1 ) % count] : a;
+            const Vector2 next = ( closed || i < segments - 1 ) ? path[( i + 2 ) % count] : b;
+
+            int lineJoin = join;
+            if( LINE_JOIN_MITER == join && ( next.x != b.x || next.y != b.y ) )
+                {
+                    const Vector2 n0 = GetSegmentNormal( a, b );
+                    const Vector2 n1 = GetSegmentNormal( b, next );
+                    const float   mx = n0.x + n1.x;
+                    const float   my = n0.y + n1.y;
+                    if( mx * mx + my * my < 4.0F / ( LINE_MITER_LIMIT * LINE_MITER_LIMIT ) ) lineJoin = LINE_JOIN_BEVEL;
+                }
+
+            RenderLine * line = &lines[i];
+            line->x0          = a.x;
+            line->y0          = a.y;
+            line->x1          = b.x;
+            line->y1          = b.y;
+            line->prevX       = prev.x;
+            line->prevY       = prev.y;
+            line->nextX       = next.x;
+            line->nextY       = next.y;
+            line->r           = colorVertex.r;
+            line->g           = colorVertex.g;
+            line->b           = colorVertex.b;
+            line->a           = colorVertex.a;
+            line->halfWidth   = halfWidth;
+            line->join        = (float)lineJoin;
+        }
+
+    TransformLines( lines, segments );
+    return true;
+}
+
+// Quads along the segments of a path and the joins between them, repeated points are skipped.
+// Instanced and anti-aliased with LE_INSTANCED_LINES, tessellated into the vertex batch otherwise
+static void
+StrokePath( const Vector2 * points, int pointCount, bool closed, float thickness, int join, Color color )
+{
+    Vector2 * path = (Vector2 *)AllocFrameMemory( (size_t)pointCount * sizeof( Vector2 ) );
+    if( NULL == path ) return;
+
+    int count = 0;
+    for( int i = 0; i < pointCount; ++i )
+        {
+            if( count > 0 && points[i].x == path[count - 1].x && points[i].y == path[count - 1].y ) continue;
+            path[count++] = points[i];
+        }
+    if( closed && count > 1 && path[0].x == path[count - 1].x && path[0].y == path[count - 1].y ) --count;
+    if( count < 2 ) return;
+    if( count < 3 ) closed = false;
+
+    const float halfWidth = 0.5F * ( ( thickness > 0.0F ) ? thickness : 1.0F );
+    const float margin    = ( LINE_JOIN_MITER == join ) ? halfWidth * LINE_MITER_LIMIT : halfWidth;
+
+    float minX = path[0].x, minY = path[0].y, maxX = path[0].x, maxY = path[0].y;
+    for( int i = 1; i < count; ++i )
+        {
+            minX = fminf( minX, path[i].x );
+            minY = fminf( minY, path[i].y );
+            maxX = fmaxf( maxX, path[i].x );
+            maxY = fmaxf( maxY, path[i].y );
+        }
+    if( !IsAreaVisible( minX - margin, minY - margin, maxX + margin, maxY + margin ) ) return;
+
+    if( RecordPathLines( path, count, closed, halfWidth, join, color ) ) return;
+
+    const RenderVertex base      = ShapeVertex( color );
+    const int          segments  = closed ? count : count - 1;
+    const int          firstJoin = closed ? 0 : 1; // Open paths have no join at their ends
+    const int          lastJoin  = closed ? count : count - 1;
+
+    int vertexCount = segments * 6;
+    for( int i = firstJoin; i < lastJoin; ++i )
+        {
+            const Vector2 p = path[i];
+            vertexCount += AddStrokeJoin( NULL, base, p, GetSegmentNormal( path[( i + count - 1 ) % count], p ),
+                                          GetSegmentNormal( p, path[( i + 1 ) % count] ), halfWidth, join );
+        }
+
+    RenderVertex * vertices = RecordVertices( LE_TRIANGLES, vertexCount );
+    if( NULL == vertices ) return;
+
+    RenderVertex * v = vertices;
+    for( int i = 0; i < segments; ++i, v += 6 )
+        {
+            const Vector2 a  = path[i];
+            const Vector2 b  = path[( i + 1 ) % count];
+            const Vector2 n  = GetSegmentNormal( a, b );
+            const float   nx = n.x * halfWidth;
+            const float   ny = n.y * halfWidth;
+
+            SetVertex( &v[0], base, a.x + nx, a.y + ny );
+            SetVertex( &v[1], base, a.x - nx, a.y - ny );
+            SetVertex( &v[2], base, b.x - nx, b.y - ny );
+            SetVertex( &v[3], base, a.x + nx, a.y + ny );
+            SetVertex( &v[4], base, b.x - nx, b.y - ny );
+            SetVertex( &v[5], base, b.x + nx, b.y + ny );
+        }
+
+    for( int i = firstJoin; i < lastJoin; ++i )
+        {
+            const Vector2 p = path[i];
+            v += AddStrokeJoin( v, base, p, GetSegmentNormal( path[( i + count - 1 ) % count], p ),
+                                GetSegmentNormal( p, path[( i + 1 ) % count] ), halfWidth, join );
+        }
+
+    TransformVertices( vertices, vertexCount );
+}
+
+void
+DrawPolyline( const Vector2 * points, int pointCount, float thickness, int join, Color color )
+{
+    if( NULL == points || pointCount < 2 ) return;
+
+    StrokePath( points, pointCount, false, thickness, join, color );
+}
+
+void
+DrawPolygonLines( const Vector2 * points, int pointCount, float thickness, int join, Color color )
+{
+    if( NULL == points || pointCount < 2 ) return;
+
+    StrokePath( points, pointCount, true, thickness, join, color );
+}
+
+void
+DrawLineEx( Vector2 start, Vector2 end, float thickness, Color color )
+{
+    const Vector2 points[2] = { start, end };
+    StrokePath( points, 2, false, thickness, LINE_JOIN_MITER, color );
+}
+
+void
+DrawTriangleLinesEx( float x1, float y1, float x2, float y2, float x3, float y3, float thickness, Color color )
+{
+    const Vector2 points[3] = { { x1, y1 }, { x2, y2 }, { x3, y3 } };
+    StrokePath( points, 3, true, thickness, LINE_JOIN_MITER, color );
+}
+
+// Outline inside the rectangle, like DrawRectangleLines, filled when the borders meet
+void
+DrawRectangleLinesEx( float x, float y, float width, float height, float thickness, Color color )
+{
+    const float inset = 0.5F * ( ( thickness > 0.0F ) ? thickness : 1.0F );
+    if( 2.0F * inset >= fabsf( width ) || 2.0F * inset >= fabsf( height ) )
+        {
+            DrawRectangle( x, y, width, height, color );
+            return;
+        }
+
+    const float   left      = fminf( x, x + width ) + inset;
+    const float   top       = fminf( y, y + height ) + inset;
+    const float   right     = fmaxf( x, x + width ) - inset;
+    const float   bottom    = fmaxf( y, y + height ) - inset;
+    const Vector2 points[4] = { { left, top }, { right, top }, { right, bottom }, { left, bottom } };
+    StrokePath( points, 4, true, 2.0F * inset, LINE_JOIN_MITER, color );
+}
+
+// Outline centered on the circle
+void
+DrawCircleLinesEx( float centerX, float centerY, float radius, float thickness, Color color )
+{
+    const float halfWidth = 0.5F * ( ( thickness > 0.0F ) ? thickness : 1.0F );
+    if( !IsAreaVisible( centerX - radius - halfWidth, centerY - radius - halfWidth, centerX + radius + halfWidth,
+                        centerY + radius + halfWidth ) )
+        return;
+
+    const int segments = GetCircleSegments( radius + halfWidth );
+    Vector2 * points   = (Vector2 *)AllocFrameMemory( (size_t)segments * sizeof( Vector2 ) );
+    if( NULL == points ) return;
+
+    const float step = TAU / (float)segments;
+    for( int i = 0; i < segments; ++i )
+        {
+            points[i].x = centerX + cosf( step * (float)i ) * radius;
+            points[i].y = centerY + sinf( step * (float)i ) * radius;
+        }
+
+    StrokePath( points, segments, true, 2.0F * halfWidth, LINE_JOIN_MITER, color );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Bezier curves
+//----------------------------------------------------------------------------------------------------------------------
+// Segments keeping a cubic curve within `tolerance` of its polyline (Wang's formula)
+static int
+GetBezierSegments( Vector2 p0, Vector2 p1, Vector2 p2, Vector2 p3, float tolerance )
+{
+    const float ax       = p0.x - 2.0F * p1.x + p2.x;
+    const float ay       = p0.y - 2.0F * p1.y + p2.y;
+    const float bx       = p1.x - 2.0F * p2.x + p3.x;
+    const float by       = p1.y - 2.0F * p2.y + p3.y;
+    const float bend     = sqrtf( fmaxf( ax * ax + ay * ay, bx * bx + by * by ) );
+    const int   segments = (int)ceilf( sqrtf( 0.75F * bend / tolerance ) );
+
+    return ( segments < 1 ) ? 1 : ( segments > MAX_BEZIER_SEGMENTS ) ? MAX_BEZIER_SEGMENTS : segments;
+}
+
+static INLINE Vector2
+GetBezierPoint( Vector2 p0, Vector2 p1, Vector2 p2, Vector2 p3, float t )
+{
+    const float s = 1.0F - t;
+    const float a = s * s * s;
+    const float b = 3.0F * s * s * t;
+    const float c = 3.0F * s * t * t;
+    const float d = t * t * t;
+    return (Vector2){ a * p0.x + b * p1.x + c * p2.x + d * p3.x, a * p0.y + b * p1.y + c * p2.y + d * p3.y };
+}
+
+// Points of a cubic curve within SMOOTH_BEZIER_ERROR_RATE units of it, `start` excluded so curves
+// chain into one outline for DrawPolygon. Returns the count written, at most `maxPoints`
+int
+FlattenBezier( Vector2 start, Vector2 control1, Vector2 control2, Vector2 end, Vector2 * points, int maxPoints )
+{
+    if( NULL == points || maxPoints < 1 ) return 0;
+
+    int segments = GetBezierSegments( start, control1, control2, end, SMOOTH_BEZIER_ERROR_RATE );
+    if( segments > maxPoints ) segments = maxPoints;
+
+    for( int i = 1; i <= segments; ++i )
+        {
+            points[i - 1] = GetBezierPoint( start, control1, control2, end, (float)i / (float)segments );
+        }
+
+    return segments;
+}
+
+// Stroke a cubic curve, flattened for the pixels it covers through the current transform
+void
+DrawBezier( Vector2 start, Vector2 control1, Vector2 control2, Vector2 end, float thickness, Color color )
+{
+    // The curve stays inside the hull of its control points
+    const float margin = 0.5F * thickness * LINE_MITER_LIMIT;
+    if( !IsAreaVisible( fminf( fminf( start.x, control1.x ), fminf( control2.x, end.x ) ) - margin,
+                        fminf( fminf( start.y, control1.y ), fminf( control2.y, end.y ) ) - margin,
+                        fmaxf( fmaxf( start.x, control1.x ), fmaxf( control2.x, end.x ) ) + margin,
+                        fmaxf( fmaxf( start.y, control1.y ), fmaxf( control2.y, end.y ) ) + margin ) )
+        return;
+
+    const Matrix2D matrix = GetDrawMatrix();
+    const float    scale  = sqrtf( fabsf( matrix.m0 * matrix.m3 - matrix.m1 * matrix.m2 ) );
+    const float    error  = SMOOTH_BEZIER_ERROR_RATE / ( ( scale > 0.0F ) ? scale : 1.0F );
+
+    const int segments = GetBezierSegments( start, control1, control2, end, error );
+    Vector2 * points   = (Vector2 *)AllocFrameMemory( (size_t)( segments + 1 ) * sizeof( Vector2 ) );
+    if( NULL == points ) return;
+
+    points[0] = start;
+    for( int i = 1; i <= segments; ++i )
+        {
+            points[i] = GetBezierPoint( start, control1, control2, end, (float)i / (float)segments );
+        }
+
+    StrokePath( points, segments + 1, false, thickness, LINE_JOIN_MITER, color );
 }
@@ -0,0 +1,202 @@
+/****************************** LESKYLINE ********************************
+ * leskyline: Bottom-left skyline packing of atlas pages
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ *   - The top edge of the used area of a page is kept as horizontal
+ *     segments sorted by x, covering the page width. An area goes where its
+ *     top ends lowest, ties go to the narrowest segment so wide gaps stay open.
+ *   - Placed areas are never freed, a page is packed until it is full.
+ *   - Node arrays are accounted as MEMORY_IMAGES.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+#ifndef LEVEGL_SKYLINE_H
+#define LEVEGL_SKYLINE_H
+
+#include "lememory.h"
+
+#include "levegl/leutils.h"
+
+#include <stdbool.h>
+#include <string.h> /* memmove */
+
+//==============================================================================================================
+// DEFINES
+//==============================================================================================================
+// Nodes allocated with a new skyline, grown by doubling
+#define LE_SKYLINE_INITIAL_NODES 16
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+/// Top edge of the used area of a page over [x, x + width)
+typedef struct AtlasNode
+{
+    int x;
+    int y;
+    int width;
+} AtlasNode;
+
+typedef struct AtlasSkyline
+{
+    AtlasNode * nodes; /// Sorted by x, covering the page width
+    int         nodeCount;
+    int         nodeCapacity;
+    int         size; /// Width and height of the page
+} AtlasSkyline;
+
+//==============================================================================================================
+// FUNCTIONS
+//==============================================================================================================
+// Empty page of `size`x`size`, false when the nodes cannot be allocated
+static bool
+InitSkyline( AtlasSkyline * skyline, int size )
+{
+    memset( skyline, 0, sizeof( AtlasSkyline ) );
+
+    skyline->nodes = (AtlasNode *)LE_MALLOC( LE_SKYLINE_INITIAL_NODES * sizeof( AtlasNode ) );
+    if( NULL == skyline->nodes ) return false;
+
+    TrackMemory( MEMORY_IMAGES, LE_SKYLINE_INITIAL_NODES * sizeof( AtlasNode ), true );
+    skyline->nodeCapacity   = LE_SKYLINE_INITIAL_NODES;
+    skyline->nodeCount      = 1;
+    skyline->nodes[0].x     = 0;
+    skyline->nodes[0].y     = 0;
+    skyline->nodes[0].width = size;
+    skyline->size           = size;
+
+    return true;
+}
+
+static void
+ReleaseSkyline( AtlasSkyline * skyline )
+{
+    TrackMemory( MEMORY_IMAGES, (size_t)skyline->nodeCapacity * sizeof( AtlasNode ), false );
+    LE_FREE( skyline->nodes );
+    memset( skyline, 0, sizeof( AtlasSkyline ) );
+}
+
+// Height the top of a `width` wide area would sit at when placed at node `index`, -1 if it does not fit
+static int
+FitSkyline( const AtlasSkyline * skyline, int index, int width, int height )
+{
+    const int x = skyline->nodes[index].x;
+    if( x + width > skyline->size ) return -1;
+
+    int y         = 0;
+    int remaining = width;
+    for( int i = index; remaining > 0; ++i )
+        {
+            if( skyline->nodes[i].y > y ) y = skyline->nodes[i].y;
+            if( y + height > skyline->size ) return -1;
+            remaining -= skyline->nodes[i].width;
+        }
+
+    return y;
+}
+
+// Place a `width`x`height` area in the page, false when it is full
+static bool
+PackSkyline( AtlasSkyline * skyline, int width, int height, int * x, int * y )
+{
+    int bestIndex = -1;
+    int bestTop   = skyline->size + 1;
+    int bestWidth = skyline->size + 1;
+    int bestY     = 0;
+    for( int i = 0; i < skyline->nodeCount; ++i )
+        {
+            const int fitY = FitSkyline( skyline, i, width, height );
+            if( fitY < 0 ) continue;
+
+            // Lowest top first, then the narrowest segment so wide gaps stay open
+            if( fitY + height < bestTop || ( fitY + height == bestTop && skyline->nodes[i].width < bestWidth ) )
+                {
+                    bestIndex = i;
+                    bestTop   = fitY + height;
+                    bestWidth = skyline->nodes[i].width;
+                    bestY     = fitY;
+                }
+        }
+
+    if( bestIndex < 0 ) return false;
+
+    if( skyline->nodeCount + 1 > skyline->nodeCapacity )
+        {
+            const int   capacity = skyline->nodeCapacity * 2;
+            AtlasNode * nodes    = (AtlasNode *)LE_REALLOC( skyline->nodes, (size_t)capacity * sizeof( AtlasNode ) );
+            if( NULL == nodes ) return false;
+
+            TrackMemory( MEMORY_IMAGES, (size_t)skyline->nodeCapacity * sizeof( AtlasNode ), true );
+            skyline->nodes        = nodes;
+            skyline->nodeCapacity = capacity;
+        }
+
+    *x = skyline->nodes[bestIndex].x;
+    *y = bestY;
+
+    // The new segment covers the area, the ones it shadows shrink or disappear
+    memmove( &skyline->nodes[bestIndex + 1], &skyline->nodes[bestIndex],
+             (size_t)( skyline->nodeCount - bestIndex ) * sizeof( AtlasNode ) );
+    skyline->nodes[bestIndex].x     = *x;
+    skyline->nodes[bestIndex].y     = bestTop;
+    skyline->nodes[bestIndex].width = width;
+    ++skyline->nodeCount;
+
+    const int right = *x + width;
+    int       i     = bestIndex + 1;
+    while( i < skyline->nodeCount && skyline->nodes[i].x < right )
+        {
+            const int shrink = right - skyline->nodes[i].x;
+            if( shrink < skyline->nodes[i].width )
+                {
+                    skyline->nodes[i].x += shrink;
+                    skyline->nodes[i].width -= shrink;
+                    break;
+                }
+
+            memmove( &skyline->nodes[i], &skyline->nodes[i + 1],
+                     (size_t)( skyline->nodeCount - i - 1 ) * sizeof( AtlasNode ) );
+            --skyline->nodeCount;
+        }
+
+    // Neighbours at the same height become one segment
+    for( i = 0; i + 1 < skyline->nodeCount; )
+        {
+            if( skyline->nodes[i].y == skyline->nodes[i + 1].y )
+                {
+                    skyline->nodes[i].width += skyline->nodes[i + 1].width;
+                    memmove( &skyline->nodes[i + 1], &skyline->nodes[i + 2],
+                             (size_t)( skyline->nodeCount - i - 2 ) * sizeof( AtlasNode ) );
+                    --skyline->nodeCount;
+                }
+            else
+                {
+                    ++i;
+                }
+        }
+
+    return true;
+}
+
+#endif // !LEVEGL_SKYLINE_H
@@ -0,0 +1,247 @@
+/******************************* LESYSTEM ********************************
+ * lesystem: Operating system primitives used internally by the modules
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+#if !defined( _WIN32 ) && !defined( _POSIX_C_SOURCE )
+#    define _POSIX_C_SOURCE 200809L /* clock_gettime */
+#endif
+
+#include "lesystem.h"
+
+#include "levegl/leutils.h"
+
+#if defined( _WIN32 )
+#    define WIN32_LEAN_AND_MEAN
+#    include <windows.h>
+#else
+#    include <time.h>
+#endif
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+// Entry point arguments, heap allocated so the spawning frame may return first
+typedef struct ThreadStart
+{
+    leThreadFunc func;
+    void *       userData;
+} ThreadStart;
+
+//==============================================================================================================
+// GLOBALS
+//==============================================================================================================
+static LE_THREAD_LOCAL unsigned long threadId    = 0; // Assigned on the first leGetThreadId of each thread
+static long                          threadCount = 0; // Ids handed out so far
+
+//==============================================================================================================
+// MODULE INTERNAL FUNCTIONS
+//==============================================================================================================
+#if defined( _WIN32 )
+static DWORD WINAPI
+ThreadEntry( LPVOID param )
+#else
+static void *
+ThreadEntry( void * param )
+#endif
+{
+    ThreadStart start = *(ThreadStart *)param;
+    LE_FREE( param );
+
+    start.func( start.userData );
+
+    return 0;
+}
+
+//==============================================================================================================
+// MODULE FUNCTIONS DEFINITIONS
+//==============================================================================================================
+unsigned long long
+leGetClockNs( void )
+{
+#if defined( _WIN32 )
+    static LARGE_INTEGER frequency = { 0 };
+    LARGE_INTEGER        counter;
+
+    if( 0 == frequency.QuadPart ) QueryPerformanceFrequency( &frequency );
+    QueryPerformanceCounter( &counter );
+
+    return (unsigned long long)( counter.QuadPart / frequency.QuadPart ) * 1000000000ULL
+         + (unsigned long long)( counter.QuadPart % frequency.QuadPart ) * 1000000000ULL
+               / (unsigned long long)frequency.QuadPart;
+#else
+    struct timespec now;
+    clock_gettime( CLOCK_MONOTONIC, &now );
+
+    return (unsigned long long)now.tv_sec * 1000000000ULL + (unsigned long long)now.tv_nsec;
+#endif
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Threads
+//----------------------------------------------------------------------------------------------------------------------
+bool
+leThreadCreate( leThread * thread, leThreadFunc func, void * userData )
+{
+    ThreadStart * start = (ThreadStart *)LE_MALLOC( sizeof( ThreadStart ) );
+    if( NULL == start ) return false;
+
+    start->func     = func;
+    start->userData = userData;
+
+#if defined( _WIN32 )
+    thread->handle = (void *)CreateThread( NULL, 0, ThreadEntry, start, 0, NULL );
+    if( NULL == thread->handle )
+#else
+    if( 0 != pthread_create( &thread->handle, NULL, ThreadEntry, start ) )
+#endif
+        {
+            LE_FREE( start );
+            return false;
+        }
+
+    return true;
+}
+
+void
+leThreadJoin( leThread * thread )
+{
+#if defined( _WIN32 )
+    WaitForSingleObject( (HANDLE)thread->handle, INFINITE );
+    CloseHandle( (HANDLE)thread->handle );
+#else
+    pthread_join( thread->handle, NULL );
+#endif
+}
+
+void
+leThreadSleep( unsigned long long ns )
+{
+#if defined( _WIN32 )
+    Sleep( (DWORD)( ( ns + 999999ULL ) / 1000000ULL ) );
+#else
+    struct timespec duration = { (time_t)( ns / 1000000000ULL ), (long)( ns % 1000000000ULL ) };
+    while( 0 != nanosleep( &duration, &duration ) ) continue; // Interrupted, sleep what remains
+#endif
+}
+
+// Counted rather than taken from the OS, whose ids are reused once a thread exits
+unsigned long
+leGetThreadId( void )
+{
+    if( 0 == threadId ) threadId = (unsigned long)leAtomicAdd( &threadCount, 1L ) + 1UL;
+
+    return threadId;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Mutexes and condition variables
+//----------------------------------------------------------------------------------------------------------------------
+void
+leMutexInit( leMutex * mutex )
+{
+#if defined( _WIN32 )
+    InitializeSRWLock( (PSRWLOCK)&mutex->handle );
+#else
+    pthread_mutex_init( &mutex->handle, NULL );
+#endif
+}
+
+void
+leMutexDestroy( leMutex * mutex )
+{
+#if defined( _WIN32 )
+    (void)mutex; // SRW locks need no cleanup
+#else
+    pthread_mutex_destroy( &mutex->handle );
+#endif
+}
+
+void
+leMutexLock( leMutex * mutex )
+{
+#if defined( _WIN32 )
+    AcquireSRWLockExclusive( (PSRWLOCK)&mutex->handle );
+#else
+    pthread_mutex_lock( &mutex->handle );
+#endif
+}
+
+void
+leMutexUnlock( leMutex * mutex )
+{
+#if defined( _WIN32 )
+    ReleaseSRWLockExclusive( (PSRWLOCK)&mutex->handle );
+#else
+    pthread_mutex_unlock( &mutex->handle );
+#endif
+}
+
+void
+leConditionInit( leCondition * condition )
+{
+#if defined( _WIN32 )
+    InitializeConditionVariable( (PCONDITION_VARIABLE)&condition->handle );
+#else
+    pthread_cond_init( &condition->handle, NULL );
+#endif
+}
+
+void
+leConditionDestroy( leCondition * condition )
+{
+#if defined( _WIN32 )
+    (void)condition; // Condition variables need no cleanup
+#else
+    pthread_cond_destroy( &condition->handle );
+#endif
+}
+
+void
+leConditionWait( leCondition * condition, leMutex * mutex )
+{
+#if defined( _WIN32 )
+    SleepConditionVariableSRW( (PCONDITION_VARIABLE)&condition->handle, (PSRWLOCK)&mutex->handle, INFINITE, 0 );
+#else
+    pthread_cond_wait( &condition->handle, &mutex->handle );
+#endif
+}
+
+void
+leConditionSignal( leCondition * condition )
+{
+#if defined( _WIN32 )
+    WakeConditionVariable( (PCONDITION_VARIABLE)&condition->handle );
+#else
+    pthread_cond_signal( &condition->handle );
+#endif
+}
+
+void
+leConditionBroadcast( leCondition * condition )
+{
+#if defined( _WIN32 )
+    WakeAllConditionVariable( (PCONDITION_VARIABLE)&condition->handle );
+#else
+    pthread_cond_broadcast( &condition->handle );
+#endif
+}
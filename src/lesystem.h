@@ -0,0 +1,153 @@
+/******************************* LESYSTEM ********************************
+ * lesystem: Operating system primitives used internally by the modules
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ *   - Atomics map to the GCC/Clang __atomic builtins or to the MSVC
+ *     Interlocked family, keeping the library buildable as plain C99.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+#ifndef LEVEGL_SYSTEM_H
+#define LEVEGL_SYSTEM_H
+
+#include <stdbool.h>
+
+#if defined( _MSC_VER )
+#    include <intrin.h>
+#endif
+
+#if !defined( _WIN32 )
+#    include <pthread.h>
+#endif
+
+//==============================================================================================================
+// DEFINES
+//==============================================================================================================
+#if defined( _MSC_VER )
+#    define LE_THREAD_LOCAL __declspec( thread )
+#else
+#    define LE_THREAD_LOCAL __thread
+#endif
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+typedef void ( *leThreadFunc )( void * userData );
+
+#if defined( _WIN32 )
+// Opaque storage for HANDLE, SRWLOCK and CONDITION_VARIABLE, keeping <windows.h> out of the modules
+typedef struct leThread
+{
+    void * handle;
+} leThread;
+
+typedef struct leMutex
+{
+    void * handle;
+} leMutex;
+
+typedef struct leCondition
+{
+    void * handle;
+} leCondition;
+#else
+typedef struct leThread
+{
+    pthread_t handle;
+} leThread;
+
+typedef struct leMutex
+{
+    pthread_mutex_t handle;
+} leMutex;
+
+typedef struct leCondition
+{
+    pthread_cond_t handle;
+} leCondition;
+#endif
+
+// Static initializer for mutexes with static storage, which need no leMutexInit
+#if defined( _WIN32 )
+#    define LE_MUTEX_INITIALIZER { NULL } // SRWLOCK_INIT
+#else
+#    define LE_MUTEX_INITIALIZER { PTHREAD_MUTEX_INITIALIZER }
+#endif
+
+//==============================================================================================================
+// ATOMICS
+//==============================================================================================================
+// Sequentially consistent operations over `long` and pointer sized values
+#if defined( _MSC_VER )
+#    define leAtomicLoad( ptr )                   _InterlockedOr( (long volatile *)( ptr ), 0 )
+#    define leAtomicStore( ptr, value )           _InterlockedExchange( (long volatile *)( ptr ), ( value ) )
+#    define leAtomicAdd( ptr, value )             _InterlockedExchangeAdd( (long volatile *)( ptr ), ( value ) )
+#    define leAtomicCompareSwap( ptr, expected, desired )                                                        \
+        ( _InterlockedCompareExchange( (long volatile *)( ptr ), ( desired ), ( expected ) ) == ( expected ) )
+#    define leAtomicLoadPtr( ptr )                _InterlockedCompareExchangePointer( (void * volatile *)( ptr ), 0, 0 )
+#    define leAtomicStorePtr( ptr, value )        _InterlockedExchangePointer( (void * volatile *)( ptr ), ( value ) )
+#    define leAtomicExchangePtr( ptr, value )     _InterlockedExchangePointer( (void * volatile *)( ptr ), ( value ) )
+#    define leAtomicCompareSwapPtr( ptr, expected, desired )                                                     \
+        ( _InterlockedCompareExchangePointer( (void * volatile *)( ptr ), ( desired ), ( expected ) )           \
+          == ( expected ) )
+#else
+#    define leAtomicLoad( ptr )                   __atomic_load_n( ( ptr ), __ATOMIC_SEQ_CST )
+#    define leAtomicStore( ptr, value )           __atomic_store_n( ( ptr ), ( value ), __ATOMIC_SEQ_CST )
+#    define leAtomicAdd( ptr, value )             __atomic_fetch_add( ( ptr ), ( value ), __ATOMIC_SEQ_CST )
+#    define leAtomicCompareSwap( ptr, expected, desired )                                                        \
+        __extension__( {                                                                                         \
+            __typeof__( *( ptr ) ) leExpected_ = ( expected );                                                   \
+            __atomic_compare_exchange_n( ( ptr ), &leExpected_, ( desired ), 0, __ATOMIC_SEQ_CST,                \
+                                         __ATOMIC_SEQ_CST );                                                     \
+        } )
+#    define leAtomicLoadPtr( ptr )                leAtomicLoad( ptr )
+#    define leAtomicStorePtr( ptr, value )        leAtomicStore( ptr, value )
+#    define leAtomicExchangePtr( ptr, value )     __atomic_exchange_n( ( ptr ), ( value ), __ATOMIC_SEQ_CST )
+#    define leAtomicCompareSwapPtr( ptr, expected, desired ) leAtomicCompareSwap( ptr, expected, desired )
+#endif
+
+//==============================================================================================================
+// FUNCTIONS DECLARATIONS
+//==============================================================================================================
+unsigned long long leGetClockNs( void ); // Monotonic clock in nanoseconds, valid before InitWindow
+
+// Threads
+bool          leThreadCreate( leThread * thread, leThreadFunc func, void * userData ); // Spawn a joinable thread
+void          leThreadJoin( leThread * thread );                                       // Wait for a thread to exit
+void          leThreadSleep( unsigned long long ns );                                  // At least `ns` nanoseconds
+unsigned long leGetThreadId( void ); // Calling thread, never 0 and never reused after the thread exits
+
+// Mutexes and condition variables
+void leMutexInit( leMutex * mutex );
+void leMutexDestroy( leMutex * mutex );
+void leMutexLock( leMutex * mutex );
+void leMutexUnlock( leMutex * mutex );
+
+void leConditionInit( leCondition * condition );
+void leConditionDestroy( leCondition * condition );
+void leConditionWait( leCondition * condition, leMutex * mutex ); // Release `mutex` while sleeping
+void leConditionSignal( leCondition * condition );
+void leConditionBroadcast( leCondition * condition );
+
+#endif // !LEVEGL_SYSTEM_H
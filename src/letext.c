@@ -0,0 +1,1235 @@
+/********************************* LETEXT *********************************
+ * letext: TrueType fonts, glyph atlases and text drawing
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ * - DEFINES:
+ *   - LE_FONT_ATLAS_SIZE: Width and height of the atlas pages holding the glyphs of a font
+ *   - LE_FONT_SDF_SIZE: Pixel size FONT_SDF glyphs are rasterized at
+ *   - LE_FONT_SDF_SPREAD: Pixels at LE_FONT_SDF_SIZE the distance field covers on each side of an edge
+ *   - LE_TEXT_CACHE_SIZE: Shaped strings a font keeps before its cache is flushed
+ *
+ * - Fonts are TrueType files with quadratic outlines. cmap formats 4 and 12, composite glyphs and
+ *   the pairs of the 'kern' table are read; hinting, OpenType layout and CFF outlines are not.
+ * - Glyphs are rasterized the first time a string uses them and packed into the atlas of the
+ *   font, later draws only append quads to the batch. FONT_DEFAULT rasterizes coverage for every
+ *   pixel size drawn, FONT_SDF rasterizes a signed distance field once at LE_FONT_SDF_SIZE which
+ *   the default shader thresholds at any size.
+ * - Strings are shaped once: the UTF-8 decoding, glyph lookups, advances and kerning of a string
+ *   are cached by content in font units, so a label redrawn at any size or position skips them.
+ * - Glyphs share the atlas texture with its white texel, labels batch with the shapes around them.
+ * - A font belongs to the context current when it was loaded, like its atlas. DrawText may be
+ *   called from several recording threads, the caches of a font are guarded by its lock.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+//==============================================================================================================
+// INCLUDES
+//==============================================================================================================
+#include "lememory.h"
+#include "lerender.h"
+#include "lesystem.h"
+#include "letruetype.h"
+
+#include "levegl/leutils.h"
+#include "levegl/levegl.h"
+
+#undef LEGL_IMPLEMENTATION
+#include "levegl/legl.h"
+
+#include <float.h>  /* FLT_MAX */
+#include <math.h>   /* ceilf, floorf, fabsf, sqrtf */
+#include <stdio.h>  /* fopen, fread */
+#include <string.h> /* memcmp, memcpy, strlen */
+
+//==============================================================================================================
+// DEFINES
+//==============================================================================================================
+#ifndef LE_FONT_ATLAS_SIZE
+#    define LE_FONT_ATLAS_SIZE 1024
+#endif
+
+#ifndef LE_FONT_SDF_SIZE
+#    define LE_FONT_SDF_SIZE 48
+#endif
+
+#ifndef LE_FONT_SDF_SPREAD
+#    define LE_FONT_SDF_SPREAD 6
+#endif
+
+#ifndef LE_TEXT_CACHE_SIZE
+#    define LE_TEXT_CACHE_SIZE 4096
+#endif
+
+#define GLYPH_MAX_SIZE  4095 // Pixel sizes fit the low 12 bits of a glyph key
+#define GLYPH_MAX_DEPTH 8    // Nesting of composite glyphs
+#define GLYPH_FLATNESS  0.2F // Pixels a flattened curve may stray from the outline
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+/// A glyph rasterized at one pixel size
+typedef struct FontGlyph
+{
+    unsigned int key;     /// ( glyph index + 1 ) << 12 | pixel size, 0 for an empty slot
+    AtlasSprite  sprite;  /// Texture ID 0 for glyphs without pixels
+    float        offsetX; /// Top-left of the bitmap from the pen on the baseline, in pixels
+    float        offsetY;
+} FontGlyph;
+
+/// A glyph placed by shaping
+typedef struct ShapedGlyph
+{
+    float          x;     /// Pen position on the line in font units
+    unsigned short glyph; /// Glyph index
+    unsigned short line;
+} ShapedGlyph;
+
+/// A shaped string, independent of size and position
+typedef struct TextRun
+{
+    unsigned int  hash; /// 0 for an empty slot
+    int           length;
+    char *        text;
+    ShapedGlyph * glyphs; /// Only the glyphs with an outline
+    int           glyphCount;
+    int           lineCount;
+    float         width; /// Widest line advance in font units
+} TextRun;
+
+/// Line segment of a flattened outline, in pixels
+typedef struct GlyphEdge
+{
+    float x0;
+    float y0;
+    float x1;
+    float y1;
+} GlyphEdge;
+
+typedef struct GlyphOutline
+{
+    GlyphEdge * edges;
+    int         count;
+    int         capacity;
+} GlyphOutline;
+
+struct Font
+{
+    unsigned char * data; /// Copy of the file
+    size_t          size;
+    int             type; /// FontType
+
+    size_t glyf; /// Table offsets, `kern` is 0 without kerning pairs
+    size_t glyfLength;
+    size_t loca;
+    size_t hmtx;
+    size_t kern; /// Offset of the first kerning pair
+    int    kernPairs;
+    int    glyphCount;
+    int    metricCount;
+    bool   longOffsets;
+
+    CharacterMap cmap; /// Unicode subtable used, reading `data`
+
+    int unitsPerEm;
+    int ascent;
+    int descent;
+    int lineGap;
+
+    TextureAtlas * atlas;
+    leMutex        lock; /// Guards the tables below, DrawText may run on several threads
+
+    FontGlyph * glyphs; /// Open addressing table keyed by glyph and size
+    int         glyphCapacity;
+    int         glyphUsed;
+    TextRun *   runs; /// Open addressing table keyed by string
+    int         runCapacity;
+    int         runUsed;
+};
+
+//==============================================================================================================
+// MODULE INTERNAL FUNCTIONS
+//==============================================================================================================
+// 2.14 fixed point of the composite glyph transforms
+static INLINE float
+ReadF2Dot14( const unsigned char * bytes )
+{
+    return (float)ReadS16( bytes ) / 16384.0F;
+}
+
+static INLINE bool
+HasBytes( const Font * font, size_t offset, size_t bytes )
+{
+    return HasFontBytes( font->size, offset, bytes );
+}
+
+// Offset and length of a table, false when the file lacks it
+static bool
+FindTable( const Font * font, const char * tag, size_t * offset, size_t * length )
+{
+    const int tableCount = (int)ReadU16( font->data + 4 );
+    for( int i = 0; i < tableCount && HasBytes( font, 12 + (size_t)i * 16, 16 ); ++i )
+        {
+            const unsigned char * record = font->data + 12 + (size_t)i * 16;
+            if( 0 != memcmp( record, tag, 4 ) ) continue;
+
+            *offset = ReadU32( record + 8 );
+            *length = ReadU32( record + 12 );
+            return HasBytes( font, *offset, *length );
+        }
+
+    return false;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Font tables
+//----------------------------------------------------------------------------------------------------------------------
+// Horizontal kerning pairs of the first format 0 subtable
+static void
+SelectKerningPairs( Font * font )
+{
+    size_t offset = 0;
+    size_t length = 0;
+    if( !FindTable( font, "kern", &offset, &length ) || length < 18 ) return;
+
+    const unsigned char * table = font->data + offset;
+    if( 0 != ReadU16( table ) || 0 == ReadU16( table + 2 ) ) return;
+
+    // Format 0 in the high byte, horizontal in bit 0
+    const unsigned int coverage = ReadU16( table + 8 );
+    if( 0 != ( coverage >> 8 ) || 0 == ( coverage & 1 ) ) return;
+
+    const int pairs = (int)ReadU16( table + 10 );
+    if( 18 + (size_t)pairs * 6 > length ) return;
+
+    font->kern      = offset + 18;
+    font->kernPairs = pairs;
+}
+
+static int
+GetGlyphAdvance( const Font * font, int glyph )
+{
+    const int metric = ( glyph < font->metricCount ) ? glyph : font->metricCount - 1;
+    return (int)ReadU16( font->data + font->hmtx + (size_t)metric * 4 );
+}
+
+static int
+GetGlyphKerning( const Font * font, int left, int right )
+{
+    if( 0 == font->kernPairs ) return 0;
+
+    const unsigned int key  = ( (unsigned int)left << 16 ) | (unsigned int)right;
+    int                low  = 0;
+    int                high = font->kernPairs - 1;
+    while( low <= high )
+        {
+            const int             middle = ( low + high ) / 2;
+            const unsigned char * pair   = font->data + font->kern + (size_t)middle * 6;
+            const unsigned int    found  = ReadU32( pair );
+            if( key < found )
+                high = middle - 1;
+            else if( key > found )
+                low = middle + 1;
+            else
+                return ReadS16( pair + 4 );
+        }
+
+    return 0;
+}
+
+// Bytes of a glyph inside 'glyf', false for glyphs without an outline such as spaces
+static bool
+GetGlyphData( const Font * font, int glyph, const unsigned char ** data, size_t * length )
+{
+    if( glyph < 0 || glyph >= font->glyphCount ) return false;
+
+    const unsigned char * loca  = font->data + font->loca;
+    const size_t          start = font->longOffsets ? ReadU32( loca + glyph * 4 ) : ReadU16( loca + glyph * 2 ) * 2U;
+    const size_t end = font->longOffsets ? ReadU32( loca + glyph * 4 + 4 ) : ReadU16( loca + glyph * 2 + 2 ) * 2U;
+    if( end <= start || end > font->glyfLength || end - start < 10 ) return false;
+
+    *data   = font->data + font->glyf + start;
+    *length = end - start;
+    return true;
+}
+
+static INLINE bool
+HasGlyphOutline( const Font * font, int glyph )
+{
+    const unsigned char * data   = NULL;
+    size_t                length = 0;
+    return GetGlyphData( font, glyph, &data, &length );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Outlines
+//----------------------------------------------------------------------------------------------------------------------
+static bool
+AddGlyphEdge( GlyphOutline * outline, float x0, float y0, float x1, float y1 )
+{
+    if( outline->count == outline->capacity )
+        {
+            const int   capacity = ( 0 == outline->capacity ) ? 64 : outline->capacity * 2;
+            GlyphEdge * edges    = (GlyphEdge *)LE_REALLOC( outline->edges, (size_t)capacity * sizeof( GlyphEdge ) );
+            if( NULL == edges ) return false;
+
+            outline->edges    = edges;
+            outline->capacity = capacity;
+        }
+
+    outline->edges[outline->count++] = (GlyphEdge){ x0, y0, x1, y1 };
+    return true;
+}
+
+// Flatten a quadratic curve into segments within GLYPH_FLATNESS of it
+static bool
+AddGlyphCurve( GlyphOutline * outline, float x0, float y0, float cx, float cy, float x1, float y1 )
+{
+    const float ddx      = x0 - 2.0F * cx + x1;
+    const float ddy      = y0 - 2.0F * cy + y1;
+    const float error    = sqrtf( ddx * ddx + ddy * ddy ) / ( 8.0F * GLYPH_FLATNESS );
+    const int   segments = ( error > 1.0F ) ? (int)fminf( ceilf( sqrtf( error ) ), 64.0F ) : 1;
+
+    float x = x0;
+    float y = y0;
+    for( int i = 1; i <= segments; ++i )
+        {
+            const float t  = (float)i / (float)segments;
+            const float s  = 1.0F - t;
+            const float nx = s * s * x0 + 2.0F * s * t * cx + t * t * x1;
+            const float ny = s * s * y0 + 2.0F * s * t * cy + t * t * y1;
+            if( !AddGlyphEdge( outline, x, y, nx, ny ) ) return false;
+
+            x = nx;
+            y = ny;
+        }
+
+    return true;
+}
+
+// Points [start, end] form a closed contour of on-curve points and quadratic control points,
+// two control points in a row imply an on-curve point halfway
+static bool
+AddGlyphContour( GlyphOutline * outline, const float * points, const unsigned char * flags, int start, int end )
+{
+    const int count = end - start + 1;
+    if( count < 2 ) return true;
+
+    // Begin on an on-curve point, or between the two last control points
+    float sx, sy;
+    int   first = start;
+    int   last  = end;
+    if( flags[start] & 1 )
+        {
+            sx    = points[start * 2];
+            sy    = points[start * 2 + 1];
+            first = start + 1;
+        }
+    else if( flags[end] & 1 )
+        {
+            sx   = points[end * 2];
+            sy   = points[end * 2 + 1];
+            last = end - 1;
+        }
+    else
+        {
+            sx = 0.5F * ( points[start * 2] + points[end * 2] );
+            sy = 0.5F * ( points[start * 2 + 1] + points[end * 2 + 1] );
+        }
+
+    float x = sx, y = sy;
+    float cx = 0.0F, cy = 0.0F;
+    bool  control = false;
+    bool  ok      = true;
+    for( int i = first; i <= last && ok; ++i )
+        {
+            const float px = points[i * 2];
+            const float py = points[i * 2 + 1];
+            if( flags[i] & 1 )
+                {
+                    ok      = control ? AddGlyphCurve( outline, x, y, cx, cy, px, py )
+                                      : AddGlyphEdge( outline, x, y, px, py );
+                    x       = px;
+                    y       = py;
+                    control = false;
+                }
+            else if( control )
+                {
+                    const float mx = 0.5F * ( cx + px );
+                    const float my = 0.5F * ( cy + py );
+                    ok             = AddGlyphCurve( outline, x, y, cx, cy, mx, my );
+                    x              = mx;
+                    y              = my;
+                    cx             = px;
+                    cy             = py;
+                }
+            else
+                {
+                    cx      = px;
+                    cy      = py;
+                    control = true;
+                }
+        }
+
+    if( !ok ) return false;
+    return control ? AddGlyphCurve( outline, x, y, cx, cy, sx, sy ) : AddGlyphEdge( outline, x, y, sx, sy );
+}
+
+// Contours of a simple glyph through the affine `m` (x' = m0 x + m2 y + m4, y' = m1 x + m3 y + m5)
+static bool
+ReadSimpleGlyph( const unsigned char * data, size_t length, int contours, const float * m, GlyphOutline * outline )
+{
+    size_t p = 10 + (size_t)contours * 2;
+    if( 0 == contours ) return true;
+    if( p + 2 > length ) return false;
+
+    const int pointCount = (int)ReadU16( data + p - 2 ) + 1;
+    p += 2 + ReadU16( data + p ); // Instructions
+
+    unsigned char * flags  = (unsigned char *)LE_MALLOC( (size_t)pointCount );
+    float *         points = (float *)LE_MALLOC( (size_t)pointCount * 2 * sizeof( float ) );
+    bool            ok     = ( NULL != flags && NULL != points );
+
+    // Flags, with a repeat count when bit 3 is set
+    for( int i = 0; i < pointCount && ok; ++i )
+        {
+            ok = ( p < length );
+            if( !ok ) break;
+
+            flags[i] = data[p++];
+            if( flags[i] & 8 )
+                {
+                    ok = ( p < length );
+                    for( int repeat = ok ? data[p++] : 0; repeat > 0 && i + 1 < pointCount; --repeat )
+                        {
+                            flags[i + 1] = flags[i];
+                            ++i;
+                        }
+                }
+        }
+
+    // Coordinates are deltas, a short one (bit 1 and 2) carries its sign in bit 4 and 5, a long
+    // one is omitted when that bit says it repeats the last coordinate
+    for( int axis = 0; axis < 2 && ok; ++axis )
+        {
+            const unsigned char shortBit = axis ? 4 : 2;
+            const unsigned char sameBit  = axis ? 32 : 16;
+            int                 value    = 0;
+            for( int i = 0; i < pointCount && ok; ++i )
+                {
+                    if( flags[i] & shortBit )
+                        {
+                            ok = ( p < length );
+                            if( ok ) value += ( flags[i] & sameBit ) ? data[p] : -(int)data[p];
+                            p += 1;
+                        }
+                    else if( !( flags[i] & sameBit ) )
+                        {
+                            ok = ( p + 2 <= length );
+                            if( ok ) value += ReadS16( data + p );
+                            p += 2;
+                        }
+                    points[i * 2 + axis] = (float)value;
+                }
+        }
+
+    for( int i = 0; i < pointCount && ok; ++i )
+        {
+            const float x     = points[i * 2];
+            const float y     = points[i * 2 + 1];
+            points[i * 2]     = m[0] * x + m[2] * y + m[4];
+            points[i * 2 + 1] = m[1] * x + m[3] * y + m[5];
+        }
+
+    int start = 0;
+    for( int c = 0; c < contours && ok; ++c )
+        {
+            const int end = (int)ReadU16( data + 10 + c * 2 );
+            ok            = ( end >= start && end < pointCount )
+                 && AddGlyphContour( outline, points, flags, start, end );
+            start = end + 1;
+        }
+
+    LE_FREE( points );
+    LE_FREE( flags );
+    return ok;
+}
+
+static bool
+ReadGlyphOutline( const Font * font, int glyph, const float * m, GlyphOutline * outline, int depth )
+{
+    const unsigned char * data   = NULL;
+    size_t                length = 0;
+    if( !GetGlyphData( font, glyph, &data, &length ) ) return true;
+
+    const int contours = ReadS16( data );
+    if( contours >= 0 ) return ReadSimpleGlyph( data, length, contours, m, outline );
+    if( depth >= GLYPH_MAX_DEPTH ) return false;
+
+    // Composite glyph, a list of transformed components
+    size_t       p     = 10;
+    unsigned int flags = 0;
+    do
+        {
+            if( p + 4 > length ) return false;
+
+            flags                = ReadU16( data + p );
+            const int  component = (int)ReadU16( data + p + 2 );
+            const bool words     = ( flags & 0x0001 );
+            if( p + ( words ? 8 : 6 ) > length ) return false;
+
+            const float args[2] = { (float)( words ? ReadS16( data + p + 4 ) : (signed char)data[p + 4] ),
+                                    (float)( words ? ReadS16( data + p + 6 ) : (signed char)data[p + 5] ) };
+            p += words ? 8 : 6;
+
+            // Point matching components (no ARGS_ARE_XY_VALUES) are placed at their origin
+            const float dx = ( flags & 0x0002 ) ? args[0] : 0.0F;
+            const float dy = ( flags & 0x0002 ) ? args[1] : 0.0F;
+
+            float a = 1.0F, b = 0.0F, c = 0.0F, d = 1.0F;
+            if( flags & 0x0008 )
+                {
+                    if( p + 2 > length ) return false;
+                    a = d = ReadF2Dot14( data + p );
+                    p += 2;
+                }
+            else if( flags & 0x0040 )
+                {
+                    if( p + 4 > length ) return false;
+                    a = ReadF2Dot14( data + p );
+                    d = ReadF2Dot14( data + p + 2 );
+                    p += 4;
+                }
+            else if( flags & 0x0080 )
+                {
+                    if( p + 8 > length ) return false;
+                    a = ReadF2Dot14( data + p );
+                    b = ReadF2Dot14( data + p + 2 );
+                    c = ReadF2Dot14( data + p + 4 );
+                    d = ReadF2Dot14( data + p + 6 );
+                    p += 8;
+                }
+
+            const float child[6] = { m[0] * a + m[2] * b,           m[1] * a + m[3] * b,
+                                     m[0] * c + m[2] * d,           m[1] * c + m[3] * d,
+                                     m[0] * dx + m[2] * dy + m[4], m[1] * dx + m[3] * dy + m[5] };
+            if( !ReadGlyphOutline( font, component, child, outline, depth + 1 ) ) return false;
+        }
+    while( flags & 0x0020 );
+
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Rasterization
+//----------------------------------------------------------------------------------------------------------------------
+// Signed area an edge covers in each pixel it crosses, a running sum of the rows is the coverage
+static void
+AccumulateEdge( float * accumulation, int width, int height, GlyphEdge edge )
+{
+    if( edge.y0 == edge.y1 ) return;
+
+    float direction = 1.0F;
+    if( edge.y0 > edge.y1 )
+        {
+            edge      = (GlyphEdge){ edge.x1, edge.y1, edge.x0, edge.y0 };
+            direction = -1.0F;
+        }
+
+    const float slope = ( edge.x1 - edge.x0 ) / ( edge.y1 - edge.y0 );
+    const int   first = ( edge.y0 > 0.0F ) ? (int)edge.y0 : 0;
+    const int   last  = ( (int)ceilf( edge.y1 ) < height ) ? (int)ceilf( edge.y1 ) : height;
+
+    float x = edge.x0 - ( ( edge.y0 < 0.0F ) ? edge.y0 * slope : 0.0F );
+    for( int row = first; row < last; ++row )
+        {
+            float *     line  = accumulation + (size_t)row * width;
+            const float dy    = fminf( (float)( row + 1 ), edge.y1 ) - fmaxf( (float)row, edge.y0 );
+            const float next  = x + slope * dy;
+            const float area  = dy * direction;
+            const float left  = fminf( x, next );
+            const float right = fmaxf( x, next );
+            const int   begin = (int)floorf( left );
+            const int   end   = (int)ceilf( right );
+
+            if( end <= begin + 1 )
+                {
+                    // Inside one pixel, split by the mean position
+                    const float middle = 0.5F * ( x + next ) - (float)begin;
+                    line[begin] += area - area * middle;
+                    line[begin + 1] += area * middle;
+                }
+            else
+                {
+                    const float scale     = 1.0F / ( right - left );
+                    const float leftFrac  = left - (float)begin;
+                    const float rightFrac = right - (float)end + 1.0F;
+                    const float head      = 0.5F * scale * ( 1.0F - leftFrac ) * ( 1.0F - leftFrac );
+                    const float tail      = 0.5F * scale * rightFrac * rightFrac;
+
+                    line[begin] += area * head;
+                    if( end == begin + 2 )
+                        {
+                            line[begin + 1] += area * ( 1.0F - head - tail );
+                        }
+                    else
+                        {
+                            const float second = scale * ( 1.5F - leftFrac );
+                            line[begin + 1] += area * ( second - head );
+                            for( int i = begin + 2; i < end - 1; ++i ) line[i] += area * scale;
+                            line[end - 1] += area * ( 1.0F - second - (float)( end - begin - 3 ) * scale - tail );
+                        }
+                    line[end] += area * tail;
+                }
+
+            x = next;
+        }
+}
+
+static float
+GetEdgeDistanceSquared( const GlyphEdge * edge, float x, float y )
+{
+    const float dx     = edge->x1 - edge->x0;
+    const float dy     = edge->y1 - edge->y0;
+    const float length = dx * dx + dy * dy;
+    float       t      = ( length > 0.0F ) ? ( ( x - edge->x0 ) * dx + ( y - edge->y0 ) * dy ) / length : 0.0F;
+    t                  = fminf( fmaxf( t, 0.0F ), 1.0F );
+
+    const float ex = edge->x0 + t * dx - x;
+    const float ey = edge->y0 + t * dy - y;
+    return ex * ex + ey * ey;
+}
+
+// Alpha of every pixel: coverage, or with FONT_SDF the signed distance to the nearest edge mapped
+// from [-spread, spread] to [0, 1], inside above 0.5
+static void
+FillGlyphPixels( const GlyphOutline * outline, bool distanceField, int width, int height, unsigned char * pixels )
+{
+    float * coverage = (float *)LE_CALLOC( (size_t)width * height + 2, sizeof( float ) );
+    if( NULL == coverage ) return;
+
+    for( int i = 0; i < outline->count; ++i ) AccumulateEdge( coverage, width, height, outline->edges[i] );
+
+    float sum = 0.0F;
+    for( int i = 0; i < width * height; ++i )
+        {
+            sum += coverage[i];
+            coverage[i] = fminf( fabsf( sum ), 1.0F );
+        }
+
+    const float spread = (float)LE_FONT_SDF_SPREAD;
+    for( int y = 0; y < height; ++y )
+        {
+            for( int x = 0; x < width; ++x )
+                {
+                    const float inside = coverage[y * width + x];
+                    float       alpha  = inside;
+                    if( distanceField )
+                        {
+                            float nearest = FLT_MAX;
+                            for( int i = 0; i < outline->count; ++i )
+                                {
+                                    const float d = GetEdgeDistanceSquared( &outline->edges[i], (float)x + 0.5F,
+                                                                            (float)y + 0.5F );
+                                    nearest       = fminf( nearest, d );
+                                }
+
+                            const float distance = ( inside >= 0.5F ) ? sqrtf( nearest ) : -sqrtf( nearest );
+                            alpha                = fminf( fmaxf( 0.5F + 0.5F * distance / spread, 0.0F ), 1.0F );
+                        }
+
+                    unsigned char * pixel = pixels + ( (size_t)y * width + x ) * 4;
+                    pixel[0] = pixel[1] = pixel[2] = 255;
+                    pixel[3]                       = (unsigned char)( alpha * 255.0F + 0.5F );
+                }
+        }
+
+    LE_FREE( coverage );
+}
+
+// Rasterize a glyph into the font atlas, glyphs without pixels keep a texture ID of 0
+static void
+RasterizeGlyph( Font * font, int glyph, int pixelSize, FontGlyph * entry )
+{
+    const bool  distanceField = ( FONT_SDF == font->type );
+    const float scale         = (float)pixelSize / (float)font->unitsPerEm;
+    const float flip[6]       = { scale, 0.0F, 0.0F, -scale, 0.0F, 0.0F };
+
+    GlyphOutline outline = { 0 };
+    if( !ReadGlyphOutline( font, glyph, flip, &outline, 0 ) )
+        {
+            TRACELOG( LOG_WARNING, "FONT: Invalid outline for glyph %d", glyph );
+            outline.count = 0;
+        }
+
+    if( outline.count > 0 )
+        {
+            float minX = FLT_MAX, minY = FLT_MAX, maxX = -FLT_MAX, maxY = -FLT_MAX;
+            for( int i = 0; i < outline.count; ++i )
+                {
+                    const GlyphEdge * edge = &outline.edges[i];
+                    minX                   = fminf( minX, fminf( edge->x0, edge->x1 ) );
+                    minY                   = fminf( minY, fminf( edge->y0, edge->y1 ) );
+                    maxX                   = fmaxf( maxX, fmaxf( edge->x0, edge->x1 ) );
+                    maxY                   = fmaxf( maxY, fmaxf( edge->y0, edge->y1 ) );
+                }
+
+            // Blank pixels around the outline keep the rasterizer inside and let the field fall off
+            const float pad    = distanceField ? (float)LE_FONT_SDF_SPREAD : 1.0F;
+            const float left   = floorf( minX ) - pad;
+            const float top    = floorf( minY ) - pad;
+            const int   width  = (int)( ceilf( maxX ) + pad - left );
+            const int   height = (int)( ceilf( maxY ) + pad - top );
+
+            Image image = { 0 };
+            if( width < LE_FONT_ATLAS_SIZE && height < LE_FONT_ATLAS_SIZE )
+                {
+                    image.data   = LE_MALLOC( (size_t)width * height * 4 );
+                    image.width  = width;
+                    image.height = height;
+                }
+
+            if( NULL != image.data )
+                {
+                    for( int i = 0; i < outline.count; ++i )
+                        {
+                            GlyphEdge * edge = &outline.edges[i];
+                            edge->x0 -= left;
+                            edge->x1 -= left;
+                            edge->y0 -= top;
+                            edge->y1 -= top;
+                        }
+
+                    FillGlyphPixels( &outline, distanceField, width, height, (unsigned char *)image.data );
+                    if( AddAtlasImage( font->atlas, image, &entry->sprite ) )
+                        {
+                            entry->offsetX = left;
+                            entry->offsetY = top;
+                        }
+                    LE_FREE( image.data );
+                }
+            else
+                {
+                    TRACELOG( LOG_WARNING, "FONT: Glyph %d at size %d does not fit the atlas", glyph, pixelSize );
+                }
+        }
+
+    LE_FREE( outline.edges );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Caches
+//----------------------------------------------------------------------------------------------------------------------
+static INLINE unsigned int
+HashGlyphKey( unsigned int key )
+{
+    return key * 2654435761U;
+}
+
+static bool
+GrowGlyphTable( Font * font )
+{
+    const int   capacity = ( 0 == font->glyphCapacity ) ? 256 : font->glyphCapacity * 2;
+    FontGlyph * glyphs   = (FontGlyph *)LE_CALLOC( (size_t)capacity, sizeof( FontGlyph ) );
+    if( NULL == glyphs ) return false;
+
+    for( int i = 0; i < font->glyphCapacity; ++i )
+        {
+            const FontGlyph * entry = &font->glyphs[i];
+            if( 0 == entry->key ) continue;
+
+            unsigned int slot = HashGlyphKey( entry->key ) & (unsigned int)( capacity - 1 );
+            while( 0 != glyphs[slot].key ) slot = ( slot + 1 ) & (unsigned int)( capacity - 1 );
+            glyphs[slot] = *entry;
+        }
+
+    LE_FREE( font->glyphs );
+    TrackMemory( MEMORY_FONTS, (size_t)( capacity - font->glyphCapacity ) * sizeof( FontGlyph ), true );
+    font->glyphs        = glyphs;
+    font->glyphCapacity = capacity;
+    return true;
+}
+
+// A glyph at a pixel size, rasterized on first use
+static const FontGlyph *
+GetFontGlyph( Font * font, int glyph, int pixelSize )
+{
+    if( ( font->glyphUsed + 1 ) * 4 > font->glyphCapacity * 3 && !GrowGlyphTable( font ) ) return NULL;
+
+    const unsigned int key  = ( (unsigned int)( glyph + 1 ) << 12 ) | (unsigned int)pixelSize;
+    const unsigned int mask = (unsigned int)( font->glyphCapacity - 1 );
+    unsigned int       slot = HashGlyphKey( key ) & mask;
+    while( 0 != font->glyphs[slot].key )
+        {
+            if( key == font->glyphs[slot].key ) return &font->glyphs[slot];
+            slot = ( slot + 1 ) & mask;
+        }
+
+    FontGlyph * entry = &font->glyphs[slot];
+    entry->key        = key;
+    ++font->glyphUsed;
+
+    RasterizeGlyph( font, glyph, pixelSize, entry );
+    return entry;
+}
+
+// FNV-1a
+static unsigned int
+HashText( const char * text, int length )
+{
+    unsigned int hash = 2166136261U;
+    for( int i = 0; i < length; ++i ) hash = ( hash ^ (unsigned char)text[i] ) * 16777619U;
+    return ( 0 != hash ) ? hash : 1;
+}
+
+static size_t
+GetRunSize( const TextRun * run )
+{
+    return (size_t)run->length + 1 + (size_t)run->glyphCount * sizeof( ShapedGlyph );
+}
+
+static void
+ClearTextRuns( Font * font )
+{
+    size_t bytes = 0;
+    for( int i = 0; i < font->runCapacity; ++i )
+        {
+            TextRun * run = &font->runs[i];
+            if( 0 == run->hash ) continue;
+
+            bytes += GetRunSize( run );
+            LE_FREE( run->text );
+            LE_FREE( run->glyphs );
+            *run = (TextRun){ 0 };
+        }
+
+    font->runUsed = 0;
+    TrackMemory( MEMORY_FONTS, bytes, false );
+}
+
+static bool
+GrowRunTable( Font * font )
+{
+    const int capacity = ( 0 == font->runCapacity ) ? 64 : font->runCapacity * 2;
+    TextRun * runs     = (TextRun *)LE_CALLOC( (size_t)capacity, sizeof( TextRun ) );
+    if( NULL == runs ) return false;
+
+    for( int i = 0; i < font->runCapacity; ++i )
+        {
+            const TextRun * run = &font->runs[i];
+            if( 0 == run->hash ) continue;
+
+            unsigned int slot = run->hash & (unsigned int)( capacity - 1 );
+            while( 0 != runs[slot].hash ) slot = ( slot + 1 ) & (unsigned int)( capacity - 1 );
+            runs[slot] = *run;
+        }
+
+    LE_FREE( font->runs );
+    TrackMemory( MEMORY_FONTS, (size_t)( capacity - font->runCapacity ) * sizeof( TextRun ), true );
+    font->runs        = runs;
+    font->runCapacity = capacity;
+    return true;
+}
+
+// Glyphs and pen positions of a string in font units, lines split at '\n'
+static bool
+ShapeText( const Font * font, const char * text, int length, TextRun * run )
+{
+    run->glyphs = (ShapedGlyph *)LE_MALLOC( (size_t)( length > 0 ? length : 1 ) * sizeof( ShapedGlyph ) );
+    run->text   = (char *)LE_MALLOC( (size_t)length + 1 );
+    if( NULL == run->glyphs || NULL == run->text )
+        {
+            LE_FREE( run->glyphs );
+            LE_FREE( run->text );
+            return false;
+        }
+
+    memcpy( run->text, text, (size_t)length + 1 );
+    run->length    = length;
+    run->lineCount = 1;
+
+    float x        = 0.0F;
+    int   previous = -1;
+    for( int i = 0, bytes = 0; i < length; i += bytes )
+        {
+            const int codepoint = DecodeCodepoint( (const unsigned char *)text + i, length - i, &bytes );
+            if( '\n' == codepoint )
+                {
+                    run->width = fmaxf( run->width, x );
+                    x          = 0.0F;
+                    previous   = -1;
+                    ++run->lineCount;
+                    continue;
+                }
+
+            const int glyph = FindGlyphIndex( &font->cmap, codepoint );
+            if( previous >= 0 ) x += (float)GetGlyphKerning( font, previous, glyph );
+
+            if( HasGlyphOutline( font, glyph ) )
+                {
+                    ShapedGlyph * shaped = &run->glyphs[run->glyphCount++];
+                    shaped->x            = x;
+                    shaped->glyph        = (unsigned short)glyph;
+                    shaped->line         = (unsigned short)( run->lineCount - 1 );
+                }
+
+            x += (float)GetGlyphAdvance( font, glyph );
+            previous = glyph;
+        }
+
+    run->width = fmaxf( run->width, x );
+
+    // Keep only the glyphs drawn
+    if( 0 == run->glyphCount )
+        {
+            LE_FREE( run->glyphs );
+            run->glyphs = NULL;
+        }
+    else if( run->glyphCount < length )
+        {
+            const size_t  bytes  = (size_t)run->glyphCount * sizeof( ShapedGlyph );
+            ShapedGlyph * glyphs = (ShapedGlyph *)LE_REALLOC( run->glyphs, bytes );
+            if( NULL != glyphs ) run->glyphs = glyphs;
+        }
+
+    return true;
+}
+
+// The shaped run of a string, shaped and cached on first use
+static const TextRun *
+GetTextRun( Font * font, const char * text )
+{
+    const int          length = (int)strlen( text );
+    const unsigned int hash   = HashText( text, length );
+
+    if( font->runCapacity > 0 )
+        {
+            const unsigned int mask = (unsigned int)( font->runCapacity - 1 );
+            for( unsigned int slot = hash & mask; 0 != font->runs[slot].hash; slot = ( slot + 1 ) & mask )
+                {
+                    const TextRun * run = &font->runs[slot];
+                    if( hash == run->hash && length == run->length && 0 == memcmp( text, run->text, (size_t)length ) )
+                        return run;
+                }
+        }
+
+    // A full cache starts over instead of tracking use, strings still drawn are shaped again
+    if( font->runUsed >= LE_TEXT_CACHE_SIZE ) ClearTextRuns( font );
+    if( ( font->runUsed + 1 ) * 4 > font->runCapacity * 3 && !GrowRunTable( font ) ) return NULL;
+
+    TextRun shaped = { 0 };
+    if( !ShapeText( font, text, length, &shaped ) ) return NULL;
+    shaped.hash = hash;
+
+    const unsigned int mask = (unsigned int)( font->runCapacity - 1 );
+    unsigned int       slot = hash & mask;
+    while( 0 != font->runs[slot].hash ) slot = ( slot + 1 ) & mask;
+
+    font->runs[slot] = shaped;
+    ++font->runUsed;
+    TrackMemory( MEMORY_FONTS, GetRunSize( &shaped ), true );
+    return &font->runs[slot];
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Drawing
+//----------------------------------------------------------------------------------------------------------------------
+static INLINE void
+SetGlyphVertex( RenderVertex * vertex, RenderVertex base, float x, float y, float u, float v )
+{
+    *vertex   = base;
+    vertex->x = x;
+    vertex->y = y;
+    vertex->u = u;
+    vertex->v = v;
+}
+
+// Quad covering a glyph bitmap drawn at (x, y) and `scale` times its pixel size
+static void
+SetGlyphQuad( RenderVertex * v, RenderVertex base, const FontGlyph * glyph, float x, float y, float scale,
+              bool distanceField )
+{
+    const Texture   texture = glyph->sprite.texture;
+    const Rectangle source  = glyph->sprite.source;
+
+    const float left   = x + glyph->offsetX * scale;
+    const float top    = y + glyph->offsetY * scale;
+    const float right  = left + source.width * scale;
+    const float bottom = top + source.height * scale;
+    const float u0     = source.x / (float)texture.width;
+    const float v0     = source.y / (float)texture.height;
+    const float u1     = ( source.x + source.width ) / (float)texture.width;
+    const float v1     = ( source.y + source.height ) / (float)texture.height;
+
+    base.layer = distanceField ? -1.0F - (float)texture.layer : (float)texture.layer;
+
+    SetGlyphVertex( &v[0], base, left, top, u0, v0 );
+    SetGlyphVertex( &v[1], base, left, bottom, u0, v1 );
+    SetGlyphVertex( &v[2], base, right, bottom, u1, v1 );
+    SetGlyphVertex( &v[3], base, right, top, u1, v0 );
+}
+
+static void
+DrawTextRun( Font * font, const TextRun * run, float posX, float posY, float fontSize, Color color )
+{
+    const bool  distanceField = ( FONT_SDF == font->type );
+    const float scale         = fontSize / (float)font->unitsPerEm;
+    const float lineHeight    = (float)( font->ascent - font->descent + font->lineGap ) * scale;
+
+    // Glyphs may overhang their advance and line, a margin of one size covers them
+    if( !IsAreaVisible( posX - fontSize, posY - fontSize, posX + run->width * scale + fontSize,
+                        posY + (float)run->lineCount * lineHeight + fontSize ) )
+        return;
+
+    int pixelSize = distanceField ? LE_FONT_SDF_SIZE : (int)( fontSize + 0.5F );
+    pixelSize     = ( pixelSize < 1 ) ? 1 : ( pixelSize > GLYPH_MAX_SIZE ) ? GLYPH_MAX_SIZE : pixelSize;
+
+    const float bitmapScale = distanceField ? fontSize / (float)LE_FONT_SDF_SIZE : 1.0F;
+
+    // Rasterize what is missing first, the whole string is one reservation when its glyphs share
+    // a texture, which they always do with texture arrays
+    int          quadCount = 0;
+    unsigned int textureId = 0;
+    bool         shared    = true;
+    for( int i = 0; i < run->glyphCount; ++i )
+        {
+            const FontGlyph * glyph = GetFontGlyph( font, run->glyphs[i].glyph, pixelSize );
+            if( NULL == glyph || 0 == glyph->sprite.texture.id ) continue;
+
+            if( 0 != textureId && textureId != glyph->sprite.texture.id ) shared = false;
+            textureId = glyph->sprite.texture.id;
+            ++quadCount;
+        }
+
+    if( 0 == quadCount ) return;
+
+    RenderVertex base = { 0 };
+    SetVertexColor( &base, color );
+
+    const float baseline = posY + (float)font->ascent * scale;
+
+    RenderVertex * v = NULL;
+    if( shared )
+        {
+            RecordTexture( textureId );
+            v = RecordVertices( LE_QUADS, quadCount * 4 );
+            if( NULL == v ) return;
+        }
+
+    int written = 0;
+    for( int i = 0; i < run->glyphCount; ++i )
+        {
+            const ShapedGlyph * shaped = &run->glyphs[i];
+            const FontGlyph *   glyph  = GetFontGlyph( font, shaped->glyph, pixelSize );
+            if( NULL == glyph || 0 == glyph->sprite.texture.id ) continue;
+
+            // Coverage glyphs land on whole pixels to stay sharp
+            float x = posX + shaped->x * scale;
+            float y = baseline + (float)shaped->line * lineHeight;
+            if( !distanceField )
+                {
+                    x = floorf( x + 0.5F );
+                    y = floorf( y + 0.5F );
+                }
+
+            if( shared )
+                {
+                    SetGlyphQuad( &v[written * 4], base, glyph, x, y, bitmapScale, distanceField );
+                    ++written;
+                    continue;
+                }
+
+            RecordTexture( glyph->sprite.texture.id );
+            RenderVertex * quad = RecordVertices( LE_QUADS, 4 );
+            if( NULL == quad ) return;
+
+            SetGlyphQuad( quad, base, glyph, x, y, bitmapScale, distanceField );
+            TransformVertices( quad, 4 );
+        }
+
+    if( shared ) TransformVertices( v, written * 4 );
+}
+
+//==============================================================================================================
+// MODULE FUNCTIONS DEFINITIONS
+//==============================================================================================================
+Font *
+LoadFont( const char * fileName, int type )
+{
+    LE_PROFILE_ZONE( "LoadFont" );
+
+    FILE * file = fopen( fileName, "rb" );
+    if( NULL == file )
+        {
+            TRACELOG( LOG_WARNING, "FONT: Failed to open file: %s", fileName );
+            return NULL;
+        }
+
+    fseek( file, 0, SEEK_END );
+    const long size = ftell( file );
+    fseek( file, 0, SEEK_SET );
+
+    unsigned char * data = ( size > 0 ) ? (unsigned char *)LE_MALLOC( (size_t)size ) : NULL;
+    if( NULL == data )
+        {
+            fclose( file );
+            return NULL;
+        }
+
+    TrackMemory( MEMORY_FILE_DATA, (size_t)size, true );
+    const size_t bytes = fread( data, 1, (size_t)size, file );
+    fclose( file );
+
+    Font * font = LoadFontFromMemory( data, (int)bytes, type );
+    if( NULL != font ) TRACELOG( LOG_INFO, "FONT: [%s] Loaded %d glyphs", fileName, font->glyphCount );
+
+    TrackMemory( MEMORY_FILE_DATA, (size_t)size, false );
+    LE_FREE( data );
+    return font;
+}
+
+Font *
+LoadFontFromMemory( const unsigned char * data, int size, int type )
+{
+    if( NULL == data || size < 12 ) return NULL;
+
+    Font * font = (Font *)LE_CALLOC( 1, sizeof( Font ) );
+    if( NULL == font ) return NULL;
+
+    font->data = (unsigned char *)LE_MALLOC( (size_t)size );
+    if( NULL == font->data )
+        {
+            LE_FREE( font );
+            return NULL;
+        }
+
+    memcpy( font->data, data, (size_t)size );
+    font->size = (size_t)size;
+    font->type = ( FONT_SDF == type ) ? FONT_SDF : FONT_DEFAULT;
+    TrackMemory( MEMORY_FONTS, sizeof( Font ) + font->size, true );
+
+    const unsigned int version = ReadU32( font->data );
+    size_t             head = 0, hhea = 0, maxp = 0, cmap = 0, headLength = 0, hheaLength = 0, maxpLength = 0;
+    size_t             cmapLength = 0, locaLength = 0, hmtxLength = 0;
+
+    bool valid = ( 0x00010000 == version || 0x74727565 == version ) // 1.0 or 'true'
+              && FindTable( font, "head", &head, &headLength ) && headLength >= 54
+              && FindTable( font, "hhea", &hhea, &hheaLength ) && hheaLength >= 36
+              && FindTable( font, "maxp", &maxp, &maxpLength ) && maxpLength >= 6
+              && FindTable( font, "cmap", &cmap, &cmapLength ) && FindTable( font, "loca", &font->loca, &locaLength )
+              && FindTable( font, "glyf", &font->glyf, &font->glyfLength )
+              && FindTable( font, "hmtx", &font->hmtx, &hmtxLength );
+
+    if( valid )
+        {
+            font->unitsPerEm  = (int)ReadU16( font->data + head + 18 );
+            font->longOffsets = ( 0 != ReadS16( font->data + head + 50 ) );
+            font->ascent      = ReadS16( font->data + hhea + 4 );
+            font->descent     = ReadS16( font->data + hhea + 6 );
+            font->lineGap     = ReadS16( font->data + hhea + 8 );
+            font->metricCount = (int)ReadU16( font->data + hhea + 34 );
+            font->glyphCount  = (int)ReadU16( font->data + maxp + 4 );
+
+            valid = font->unitsPerEm > 0 && font->metricCount > 0 && (size_t)font->metricCount * 4 <= hmtxLength
+                 && (size_t)( font->glyphCount + 1 ) * ( font->longOffsets ? 4 : 2 ) <= locaLength
+                 && SelectCharacterMap( &font->cmap, font->data, font->size, cmap, cmapLength );
+        }
+
+    if( !valid )
+        {
+            TRACELOG( LOG_WARNING, "FONT: Unsupported font data, TrueType outlines expected" );
+            TrackMemory( MEMORY_FONTS, sizeof( Font ) + font->size, false );
+            LE_FREE( font->data );
+            LE_FREE( font );
+            return NULL;
+        }
+
+    SelectKerningPairs( font );
+
+    font->atlas = CreateTextureAtlas( LE_FONT_ATLAS_SIZE );
+    if( NULL == font->atlas )
+        {
+            TrackMemory( MEMORY_FONTS, sizeof( Font ) + font->size, false );
+            LE_FREE( font->data );
+            LE_FREE( font );
+            return NULL;
+        }
+
+    leMutexInit( &font->lock );
+    return font;
+}
+
+void
+UnloadFont( Font * font )
+{
+    if( NULL == font ) return;
+
+    ClearTextRuns( font );
+    DestroyTextureAtlas( font->atlas );
+    leMutexDestroy( &font->lock );
+
+    TrackMemory( MEMORY_FONTS,
+                 sizeof( Font ) + font->size + (size_t)font->glyphCapacity * sizeof( FontGlyph )
+                     + (size_t)font->runCapacity * sizeof( TextRun ),
+                 false );
+
+    LE_FREE( font->runs );
+    LE_FREE( font->glyphs );
+    LE_FREE( font->data );
+    LE_FREE( font );
+}
+
+// Draw a string with its top-left at (posX, posY), lines split at '\n'
+void
+DrawText( Font * font, const char * text, float posX, float posY, float fontSize, Color color )
+{
+    if( NULL == font || NULL == text || '\0' == text[0] || fontSize <= 0.0F ) return;
+
+    leMutexLock( &font->lock );
+
+    const TextRun * run = GetTextRun( font, text );
+    if( NULL != run ) DrawTextRun( font, run, posX, posY, fontSize, color );
+
+    leMutexUnlock( &font->lock );
+}
+
+// Width of the widest line and height of every line of a string
+Vector2
+MeasureText( Font * font, const char * text, float fontSize )
+{
+    Vector2 size = { 0.0F, 0.0F };
+    if( NULL == font || NULL == text || '\0' == text[0] ) return size;
+
+    leMutexLock( &font->lock );
+
+    const TextRun * run = GetTextRun( font, text );
+    if( NULL != run )
+        {
+            const float scale = fontSize / (float)font->unitsPerEm;
+            size.x            = run->width * scale;
+            size.y            = (float)run->lineCount * (float)( font->ascent - font->descent + font->lineGap ) * scale;
+        }
+
+    leMutexUnlock( &font->lock );
+    return size;
+}
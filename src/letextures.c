@@ -0,0 +1,1231 @@
+/****************************** LETEXTURES *******************************
+ * letextures: Image decoding, textures and texture atlases
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ * - DEFINES:
+ *   - LE_TEXTURE_WORKERS: Threads decoding the files of LoadTextureAsync
+ *   - LE_TEXTURE_UPLOAD_BUDGET: Bytes of decoded async loads uploaded per frame, at least one load
+ *   - LE_ATLAS_PADDING: Pixels left between the images of an atlas page
+ *
+ * - Images are RGBA with 8 bits per channel. QOI and binary PNM (P5 gray, P6 RGB, up to 8 bits)
+ *   are decoded, the format is detected from the first bytes.
+ * - LoadTextureAsync hands the file to a process wide pool of decoding threads, started with the
+ *   first async load and stopped with the last context. Decoded images wait in the context until
+ *   the thread owning the GL context submits a frame, which uploads them through a pixel unpack
+ *   buffer within LE_TEXTURE_UPLOAD_BUDGET, so a burst of loads never stalls one frame.
+ * - Atlas pages pack images with a bottom-left skyline: the top edge of the used area is kept as a
+ *   list of horizontal segments and every image goes where its top ends lowest. Pages are created
+ *   when an image fits nowhere, their pixels are written before the next frame executes.
+ * - With LE_TEXTURE_ARRAYS the pages of an atlas are layers of one texture array, grown by
+ *   doubling, so sprites of every page draw together. Each atlas texture also holds a white texel
+ *   shapes sample, keeping them in the same draw as the sprites around them.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+//==============================================================================================================
+// INCLUDES
+//==============================================================================================================
+#include "lecore_context.h"
+#include "lememory.h"
+#include "lerender.h"
+#include "leskyline.h"
+#include "lesystem.h"
+
+#include "levegl/leutils.h"
+#include "levegl/levegl.h"
+
+#undef LEGL_IMPLEMENTATION
+#include "levegl/legl.h"
+
+#include <math.h>   /* cosf, sinf, fabsf, fminf, fmaxf */
+#include <stdio.h>  /* fopen, fread */
+#include <string.h> /* memcpy, memset, strlen */
+
+//==============================================================================================================
+// DEFINES
+//==============================================================================================================
+#ifndef LE_TEXTURE_WORKERS
+#    define LE_TEXTURE_WORKERS 2
+#endif
+
+#ifndef LE_TEXTURE_UPLOAD_BUDGET
+#    define LE_TEXTURE_UPLOAD_BUDGET ( 4 * 1024 * 1024 )
+#endif
+
+#ifndef LE_ATLAS_PADDING
+#    define LE_ATLAS_PADDING 1
+#endif
+
+// Largest width or height decoded, keeps the pixel count of any image inside an int
+#define LE_MAX_IMAGE_SIZE 16384
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+typedef enum
+{
+    TEXTURE_LOAD_DECODING = 0, /// Queued or being decoded by a worker
+    TEXTURE_LOAD_UPLOADING,    /// Decoded, waiting for a frame to upload it
+    TEXTURE_LOAD_DONE,         /// Uploaded, or failed with a texture ID of 0
+} TextureLoadState;
+
+struct TextureLoad
+{
+    LeContext *          context;
+    char *               fileName;
+    Image                image;
+    Texture              texture;
+    long                 state; /// TextureLoadState, atomic, nothing touches the load once DONE but its owner
+    struct TextureLoad * next;  /// Pool queue, then the ready list of the context
+};
+
+/// Atlas pixels waiting for the GL context
+typedef struct TextureUpdate
+{
+    unsigned int           textureId;
+    int                    x;
+    int                    y;
+    int                    layer;
+    Image                  image;
+    struct TextureUpdate * next;
+} TextureUpdate;
+
+struct TexturesState
+{
+    leMutex     lock; /// Guards everything below but `pixelBufferId`, workers append decoded loads
+    leCondition idle; /// Broadcast when `decoding` drops
+
+    TextureLoad *    ready; /// Decoded loads in completion order
+    TextureLoad **   readyTail;
+    TextureUpdate *  updates; /// Atlas writes, all uploaded before the next frame executes
+    TextureUpdate ** updatesTail;
+    int              decoding; /// Loads of this context still queued or decoding
+
+    unsigned int pixelBufferId; /// Touched only by the thread owning the GL context
+};
+
+typedef struct AtlasPage
+{
+    Texture      texture;
+    AtlasSkyline skyline;
+} AtlasPage;
+
+struct TextureAtlas
+{
+    LeContext *  context;
+    int          pageSize;
+    AtlasPage *  pages;
+    int          pageCount;
+    int          pageCapacity;
+    unsigned int textureId;     /// Texture array holding every page (LE_TEXTURE_ARRAYS)
+    int          layerCapacity; /// Layers allocated in `textureId`
+};
+
+/// Arguments of the GL work forwarded to the render thread
+typedef struct TextureTask
+{
+    const void *   data;
+    Texture *      texture;
+    TextureAtlas * atlas;
+    int            layers;
+} TextureTask;
+
+//==============================================================================================================
+// GLOBALS
+//==============================================================================================================
+// Decoding threads, shared by every context
+static struct
+{
+    int           users; /// Contexts alive, the last one stops the threads
+    int           threadCount;
+    leMutex       queueLock;
+    leCondition   wake;
+    TextureLoad * queue; /// FIFO of loads to decode
+    TextureLoad * queueTail;
+    bool          quit;
+    leThread      threads[LE_TEXTURE_WORKERS];
+} decodePool = { 0 };
+
+static leMutex decodePoolLock = LE_MUTEX_INITIALIZER; // Guards `users` and starting or stopping the threads
+
+//==============================================================================================================
+// MODULE FUNCTIONS DECLARATIONS
+//==============================================================================================================
+extern void PostEmptyEvent( void );
+
+//==============================================================================================================
+// MODULE INTERNAL FUNCTIONS
+//==============================================================================================================
+static INLINE size_t
+GetImageSize( int width, int height )
+{
+    return (size_t)width * (size_t)height * 4;
+}
+
+static Image
+AllocImage( int width, int height )
+{
+    Image image = { 0 };
+    if( width <= 0 || height <= 0 || width > LE_MAX_IMAGE_SIZE || height > LE_MAX_IMAGE_SIZE ) return image;
+
+    image.data = LE_MALLOC( GetImageSize( width, height ) );
+    if( NULL == image.data ) return image;
+
+    image.width  = width;
+    image.height = height;
+    TrackMemory( MEMORY_IMAGES, GetImageSize( width, height ), true );
+    return image;
+}
+
+// Whole file in memory, `bytes` receives its size
+static unsigned char *
+LoadFileData( const char * fileName, size_t * bytes )
+{
+    *bytes = 0;
+
+    FILE * file = fopen( fileName, "rb" );
+    if( NULL == file )
+        {
+            TRACELOG( LOG_WARNING, "IMAGE: Failed to open file: %s", fileName );
+            return NULL;
+        }
+
+    fseek( file, 0, SEEK_END );
+    const long size = ftell( file );
+    fseek( file, 0, SEEK_SET );
+
+    unsigned char * data = ( size > 0 ) ? (unsigned char *)LE_MALLOC( (size_t)size ) : NULL;
+    if( NULL == data )
+        {
+            fclose( file );
+            return NULL;
+        }
+
+    TrackMemory( MEMORY_FILE_DATA, (size_t)size, true );
+    *bytes = fread( data, 1, (size_t)size, file );
+    fclose( file );
+
+    return data;
+}
+
+static void
+UnloadFileData( unsigned char * data, size_t bytes )
+{
+    if( NULL == data ) return;
+
+    TrackMemory( MEMORY_FILE_DATA, bytes, false );
+    LE_FREE( data );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Decoders
+//----------------------------------------------------------------------------------------------------------------------
+static INLINE unsigned int
+ReadBigEndian32( const unsigned char * bytes )
+{
+    return ( (unsigned int)bytes[0] << 24 ) | ( (unsigned int)bytes[1] << 16 ) | ( (unsigned int)bytes[2] << 8 )
+         | (unsigned int)bytes[3];
+}
+
+// Quite OK Image format, see qoiformat.org
+static Image
+DecodeQOI( const unsigned char * data, size_t size )
+{
+    Image image = { 0 };
+    if( size < 14 + 8 ) return image;
+
+    const unsigned int width  = ReadBigEndian32( data + 4 );
+    const unsigned int height = ReadBigEndian32( data + 8 );
+    if( width > LE_MAX_IMAGE_SIZE || height > LE_MAX_IMAGE_SIZE ) return image;
+
+    image = AllocImage( (int)width, (int)height );
+    if( NULL == image.data ) return image;
+
+    unsigned char   index[64][4];
+    unsigned char   pixel[4] = { 0, 0, 0, 255 };
+    unsigned char * out      = (unsigned char *)image.data;
+    const size_t    end      = size - 8; // The stream ends with 7 zeros and a one
+    size_t          p        = 14;
+    int             run      = 0;
+
+    memset( index, 0, sizeof( index ) );
+
+    for( size_t i = 0, count = (size_t)width * height; i < count; ++i )
+        {
+            if( run > 0 )
+                {
+                    --run;
+                }
+            else if( p < end )
+                {
+                    const unsigned char op = data[p++];
+
+                    if( 0xFE == op && p + 3 <= end )
+                        {
+                            memcpy( pixel, data + p, 3 );
+                            p += 3;
+                        }
+                    else if( 0xFF == op && p + 4 <= end )
+                        {
+                            memcpy( pixel, data + p, 4 );
+                            p += 4;
+                        }
+                    else if( 0x00 == ( op & 0xC0 ) )
+                        {
+                            memcpy( pixel, index[op], 4 );
+                        }
+                    else if( 0x40 == ( op & 0xC0 ) )
+                        {
+                            pixel[0] = (unsigned char)( pixel[0] + ( ( op >> 4 ) & 3 ) - 2 );
+                            pixel[1] = (unsigned char)( pixel[1] + ( ( op >> 2 ) & 3 ) - 2 );
+                            pixel[2] = (unsigned char)( pixel[2] + ( op & 3 ) - 2 );
+                        }
+                    else if( 0x80 == ( op & 0xC0 ) && p < end )
+                        {
+                            const int green = ( op & 0x3F ) - 32;
+                            const int next  = data[p++];
+                            pixel[0]        = (unsigned char)( pixel[0] + green - 8 + ( ( next >> 4 ) & 0x0F ) );
+                            pixel[1]        = (unsigned char)( pixel[1] + green );
+                            pixel[2]        = (unsigned char)( pixel[2] + green - 8 + ( next & 0x0F ) );
+                        }
+                    else if( 0xC0 == ( op & 0xC0 ) && op < 0xFE )
+                        {
+                            run = op & 0x3F;
+                        }
+
+                    memcpy( index[( pixel[0] * 3 + pixel[1] * 5 + pixel[2] * 7 + pixel[3] * 11 ) % 64], pixel, 4 );
+                }
+
+            memcpy( out + i * 4, pixel, 4 );
+        }
+
+    return image;
+}
+
+// Skip whitespace and comments, then read a decimal field of a PNM header
+static bool
+ReadPNMField( const unsigned char * data, size_t size, size_t * p, unsigned int * value )
+{
+    while( *p < size )
+        {
+            if( '#' == data[*p] )
+                {
+                    while( *p < size && '\n' != data[*p] ) ++*p;
+                }
+            else if( ' ' == data[*p] || '\t' == data[*p] || '\r' == data[*p] || '\n' == data[*p] )
+                {
+                    ++*p;
+                }
+            else
+                {
+                    break;
+                }
+        }
+
+    if( *p >= size || data[*p] < '0' || data[*p] > '9' ) return false;
+
+    *value = 0;
+    while( *p < size && data[*p] >= '0' && data[*p] <= '9' && *value <= 100000 )
+        {
+            *value = *value * 10 + (unsigned int)( data[*p] - '0' );
+            ++*p;
+        }
+
+    return true;
+}
+
+// Binary portable graymap (P5) and pixmap (P6) with up to 8 bits per sample
+static Image
+DecodePNM( const unsigned char * data, size_t size )
+{
+    Image image = { 0 };
+
+    const int    channels = ( '5' == data[1] ) ? 1 : 3;
+    size_t       p        = 2;
+    unsigned int width = 0, height = 0, maxValue = 0;
+    if( !ReadPNMField( data, size, &p, &width ) || !ReadPNMField( data, size, &p, &height )
+        || !ReadPNMField( data, size, &p, &maxValue ) )
+        {
+            return image;
+        }
+
+    // A single whitespace separates the header from the samples
+    ++p;
+    if( 0 == maxValue || maxValue > 255 || width > LE_MAX_IMAGE_SIZE || height > LE_MAX_IMAGE_SIZE ) return image;
+    if( p > size || size - p < (size_t)width * height * (size_t)channels ) return image;
+
+    image = AllocImage( (int)width, (int)height );
+    if( NULL == image.data ) return image;
+
+    const unsigned char * in  = data + p;
+    unsigned char *       out = (unsigned char *)image.data;
+    for( size_t i = 0, count = (size_t)width * height; i < count; ++i, in += channels, out += 4 )
+        {
+            out[0] = (unsigned char)( in[0] * 255U / maxValue );
+            out[1] = (unsigned char)( in[( channels > 1 ) ? 1 : 0] * 255U / maxValue );
+            out[2] = (unsigned char)( in[( channels > 1 ) ? 2 : 0] * 255U / maxValue );
+            out[3] = 255;
+        }
+
+    return image;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Uploads
+//----------------------------------------------------------------------------------------------------------------------
+// Wake a context sleeping in an event driven BeginDrawing, its loads changed state
+static void
+RequestContextRedraw( LeContext * context )
+{
+    leAtomicStore( &context->core.redraw.requested, 1L );
+    PostEmptyEvent();
+}
+
+static void
+LoadTextureTask( void * userData )
+{
+    TextureTask * task = (TextureTask *)userData;
+    task->texture->id  = leLoadTexture( task->data, task->texture->width, task->texture->height, 1 );
+}
+
+static void
+UnloadTextureTask( void * userData )
+{
+    TextureTask * task = (TextureTask *)userData;
+    leUnloadTexture( task->texture->id );
+}
+
+// Write the atlas pixels queued so far, on the thread owning the GL context
+static void
+UploadTextureUpdates( TexturesState * textures )
+{
+    leMutexLock( &textures->lock );
+    TextureUpdate * update = textures->updates;
+    textures->updates      = NULL;
+    textures->updatesTail  = &textures->updates;
+    leMutexUnlock( &textures->lock );
+
+    while( NULL != update )
+        {
+            TextureUpdate * next = update->next;
+
+            leUpdateTexture( update->textureId, update->x, update->y, update->layer, update->image.width,
+                             update->image.height, update->image.data, textures->pixelBufferId );
+            UnloadImage( update->image );
+            LE_FREE( update );
+
+            update = next;
+        }
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Decoding pool
+//----------------------------------------------------------------------------------------------------------------------
+static void
+LockDecodePool( void )
+{
+    leMutexLock( &decodePoolLock );
+}
+
+static void
+UnlockDecodePool( void )
+{
+    leMutexUnlock( &decodePoolLock );
+}
+
+// Hand a decoded (or failed) load back to its context
+static void
+FinishDecode( TextureLoad * load )
+{
+    TexturesState * textures = load->context->textures;
+
+    leMutexLock( &textures->lock );
+    if( NULL != load->image.data )
+        {
+            load->next           = NULL;
+            *textures->readyTail = load;
+            textures->readyTail  = &load->next;
+            leAtomicStore( &load->state, (long)TEXTURE_LOAD_UPLOADING );
+        }
+    else
+        {
+            TRACELOG( LOG_WARNING, "TEXTURE: Failed to decode %s", load->fileName );
+        }
+
+    // Either way the application has something to look at
+    RequestContextRedraw( load->context );
+
+    --textures->decoding;
+    leConditionBroadcast( &textures->idle );
+
+    // Last access, the owner may free a finished load at any time
+    if( NULL == load->image.data ) leAtomicStore( &load->state, (long)TEXTURE_LOAD_DONE );
+    leMutexUnlock( &textures->lock );
+}
+
+static void
+DecodeWorker( void * userData )
+{
+    UNUSED( userData );
+
+    leMutexLock( &decodePool.queueLock );
+    for( ;; )
+        {
+            while( !decodePool.quit && NULL == decodePool.queue )
+                {
+                    leConditionWait( &decodePool.wake, &decodePool.queueLock );
+                }
+
+            TextureLoad * load = decodePool.queue;
+            if( NULL == load ) break;
+
+            decodePool.queue = load->next;
+            if( NULL == decodePool.queue ) decodePool.queueTail = NULL;
+            leMutexUnlock( &decodePool.queueLock );
+
+            LE_PROFILE_BEGIN( "DecodeTexture" );
+            load->image = LoadImage( load->fileName );
+            LE_PROFILE_END();
+
+            FinishDecode( load );
+
+            leMutexLock( &decodePool.queueLock );
+        }
+    leMutexUnlock( &decodePool.queueLock );
+}
+
+// Spawn the decoding threads, false when none could start
+static bool
+StartDecodePool( void )
+{
+    LockDecodePool();
+    if( 0 == decodePool.threadCount )
+        {
+            leMutexInit( &decodePool.queueLock );
+            leConditionInit( &decodePool.wake );
+            decodePool.quit = false;
+
+            while( decodePool.threadCount < LE_TEXTURE_WORKERS
+                   && leThreadCreate( &decodePool.threads[decodePool.threadCount], DecodeWorker, NULL ) )
+                {
+                    ++decodePool.threadCount;
+                }
+
+            if( 0 == decodePool.threadCount )
+                {
+                    leConditionDestroy( &decodePool.wake );
+                    leMutexDestroy( &decodePool.queueLock );
+                }
+            else
+                {
+                    TRACELOG( LOG_INFO, "TEXTURE: %d decoding threads started", decodePool.threadCount );
+                }
+        }
+    const bool started = decodePool.threadCount > 0;
+    UnlockDecodePool();
+
+    return started;
+}
+
+// Called with the pool locked once no context is left
+static void
+StopDecodePool( void )
+{
+    leMutexLock( &decodePool.queueLock );
+    decodePool.quit = true;
+    leConditionBroadcast( &decodePool.wake );
+    leMutexUnlock( &decodePool.queueLock );
+
+    for( int i = 0; i < decodePool.threadCount; ++i ) leThreadJoin( &decodePool.threads[i] );
+
+    leConditionDestroy( &decodePool.wake );
+    leMutexDestroy( &decodePool.queueLock );
+    decodePool.threadCount = 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Sprites
+//----------------------------------------------------------------------------------------------------------------------
+static INLINE void
+SetSpriteVertex( RenderVertex * vertex, RenderVertex base, float x, float y, float u, float v )
+{
+    *vertex   = base;
+    vertex->x = x;
+    vertex->y = y;
+    vertex->u = u;
+    vertex->v = v;
+}
+
+static void
+CreateAtlasPageTask( void * userData )
+{
+    TextureTask * task = (TextureTask *)userData;
+    task->texture->id  = leLoadTexture( NULL, task->texture->width, task->texture->height, task->layers );
+}
+
+#if LE_TEXTURE_ARRAYS
+static void
+ResizeAtlasLayersTask( void * userData )
+{
+    TextureTask *  task  = (TextureTask *)userData;
+    TextureAtlas * atlas = task->atlas;
+    if( !leResizeTextureLayers( atlas->textureId, atlas->pageSize, atlas->pageSize, atlas->layerCapacity,
+                                task->layers ) )
+        {
+            task->layers = atlas->layerCapacity;
+        }
+}
+#endif
+
+// Pending atlas writes go first, they may target the pages being deleted
+static void
+DestroyAtlasPagesTask( void * userData )
+{
+    TextureTask * task = (TextureTask *)userData;
+
+    TexturesState * textures = task->atlas->context->textures;
+    if( NULL != textures ) UploadTextureUpdates( textures );
+
+    if( 0 != task->atlas->textureId )
+        {
+            leUnloadTexture( task->atlas->textureId );
+            return;
+        }
+
+    for( int i = 0; i < task->atlas->pageCount; ++i ) leUnloadTexture( task->atlas->pages[i].texture.id );
+}
+
+// Queue a copy of the image for the next frame, false when out of memory
+static bool
+QueueTextureUpdate( TexturesState * textures, const Texture * texture, int x, int y, Image image )
+{
+    TextureUpdate * update = (TextureUpdate *)LE_MALLOC( sizeof( TextureUpdate ) );
+    if( NULL == update ) return false;
+
+    update->image = AllocImage( image.width, image.height );
+    if( NULL == update->image.data )
+        {
+            LE_FREE( update );
+            return false;
+        }
+
+    memcpy( update->image.data, image.data, GetImageSize( image.width, image.height ) );
+    update->textureId = texture->id;
+    update->x         = x;
+    update->y         = y;
+    update->layer     = texture->layer;
+    update->next      = NULL;
+
+    leMutexLock( &textures->lock );
+    *textures->updatesTail = update;
+    textures->updatesTail  = &update->next;
+    leMutexUnlock( &textures->lock );
+
+    return true;
+}
+
+// Storage for one more page: a layer of the shared texture array, or a texture of its own
+static bool
+LoadAtlasPageTexture( TextureAtlas * atlas, Texture * texture )
+{
+    TextureTask task = { 0 };
+    task.atlas       = atlas;
+    task.texture     = texture;
+    task.layers      = 1;
+
+    texture->width  = atlas->pageSize;
+    texture->height = atlas->pageSize;
+
+#if LE_TEXTURE_ARRAYS
+    if( 0 == atlas->textureId )
+        {
+            InvokeOnRenderThread( CreateAtlasPageTask, &task );
+            atlas->textureId     = texture->id;
+            atlas->layerCapacity = ( 0 != texture->id ) ? 1 : 0;
+        }
+    else if( atlas->pageCount == atlas->layerCapacity )
+        {
+            // Layers double, the texture name and the sprites handed out so far stay valid
+            task.layers = atlas->layerCapacity * 2;
+            InvokeOnRenderThread( ResizeAtlasLayersTask, &task );
+            atlas->layerCapacity = task.layers;
+        }
+
+    texture->id    = atlas->textureId;
+    texture->layer = atlas->pageCount;
+    return 0 != texture->id && texture->layer < atlas->layerCapacity;
+#else
+    InvokeOnRenderThread( CreateAtlasPageTask, &task );
+    return 0 != texture->id;
+#endif
+}
+
+static AtlasPage *
+AddAtlasPage( TextureAtlas * atlas )
+{
+    if( atlas->pageCount + 1 > atlas->pageCapacity )
+        {
+            const int   capacity = ( atlas->pageCapacity > 0 ) ? atlas->pageCapacity * 2 : 4;
+            AtlasPage * pages    = (AtlasPage *)LE_REALLOC( atlas->pages, (size_t)capacity * sizeof( AtlasPage ) );
+            if( NULL == pages ) return NULL;
+
+            TrackMemory( MEMORY_IMAGES, (size_t)( capacity - atlas->pageCapacity ) * sizeof( AtlasPage ), true );
+            atlas->pages        = pages;
+            atlas->pageCapacity = capacity;
+        }
+
+    AtlasPage * page = &atlas->pages[atlas->pageCount];
+    memset( page, 0, sizeof( AtlasPage ) );
+
+    if( !InitSkyline( &page->skyline, atlas->pageSize ) ) return NULL;
+
+    if( !LoadAtlasPageTexture( atlas, &page->texture ) )
+        {
+            ReleaseSkyline( &page->skyline );
+            return NULL;
+        }
+
+    ++atlas->pageCount;
+
+    // A white texel in the corner of each texture lets shapes batch with the sprites of the atlas
+    if( 0 == page->texture.layer )
+        {
+            static unsigned char white[4] = { 255, 255, 255, 255 };
+            const Image          texel    = { white, 1, 1 };
+
+            int x = 0, y = 0;
+            PackSkyline( &page->skyline, 1 + LE_ATLAS_PADDING, 1 + LE_ATLAS_PADDING, &x, &y );
+            if( QueueTextureUpdate( atlas->context->textures, &page->texture, x, y, texel ) )
+                {
+                    const float center = 0.5F / (float)atlas->pageSize;
+                    AddWhiteTexel( page->texture.id, (float)x / (float)atlas->pageSize + center,
+                                   (float)y / (float)atlas->pageSize + center, 0.0F );
+                }
+        }
+
+    return page;
+}
+
+//==============================================================================================================
+// MODULE FUNCTIONS DEFINITIONS
+//==============================================================================================================
+void
+InitTextures( void )
+{
+    TexturesState * textures = (TexturesState *)LE_CALLOC( 1, sizeof( TexturesState ) );
+    if( NULL == textures )
+        {
+            TRACELOG( LOG_ERROR, "TEXTURE: Failed to allocate textures state" );
+            return;
+        }
+
+    leMutexInit( &textures->lock );
+    leConditionInit( &textures->idle );
+    textures->readyTail   = &textures->ready;
+    textures->updatesTail = &textures->updates;
+
+    GetCurrentContext()->textures = textures;
+
+    LockDecodePool();
+    ++decodePool.users;
+    UnlockDecodePool();
+}
+
+// Called with the GL context current, loads still pending finish as failed
+void
+CleanupTextures( void )
+{
+    LeContext *     context  = GetCurrentContext();
+    TexturesState * textures = context->textures;
+    if( NULL == textures ) return;
+
+    // The pool outlives this call, the context still counts as a user
+    LockDecodePool();
+    const bool started = decodePool.threadCount > 0;
+    UnlockDecodePool();
+
+    // Loads of this context still queued never reach a worker
+    if( started )
+        {
+            leMutexLock( &decodePool.queueLock );
+            TextureLoad ** link  = &decodePool.queue;
+            decodePool.queueTail = NULL;
+            while( NULL != *link )
+                {
+                    TextureLoad * load = *link;
+                    if( load->context != context )
+                        {
+                            decodePool.queueTail = load;
+                            link                 = &load->next;
+                            continue;
+                        }
+
+                    *link = load->next;
+
+                    leMutexLock( &textures->lock );
+                    --textures->decoding;
+                    leAtomicStore( &load->state, (long)TEXTURE_LOAD_DONE );
+                    leMutexUnlock( &textures->lock );
+                }
+            leMutexUnlock( &decodePool.queueLock );
+        }
+
+    leMutexLock( &textures->lock );
+    while( textures->decoding > 0 ) leConditionWait( &textures->idle, &textures->lock );
+    leMutexUnlock( &textures->lock );
+
+    for( TextureLoad * load = textures->ready; NULL != load; )
+        {
+            TextureLoad * next = load->next;
+            UnloadImage( load->image );
+            load->image = (Image){ 0 };
+            leAtomicStore( &load->state, (long)TEXTURE_LOAD_DONE );
+            load = next;
+        }
+
+    for( TextureUpdate * update = textures->updates; NULL != update; )
+        {
+            TextureUpdate * next = update->next;
+            UnloadImage( update->image );
+            LE_FREE( update );
+            update = next;
+        }
+
+    leUnloadPixelBuffer( textures->pixelBufferId );
+    leConditionDestroy( &textures->idle );
+    leMutexDestroy( &textures->lock );
+    LE_FREE( textures );
+    context->textures = NULL;
+
+    LockDecodePool();
+    if( 0 == --decodePool.users && decodePool.threadCount > 0 ) StopDecodePool();
+    UnlockDecodePool();
+}
+
+// Upload what the decoding threads finished, called before a frame executes where the GL context is current
+void
+ProcessTextureUploads( void )
+{
+    LeContext *     context  = GetCurrentContext();
+    TexturesState * textures = context->textures;
+    if( NULL == textures ) return;
+
+    leMutexLock( &textures->lock );
+    const bool pending = NULL != textures->updates || NULL != textures->ready;
+    leMutexUnlock( &textures->lock );
+    if( !pending ) return;
+
+    LE_PROFILE_BEGIN( "UploadTextures" );
+
+    if( 0 == textures->pixelBufferId ) textures->pixelBufferId = leLoadPixelBuffer();
+
+    UploadTextureUpdates( textures );
+
+    // Whole loads within the budget, the first one always goes
+    leMutexLock( &textures->lock );
+    TextureLoad * batch = NULL;
+    size_t        bytes = 0;
+    if( NULL != textures->ready )
+        {
+            TextureLoad ** link = &textures->ready;
+            while( NULL != *link && ( 0 == bytes || bytes < LE_TEXTURE_UPLOAD_BUDGET ) )
+                {
+                    bytes += GetImageSize( ( *link )->image.width, ( *link )->image.height );
+                    link = &( *link )->next;
+                }
+
+            batch           = textures->ready;
+            textures->ready = *link;
+            *link           = NULL;
+            if( NULL == textures->ready ) textures->readyTail = &textures->ready;
+        }
+    leMutexUnlock( &textures->lock );
+
+    while( NULL != batch )
+        {
+            TextureLoad * load = batch;
+            batch              = load->next;
+
+            load->texture.width  = load->image.width;
+            load->texture.height = load->image.height;
+            load->texture.id     = leLoadTexture( NULL, load->image.width, load->image.height, 1 );
+            if( 0 != load->texture.id )
+                {
+                    leUpdateTexture( load->texture.id, 0, 0, 0, load->image.width, load->image.height,
+                                     load->image.data, textures->pixelBufferId );
+                }
+
+            UnloadImage( load->image );
+            load->image = (Image){ 0 };
+            leAtomicStore( &load->state, (long)TEXTURE_LOAD_DONE );
+        }
+
+    // The application polls its loads on the next frame
+    if( bytes > 0 ) RequestContextRedraw( context );
+
+    LE_PROFILE_END();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Images
+//----------------------------------------------------------------------------------------------------------------------
+Image
+LoadImage( const char * fileName )
+{
+    Image image = { 0 };
+    if( !STR_NONEMPTY( fileName ) ) return image;
+
+    size_t          size = 0;
+    unsigned char * data = LoadFileData( fileName, &size );
+    if( NULL == data ) return image;
+
+    image = LoadImageFromMemory( data, (int)size );
+    UnloadFileData( data, size );
+
+    if( NULL == image.data ) TRACELOG( LOG_WARNING, "IMAGE: Unsupported or corrupt file: %s", fileName );
+    return image;
+}
+
+// Decode a QOI or binary PNM file held in memory
+Image
+LoadImageFromMemory( const unsigned char * data, int size )
+{
+    Image image = { 0 };
+    if( NULL == data || size < 4 ) return image;
+
+    if( 0 == memcmp( data, "qoif", 4 ) )
+        {
+            image = DecodeQOI( data, (size_t)size );
+        }
+    else if( 'P' == data[0] && ( '5' == data[1] || '6' == data[1] ) )
+        {
+            image = DecodePNM( data, (size_t)size );
+        }
+
+    return image;
+}
+
+void
+UnloadImage( Image image )
+{
+    if( NULL == image.data ) return;
+
+    TrackMemory( MEMORY_IMAGES, GetImageSize( image.width, image.height ), false );
+    LE_FREE( image.data );
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Textures
+//----------------------------------------------------------------------------------------------------------------------
+Texture
+LoadTexture( const char * fileName )
+{
+    LE_PROFILE_ZONE( "LoadTexture" );
+
+    Image   image   = LoadImage( fileName );
+    Texture texture = LoadTextureFromImage( image );
+    UnloadImage( image );
+
+    return texture;
+}
+
+// Upload an image, blocking until the GL context holding thread did it
+Texture
+LoadTextureFromImage( Image image )
+{
+    Texture texture = { 0 };
+    if( NULL == image.data ) return texture;
+
+    texture.width  = image.width;
+    texture.height = image.height;
+
+    TextureTask task = { 0 };
+    task.data        = image.data;
+    task.texture     = &texture;
+    InvokeOnRenderThread( LoadTextureTask, &task );
+
+    if( 0 == texture.id ) TRACELOG( LOG_WARNING, "TEXTURE: Failed to load texture" );
+    return texture;
+}
+
+void
+UnloadTexture( Texture texture )
+{
+    if( 0 == texture.id ) return;
+
+    TextureTask task = { 0 };
+    task.texture     = &texture;
+    InvokeOnRenderThread( UnloadTextureTask, &task );
+}
+
+// Decode a file on the worker threads, then upload it during a later frame. Poll the load until done,
+// loads still pending when the context is destroyed finish with a texture ID of 0
+TextureLoad *
+LoadTextureAsync( const char * fileName )
+{
+    LeContext *     context  = GetCurrentContext();
+    TexturesState * textures = ( NULL != context ) ? context->textures : NULL;
+    if( NULL == textures || !STR_NONEMPTY( fileName ) ) return NULL;
+
+    const bool threaded = StartDecodePool();
+    if( !threaded ) TRACELOG( LOG_WARNING, "TEXTURE: No decoding thread, %s loads synchronously", fileName );
+
+    TextureLoad * load = (TextureLoad *)LE_CALLOC( 1, sizeof( TextureLoad ) );
+    if( NULL == load ) return NULL;
+
+    const size_t length = strlen( fileName ) + 1;
+    load->fileName      = (char *)LE_MALLOC( length );
+    if( NULL == load->fileName )
+        {
+            LE_FREE( load );
+            return NULL;
+        }
+
+    memcpy( load->fileName, fileName, length );
+    load->context = context;
+    load->state   = TEXTURE_LOAD_DECODING;
+
+    leMutexLock( &textures->lock );
+    ++textures->decoding;
+    leMutexUnlock( &textures->lock );
+
+    if( !threaded )
+        {
+            load->image = LoadImage( load->fileName );
+            FinishDecode( load );
+            return load;
+        }
+
+    leMutexLock( &decodePool.queueLock );
+    if( NULL != decodePool.queueTail )
+        {
+            decodePool.queueTail->next = load;
+        }
+    else
+        {
+            decodePool.queue = load;
+        }
+    decodePool.queueTail = load;
+    leConditionSignal( &decodePool.wake );
+    leMutexUnlock( &decodePool.queueLock );
+
+    return load;
+}
+
+// True once the load is done, `texture` then receives it (ID 0 on failure) and the load is released
+bool
+PollTextureLoad( TextureLoad * load, Texture * texture )
+{
+    if( NULL == load ) return true;
+    if( TEXTURE_LOAD_DONE != leAtomicLoad( &load->state ) ) return false;
+
+    if( NULL != texture ) *texture = load->texture;
+
+    LE_FREE( load->fileName );
+    LE_FREE( load );
+    return true;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Atlases
+//----------------------------------------------------------------------------------------------------------------------
+TextureAtlas *
+CreateTextureAtlas( int pageSize )
+{
+    if( pageSize <= 0 || pageSize > LE_MAX_IMAGE_SIZE )
+        {
+            TRACELOG( LOG_WARNING, "TEXTURE: Invalid atlas page size %d", pageSize );
+            return NULL;
+        }
+
+    TextureAtlas * atlas = (TextureAtlas *)LE_CALLOC( 1, sizeof( TextureAtlas ) );
+    if( NULL == atlas ) return NULL;
+
+    TrackMemory( MEMORY_IMAGES, sizeof( TextureAtlas ), true );
+    atlas->context  = GetCurrentContext();
+    atlas->pageSize = pageSize;
+
+    return atlas;
+}
+
+void
+DestroyTextureAtlas( TextureAtlas * atlas )
+{
+    if( NULL == atlas ) return;
+
+    for( int i = 0; i < atlas->pageCount; ++i )
+        {
+            if( 0 == atlas->pages[i].texture.layer ) RemoveWhiteTexel( atlas->pages[i].texture.id );
+        }
+
+    TextureTask task = { 0 };
+    task.atlas       = atlas;
+    InvokeOnRenderThread( DestroyAtlasPagesTask, &task );
+
+    size_t bytes = sizeof( TextureAtlas ) + (size_t)atlas->pageCapacity * sizeof( AtlasPage );
+    for( int i = 0; i < atlas->pageCount; ++i ) ReleaseSkyline( &atlas->pages[i].skyline );
+
+    LE_FREE( atlas->pages );
+    LE_FREE( atlas );
+    TrackMemory( MEMORY_IMAGES, bytes, false );
+}
+
+// Pack a copy of the image into the first page with room, opening a page when none has.
+// The pixels reach the page before the next frame executes
+bool
+AddAtlasImage( TextureAtlas * atlas, Image image, AtlasSprite * sprite )
+{
+    if( NULL == atlas || NULL == image.data || NULL == sprite ) return false;
+
+    TexturesState * textures = atlas->context->textures;
+    const int       width    = image.width + LE_ATLAS_PADDING;
+    const int       height   = image.height + LE_ATLAS_PADDING;
+    if( NULL == textures || width > atlas->pageSize || height > atlas->pageSize )
+        {
+            TRACELOG( LOG_WARNING, "TEXTURE: Image of %dx%d does not fit atlas pages of %d", image.width, image.height,
+                      atlas->pageSize );
+            return false;
+        }
+
+    AtlasPage * page = NULL;
+    int         x    = 0;
+    int         y    = 0;
+    for( int i = 0; i < atlas->pageCount && NULL == page; ++i )
+        {
+            if( PackSkyline( &atlas->pages[i].skyline, width, height, &x, &y ) ) page = &atlas->pages[i];
+        }
+
+    if( NULL == page )
+        {
+            page = AddAtlasPage( atlas );
+            if( NULL == page || !PackSkyline( &page->skyline, width, height, &x, &y ) ) return false;
+        }
+
+    if( !QueueTextureUpdate( textures, &page->texture, x, y, image ) ) return false;
+
+    sprite->texture = page->texture;
+    sprite->source  = (Rectangle){ (float)x, (float)y, (float)image.width, (float)image.height };
+    return true;
+}
+
+int
+GetAtlasPageCount( const TextureAtlas * atlas )
+{
+    return ( NULL != atlas ) ? atlas->pageCount : 0;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Drawing
+//----------------------------------------------------------------------------------------------------------------------
+void
+DrawTexture( Texture texture, int posX, int posY, Color tint )
+{
+    const Rectangle source = { 0.0F, 0.0F, (float)texture.width, (float)texture.height };
+    const Rectangle dest   = { (float)posX, (float)posY, (float)texture.width, (float)texture.height };
+    DrawTexturePro( texture, source, dest, (Vector2){ 0.0F, 0.0F }, 0.0F, tint );
+}
+
+void
+DrawTextureRec( Texture texture, Rectangle source, Vector2 position, Color tint )
+{
+    const Rectangle dest = { position.x, position.y, fabsf( source.width ), fabsf( source.height ) };
+    DrawTexturePro( texture, source, dest, (Vector2){ 0.0F, 0.0F }, 0.0F, tint );
+}
+
+// Draw the `source` pixels of a texture into `dest`, placing `origin` at the destination position
+void
+DrawTexturePro( Texture texture, Rectangle source, Rectangle dest, Vector2 origin, float rotation, Color tint )
+{
+    if( 0 == texture.id || texture.width <= 0 || texture.height <= 0 ) return;
+
+    // Corners clockwise from the top-left
+    float x[4], y[4];
+    if( 0.0F == rotation )
+        {
+            x[0] = x[3] = dest.x - origin.x;
+            y[0] = y[1] = dest.y - origin.y;
+            x[1] = x[2] = x[0] + dest.width;
+            y[2] = y[3] = y[0] + dest.height;
+        }
+    else
+        {
+            const float cosine = cosf( rotation * DEG2RAD );
+            const float sine   = sinf( rotation * DEG2RAD );
+            const float left   = -origin.x;
+            const float top    = -origin.y;
+            const float right  = left + dest.width;
+            const float bottom = top + dest.height;
+
+            x[0] = dest.x + left * cosine - top * sine;
+            y[0] = dest.y + left * sine + top * cosine;
+            x[1] = dest.x + right * cosine - top * sine;
+            y[1] = dest.y + right * sine + top * cosine;
+            x[2] = dest.x + right * cosine - bottom * sine;
+            y[2] = dest.y + right * sine + bottom * cosine;
+            x[3] = dest.x + left * cosine - bottom * sine;
+            y[3] = dest.y + left * sine + bottom * cosine;
+        }
+
+    if( !IsAreaVisible( fminf( fminf( x[0], x[1] ), fminf( x[2], x[3] ) ),
+                        fminf( fminf( y[0], y[1] ), fminf( y[2], y[3] ) ),
+                        fmaxf( fmaxf( x[0], x[1] ), fmaxf( x[2], x[3] ) ),
+                        fmaxf( fmaxf( y[0], y[1] ), fmaxf( y[2], y[3] ) ) ) )
+        {
+            return;
+        }
+
+    // A negative size flips the source, its edges swap
+    float u0 = source.x / (float)texture.width;
+    float v0 = source.y / (float)texture.height;
+    float u1 = ( source.x + fabsf( source.width ) ) / (float)texture.width;
+    float v1 = ( source.y + fabsf( source.height ) ) / (float)texture.height;
+    if( source.width < 0.0F )
+        {
+            const float u = u0;
+            u0            = u1;
+            u1            = u;
+        }
+    if( source.height < 0.0F )
+        {
+            const float v = v0;
+            v0            = v1;
+            v1            = v;
+        }
+
+    RecordTexture( texture.id );
+
+    RenderVertex * v = RecordVertices( LE_QUADS, 4 );
+    if( NULL == v ) return;
+
+    RenderVertex base = { 0 };
+    base.layer        = (float)texture.layer;
+    SetVertexColor( &base, tint );
+
+    SetSpriteVertex( &v[0], base, x[0], y[0], u0, v0 );
+    SetSpriteVertex( &v[1], base, x[3], y[3], u0, v1 );
+    SetSpriteVertex( &v[2], base, x[2], y[2], u1, v1 );
+    SetSpriteVertex( &v[3], base, x[1], y[1], u1, v0 );
+
+    TransformVertices( v, 4 );
+}
@@ -0,0 +1,219 @@
+/****************************** LETRUETYPE ********************************
+ * letruetype: TrueType character maps and UTF-8 decoding
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ *   - Font data is big-endian, every read is bounded by the size of the
+ *     file so malformed fonts map codepoints to the missing glyph.
+ *   - Character maps of format 12 (full Unicode) and 4 (BMP segments) are
+ *     read, format 12 is preferred when a font has both.
+ *   - Malformed UTF-8 decodes to U+FFFD, one codepoint per bad sequence.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+#ifndef LEVEGL_TRUETYPE_H
+#define LEVEGL_TRUETYPE_H
+
+#include "levegl/levegl.h"
+
+#include <stdbool.h>
+#include <stddef.h>
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+/// Unicode subtable of a 'cmap' table
+typedef struct CharacterMap
+{
+    const unsigned char * data; /// Whole font file
+    size_t                size;
+    size_t                offset; /// Subtable used
+    int                   format;
+} CharacterMap;
+
+//==============================================================================================================
+// FUNCTIONS
+//==============================================================================================================
+static INLINE unsigned int
+ReadU16( const unsigned char * bytes )
+{
+    return ( (unsigned int)bytes[0] << 8 ) | (unsigned int)bytes[1];
+}
+
+static INLINE int
+ReadS16( const unsigned char * bytes )
+{
+    return (short)ReadU16( bytes );
+}
+
+static INLINE unsigned int
+ReadU32( const unsigned char * bytes )
+{
+    return ( (unsigned int)bytes[0] << 24 ) | ( (unsigned int)bytes[1] << 16 ) | ( (unsigned int)bytes[2] << 8 )
+         | (unsigned int)bytes[3];
+}
+
+static INLINE bool
+HasFontBytes( size_t size, size_t offset, size_t bytes )
+{
+    return offset <= size && bytes <= size - offset;
+}
+
+// Pick the Unicode character map, full repertoire (format 12) first
+static bool
+SelectCharacterMap( CharacterMap * map, const unsigned char * data, size_t size, size_t offset, size_t length )
+{
+    if( length < 4 ) return false;
+
+    const int tableCount = (int)ReadU16( data + offset + 2 );
+    for( int format = 12; format >= 4; format -= 8 )
+        {
+            for( int i = 0; i < tableCount && 4 + (size_t)i * 8 + 8 <= length; ++i )
+                {
+                    const unsigned char * record   = data + offset + 4 + i * 8;
+                    const unsigned int    platform = ReadU16( record );
+                    const unsigned int    encoding = ReadU16( record + 2 );
+                    const size_t          table    = offset + ReadU32( record + 4 );
+                    if( !( 0 == platform || ( 3 == platform && ( 1 == encoding || 10 == encoding ) ) ) ) continue;
+                    if( !HasFontBytes( size, table, 16 ) ) continue;
+                    if( (unsigned int)format != ReadU16( data + table ) ) continue;
+
+                    map->data   = data;
+                    map->size   = size;
+                    map->offset = table;
+                    map->format = format;
+                    return true;
+                }
+        }
+
+    return false;
+}
+
+// Glyph index of a codepoint, 0 (the missing glyph) when the map lacks it
+static int
+FindGlyphIndex( const CharacterMap * map, int codepoint )
+{
+    const unsigned char * table = map->data + map->offset;
+
+    if( 12 == map->format )
+        {
+            const unsigned int groups = ReadU32( table + 12 );
+            if( !HasFontBytes( map->size, map->offset + 16, (size_t)groups * 12 ) ) return 0;
+
+            int low  = 0;
+            int high = (int)groups - 1;
+            while( low <= high )
+                {
+                    const int             middle = ( low + high ) / 2;
+                    const unsigned char * group  = table + 16 + (size_t)middle * 12;
+                    if( (unsigned int)codepoint < ReadU32( group ) )
+                        high = middle - 1;
+                    else if( (unsigned int)codepoint > ReadU32( group + 4 ) )
+                        low = middle + 1;
+                    else
+                        return (int)( ReadU32( group + 8 ) + (unsigned int)codepoint - ReadU32( group ) );
+                }
+            return 0;
+        }
+
+    if( codepoint > 0xFFFF ) return 0;
+
+    // Format 4: segments of end codes, start codes, deltas and range offsets
+    const size_t segments = ReadU16( table + 6 ) / 2;
+    if( !HasFontBytes( map->size, map->offset + 16, segments * 8 ) ) return 0;
+
+    const unsigned char * ends   = table + 14;
+    const unsigned char * starts = ends + segments * 2 + 2;
+    const unsigned char * deltas = starts + segments * 2;
+    const unsigned char * ranges = deltas + segments * 2;
+    for( size_t i = 0; i < segments; ++i )
+        {
+            if( (unsigned int)codepoint > ReadU16( ends + i * 2 ) ) continue;
+
+            const unsigned int start = ReadU16( starts + i * 2 );
+            if( (unsigned int)codepoint < start ) return 0;
+
+            const unsigned int delta = ReadU16( deltas + i * 2 );
+            const unsigned int range = ReadU16( ranges + i * 2 );
+            if( 0 == range ) return (int)( ( (unsigned int)codepoint + delta ) & 0xFFFF );
+
+            // The range offset is relative to its own slot
+            const size_t entry = (size_t)( ranges + i * 2 - map->data ) + range + ( codepoint - start ) * 2;
+            if( !HasFontBytes( map->size, entry, 2 ) ) return 0;
+
+            const unsigned int glyph = ReadU16( map->data + entry );
+            return ( 0 != glyph ) ? (int)( ( glyph + delta ) & 0xFFFF ) : 0;
+        }
+
+    return 0;
+}
+
+// Next codepoint of a UTF-8 string, U+FFFD for malformed sequences
+static int
+DecodeCodepoint( const unsigned char * text, int length, int * bytes )
+{
+    const int lead = text[0];
+    int       size = 1;
+    int       code = lead;
+    if( lead >= 0xF0 && lead < 0xF8 )
+        {
+            size = 4;
+            code = lead & 0x07;
+        }
+    else if( lead >= 0xE0 )
+        {
+            size = 3;
+            code = lead & 0x0F;
+        }
+    else if( lead >= 0xC0 )
+        {
+            size = 2;
+            code = lead & 0x1F;
+        }
+    else if( lead >= 0x80 )
+        {
+            *bytes = 1;
+            return 0xFFFD;
+        }
+
+    if( lead >= 0xF8 || size > length )
+        {
+            *bytes = 1;
+            return 0xFFFD;
+        }
+
+    for( int i = 1; i < size; ++i )
+        {
+            if( 0x80 != ( text[i] & 0xC0 ) )
+                {
+                    *bytes = i;
+                    return 0xFFFD;
+                }
+            code = ( code << 6 ) | ( text[i] & 0x3F );
+        }
+
+    *bytes = size;
+    return code;
+}
+
+#endif // !LEVEGL_TRUETYPE_H
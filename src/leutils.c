@@ -22,19 +22,137 @@
  *
  *************************************************************************/
 
+#include "lelogformat.h"
+#include "lememory.h"
+#include "lesystem.h"
+
 #include "levegl/leutils.h"
 
 #include "levegl/levegl.h"
 
+#undef LEGL_IMPLEMENTATION
+#include "levegl/legl.h"
+
 #include <stdarg.h> /* va_start, va_end, va_list */
-#include <stdio.h>  /* fprintf, vfprintf, stdout */
-#include <stdlib.h> /* abort */
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* uintptr_t */
+#include <stdio.h>  /* fprintf, vfprintf, vsnprintf, fwrite, fopen, stdout */
+#include <stdlib.h> /* abort, malloc, realloc, free */
+#include <string.h> /* memcpy, strlen */
+
+//----------------------------------------------------------------------------------------------------------------------
+// Defines
+//----------------------------------------------------------------------------------------------------------------------
+// Records held by the asynchronous queue, a power of two
+#ifndef LE_LOG_QUEUE_SIZE
+#    define LE_LOG_QUEUE_SIZE 1024
+#endif
+
+// Longest formatted message kept by the asynchronous queue, longer ones are truncated
+#ifndef LE_LOG_RECORD_SIZE
+#    define LE_LOG_RECORD_SIZE 256
+#endif
+
+// Bytes the writer thread gathers before a single write to stdout
+#ifndef LE_LOG_WRITE_BATCH
+#    define LE_LOG_WRITE_BATCH 16384
+#endif
+
+// Binary log file used until SetTraceLogBinaryFile
+#ifndef LE_LOG_BINARY_OUTPUT
+#    define LE_LOG_BINARY_OUTPUT "levegl_log.bin"
+#endif
+
+// Initial slots of the GPU object table, a power of two
+#ifndef LE_GPU_MEMORY_OBJECTS
+#    define LE_GPU_MEMORY_OBJECTS 256
+#endif
+
+// Distinct format strings given an ID, later ones are written as TEXT records, a power of two
+#ifndef LE_LOG_MAX_FORMATS
+#    define LE_LOG_MAX_FORMATS 1024
+#endif
+
+// Largest EVENT payload, long strings are truncated to fit
+#ifndef LE_LOG_BINARY_PAYLOAD
+#    define LE_LOG_BINARY_PAYLOAD 1024
+#endif
+
+//----------------------------------------------------------------------------------------------------------------------
+// Types Definition
+//----------------------------------------------------------------------------------------------------------------------
+// Pre-formatted message, published to the writer once `sequence` moves past its slot
+typedef struct LogRecord
+{
+    long sequence;
+    int  level;
+    char text[LE_LOG_RECORD_SIZE];
+} LogRecord;
+
+// Bounded multi-producer single-consumer ring, producers never take a lock
+typedef struct LogQueue
+{
+    LogRecord * records;
+    long        tail;    // Next slot claimed by a producer
+    long        head;    // Next slot read by the writer
+    long        dropped; // Messages lost to a full queue since the last report
+
+    leThread    thread;
+    leMutex     lock;
+    leCondition wake;
+    long        sleeping; // Writer waits on `wake`, producers must signal
+    bool        quit;
+} LogQueue;
+
+// Binary writer state, guarded by `logBinaryLock`
+typedef struct LogBinary
+{
+    FILE *       file;
+    bool         failed; // Open failed, messages go to text output
+    char *       formats[LE_LOG_MAX_FORMATS * 2]; // Open addressing on the format string contents, owned copies
+    unsigned int hashes[LE_LOG_MAX_FORMATS * 2];
+    unsigned int ids[LE_LOG_MAX_FORMATS * 2];
+    unsigned int formatCount;
+    char         fileName[256];
+} LogBinary;
+
+// Size of one GPU object, `bytes == 0` marks a free slot
+typedef struct GpuObject
+{
+    const void * owner;
+    int          kind;
+    unsigned int id;
+    size_t       bytes;
+} GpuObject;
+
+// Accounting behind GetMemoryStats, guarded by `memoryStatsLock`
+typedef struct MemoryAccounting
+{
+    MemoryUsage cpu[MEMORY_CPU_CATEGORIES];
+    MemoryUsage gpu[LE_GPU_MEMORY_KINDS];
+
+    GpuObject * objects; // Open addressing on (owner, kind, id)
+    size_t      objectCapacity;
+    size_t      objectCount;
+} MemoryAccounting;
 
 //----------------------------------------------------------------------------------------------------------------------
 // Variables Definition
 //----------------------------------------------------------------------------------------------------------------------
 static LogLevel         logLevel = LOG_INFO; // Current log level
 static TraceLogCallback traceLog = NULL;     // Custom trace log function
+static LogQueue *       logQueue = NULL;     // Asynchronous mode when set
+static long             logUsers = 0;        // Producers that may hold `logQueue`, it is freed at zero
+
+static LogBinary logBinary     = { 0 };
+static leMutex   logBinaryLock = LE_MUTEX_INITIALIZER;
+
+static MemAllocCallback   memAlloc   = malloc; // Allocation used by MemAlloc
+static MemReallocCallback memRealloc = realloc;
+static MemFreeCallback    memFree    = free;
+
+static MemoryAccounting memoryStats     = { 0 };
+static leMutex          memoryStatsLock = LE_MUTEX_INITIALIZER;
 
 //----------------------------------------------------------------------------------------------------------------------
 // Callbacks
@@ -46,6 +164,628 @@ SetTraceLogCallback( TraceLogCallback callback )
     traceLog = callback;
 }
 
+// Replace the allocator, NULL restores the C one. Memory must not change hands between allocators
+void
+SetMemoryCallbacks( MemAllocCallback alloc, MemReallocCallback resize, MemFreeCallback release )
+{
+    memAlloc   = ( NULL != alloc ) ? alloc : malloc;
+    memRealloc = ( NULL != resize ) ? resize : realloc;
+    memFree    = ( NULL != release ) ? release : free;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Module Internal Functions Definition
+//----------------------------------------------------------------------------------------------------------------------
+static const char *
+GetLogLevelName( int logType )
+{
+    switch( logType )
+        {
+        case LOG_TRACE:   return "TRACE";
+        case LOG_DEBUG:   return "DEBUG";
+        case LOG_INFO:    return "INFO";
+        case LOG_WARNING: return "WARNING";
+        case LOG_ERROR:   return "ERROR";
+        case LOG_FATAL:   return "FATAL";
+        default:          return "UNKNOWN";
+        }
+}
+
+// Forward an already formatted message through the va_list based callback
+static void
+InvokeTraceLogCallback( int logType, const char * text, ... )
+{
+    va_list args;
+    va_start( args, text );
+    traceLog( logType, text, args );
+    va_end( args );
+}
+
+// Claim a slot and format into it, false when the queue is full
+static bool
+PushLogRecord( LogQueue * queue, int logType, const char * text, va_list args )
+{
+    long        position = leAtomicLoad( &queue->tail );
+    LogRecord * record   = NULL;
+
+    for( ;; )
+        {
+            record           = &queue->records[position & ( LE_LOG_QUEUE_SIZE - 1 )];
+            const long delta = (long)( (unsigned long)leAtomicLoad( &record->sequence ) - (unsigned long)position );
+
+            if( 0 == delta )
+                {
+                    if( leAtomicCompareSwap( &queue->tail, position, position + 1 ) ) break;
+                    position = leAtomicLoad( &queue->tail );
+                }
+            else if( delta < 0 )
+                {
+                    return false;
+                }
+            else
+                {
+                    position = leAtomicLoad( &queue->tail );
+                }
+        }
+
+    record->level = logType;
+    vsnprintf( record->text, LE_LOG_RECORD_SIZE, text, args );
+    leAtomicStore( &record->sequence, position + 1 );
+
+    // Only a sleeping writer needs the lock, see LogWriterLoop
+    if( leAtomicLoad( &queue->sleeping ) )
+        {
+            leMutexLock( &queue->lock );
+            leConditionSignal( &queue->wake );
+            leMutexUnlock( &queue->lock );
+        }
+
+    return true;
+}
+
+// Next published record, NULL when none is ready
+static LogRecord *
+PeekLogRecord( LogQueue * queue )
+{
+    LogRecord * record = &queue->records[queue->head & ( LE_LOG_QUEUE_SIZE - 1 )];
+    return ( leAtomicLoad( &record->sequence ) == queue->head + 1 ) ? record : NULL;
+}
+
+// Hand the slot back to producers for the next lap
+static void
+ReleaseLogRecord( LogQueue * queue, LogRecord * record )
+{
+    leAtomicStore( &record->sequence, queue->head + LE_LOG_QUEUE_SIZE );
+    ++queue->head;
+}
+
+// Append "[LEVEL] text\n" to the batch, writing it out first when the line would not fit
+static void
+AppendLogLine( char * batch, int * length, int logType, const char * text )
+{
+    const char * level       = GetLogLevelName( logType );
+    const size_t levelLength = strlen( level );
+    const size_t textLength  = strlen( text );
+    const int    size        = (int)( levelLength + textLength ) + 4;
+
+    if( *length + size > LE_LOG_WRITE_BATCH )
+        {
+            fwrite( batch, 1, (size_t)*length, stdout );
+            *length = 0;
+        }
+
+    char * cursor = batch + *length;
+    *cursor++     = '[';
+    memcpy( cursor, level, levelLength );
+    cursor += levelLength;
+    *cursor++ = ']';
+    *cursor++ = ' ';
+    memcpy( cursor, text, textLength );
+    cursor += textLength;
+    *cursor = '\n';
+
+    *length += size;
+}
+
+// Drain every ready record, one write per batch, returns false when nothing was ready
+static bool
+DrainLogQueue( LogQueue * queue, char * batch )
+{
+    LogRecord * record;
+    int         length  = 0;
+    bool        drained = false;
+
+    while( NULL != ( record = PeekLogRecord( queue ) ) )
+        {
+            drained = true;
+
+            if( NULL != traceLog )
+                {
+                    InvokeTraceLogCallback( record->level, "%s", record->text );
+                }
+            else
+                {
+                    AppendLogLine( batch, &length, record->level, record->text );
+                }
+
+            ReleaseLogRecord( queue, record );
+        }
+
+    const long dropped = leAtomicLoad( &queue->dropped );
+    if( dropped > 0 )
+        {
+            leAtomicAdd( &queue->dropped, -dropped );
+
+            char text[64];
+            snprintf( text, sizeof( text ), "LOG: %ld messages dropped, queue full", dropped );
+            if( NULL != traceLog )
+                {
+                    InvokeTraceLogCallback( LOG_WARNING, "%s", text );
+                }
+            else
+                {
+                    AppendLogLine( batch, &length, LOG_WARNING, text );
+                }
+        }
+
+    if( length > 0 )
+        {
+            fwrite( batch, 1, (size_t)length, stdout );
+            fflush( stdout );
+        }
+
+    return drained;
+}
+
+static void
+LogWriterLoop( void * userData )
+{
+    LogQueue * queue = (LogQueue *)userData;
+    char *     batch = (char *)LE_MALLOC( LE_LOG_WRITE_BATCH );
+    if( NULL == batch ) return;
+
+    for( ;; )
+        {
+            if( DrainLogQueue( queue, batch ) ) continue;
+
+            // Announce the sleep before the last check, a producer publishing in between signals us
+            leMutexLock( &queue->lock );
+            leAtomicStore( &queue->sleeping, 1 );
+            const bool quit = queue->quit;
+            if( !quit && NULL == PeekLogRecord( queue ) ) leConditionWait( &queue->wake, &queue->lock );
+            leAtomicStore( &queue->sleeping, 0 );
+            leMutexUnlock( &queue->lock );
+
+            if( quit ) break;
+        }
+
+    DrainLogQueue( queue, batch );
+    LE_FREE( batch );
+}
+
+// Drain what is left and release a queue no producer can reach anymore
+static void
+JoinLogWriter( LogQueue * queue )
+{
+    leMutexLock( &queue->lock );
+    queue->quit = true;
+    leConditionSignal( &queue->wake );
+    leMutexUnlock( &queue->lock );
+
+    leThreadJoin( &queue->thread );
+
+    leConditionDestroy( &queue->wake );
+    leMutexDestroy( &queue->lock );
+    LE_FREE( queue->records );
+    LE_FREE( queue );
+}
+
+// Only the caller swapping the queue out stops it, producers still holding it finish their push before the free
+static void
+StopLogWriter( void )
+{
+    LogQueue * queue = (LogQueue *)leAtomicExchangePtr( &logQueue, NULL );
+    if( NULL == queue ) return;
+
+    while( 0 != leAtomicLoad( &logUsers ) ) leThreadSleep( 1000 );
+
+    JoinLogWriter( queue );
+}
+
+// Shared by TraceLog and the binary writer fallbacks
+static void
+TraceLogArgs( int logType, const char * text, va_list args )
+{
+    // Counted before the load, StopLogWriter waits for the push once the queue is swapped out
+    leAtomicAdd( &logUsers, 1 );
+    LogQueue * queue = (LogQueue *)leAtomicLoadPtr( &logQueue );
+    if( NULL != queue && LOG_FATAL != logType )
+        {
+            if( !PushLogRecord( queue, logType, text, args ) ) leAtomicAdd( &queue->dropped, 1 );
+            leAtomicAdd( &logUsers, -1 );
+            return;
+        }
+    leAtomicAdd( &logUsers, -1 );
+
+    // Fatal messages are written after everything queued, right before aborting
+    if( NULL != queue ) StopLogWriter();
+
+    // Use custom callback if available
+    if( NULL != traceLog )
+        {
+            traceLog( logType, text, args );
+            return;
+        }
+
+    // Print log message
+    fprintf( stdout, "[%s] ", GetLogLevelName( logType ) );
+    vfprintf( stdout, text, args );
+    fprintf( stdout, "\n" );
+
+    // Handle fatal errors
+    if( UNLIKELY( logType == LOG_FATAL ) ) abort();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Binary log
+//----------------------------------------------------------------------------------------------------------------------
+static void
+LockLogBinary( void )
+{
+    leMutexLock( &logBinaryLock );
+}
+
+static void
+UnlockLogBinary( void )
+{
+    leMutexUnlock( &logBinaryLock );
+}
+
+static void
+WriteLogBinaryRecord( int kind, int logType, unsigned int formatId, const void * payload, size_t size )
+{
+    LogRecordHeader header = { 0 };
+    header.kind            = (unsigned char)kind;
+    header.level           = (unsigned char)logType;
+    header.size            = (unsigned short)size;
+    header.formatId        = formatId;
+    header.timestamp       = leGetClockNs();
+
+    fwrite( &header, sizeof( header ), 1, logBinary.file );
+    if( size > 0 ) fwrite( payload, 1, size, logBinary.file );
+}
+
+// Open the output on first use, false when binary logging is unavailable
+static bool
+OpenLogBinary( void )
+{
+    if( NULL != logBinary.file ) return true;
+    if( logBinary.failed ) return false;
+
+    const char * fileName = ( '\0' != logBinary.fileName[0] ) ? logBinary.fileName : LE_LOG_BINARY_OUTPUT;
+
+    logBinary.file = fopen( fileName, "wb" );
+    if( NULL == logBinary.file )
+        {
+            logBinary.failed = true;
+            return false;
+        }
+
+    // Records are small, let stdio gather them into large writes
+    setvbuf( logBinary.file, NULL, _IOFBF, 1 << 16 );
+    fwrite( LE_LOG_BINARY_MAGIC, 1, LE_LOG_BINARY_MAGIC_SIZE, logBinary.file );
+
+    return true;
+}
+
+static void
+CloseLogBinary( void )
+{
+    if( NULL != logBinary.file ) fclose( logBinary.file );
+
+    // A new file must describe its formats again
+    for( unsigned int i = 0; i < LE_LOG_MAX_FORMATS * 2; ++i ) LE_FREE( logBinary.formats[i] );
+    memset( logBinary.formats, 0, sizeof( logBinary.formats ) );
+    logBinary.file        = NULL;
+    logBinary.failed      = false;
+    logBinary.formatCount = 0;
+}
+
+// ID of a format string, writing its FORMAT record the first time, UINT_MAX once the table is full.
+// Keyed by contents, a buffer reused for another format must not keep the ID of the first one
+static unsigned int
+GetLogFormatId( const char * text )
+{
+    // FNV-1a
+    unsigned int hash   = 2166136261U;
+    size_t       length = 0;
+    for( ; '\0' != text[length]; ++length ) hash = ( hash ^ (unsigned char)text[length] ) * 16777619U;
+
+    const unsigned int mask = LE_LOG_MAX_FORMATS * 2 - 1;
+    unsigned int       slot = hash & mask;
+
+    while( NULL != logBinary.formats[slot] )
+        {
+            if( hash == logBinary.hashes[slot] && 0 == strcmp( text, logBinary.formats[slot] ) )
+                {
+                    return logBinary.ids[slot];
+                }
+            slot = ( slot + 1 ) & mask;
+        }
+
+    if( logBinary.formatCount >= LE_LOG_MAX_FORMATS ) return (unsigned int)-1;
+
+    char * copy = (char *)LE_MALLOC( length + 1 );
+    if( NULL == copy ) return (unsigned int)-1;
+    memcpy( copy, text, length + 1 );
+
+    const unsigned int id   = logBinary.formatCount++;
+    logBinary.formats[slot] = copy;
+    logBinary.hashes[slot]  = hash;
+    logBinary.ids[slot]     = id;
+
+    if( length > 0xFFFF ) length = 0xFFFF;
+    WriteLogBinaryRecord( LOG_RECORD_FORMAT, 0, id, text, length );
+
+    return id;
+}
+
+// Copy `size` bytes to the payload, false when it is full
+static bool
+AppendLogPayload( unsigned char * payload, size_t * length, const void * data, size_t size )
+{
+    if( *length + size > LE_LOG_BINARY_PAYLOAD ) return false;
+
+    memcpy( payload + *length, data, size );
+    *length += size;
+
+    return true;
+}
+
+// Raw arguments in the order of the conversions of `text`, see lelogformat.h
+static size_t
+EncodeLogArguments( unsigned char * payload, const char * text, va_list args )
+{
+    size_t length = 0;
+
+    for( const char * cursor = text; '\0' != *cursor; ++cursor )
+        {
+            if( '%' != *cursor ) continue;
+
+            const LogConversion conversion = ParseLogConversion( cursor );
+            cursor += conversion.length - 1;
+            if( LOG_ARG_NONE == conversion.type ) continue;
+
+            for( int i = 0; i < conversion.stars; ++i )
+                {
+                    const long long star = va_arg( args, int );
+                    AppendLogPayload( payload, &length, &star, sizeof( star ) );
+                }
+
+            long long integer = 0;
+            double    real    = 0.0;
+            switch( conversion.type )
+                {
+                case LOG_ARG_INT:     integer = va_arg( args, int ); break;
+                case LOG_ARG_LONG:    integer = va_arg( args, long ); break;
+                case LOG_ARG_LLONG:   integer = va_arg( args, long long ); break;
+                case LOG_ARG_SIZE:    integer = (long long)va_arg( args, size_t ); break;
+                case LOG_ARG_POINTER: integer = (long long)(uintptr_t)va_arg( args, void * ); break;
+                case LOG_ARG_DOUBLE:  real = va_arg( args, double ); break;
+                case LOG_ARG_LDOUBLE: real = (double)va_arg( args, long double ); break;
+                case LOG_ARG_STRING:
+                    {
+                        const char * string = va_arg( args, const char * );
+                        if( NULL == string ) string = "(null)";
+
+                        if( length + sizeof( unsigned short ) > LE_LOG_BINARY_PAYLOAD ) continue;
+                        const size_t room = LE_LOG_BINARY_PAYLOAD - length - sizeof( unsigned short );
+
+                        size_t stringLength = strlen( string );
+                        if( stringLength > room ) stringLength = room;
+
+                        const unsigned short size = (unsigned short)stringLength;
+                        AppendLogPayload( payload, &length, &size, sizeof( size ) );
+                        AppendLogPayload( payload, &length, string, stringLength );
+                    }
+                    continue;
+                default: continue;
+                }
+
+            if( LOG_ARG_DOUBLE == conversion.type || LOG_ARG_LDOUBLE == conversion.type )
+                {
+                    AppendLogPayload( payload, &length, &real, sizeof( real ) );
+                }
+            else
+                {
+                    AppendLogPayload( payload, &length, &integer, sizeof( integer ) );
+                }
+        }
+
+    return length;
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Memory accounting
+//----------------------------------------------------------------------------------------------------------------------
+static void
+LockMemoryStats( void )
+{
+    leMutexLock( &memoryStatsLock );
+}
+
+static void
+UnlockMemoryStats( void )
+{
+    leMutexUnlock( &memoryStatsLock );
+}
+
+static void
+UpdateMemoryUsage( MemoryUsage * usage, size_t previous, size_t bytes )
+{
+    usage->bytes = ( usage->bytes + bytes >= previous ) ? usage->bytes + bytes - previous : 0;
+    if( usage->bytes > usage->peakBytes ) usage->peakBytes = usage->bytes;
+}
+
+static size_t
+HashGpuObject( const void * owner, int kind, unsigned int id )
+{
+    const size_t hash = (size_t)(uintptr_t)owner ^ ( (size_t)kind << 24 ) ^ (size_t)id;
+    return (size_t)( ( hash * 2654435761U ) >> 4 );
+}
+
+// Slot holding the object, or the empty slot where it would go
+static GpuObject *
+FindGpuObject( const void * owner, int kind, unsigned int id )
+{
+    const size_t mask = memoryStats.objectCapacity - 1;
+
+    for( size_t slot = HashGpuObject( owner, kind, id ) & mask;; slot = ( slot + 1 ) & mask )
+        {
+            GpuObject * object = &memoryStats.objects[slot];
+            if( 0 == object->bytes ) return object;
+            if( owner == object->owner && kind == object->kind && id == object->id ) return object;
+        }
+}
+
+// Remove a slot without tombstones, shifting back the entries of its probe chain
+static void
+EraseGpuObject( GpuObject * object )
+{
+    const size_t mask = memoryStats.objectCapacity - 1;
+    size_t       hole = (size_t)( object - memoryStats.objects );
+
+    for( size_t slot = ( hole + 1 ) & mask; 0 != memoryStats.objects[slot].bytes; slot = ( slot + 1 ) & mask )
+        {
+            const GpuObject * next = &memoryStats.objects[slot];
+            const size_t      home = HashGpuObject( next->owner, next->kind, next->id ) & mask;
+
+            // Move it when the hole lies between its home slot and where it sits now
+            if( ( ( slot - home ) & mask ) >= ( ( slot - hole ) & mask ) )
+                {
+                    memoryStats.objects[hole] = *next;
+                    hole                      = slot;
+                }
+        }
+
+    memoryStats.objects[hole].bytes = 0;
+    --memoryStats.objectCount;
+}
+
+static bool
+GrowGpuObjects( void )
+{
+    const size_t capacity = ( memoryStats.objectCapacity > 0 ) ? memoryStats.objectCapacity * 2 : LE_GPU_MEMORY_OBJECTS;
+    GpuObject *  objects  = (GpuObject *)LE_CALLOC( capacity, sizeof( GpuObject ) );
+    if( NULL == objects ) return false;
+
+    GpuObject *  previous         = memoryStats.objects;
+    const size_t previousCapacity = memoryStats.objectCapacity;
+
+    memoryStats.objects        = objects;
+    memoryStats.objectCapacity = capacity;
+
+    for( size_t i = 0; i < previousCapacity; ++i )
+        {
+            const GpuObject * object = &previous[i];
+            if( 0 != object->bytes ) *FindGpuObject( object->owner, object->kind, object->id ) = *object;
+        }
+
+    LE_FREE( previous );
+    return true;
+}
+
+// Account CPU bytes gained or released by a module
+void
+TrackMemory( MemoryCategory category, size_t bytes, bool allocated )
+{
+    LockMemoryStats();
+    UpdateMemoryUsage( &memoryStats.cpu[category], allocated ? 0 : bytes, allocated ? bytes : 0 );
+    UnlockMemoryStats();
+}
+
+// Record the current size of a GPU object, 0 when it was deleted
+void
+TrackGpuMemory( const void * owner, int kind, unsigned int id, size_t bytes )
+{
+    if( kind < 0 || kind >= LE_GPU_MEMORY_KINDS ) return;
+
+    LockMemoryStats();
+
+    // Keep the table under half full so probe chains stay short
+    if( ( memoryStats.objectCount + 1 ) * 2 > memoryStats.objectCapacity && !GrowGpuObjects() )
+        {
+            UnlockMemoryStats();
+            return;
+        }
+
+    GpuObject *  object   = FindGpuObject( owner, kind, id );
+    const size_t previous = object->bytes;
+
+    UpdateMemoryUsage( &memoryStats.gpu[kind], previous, bytes );
+
+    if( 0 == bytes )
+        {
+            if( 0 != previous ) EraseGpuObject( object );
+        }
+    else
+        {
+            if( 0 == previous ) ++memoryStats.objectCount;
+
+            object->owner = owner;
+            object->kind  = kind;
+            object->id    = id;
+            object->bytes = bytes;
+        }
+
+    UnlockMemoryStats();
+}
+
+//----------------------------------------------------------------------------------------------------------------------
+// Module Functions Definition: Memory
+//----------------------------------------------------------------------------------------------------------------------
+void *
+MemAlloc( size_t size )
+{
+    return memAlloc( size );
+}
+
+void *
+MemRealloc( void * ptr, size_t size )
+{
+    return memRealloc( ptr, size );
+}
+
+void
+MemFree( void * ptr )
+{
+    if( NULL != ptr ) memFree( ptr );
+}
+
+// Snapshot of the memory accounting
+MemoryStats
+GetMemoryStats( void )
+{
+    MemoryStats stats = { 0 };
+
+    LockMemoryStats();
+    stats.vertexStaging    = memoryStats.cpu[MEMORY_VERTEX_STAGING];
+    stats.commandBuffers   = memoryStats.cpu[MEMORY_COMMAND_BUFFERS];
+    stats.fileData         = memoryStats.cpu[MEMORY_FILE_DATA];
+    stats.shaders          = memoryStats.cpu[MEMORY_SHADERS];
+    stats.scenes           = memoryStats.cpu[MEMORY_SCENES];
+    stats.images           = memoryStats.cpu[MEMORY_IMAGES];
+    stats.fonts            = memoryStats.cpu[MEMORY_FONTS];
+    stats.polygons         = memoryStats.cpu[MEMORY_POLYGONS];
+    stats.particles        = memoryStats.cpu[MEMORY_PARTICLES];
+    stats.gpuBuffers       = memoryStats.gpu[LE_GPU_MEMORY_BUFFER];
+    stats.gpuTextures      = memoryStats.gpu[LE_GPU_MEMORY_TEXTURE];
+    stats.gpuRenderTargets = memoryStats.gpu[LE_GPU_MEMORY_RENDER_TARGET];
+    UnlockMemoryStats();
+
+    return stats;
+}
+
 //----------------------------------------------------------------------------------------------------------------------
 // Module Functions Definition: Utilities
 //----------------------------------------------------------------------------------------------------------------------
@@ -56,6 +796,73 @@ SetLogLevel( int logType )
     logLevel = logType;
 }
 
+// Queue messages for a background writer, other threads may keep logging while it changes
+void
+SetTraceLogAsync( bool enabled )
+{
+    if( !enabled )
+        {
+            StopLogWriter();
+            return;
+        }
+
+    if( NULL != leAtomicLoadPtr( &logQueue ) ) return;
+
+    LogQueue * queue = (LogQueue *)LE_CALLOC( 1, sizeof( LogQueue ) );
+    if( NULL == queue ) return;
+
+    queue->records = (LogRecord *)LE_MALLOC( LE_LOG_QUEUE_SIZE * sizeof( LogRecord ) );
+    if( NULL == queue->records )
+        {
+            LE_FREE( queue );
+            return;
+        }
+
+    for( long i = 0; i < LE_LOG_QUEUE_SIZE; ++i ) queue->records[i].sequence = i;
+
+    leMutexInit( &queue->lock );
+    leConditionInit( &queue->wake );
+
+    // Synchronous output written so far must come first
+    fflush( stdout );
+
+    if( !leThreadCreate( &queue->thread, LogWriterLoop, queue ) )
+        {
+            leConditionDestroy( &queue->wake );
+            leMutexDestroy( &queue->lock );
+            LE_FREE( queue->records );
+            LE_FREE( queue );
+            return;
+        }
+
+    // A concurrent enable won, this writer never saw a record
+    if( !leAtomicCompareSwapPtr( &logQueue, NULL, queue ) ) JoinLogWriter( queue );
+}
+
+// Flush and stop asynchronous logging, called when the last context closes
+void
+CloseTraceLog( void )
+{
+    StopLogWriter();
+
+    LockLogBinary();
+    CloseLogBinary();
+    UnlockLogBinary();
+}
+
+// Set the binary log output, the current file is closed and the next record opens the new one
+void
+SetTraceLogBinaryFile( const char * fileName )
+{
+    LockLogBinary();
+
+    CloseLogBinary();
+    logBinary.fileName[0] = '\0';
+    if( NULL != fileName ) snprintf( logBinary.fileName, sizeof( logBinary.fileName ), "%s", fileName );
+
+    UnlockLogBinary();
+}
+
 // Display the given message
 void
 TraceLog( int logType, const char * text, ... )
@@ -65,35 +872,69 @@ TraceLog( int logType, const char * text, ... )
 
     va_list args;
     va_start( args, text );
+    TraceLogArgs( logType, text, args );
+    va_end( args );
+}
 
-    // Use custom callback if available
-    if( NULL != traceLog )
+// Record the format ID, a timestamp and the raw arguments, formatting is left to ledecode
+void
+TraceLogBinary( int logType, const char * text, ... )
+{
+    // Skip logging
+    if( (int)logLevel > logType ) return;
+
+    va_list args;
+    va_start( args, text );
+
+    // Custom callbacks expect formatted text, and fatal messages must be seen before aborting
+    if( NULL != traceLog || LOG_FATAL == logType )
         {
-            traceLog( logType, text, args );
+            if( LOG_FATAL == logType )
+                {
+                    LockLogBinary();
+                    if( NULL != logBinary.file ) fflush( logBinary.file );
+                    UnlockLogBinary();
+                }
+
+            TraceLogArgs( logType, text, args );
             va_end( args );
             return;
         }
 
-    // Determine log level string
-    char * levelString;
-    switch( logType )
+    // Encoded before taking the lock, other threads only wait on the write itself
+    va_list fallback;
+    va_copy( fallback, args );
+
+    unsigned char payload[LE_LOG_BINARY_PAYLOAD];
+    size_t        length = EncodeLogArguments( payload, text, args );
+
+    LockLogBinary();
+
+    if( OpenLogBinary() )
         {
-        case LOG_TRACE:   levelString = "TRACE"; break;
-        case LOG_DEBUG:   levelString = "DEBUG"; break;
-        case LOG_INFO:    levelString = "INFO"; break;
-        case LOG_WARNING: levelString = "WARNING"; break;
-        case LOG_ERROR:   levelString = "ERROR"; break;
-        case LOG_FATAL:   levelString = "FATAL"; break;
-        default:          levelString = "UNKNOWN"; break;
-        }
+            const unsigned int formatId = GetLogFormatId( text );
+            if( (unsigned int)-1 != formatId )
+                {
+                    WriteLogBinaryRecord( LOG_RECORD_EVENT, logType, formatId, payload, length );
+                }
+            else
+                {
+                    const int written = vsnprintf( (char *)payload, sizeof( payload ), text, fallback );
+                    length            = ( written < 0 ) ? 0 : strlen( (char *)payload );
+                    WriteLogBinaryRecord( LOG_RECORD_TEXT, logType, 0, payload, length );
+                }
 
-    // Print log message
-    fprintf( stdout, "[%s] ", levelString );
-    vfprintf( stdout, text, args );
-    fprintf( stdout, "\n" );
+            // Warnings and errors reach the file even if the process dies before CloseWindow
+            if( logType >= LOG_WARNING ) fflush( logBinary.file );
 
-    va_end( args );
+            UnlockLogBinary();
+        }
+    else
+        {
+            UnlockLogBinary();
+            TraceLogArgs( logType, text, fallback );
+        }
 
-    // Handle fatal errors
-    if( UNLIKELY( logType == LOG_FATAL ) ) abort();
+    va_end( fallback );
+    va_end( args );
 }
@@ -2,6 +2,8 @@
 // INCLUDES
 //==============================================================================================================
 #include "lecore_context.h"
+#include "lerender.h"
+#include "lesystem.h"
 
 #include "levegl/leutils.h"
 #include "levegl/levegl.h"
@@ -13,27 +15,55 @@
 #include "GLFW/glfw3.h"
 //#include "GLFW/glfw3native.h"
 
+#include <string.h> /* strstr */
+
 //==============================================================================================================
 // TYPES
 //==============================================================================================================
-typedef struct PlatformContext
+#if defined( _WIN32 )
+    #define LE_EGLAPIENTRY __stdcall
+#else
+    #define LE_EGLAPIENTRY
+#endif
+
+// EGL entry points used to present damaged areas, resolved through GLFW so EGL is not linked
+typedef void * ( LE_EGLAPIENTRY * PFNEGLGETCURRENTPROC )( int );
+typedef void * ( LE_EGLAPIENTRY * PFNEGLGETCURRENTDISPLAYPROC )( void );
+typedef const char * ( LE_EGLAPIENTRY * PFNEGLQUERYSTRINGPROC )( void *, int );
+typedef unsigned int ( LE_EGLAPIENTRY * PFNEGLSWAPBUFFERSWITHDAMAGEPROC )( void *, void *, const int *, int );
+
+#define LE_EGL_EXTENSIONS 0x3055
+#define LE_EGL_DRAW       0x3059
+
+struct PlatformContext
 {
     GLFWwindow * handle;
-} PlatformContext;
+
+    bool                            damageResolved;  /// Lookup below done, on the thread presenting
+    PFNEGLSWAPBUFFERSWITHDAMAGEPROC swapWithDamage;  /// NULL when the whole buffer is presented
+    void *                          damageDisplay;   /// EGLDisplay
+    void *                          damageSurface;   /// EGLSurface
+};
 
 //==============================================================================================================
 // GLOBALS
 //==============================================================================================================
-extern CoreContext     core;
-static PlatformContext platform = { 0 };
+// GLFW wants windows created and events processed on the thread that initialized it
+static leMutex       windowLock     = LE_MUTEX_INITIALIZER; // Guards the two below, contexts close on any thread
+static int           windowCount    = 0;                    // Open windows, GLFW terminates with the last one
+static unsigned long platformThread = 0;                    // Thread that initialized GLFW
 
 //==============================================================================================================
 // MODULE FUNCTIONS DECLARATIONS
 //==============================================================================================================
-int InitPlatform();
+int  InitPlatform();
+void ClosePlatform( void );
+bool IsPlatformThread( void );
 
 extern void InitShapes( void );
 extern void CleanupShapes( void );
+extern void InitTextures( void );
+extern void CleanupTextures( void );
 
 // GLFW callbacks and window management
 static void FramebufferSizeCallback( GLFWwindow * window, int width, int height );
@@ -44,20 +74,46 @@ static void FramebufferSizeCallback( GLFWwindow * window, int width, int height
 int
 InitPlatform()
 {
-    TRACELOG( LOG_INFO, "Initializing window: %s (%dx%d)", core.window.title, core.window.screen.width,
-              core.window.screen.height );
+    LeContext *   context = GetCurrentContext();
+    CoreContext * core    = &context->core;
+
+    TRACELOG( LOG_INFO, "Initializing window: %s (%dx%d)", core->window.title, core->window.screen.width,
+              core->window.screen.height );
+
+    leMutexLock( &windowLock );
+    if( 0 != windowCount && leGetThreadId() != platformThread )
+        {
+            leMutexUnlock( &windowLock );
+            TRACELOG( LOG_ERROR, "Windows are created on the thread that created the first one" );
+            return -1;
+        }
 
     if( !glfwInit() )
         {
+            leMutexUnlock( &windowLock );
             TRACELOG( LOG_ERROR, "Failed to initialize GLFW" );
             return -1;
         }
 
+    PlatformContext * platform = (PlatformContext *)LE_CALLOC( 1, sizeof( PlatformContext ) );
+    if( NULL == platform )
+        {
+            if( 0 == windowCount ) glfwTerminate();
+            leMutexUnlock( &windowLock );
+            TRACELOG( LOG_ERROR, "Failed to allocate platform state" );
+            return -1;
+        }
+
     glfwDefaultWindowHints();
 
     // Set OpenGL version and profile.
+#if defined( GRAPHICS_API_OPENGL_43 )
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 4 );
+    glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 3 );
+#else
     glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 3 );
     glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 3 );
+#endif
     glfwWindowHint( GLFW_OPENGL_PROFILE, GLFW_OPENGL_CORE_PROFILE );
 #ifdef __APPLE__
     glfwWindowHint( GLFW_OPENGL_FORWARD_COMPAT, GLFW_TRUE );
@@ -65,35 +121,59 @@ InitPlatform()
 
     // Apply window hints based on our flag configuration:
     // Set whether the window should be resizable.
-    glfwWindowHint( GLFW_RESIZABLE, FLAG_CHECK( core.window.flags, FLAG_WINDOW_RESIZABLE ) ? GLFW_TRUE : GLFW_FALSE );
+    glfwWindowHint( GLFW_RESIZABLE, FLAG_CHECK( core->window.flags, FLAG_WINDOW_RESIZABLE ) ? GLFW_TRUE : GLFW_FALSE );
+
+    // Hidden windows back offscreen and headless surfaces.
+    glfwWindowHint( GLFW_VISIBLE, FLAG_CHECK( core->window.flags, FLAG_WINDOW_HIDDEN ) ? GLFW_FALSE : GLFW_TRUE );
 
     // Configure MSAA (multi-sample anti-aliasing) sample count.
-    glfwWindowHint( GLFW_SAMPLES, FLAG_CHECK( core.window.flags, FLAG_MSAA_HINT ) ? 4 : 0 );
+    glfwWindowHint( GLFW_SAMPLES, FLAG_CHECK( core->window.flags, FLAG_MSAA_HINT ) ? 4 : 0 );
 
     // Create the window.
-    platform.handle
-        = glfwCreateWindow( core.window.screen.width, core.window.screen.height, core.window.title, NULL, NULL );
-    if( !platform.handle )
+    platform->handle
+        = glfwCreateWindow( core->window.screen.width, core->window.screen.height, core->window.title, NULL, NULL );
+    if( !platform->handle )
         {
+            LE_FREE( platform );
+            if( 0 == windowCount ) glfwTerminate();
+            leMutexUnlock( &windowLock );
             TRACELOG( LOG_ERROR, "Failed to create GLFW window" );
-            glfwTerminate();
             return -1;
         }
 
-    glfwMakeContextCurrent( platform.handle );
+    context->platform = platform;
+    platformThread    = leGetThreadId();
+    ++windowCount;
+    leMutexUnlock( &windowLock );
+    glfwSetWindowUserPointer( platform->handle, context );
+
+    glfwMakeContextCurrent( platform->handle );
 
     leLoadExtensions( glfwGetProcAddress );
 
+    if( !InitRenderer() )
+        {
+            ClosePlatform();
+            return -1;
+        }
+
     InitShapes();
+    InitTextures();
 
     // Set VSync based on our flag configuration.
-    glfwSwapInterval( FLAG_CHECK( core.window.flags, FLAG_VSYNC_HINT ) ? 1 : 0 );
+    glfwSwapInterval( FLAG_CHECK( core->window.flags, FLAG_VSYNC_HINT ) ? 1 : 0 );
 
     // Configure timing settings.
-    core.timing.targetFPS     = 60;
-    core.timing.lastFrameTime = GetTime();
+    core->timing.targetFPS     = 1.0 / 60.0;
+    core->timing.lastFrameTime = GetTime();
+
+    // The framebuffer may be larger than the window asked for on high DPI screens
+    int width = 0, height = 0;
+    glfwGetFramebufferSize( platform->handle, &width, &height );
+    leAtomicStore( &core->window.screen.width, (unsigned int)width );
+    leAtomicStore( &core->window.screen.height, (unsigned int)height );
 
-    glfwSetFramebufferSizeCallback( platform.handle, FramebufferSizeCallback );
+    glfwSetFramebufferSizeCallback( platform->handle, FramebufferSizeCallback );
 
     TRACELOG( LOG_INFO, "Window initialized successfully" );
     return 0;
@@ -102,32 +182,70 @@ InitPlatform()
 void
 ClosePlatform( void )
 {
+    LeContext *       context  = GetCurrentContext();
+    PlatformContext * platform = context->platform;
+
     // First clean up any OpenGL resources
+    CleanupTextures();
     CleanupShapes();
+    CloseRenderer();
 
     // Check if window exists before destroying
-    if( NULL != platform.handle )
+    if( NULL != platform->handle )
         {
-            glfwDestroyWindow( platform.handle );
-            platform.handle = NULL;
+            glfwDestroyWindow( platform->handle );
+            platform->handle = NULL;
         }
 
-    // Terminate GLFW and reset error callback
-    glfwSetErrorCallback( NULL );
-    glfwTerminate();
+    LE_FREE( platform );
+    context->platform = NULL;
+
+    // Terminate GLFW and reset error callback once the last window is gone
+    leMutexLock( &windowLock );
+    if( 0 == --windowCount )
+        {
+            glfwSetErrorCallback( NULL );
+            glfwTerminate();
+            platformThread = 0;
+        }
+    leMutexUnlock( &windowLock );
+}
+
+// Whether the calling thread may create windows and process events, any thread may before the first window
+bool
+IsPlatformThread( void )
+{
+    leMutexLock( &windowLock );
+    const bool owner = 0 == windowCount || leGetThreadId() == platformThread;
+    leMutexUnlock( &windowLock );
+
+    return owner;
 }
 
 bool
 ShouldQuit( void )
 {
-    return glfwWindowShouldClose( platform.handle );
+    LeContext * context = GetCurrentContext();
+    if( NULL == context ) return true;
+
+    return glfwWindowShouldClose( context->platform->handle );
 }
 
 void
 SetWindowTitle( const char * title )
 {
-    core.window.title = title;
-    glfwSetWindowTitle( platform.handle, title );
+    LeContext * context = GetCurrentContext();
+    if( NULL == context ) return;
+
+    // GLFW only changes windows from the thread that created them
+    if( !IsPlatformThread() )
+        {
+            TRACELOG( LOG_WARNING, "Window titles are set on the thread that created the window" );
+            return;
+        }
+
+    context->core.window.title = title;
+    glfwSetWindowTitle( context->platform->handle, title );
 }
 
 double
@@ -139,7 +257,111 @@ GetTime( void )
 void
 SwapBuffers( void )
 {
-    glfwSwapBuffers( platform.handle );
+    PlatformContext * platform = GetCurrentContext()->platform;
+
+    LE_PROFILE_BEGIN( "SwapBuffers" );
+    glfwSwapBuffers( platform->handle );
+    LE_PROFILE_END();
+}
+
+// Look for EGL_KHR/EXT_swap_buffers_with_damage on the EGL surface current on this thread
+static void
+ResolveSwapWithDamage( PlatformContext * platform )
+{
+    platform->damageResolved = true;
+    if( GLFW_EGL_CONTEXT_API != glfwGetWindowAttrib( platform->handle, GLFW_CONTEXT_CREATION_API ) ) return;
+
+    PFNEGLGETCURRENTDISPLAYPROC getDisplay  = (PFNEGLGETCURRENTDISPLAYPROC)glfwGetProcAddress( "eglGetCurrentDisplay" );
+    PFNEGLGETCURRENTPROC        getSurface  = (PFNEGLGETCURRENTPROC)glfwGetProcAddress( "eglGetCurrentSurface" );
+    PFNEGLQUERYSTRINGPROC       queryString = (PFNEGLQUERYSTRINGPROC)glfwGetProcAddress( "eglQueryString" );
+    if( NULL == getDisplay || NULL == getSurface || NULL == queryString ) return;
+
+    void *       display    = getDisplay();
+    const char * extensions = queryString( display, LE_EGL_EXTENSIONS );
+    if( NULL == extensions ) return;
+
+    const char * name = NULL;
+    if( NULL != strstr( extensions, "EGL_KHR_swap_buffers_with_damage" ) )
+        {
+            name = "eglSwapBuffersWithDamageKHR";
+        }
+    else if( NULL != strstr( extensions, "EGL_EXT_swap_buffers_with_damage" ) )
+        {
+            name = "eglSwapBuffersWithDamageEXT";
+        }
+    if( NULL == name ) return;
+
+    platform->swapWithDamage = (PFNEGLSWAPBUFFERSWITHDAMAGEPROC)glfwGetProcAddress( name );
+    platform->damageDisplay  = display;
+    platform->damageSurface  = getSurface( LE_EGL_DRAW );
+
+    if( NULL != platform->swapWithDamage ) TRACELOG( LOG_INFO, "PLATFORM: Presenting damaged areas with %s", name );
+}
+
+// Present a frame whose pixels only changed inside the area, bottom-left origin
+void
+SwapBuffersWithDamage( int x, int y, int width, int height )
+{
+    PlatformContext * platform = GetCurrentContext()->platform;
+
+    if( !platform->damageResolved ) ResolveSwapWithDamage( platform );
+    if( NULL == platform->swapWithDamage )
+        {
+            SwapBuffers();
+            return;
+        }
+
+    const int rect[4] = { x, y, width, height };
+
+    LE_PROFILE_BEGIN( "SwapBuffers" );
+    platform->swapWithDamage( platform->damageDisplay, platform->damageSurface, rect, 1 );
+    LE_PROFILE_END();
+}
+
+// Events of every window are processed by the thread owning them, other threads leave them to it
+void
+PollInputEvents( void )
+{
+    if( IsPlatformThread() ) glfwPollEvents();
+}
+
+// Process events, sleeping until one arrives or `timeout` elapsed, a negative timeout waits forever. Threads not
+// owning the windows sleep until the owner or RequestRedraw asks for a frame instead
+void
+WaitInputEvents( double timeout )
+{
+    if( !IsPlatformThread() )
+        {
+            LeContext * context = GetCurrentContext();
+            if( NULL == context ) return;
+
+            const double end = GetTime() + timeout;
+            while( !leAtomicLoad( &context->core.redraw.requested ) && ( timeout < 0.0 || GetTime() < end ) )
+                {
+                    leThreadSleep( 1000000ULL );
+                }
+            return;
+        }
+
+    if( timeout < 0.0 )
+        {
+            glfwWaitEvents();
+        }
+    else if( timeout > 0.0 )
+        {
+            glfwWaitEventsTimeout( timeout );
+        }
+    else
+        {
+            glfwPollEvents();
+        }
+}
+
+// Wake a thread sleeping in WaitInputEvents
+void
+PostEmptyEvent( void )
+{
+    glfwPostEmptyEvent();
 }
 
 void
@@ -150,44 +372,81 @@ WaitTime( double seconds )
             return;
         }
 
-    double start   = GetTime();
-    double elapsed = 0.0;
+    LE_PROFILE_BEGIN( "WaitTime" );
+
+    double     start   = GetTime();
+    double     elapsed = 0.0;
+    const bool events  = IsPlatformThread();
 
     while( ( elapsed = GetTime() - start ) < seconds )
         {
             const double remaining = seconds - elapsed;
-            glfwWaitEventsTimeout( remaining );
+            if( events )
+                {
+                    glfwWaitEventsTimeout( remaining );
+                }
+            else
+                {
+                    leThreadSleep( (unsigned long long)( remaining * 1e9 ) );
+                }
         }
+
+    LE_PROFILE_END();
 }
 
-// Window size getters
+// Framebuffer size, kept by FramebufferSizeCallback so any thread may ask without calling GLFW
 int
 GetScreenWidth( void )
 {
-    int width, height;
-    glfwGetFramebufferSize( platform.handle, &width, &height );
-    return width;
+    LeContext * context = GetCurrentContext();
+    if( NULL == context ) return 0;
+
+    return (int)leAtomicLoad( &context->core.window.screen.width );
 }
 
 int
 GetScreenHeight( void )
 {
-    int width, height;
-    glfwGetFramebufferSize( platform.handle, &width, &height );
-    return height;
+    LeContext * context = GetCurrentContext();
+    if( NULL == context ) return 0;
+
+    return (int)leAtomicLoad( &context->core.window.screen.height );
 }
 
 void *
 GetWindowHandle( void )
 {
-    return (void *)platform.handle;
+    LeContext * context = GetCurrentContext();
+    if( NULL == context ) return NULL;
+
+    return (void *)context->platform->handle;
+}
+
+// Make the window context current on the calling thread
+void
+AcquirePlatformContext( void )
+{
+    PlatformContext * platform = GetCurrentContext()->platform;
+
+    glfwMakeContextCurrent( platform->handle );
+}
+
+// Detach the window context from the calling thread
+void
+ReleasePlatformContext( void )
+{
+    glfwMakeContextCurrent( NULL );
 }
 
 static void
 FramebufferSizeCallback( GLFWwindow * window, int width, int height )
 {
+    // Callbacks may fire for any window, not only the current context
+    CoreContext * core = &( (LeContext *)glfwGetWindowUserPointer( window ) )->core;
+
     //glViewport( 0, 0, width, height );
-    core.window.screen.width  = width;
-    core.window.screen.height = height;
+    leAtomicStore( &core->window.screen.width, (unsigned int)width );
+    leAtomicStore( &core->window.screen.height, (unsigned int)height );
+    leAtomicStore( &core->redraw.requested, 1L );
     TRACELOG( LOG_INFO, "Window resized to %dx%d", width, height );
 }
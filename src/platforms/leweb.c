@@ -2,6 +2,8 @@
 // INCLUDES
 //==============================================================================================================
 #include "lecore_context.h"
+#include "lerender.h"
+#include "lesystem.h"
 
 #include "levegl/leutils.h"
 #include "levegl/levegl.h"
@@ -16,23 +18,26 @@
 //==============================================================================================================
 // TYPES
 //==============================================================================================================
-typedef struct PlatformContext
+struct PlatformContext
 {
     GLFWwindow * handle;
-} PlatformContext;
+};
 
 //==============================================================================================================
 // GLOBALS
 //==============================================================================================================
-extern CoreContext     core;
-static PlatformContext platform = { 0 };
+static int windowCount = 0; // Open windows, GLFW terminates with the last one
 
 //==============================================================================================================
 // MODULE FUNCTIONS DECLARATIONS
 //==============================================================================================================
 int         InitPlatform();
+void        ClosePlatform( void );
+bool        IsPlatformThread( void );
 extern void InitShapes( void );
 extern void CleanupShapes( void );
+extern void InitTextures( void );
+extern void CleanupTextures( void );
 static void FramebufferSizeCallback( GLFWwindow * window, int width, int height );
 
 //==============================================================================================================
@@ -50,8 +55,11 @@ GetTime( void )
 int
 InitPlatform()
 {
-    TRACELOG( LOG_INFO, "Initializing window: %s (%dx%d)", core.window.title, core.window.screen.width,
-              core.window.screen.height );
+    LeContext *   context = GetCurrentContext();
+    CoreContext * core    = &context->core;
+
+    TRACELOG( LOG_INFO, "Initializing window: %s (%dx%d)", core->window.title, core->window.screen.width,
+              core->window.screen.height );
 
     if( !glfwInit() )
         {
@@ -59,30 +67,50 @@ InitPlatform()
             return -1;
         }
 
+    PlatformContext * platform = (PlatformContext *)LE_CALLOC( 1, sizeof( PlatformContext ) );
+    if( NULL == platform )
+        {
+            TRACELOG( LOG_ERROR, "Failed to allocate platform state" );
+            if( 0 == windowCount ) glfwTerminate();
+            return -1;
+        }
+
     // Emscripten-specific context configuration
     glfwWindowHint( GLFW_CLIENT_API, GLFW_OPENGL_ES_API );
     glfwWindowHint( GLFW_CONTEXT_VERSION_MAJOR, 3 );
     glfwWindowHint( GLFW_CONTEXT_VERSION_MINOR, 0 );
     glfwWindowHint( GLFW_RESIZABLE, GLFW_TRUE );
 
-    platform.handle
-        = glfwCreateWindow( core.window.screen.width, core.window.screen.height, core.window.title, NULL, NULL );
-    if( !platform.handle )
+    platform->handle
+        = glfwCreateWindow( core->window.screen.width, core->window.screen.height, core->window.title, NULL, NULL );
+    if( !platform->handle )
         {
             TRACELOG( LOG_ERROR, "Failed to create GLFW window" );
-            glfwTerminate();
+            LE_FREE( platform );
+            if( 0 == windowCount ) glfwTerminate();
             return -1;
         }
 
-    glfwMakeContextCurrent( platform.handle );
+    context->platform = platform;
+    ++windowCount;
+    glfwSetWindowUserPointer( platform->handle, context );
+
+    glfwMakeContextCurrent( platform->handle );
     leLoadExtensions( glfwGetProcAddress );
+    if( !InitRenderer() )
+        {
+            ClosePlatform();
+            return -1;
+        }
+
     InitShapes();
+    InitTextures();
 
     // Configure timing
-    core.timing.targetFPS     = 60;
-    core.timing.lastFrameTime = GetTime();
+    core->timing.targetFPS     = 1.0 / 60.0;
+    core->timing.lastFrameTime = GetTime();
 
-    glfwSetFramebufferSizeCallback( platform.handle, FramebufferSizeCallback );
+    glfwSetFramebufferSizeCallback( platform->handle, FramebufferSizeCallback );
 
     TRACELOG( LOG_INFO, "Window initialized successfully" );
     return 0;
@@ -91,21 +119,69 @@ InitPlatform()
 void
 ClosePlatform( void )
 {
+    LeContext *       context  = GetCurrentContext();
+    PlatformContext * platform = context->platform;
+
+    CleanupTextures();
     CleanupShapes();
+    CloseRenderer();
 
-    if( platform.handle )
+    if( platform->handle )
         {
-            glfwDestroyWindow( platform.handle );
-            platform.handle = NULL;
+            glfwDestroyWindow( platform->handle );
+            platform->handle = NULL;
         }
 
-    glfwTerminate();
+    LE_FREE( platform );
+    context->platform = NULL;
+
+    if( 0 == --windowCount ) glfwTerminate();
+}
+
+// The browser runs everything on its main thread
+bool
+IsPlatformThread( void )
+{
+    return true;
 }
 
 bool
 ShouldQuit( void )
 {
-    return glfwWindowShouldClose( platform.handle );
+    LeContext * context = GetCurrentContext();
+    if( NULL == context ) return true;
+
+    return glfwWindowShouldClose( context->platform->handle );
+}
+
+// Browser events are dispatched between animation frames
+void
+PollInputEvents( void )
+{
+}
+
+// Browser events only run while sleeping, so sleep a display frame at a time until one asks for a redraw
+void
+WaitInputEvents( double timeout )
+{
+    LeContext * context = GetCurrentContext();
+    if( NULL == context ) return;
+
+    CoreContext * core = &context->core;
+    const double  end  = GetTime() + timeout;
+
+    LE_PROFILE_BEGIN( "WaitInputEvents" );
+    while( !leAtomicLoad( &core->redraw.requested ) && ( timeout < 0.0 || GetTime() < end ) )
+        {
+            emscripten_sleep( 16 );
+        }
+    LE_PROFILE_END();
+}
+
+// The waiting loop polls the request itself
+void
+PostEmptyEvent( void )
+{
 }
 
 void
@@ -113,21 +189,54 @@ WaitTime( double seconds )
 {
     if( seconds > 0.0 )
         {
+            LE_PROFILE_BEGIN( "WaitTime" );
             emscripten_sleep( seconds * 1000 );
+            LE_PROFILE_END();
         }
 }
 
+// The browser owns a single GL thread, contexts never move
+void
+AcquirePlatformContext( void )
+{
+}
+
+void
+ReleasePlatformContext( void )
+{
+}
+
 void
 SwapBuffers( void )
 {
-    glfwSwapBuffers( platform.handle );
+    PlatformContext * platform = GetCurrentContext()->platform;
+
+    LE_PROFILE_BEGIN( "SwapBuffers" );
+    glfwSwapBuffers( platform->handle );
+    LE_PROFILE_END();
+}
+
+// The browser composites the whole canvas
+void
+SwapBuffersWithDamage( int x, int y, int width, int height )
+{
+    (void)x;
+    (void)y;
+    (void)width;
+    (void)height;
+
+    SwapBuffers();
 }
 
 static void
 FramebufferSizeCallback( GLFWwindow * window, int width, int height )
 {
+    // Callbacks may fire for any window, not only the current context
+    CoreContext * core = &( (LeContext *)glfwGetWindowUserPointer( window ) )->core;
+
     //glViewport( 0, 0, width, height );
-    core.window.screen.width  = width;
-    core.window.screen.height = height;
+    leAtomicStore( &core->window.screen.width, (unsigned int)width );
+    leAtomicStore( &core->window.screen.height, (unsigned int)height );
+    leAtomicStore( &core->redraw.requested, 1L );
     TRACELOG( LOG_INFO, "Window resized to %dx%d", width, height );
 }
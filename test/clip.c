@@ -0,0 +1,443 @@
+#include "tau/tau.h"
+
+#include "leclip.h"
+
+#include "levegl/lemath.h"
+
+#include <math.h>   /* fabsf, fminf, fmaxf */
+#include <stdlib.h> /* rand */
+
+#define EPSILON       1e-4F
+#define SCREEN_WIDTH  800.0F
+#define SCREEN_HEIGHT 600.0F
+#define GRID_STEP     50.0F
+#define RANDOM_AREAS  400
+
+static const ClipBox box = { 0.0F, 0.0F, 10.0F, 10.0F };
+
+// Texture coordinates follow the position, so cut corners can be checked against where they landed
+static RenderVertex
+MakeVertex( float x, float y )
+{
+    RenderVertex vertex = { 0 };
+    vertex.x            = x;
+    vertex.y            = y;
+    vertex.u            = ( x + 20.0F ) / 50.0F;
+    vertex.v            = ( y + 20.0F ) / 50.0F;
+    vertex.a            = 255;
+    return vertex;
+}
+
+static bool
+IsVertexAt( RenderVertex vertex, float x, float y )
+{
+    return fabsf( vertex.x - x ) <= EPSILON && fabsf( vertex.y - y ) <= EPSILON;
+}
+
+static bool
+HasMatchingUV( RenderVertex vertex )
+{
+    return fabsf( vertex.u - ( vertex.x + 20.0F ) / 50.0F ) <= EPSILON
+        && fabsf( vertex.v - ( vertex.y + 20.0F ) / 50.0F ) <= EPSILON;
+}
+
+static float
+Cross( float ax, float ay, float bx, float by, float px, float py )
+{
+    return ( bx - ax ) * ( py - ay ) - ( by - ay ) * ( px - ax );
+}
+
+// Convex outline of either winding, borders included
+static bool
+IsInsideConvex( const RenderVertex * corners, int count, float x, float y )
+{
+    bool positive = false, negative = false;
+    for( int i = 0; i < count; ++i )
+        {
+            const RenderVertex * a    = &corners[i];
+            const RenderVertex * b    = &corners[( i + 1 ) % count];
+            const float          turn = Cross( a->x, a->y, b->x, b->y, x, y );
+            if( turn > EPSILON ) positive = true;
+            if( turn < -EPSILON ) negative = true;
+        }
+    return !( positive && negative );
+}
+
+// Twice the signed area
+static float
+GetArea( const RenderVertex * corners, int count )
+{
+    float area = 0.0F;
+    for( int i = 0, j = count - 1; i < count; j = i++ )
+        {
+            area += corners[j].x * corners[i].y - corners[i].x * corners[j].y;
+        }
+    return area;
+}
+
+// Brute force: the pieces stay in the box with the UVs of their position, none is empty, and they cover exactly
+// the part of the primitive inside the box at every sample point
+static bool
+IsValidClip( const RenderVertex * primitive, int perPrimitive, const RenderVertex * pieces, int written )
+{
+    if( 0 != written % perPrimitive ) return false;
+
+    for( int i = 0; i < written; i += perPrimitive )
+        {
+            if( fabsf( GetArea( &pieces[i], perPrimitive ) ) <= EPSILON ) return false;
+        }
+
+    for( int i = 0; i < written; ++i )
+        {
+            if( pieces[i].x < box.minX - EPSILON || pieces[i].x > box.maxX + EPSILON ) return false;
+            if( pieces[i].y < box.minY - EPSILON || pieces[i].y > box.maxY + EPSILON ) return false;
+            if( !HasMatchingUV( pieces[i] ) ) return false;
+        }
+
+    // Samples keep clear of the borders and diagonals of the test shapes
+    for( float y = -14.71F; y < 25.0F; y += 0.5F )
+        {
+            for( float x = -14.87F; x < 25.0F; x += 0.5F )
+                {
+                    const bool expected = IsInsideConvex( primitive, perPrimitive, x, y ) && x >= box.minX
+                                       && x <= box.maxX && y >= box.minY && y <= box.maxY;
+
+                    bool covered = false;
+                    for( int i = 0; i < written && !covered; i += perPrimitive )
+                        {
+                            covered = IsInsideConvex( &pieces[i], perPrimitive, x, y );
+                        }
+                    if( covered != expected ) return false;
+                }
+        }
+
+    return true;
+}
+
+TEST( clip, triangle_crossing_a_border )
+{
+    const RenderVertex triangle[3] = { MakeVertex( -5, 0 ), MakeVertex( 5, 0 ), MakeVertex( 5, 10 ) };
+    RenderVertex       pieces[CLIP_MAX_VERTICES];
+
+    // The corner left of the box is cut at both of its edges, leaving a fan of two
+    REQUIRE_EQ( ClipPrimitive( triangle, 3, box, pieces ), 6 );
+    CHECK( IsVertexAt( pieces[0], 0, 0 ) );
+    CHECK( IsVertexAt( pieces[1], 5, 0 ) );
+    CHECK( IsVertexAt( pieces[2], 5, 10 ) );
+    CHECK( IsVertexAt( pieces[3], 0, 0 ) );
+    CHECK( IsVertexAt( pieces[4], 5, 10 ) );
+    CHECK( IsVertexAt( pieces[5], 0, 5 ) );
+    for( int i = 0; i < 6; ++i ) CHECK( HasMatchingUV( pieces[i] ) );
+}
+
+TEST( clip, edges_and_corners )
+{
+    RenderVertex pieces[CLIP_MAX_VERTICES];
+
+    // Squares as large as the box, centered on each of its corners and edge midpoints
+    for( int row = 0; row < 3; ++row )
+        {
+            for( int column = 0; column < 3; ++column )
+                {
+                    if( 1 == row && 1 == column ) continue;
+
+                    const float        x       = (float)column * 5.0F - 5.0F;
+                    const float        y       = (float)row * 5.0F - 5.0F;
+                    const RenderVertex quad[4] = { MakeVertex( x, y ), MakeVertex( x + 10, y ),
+                                                   MakeVertex( x + 10, y + 10 ), MakeVertex( x, y + 10 ) };
+                    CHECK( IsValidClip( quad, 4, pieces, ClipPrimitive( quad, 4, box, pieces ) ) );
+
+                    // Both halves, wound either way
+                    const RenderVertex lower[3] = { quad[0], quad[1], quad[2] };
+                    const RenderVertex upper[3] = { quad[3], quad[2], quad[0] };
+                    CHECK( IsValidClip( lower, 3, pieces, ClipPrimitive( lower, 3, box, pieces ) ) );
+                    CHECK( IsValidClip( upper, 3, pieces, ClipPrimitive( upper, 3, box, pieces ) ) );
+                }
+        }
+
+    // Cut by every border, three corners of the box inside it
+    const RenderVertex large[3] = { MakeVertex( -8, -4 ), MakeVertex( 22, 3 ), MakeVertex( 2, 19 ) };
+    const int          written  = ClipPrimitive( large, 3, box, pieces );
+    CHECK_EQ( written, 9 );
+    CHECK( IsValidClip( large, 3, pieces, written ) );
+
+    const RenderVertex diamond[4] = { MakeVertex( 5, -3 ), MakeVertex( 13, 5 ), MakeVertex( 5, 13 ),
+                                      MakeVertex( -3, 5 ) };
+    CHECK( IsValidClip( diamond, 4, pieces, ClipPrimitive( diamond, 4, box, pieces ) ) );
+}
+
+TEST( clip, inside_and_outside )
+{
+    RenderVertex pieces[CLIP_MAX_VERTICES];
+
+    // Inside, borders included, the primitive is kept as it is
+    const RenderVertex inside[4] = { MakeVertex( 0, 0 ), MakeVertex( 10, 0 ), MakeVertex( 10, 10 ),
+                                     MakeVertex( 0, 10 ) };
+    REQUIRE_EQ( ClipPrimitive( inside, 4, box, pieces ), 4 );
+    for( int i = 0; i < 4; ++i ) CHECK( IsVertexAt( pieces[i], inside[i].x, inside[i].y ) );
+
+    const RenderVertex right[4] = { MakeVertex( 12, 2 ), MakeVertex( 20, 2 ), MakeVertex( 20, 8 ),
+                                    MakeVertex( 12, 8 ) };
+    CHECK_EQ( ClipPrimitive( right, 4, box, pieces ), 0 );
+
+    const RenderVertex above[3] = { MakeVertex( -5, -5 ), MakeVertex( 15, -5 ), MakeVertex( 5, -1 ) };
+    CHECK_EQ( ClipPrimitive( above, 3, box, pieces ), 0 );
+
+    // Its bounds overlap the box, the triangle itself passes by the corner
+    const RenderVertex corner[3] = { MakeVertex( 8, -10 ), MakeVertex( 20, -10 ), MakeVertex( 20, 2 ) };
+    CHECK_EQ( ClipPrimitive( corner, 3, box, pieces ), 0 );
+
+    // Touching the box at a corner or along a border leaves nothing to draw
+    const RenderVertex touching[3] = { MakeVertex( 5, -5 ), MakeVertex( 15, -5 ), MakeVertex( 15, 5 ) };
+    CHECK_EQ( ClipPrimitive( touching, 3, box, pieces ), 0 );
+
+    const RenderVertex along[4] = { MakeVertex( 10, 2 ), MakeVertex( 14, 2 ), MakeVertex( 14, 8 ),
+                                    MakeVertex( 10, 8 ) };
+    CHECK_EQ( ClipPrimitive( along, 4, box, pieces ), 0 );
+}
+
+TEST( clip, lines )
+{
+    RenderVertex pieces[CLIP_MAX_VERTICES];
+
+    const RenderVertex across[2] = { MakeVertex( -5, 5 ), MakeVertex( 15, 5 ) };
+    REQUIRE_EQ( ClipPrimitive( across, 2, box, pieces ), 2 );
+    CHECK( IsVertexAt( pieces[0], 0, 5 ) );
+    CHECK( IsVertexAt( pieces[1], 10, 5 ) );
+    CHECK( HasMatchingUV( pieces[0] ) && HasMatchingUV( pieces[1] ) );
+
+    const RenderVertex diagonal[2] = { MakeVertex( -2, 2 ), MakeVertex( 6, 14 ) };
+    REQUIRE_EQ( ClipPrimitive( diagonal, 2, box, pieces ), 2 );
+    CHECK( IsVertexAt( pieces[0], 0, 5 ) );
+    CHECK( IsVertexAt( pieces[1], 10.0F / 3.0F, 10 ) );
+    CHECK( HasMatchingUV( pieces[0] ) && HasMatchingUV( pieces[1] ) );
+
+    const RenderVertex outside[2] = { MakeVertex( -5, -1 ), MakeVertex( 15, -1 ) };
+    CHECK_EQ( ClipPrimitive( outside, 2, box, pieces ), 0 );
+}
+
+static const Camera2D cameras[] = {
+    { { 400.0F, 300.0F }, { 0.0F, 0.0F }, 0.0F, 1.0F },
+    { { 400.0F, 300.0F }, { 120.0F, -40.0F }, 30.0F, 1.0F },
+    { { 0.0F, 0.0F }, { 50.0F, 50.0F }, 0.0F, 2.5F },
+    { { 400.0F, 300.0F }, { -300.0F, 200.0F }, 90.0F, 0.5F },
+    { { 200.0F, 450.0F }, { 10.0F, 20.0F }, -135.0F, 3.0F },
+};
+
+#define CAMERA_COUNT ( (int)( sizeof( cameras ) / sizeof( cameras[0] ) ) )
+
+static float
+RandomRange( float low, float high )
+{
+    return low + ( high - low ) * (float)rand() / (float)RAND_MAX;
+}
+
+// Brute force: the box around the given points
+static ClipBox
+GetPointsBox( const Vector2 * points, int count )
+{
+    ClipBox box = { points[0].x, points[0].y, points[0].x, points[0].y };
+    for( int i = 1; i < count; ++i )
+        {
+            box.minX = fminf( box.minX, points[i].x );
+            box.minY = fminf( box.minY, points[i].y );
+            box.maxX = fmaxf( box.maxX, points[i].x );
+            box.maxY = fmaxf( box.maxY, points[i].y );
+        }
+    return box;
+}
+
+static bool
+IsBoxNear( ClipBox a, ClipBox b, float tolerance )
+{
+    return fabsf( a.minX - b.minX ) <= tolerance && fabsf( a.minY - b.minY ) <= tolerance
+        && fabsf( a.maxX - b.maxX ) <= tolerance && fabsf( a.maxY - b.maxY ) <= tolerance;
+}
+
+static bool
+IsPointInBox( Vector2 p, ClipBox box, float tolerance )
+{
+    return p.x >= box.minX - tolerance && p.x <= box.maxX + tolerance && p.y >= box.minY - tolerance
+        && p.y <= box.maxY + tolerance;
+}
+
+// Separating axes between a convex quad in screen pixels and the screen grown by `margin`
+static bool
+IsQuadOnScreen( const Vector2 * quad, float margin )
+{
+    const Vector2 screen[4] = { { -margin, -margin },
+                                { SCREEN_WIDTH + margin, -margin },
+                                { SCREEN_WIDTH + margin, SCREEN_HEIGHT + margin },
+                                { -margin, SCREEN_HEIGHT + margin } };
+
+    const ClipBox box = GetPointsBox( quad, 4 );
+    if( box.maxX < screen[0].x || box.minX > screen[2].x || box.maxY < screen[0].y || box.minY > screen[2].y )
+        {
+            return false;
+        }
+
+    for( int i = 0; i < 4; ++i )
+        {
+            const Vector2 a      = quad[i];
+            const Vector2 b      = quad[( i + 1 ) % 4];
+            const Vector2 normal = { a.y - b.y, b.x - a.x };
+
+            float quadLow = INFINITY, quadHigh = -INFINITY, screenLow = INFINITY, screenHigh = -INFINITY;
+            for( int k = 0; k < 4; ++k )
+                {
+                    const float q = normal.x * quad[k].x + normal.y * quad[k].y;
+                    const float s = normal.x * screen[k].x + normal.y * screen[k].y;
+                    quadLow       = fminf( quadLow, q );
+                    quadHigh      = fmaxf( quadHigh, q );
+                    screenLow     = fminf( screenLow, s );
+                    screenHigh    = fmaxf( screenHigh, s );
+                }
+            if( quadHigh < screenLow || screenHigh < quadLow ) return false;
+        }
+
+    return true;
+}
+
+// A PushMatrix transform, rotated or not
+static Matrix2D
+RandomTransform( bool rotated )
+{
+    const float scale = RandomRange( 0.5F, 2.0F );
+    Matrix2D    m     = Matrix2DTranslate( RandomRange( -200.0F, 200.0F ), RandomRange( -200.0F, 200.0F ) );
+    if( rotated ) m = Matrix2DMultiply( m, Matrix2DRotate( RandomRange( -PI, PI ) ) );
+    return Matrix2DMultiply( m, Matrix2DScale( scale, scale * RandomRange( 0.5F, 2.0F ) ) );
+}
+
+TEST( clip, camera_bounds )
+{
+    for( int c = 0; c < CAMERA_COUNT; ++c )
+        {
+            const Camera2D camera  = cameras[c];
+            const Matrix2D view    = GetCameraMatrix2D( camera );
+            const Matrix2D inverse = Matrix2DInvert( view );
+            const ClipBox  bounds  = GetCameraBounds( view, camera.zoom, SCREEN_WIDTH, SCREEN_HEIGHT );
+            const float    padding = 1.0F / camera.zoom;
+
+            // Every screen pixel is in the world area, its borders one screen pixel past the farthest
+            Vector2 seen[( (int)( SCREEN_WIDTH / GRID_STEP ) + 1 ) * ( (int)( SCREEN_HEIGHT / GRID_STEP ) + 1 )];
+            int     count = 0;
+            for( float y = 0.0F; y <= SCREEN_HEIGHT; y += GRID_STEP )
+                {
+                    for( float x = 0.0F; x <= SCREEN_WIDTH; x += GRID_STEP )
+                        {
+                            seen[count++] = Vector2Transform2D( ( Vector2 ){ x, y }, inverse );
+                        }
+                }
+
+            ClipBox expected = GetPointsBox( seen, count );
+            expected.minX -= padding;
+            expected.minY -= padding;
+            expected.maxX += padding;
+            expected.maxY += padding;
+            CHECK( IsBoxNear( bounds, expected, 1e-2F ) );
+        }
+}
+
+TEST( clip, transformed_areas )
+{
+    srand( 1234 );
+    for( int i = 0; i < RANDOM_AREAS; ++i )
+        {
+            const ClipBox  area = { RandomRange( -100.0F, 0.0F ), RandomRange( -100.0F, 0.0F ),
+                                    RandomRange( 0.0F, 100.0F ), RandomRange( 0.0F, 100.0F ) };
+            const Matrix2D m    = RandomTransform( 0 != i % 2 );
+
+            const Vector2 corners[4] = {
+                Vector2Transform2D( ( Vector2 ){ area.minX, area.minY }, m ),
+                Vector2Transform2D( ( Vector2 ){ area.maxX, area.minY }, m ),
+                Vector2Transform2D( ( Vector2 ){ area.maxX, area.maxY }, m ),
+                Vector2Transform2D( ( Vector2 ){ area.minX, area.maxY }, m ),
+            };
+            CHECK( IsBoxNear( TransformClipBox( area, m ), GetPointsBox( corners, 4 ), 1e-2F ) );
+        }
+}
+
+TEST( clip, area_visibility )
+{
+    srand( 5678 );
+    for( int c = 0; c < CAMERA_COUNT; ++c )
+        {
+            const Camera2D camera  = cameras[c];
+            const Matrix2D view    = GetCameraMatrix2D( camera );
+            const ClipBox  bounds  = GetCameraBounds( view, camera.zoom, SCREEN_WIDTH, SCREEN_HEIGHT );
+            const bool     aligned = 0.0F == camera.rotation;
+
+            int culledOnScreen = 0, keptOffScreen = 0, kept = 0;
+            for( int i = 0; i < RANDOM_AREAS; ++i )
+                {
+                    // Areas around the view, before a transform that stretches and moves them across the border
+                    const float   reach  = 800.0F / camera.zoom;
+                    const float   x      = camera.target.x + RandomRange( -reach, reach );
+                    const float   y      = camera.target.y + RandomRange( -reach, reach );
+                    const float   size   = RandomRange( 1.0F, 100.0F ) / camera.zoom;
+                    const ClipBox area   = { x, y, x + size, y + size * RandomRange( 0.2F, 2.0F ) };
+                    const bool    rotate = 0 != i % 2;
+                    const Matrix2D m     = RandomTransform( rotate );
+
+                    // Brute force: the corners of the area through PushMatrix and the camera onto the screen
+                    const Matrix2D toScreen  = Matrix2DMultiply( view, m );
+                    const Vector2  screen[4] = {
+                        Vector2Transform2D( ( Vector2 ){ area.minX, area.minY }, toScreen ),
+                        Vector2Transform2D( ( Vector2 ){ area.maxX, area.minY }, toScreen ),
+                        Vector2Transform2D( ( Vector2 ){ area.maxX, area.maxY }, toScreen ),
+                        Vector2Transform2D( ( Vector2 ){ area.minX, area.maxY }, toScreen ),
+                    };
+
+                    const bool visible = IsClipBoxOverlapping( TransformClipBox( area, m ), bounds );
+                    if( visible ) ++kept;
+                    if( !visible && IsQuadOnScreen( screen, 0.0F ) ) ++culledOnScreen;
+
+                    // Without rotation the boxes are exact, only the pixel of padding lets more through
+                    if( aligned && !rotate && visible && !IsQuadOnScreen( screen, 1.01F ) ) ++keptOffScreen;
+                }
+
+            CHECK_EQ( culledOnScreen, 0 );
+            CHECK_EQ( keptOffScreen, 0 );
+            CHECK( kept > 0 && kept < RANDOM_AREAS );
+        }
+}
+
+TEST( clip, visible_area )
+{
+    srand( 9012 );
+    for( int c = 0; c < CAMERA_COUNT; ++c )
+        {
+            const Camera2D camera  = cameras[c];
+            const Matrix2D view    = GetCameraMatrix2D( camera );
+            const ClipBox  bounds  = GetCameraBounds( view, camera.zoom, SCREEN_WIDTH, SCREEN_HEIGHT );
+            const float    padding = 1.0F / camera.zoom;
+
+            for( int i = 0; i < 8; ++i )
+                {
+                    // GetVisibleArea under a PushMatrix transform: the camera bounds mapped back through it
+                    const Matrix2D m       = RandomTransform( 0 != i % 2 );
+                    const Matrix2D inverse = Matrix2DInvert( m );
+                    const ClipBox  area    = TransformClipBox( bounds, inverse );
+
+                    // Brute force: screen corners back through the camera and the transform
+                    const Matrix2D toLocal = Matrix2DInvert( Matrix2DMultiply( view, m ) );
+                    const Vector2  local[4] = {
+                        Vector2Transform2D( ( Vector2 ){ 0.0F, 0.0F }, toLocal ),
+                        Vector2Transform2D( ( Vector2 ){ SCREEN_WIDTH, 0.0F }, toLocal ),
+                        Vector2Transform2D( ( Vector2 ){ SCREEN_WIDTH, SCREEN_HEIGHT }, toLocal ),
+                        Vector2Transform2D( ( Vector2 ){ 0.0F, SCREEN_HEIGHT }, toLocal ),
+                    };
+                    for( int k = 0; k < 4; ++k ) CHECK( IsPointInBox( local[k], area, 1e-2F ) );
+
+                    // Axis keeping transforms and cameras only add the padding, scaled into the local space
+                    if( 0.0F != camera.rotation || 0 != i % 2 ) continue;
+
+                    ClipBox expected = GetPointsBox( local, 4 );
+                    expected.minX -= padding / fabsf( m.m0 );
+                    expected.minY -= padding / fabsf( m.m3 );
+                    expected.maxX += padding / fabsf( m.m0 );
+                    expected.maxY += padding / fabsf( m.m3 );
+                    CHECK( IsBoxNear( area, expected, 1e-2F ) );
+                }
+        }
+}
@@ -0,0 +1,120 @@
+#include "tau/tau.h"
+
+#include "lelogformat.h"
+
+#include "levegl/levegl.h"
+
+#include <stdio.h>
+#include <string.h>
+
+#define BINARY_LOG  "levegl_test_log.bin"
+#define DECODED_LOG "levegl_test_log.txt"
+
+TEST( logformat, integer_conversions )
+{
+    LogConversion conversion = ParseLogConversion( "%d" );
+    CHECK_EQ( conversion.length, 2 );
+    CHECK_EQ( conversion.type, LOG_ARG_INT );
+    CHECK_EQ( conversion.specifier, 'd' );
+
+    CHECK_EQ( ParseLogConversion( "%hhu" ).type, LOG_ARG_INT );
+    CHECK_EQ( ParseLogConversion( "%-08x" ).type, LOG_ARG_INT );
+    CHECK_EQ( ParseLogConversion( "%ld" ).type, LOG_ARG_LONG );
+    CHECK_EQ( ParseLogConversion( "%lld" ).type, LOG_ARG_LLONG );
+    CHECK_EQ( ParseLogConversion( "%jd" ).type, LOG_ARG_LLONG );
+    CHECK_EQ( ParseLogConversion( "%zu" ).type, LOG_ARG_SIZE );
+    CHECK_EQ( ParseLogConversion( "%td" ).type, LOG_ARG_SIZE );
+    CHECK_EQ( ParseLogConversion( "%lld trailing" ).length, 4 );
+}
+
+TEST( logformat, other_conversions )
+{
+    CHECK_EQ( ParseLogConversion( "%.3f" ).type, LOG_ARG_DOUBLE );
+    CHECK_EQ( ParseLogConversion( "%e" ).type, LOG_ARG_DOUBLE );
+    CHECK_EQ( ParseLogConversion( "%Lf" ).type, LOG_ARG_LDOUBLE );
+    CHECK_EQ( ParseLogConversion( "%s" ).type, LOG_ARG_STRING );
+    CHECK_EQ( ParseLogConversion( "%p" ).type, LOG_ARG_POINTER );
+
+    const LogConversion stars = ParseLogConversion( "%*.*f" );
+    CHECK_EQ( stars.stars, 2 );
+    CHECK_EQ( stars.length, 5 );
+    CHECK_EQ( stars.type, LOG_ARG_DOUBLE );
+}
+
+TEST( logformat, no_argument )
+{
+    const LogConversion percent = ParseLogConversion( "%%" );
+    CHECK_EQ( percent.type, LOG_ARG_NONE );
+    CHECK_EQ( percent.length, 2 );
+    CHECK_EQ( percent.specifier, '%' );
+
+    // A lone '%' at the end of the format must not step over the terminator
+    const LogConversion lone = ParseLogConversion( "%" );
+    CHECK_EQ( lone.type, LOG_ARG_NONE );
+    CHECK_EQ( lone.length, 1 );
+
+    CHECK_EQ( ParseLogConversion( "%*q" ).stars, 0 );
+}
+
+// Message of a decoded line, after the "[time] [LEVEL] " prefix
+static const char *
+SkipDecodedPrefix( const char * line )
+{
+    const char * level = strstr( line, "] [" );
+    if( NULL == level ) return line;
+
+    const char * message = strstr( level + 3, "] " );
+    return ( NULL != message ) ? message + 2 : line;
+}
+
+TEST( logformat, ledecode_round_trip )
+{
+    char reused[32];
+
+    SetTraceLogBinaryFile( BINARY_LOG );
+
+    TraceLogBinary( LOG_INFO, "int %d uint %u long %ld size %zu", -5, 4000000000U, -7L, (size_t)123 );
+    TraceLogBinary( LOG_WARNING, "real %.3f stars %*.*f percent 100%%", 3.14159, 8, 2, 2.5 );
+    TraceLogBinary( LOG_ERROR, "string '%s' '%.3s' null %s", "hello", "abcdef", (char *)NULL );
+
+    // The same buffer holding another format gets its own ID
+    snprintf( reused, sizeof( reused ), "first %%d" );
+    TraceLogBinary( LOG_INFO, reused, 1 );
+    snprintf( reused, sizeof( reused ), "second %%s" );
+    TraceLogBinary( LOG_INFO, reused, "two" );
+    snprintf( reused, sizeof( reused ), "first %%d" );
+    TraceLogBinary( LOG_INFO, reused, 3 );
+
+    // Closes the file
+    SetTraceLogBinaryFile( NULL );
+
+    REQUIRE( 0 == system( "\"" LE_TEST_LEDECODE "\" " BINARY_LOG " > " DECODED_LOG ) );
+
+    static const char * expected[] = {
+        "int -5 uint 4000000000 long -7 size 123",
+        "real 3.142 stars     2.50 percent 100%",
+        "string 'hello' 'abc' null (null)",
+        "first 1",
+        "second two",
+        "first 3",
+    };
+    const int expectedCount = (int)( sizeof( expected ) / sizeof( expected[0] ) );
+
+    FILE * file = fopen( DECODED_LOG, "r" );
+    REQUIRE( NULL != file );
+
+    char line[256];
+    int  count = 0;
+    while( NULL != fgets( line, sizeof( line ), file ) )
+        {
+            line[strcspn( line, "\n" )] = '\0';
+            if( count < expectedCount ) CHECK_STREQ( SkipDecodedPrefix( line ), expected[count] );
+            ++count;
+        }
+    fclose( file );
+
+    CHECK_EQ( count, expectedCount );
+
+    remove( BINARY_LOG );
+    remove( DECODED_LOG );
+}
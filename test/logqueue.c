@@ -0,0 +1,118 @@
+#include "tau/tau.h"
+
+#include "lesystem.h"
+
+#include "levegl/levegl.h"
+
+#include <stdio.h>
+
+#define PRODUCERS        4
+#define PRODUCE_MESSAGES 2000
+
+static long received = 0;
+static long dropped  = 0;
+static long lastSeen[PRODUCERS];
+static long outOfOrder = 0;
+static long stopping   = 0;
+
+static void
+CountMessage( int logLevel, const char * text, va_list args )
+{
+    (void)logLevel;
+
+    int  producer = 0;
+    long message  = 0;
+    long lost     = 0;
+
+    char line[256];
+    vsnprintf( line, sizeof( line ), text, args );
+
+    if( 1 == sscanf( line, "LOG: %ld messages dropped", &lost ) )
+        {
+            leAtomicAdd( &dropped, lost );
+            return;
+        }
+
+    if( 2 != sscanf( line, "producer %d message %ld", &producer, &message ) ) return;
+
+    // Records of one producer leave the queue in the order they were pushed
+    if( message <= lastSeen[producer] ) leAtomicAdd( &outOfOrder, 1 );
+    lastSeen[producer] = message;
+    leAtomicAdd( &received, 1 );
+}
+
+static void
+Produce( void * userData )
+{
+    const int producer = (int)(size_t)userData;
+    for( long i = 0; i < PRODUCE_MESSAGES; ++i ) TraceLog( LOG_INFO, "producer %d message %ld", producer, i );
+}
+
+static void
+ResetCounters( void )
+{
+    received = dropped = outOfOrder = 0;
+    for( int i = 0; i < PRODUCERS; ++i ) lastSeen[i] = -1;
+}
+
+TEST( logqueue, every_message_is_written_or_reported )
+{
+    ResetCounters();
+    SetTraceLogCallback( CountMessage );
+    SetTraceLogAsync( true );
+
+    leThread threads[PRODUCERS];
+    for( int i = 0; i < PRODUCERS; ++i ) REQUIRE( leThreadCreate( &threads[i], Produce, (void *)(size_t)i ) );
+    for( int i = 0; i < PRODUCERS; ++i ) leThreadJoin( &threads[i] );
+
+    // Disabling drains the queue before returning
+    SetTraceLogAsync( false );
+    SetTraceLogCallback( NULL );
+
+    CHECK_EQ( received + dropped, (long)( PRODUCERS * PRODUCE_MESSAGES ) );
+    CHECK_EQ( outOfOrder, 0L );
+}
+
+static void
+CountAny( int logLevel, const char * text, va_list args )
+{
+    (void)logLevel;
+    (void)text;
+    (void)args;
+
+    leAtomicAdd( &received, 1 );
+}
+
+static void
+ProduceUntilStopped( void * userData )
+{
+    while( 0 == leAtomicLoad( &stopping ) ) TraceLog( LOG_INFO, "producer %d", (int)(size_t)userData );
+}
+
+TEST( logqueue, toggling_while_producers_log )
+{
+    ResetCounters();
+    stopping = 0;
+    SetTraceLogCallback( CountAny );
+
+    leThread threads[PRODUCERS];
+    for( int i = 0; i < PRODUCERS; ++i )
+        {
+            REQUIRE( leThreadCreate( &threads[i], ProduceUntilStopped, (void *)(size_t)i ) );
+        }
+
+    // Producers holding the queue while it is swapped out finish their push before it is freed
+    for( int i = 0; i < 100; ++i )
+        {
+            SetTraceLogAsync( true );
+            leThreadSleep( 100000 );
+            SetTraceLogAsync( false );
+        }
+
+    leAtomicStore( &stopping, 1 );
+    for( int i = 0; i < PRODUCERS; ++i ) leThreadJoin( &threads[i] );
+
+    SetTraceLogCallback( NULL );
+
+    CHECK( leAtomicLoad( &received ) > 0 );
+}
@@ -0,0 +1,201 @@
+#include "tau/tau.h"
+
+#include "levegl/lemath.h"
+#include "levegl/levegl.h"
+
+#define EPSILON 1e-4F
+
+static bool
+NearlyEqual( float a, float b )
+{
+    return fabsf( a - b ) <= EPSILON * ( 1.0F + fabsf( a ) + fabsf( b ) );
+}
+
+static bool
+Vector2Equals( Vector2 a, Vector2 b )
+{
+    return NearlyEqual( a.x, b.x ) && NearlyEqual( a.y, b.y );
+}
+
+static bool
+Matrix2DEquals( Matrix2D a, Matrix2D b )
+{
+    return NearlyEqual( a.m0, b.m0 ) && NearlyEqual( a.m1, b.m1 ) && NearlyEqual( a.m2, b.m2 )
+        && NearlyEqual( a.m3, b.m3 ) && NearlyEqual( a.m4, b.m4 ) && NearlyEqual( a.m5, b.m5 );
+}
+
+// Column-major reference product, independent of the SIMD paths
+static Matrix
+MultiplyReference( Matrix a, Matrix b )
+{
+    const float * left  = &a.m0;
+    const float * right = &b.m0;
+
+    Matrix  result;
+    float * out = &result.m0;
+    for( int column = 0; column < 4; ++column )
+        {
+            for( int row = 0; row < 4; ++row )
+                {
+                    float sum = 0.0F;
+                    for( int k = 0; k < 4; ++k ) sum += left[k * 4 + row] * right[column * 4 + k];
+                    out[column * 4 + row] = sum;
+                }
+        }
+
+    return result;
+}
+
+TEST( math, vector2 )
+{
+    const Vector2 a = { 3.0F, 4.0F };
+    const Vector2 b = { -1.0F, 2.0F };
+
+    CHECK( Vector2Equals( Vector2Add( a, b ), ( Vector2 ){ 2.0F, 6.0F } ) );
+    CHECK( Vector2Equals( Vector2Subtract( a, b ), ( Vector2 ){ 4.0F, 2.0F } ) );
+    CHECK( NearlyEqual( Vector2Dot( a, b ), 5.0F ) );
+    CHECK( NearlyEqual( Vector2Length( a ), 5.0F ) );
+    CHECK( Vector2Equals( Vector2Normalize( a ), ( Vector2 ){ 0.6F, 0.8F } ) );
+    CHECK( Vector2Equals( Vector2Lerp( a, b, 0.5F ), ( Vector2 ){ 1.0F, 3.0F } ) );
+
+    // Zero vectors are left alone instead of dividing by zero
+    CHECK( Vector2Equals( Vector2Normalize( ( Vector2 ){ 0.0F, 0.0F } ), ( Vector2 ){ 0.0F, 0.0F } ) );
+}
+
+TEST( math, matrix2d_order )
+{
+    // Transforming by a * b applies b first: rotate (1, 0) a quarter turn, then move it
+    const Matrix2D transform = Matrix2DMultiply( Matrix2DTranslate( 10.0F, 0.0F ), Matrix2DRotate( PI / 2.0F ) );
+    CHECK( Vector2Equals( Vector2Transform2D( ( Vector2 ){ 1.0F, 0.0F }, transform ), ( Vector2 ){ 10.0F, 1.0F } ) );
+
+    const Matrix2D scaled = Matrix2DMultiply( Matrix2DScale( 2.0F, 3.0F ), Matrix2DTranslate( 1.0F, 1.0F ) );
+    CHECK( Vector2Equals( Vector2Transform2D( ( Vector2 ){ 0.0F, 0.0F }, scaled ), ( Vector2 ){ 2.0F, 3.0F } ) );
+}
+
+TEST( math, matrix2d_invert )
+{
+    const Matrix2D transform = Matrix2DMultiply(
+        Matrix2DTranslate( 5.0F, -3.0F ), Matrix2DMultiply( Matrix2DRotate( 0.7F ), Matrix2DScale( 2.0F, 0.5F ) ) );
+
+    CHECK( Matrix2DEquals( Matrix2DMultiply( transform, Matrix2DInvert( transform ) ), Matrix2DIdentity() ) );
+    CHECK( Matrix2DEquals( Matrix2DMultiply( Matrix2DInvert( transform ), transform ), Matrix2DIdentity() ) );
+
+    // Singular transforms invert to the identity
+    CHECK( Matrix2DEquals( Matrix2DInvert( Matrix2DScale( 0.0F, 1.0F ) ), Matrix2DIdentity() ) );
+}
+
+TEST( math, matrix_multiply )
+{
+    Matrix a;
+    Matrix b;
+    for( int i = 0; i < 16; ++i )
+        {
+            ( &a.m0 )[i] = (float)( i + 1 ) * 0.5F;
+            ( &b.m0 )[i] = (float)( 16 - i ) * 0.25F - 1.0F;
+        }
+
+    const Matrix product   = MatrixMultiply( a, b );
+    const Matrix reference = MultiplyReference( a, b );
+    for( int i = 0; i < 16; ++i ) CHECK( NearlyEqual( ( &product.m0 )[i], ( &reference.m0 )[i] ) );
+
+    const Matrix identity = MatrixMultiply( a, MatrixIdentity() );
+    for( int i = 0; i < 16; ++i ) CHECK( NearlyEqual( ( &identity.m0 )[i], ( &a.m0 )[i] ) );
+}
+
+TEST( math, matrix_from_matrix2d )
+{
+    const Matrix2D transform = Matrix2DMultiply( Matrix2DTranslate( -2.0F, 7.0F ), Matrix2DRotate( 1.1F ) );
+    const Matrix   matrix    = MatrixFromMatrix2D( transform );
+    const Vector2  point     = { 3.0F, -4.0F };
+
+    CHECK( Vector2Equals( Vector2Transform( point, matrix ), Vector2Transform2D( point, transform ) ) );
+}
+
+TEST( math, matrix_ortho )
+{
+    const Matrix  ortho   = MatrixOrtho( 0.0F, 800.0F, 600.0F, 0.0F, -1.0F, 1.0F );
+    const Vector2 topLeft = Vector2Transform( ( Vector2 ){ 0.0F, 0.0F }, ortho );
+    const Vector2 bottom  = Vector2Transform( ( Vector2 ){ 800.0F, 600.0F }, ortho );
+
+    CHECK( Vector2Equals( topLeft, ( Vector2 ){ -1.0F, 1.0F } ) );
+    CHECK( Vector2Equals( bottom, ( Vector2 ){ 1.0F, -1.0F } ) );
+}
+
+TEST( math, batches_match_single_points )
+{
+    const Matrix2D transform = Matrix2DMultiply( Matrix2DTranslate( 4.0F, -1.0F ), Matrix2DRotate( 0.3F ) );
+
+    // An odd count runs both the paired SIMD loop and the scalar tail
+    Vector2 source[7];
+    Vector2 batch[7];
+    for( int i = 0; i < 7; ++i ) source[i] = ( Vector2 ){ (float)i, (float)( i * i ) - 3.0F };
+
+    Vector2TransformArray2D( batch, source, 7, transform );
+    for( int i = 0; i < 7; ++i ) CHECK( Vector2Equals( batch[i], Vector2Transform2D( source[i], transform ) ) );
+
+    // In place
+    Vector2 aliased[7];
+    for( int i = 0; i < 7; ++i ) aliased[i] = source[i];
+    Vector2TransformArray2D( aliased, aliased, 7, transform );
+    for( int i = 0; i < 7; ++i ) CHECK( Vector2Equals( aliased[i], batch[i] ) );
+
+    Vector2TransformArray( aliased, source, 7, MatrixFromMatrix2D( transform ) );
+    for( int i = 0; i < 7; ++i ) CHECK( Vector2Equals( aliased[i], batch[i] ) );
+}
+
+TEST( math, strided_leaves_other_fields )
+{
+    typedef struct
+    {
+        float        x, y;
+        unsigned int color;
+        float        u, v;
+    } Vertex;
+
+    const Matrix2D transform = Matrix2DMultiply( Matrix2DTranslate( 1.0F, 2.0F ), Matrix2DScale( 3.0F, -1.0F ) );
+
+    Vertex vertices[5];
+    for( int i = 0; i < 5; ++i )
+        {
+            vertices[i] = ( Vertex ){ (float)i, (float)-i, 0xA0B0C0D0U + (unsigned int)i, 0.25F, 0.75F };
+        }
+
+    Vector2TransformStrided( vertices, 5, (int)sizeof( Vertex ), transform );
+
+    for( int i = 0; i < 5; ++i )
+        {
+            const Vector2 expected = Vector2Transform2D( ( Vector2 ){ (float)i, (float)-i }, transform );
+            CHECK( Vector2Equals( ( Vector2 ){ vertices[i].x, vertices[i].y }, expected ) );
+            CHECK_EQ( vertices[i].color, 0xA0B0C0D0U + (unsigned int)i );
+            CHECK( 0.25F == vertices[i].u && 0.75F == vertices[i].v );
+        }
+}
+
+TEST( math, vector4_batch )
+{
+    Matrix matrix;
+    for( int i = 0; i < 16; ++i ) ( &matrix.m0 )[i] = (float)( i % 5 ) - 1.5F;
+
+    Vector4 source[3] = { { 1.0F, 2.0F, 3.0F, 1.0F }, { -1.0F, 0.5F, 0.0F, 1.0F }, { 0.0F, 0.0F, 2.0F, 0.0F } };
+    Vector4 batch[3];
+    Vector4TransformArray( batch, source, 3, matrix );
+
+    for( int i = 0; i < 3; ++i )
+        {
+            const Vector4 expected = Vector4Transform( source[i], matrix );
+            CHECK( NearlyEqual( batch[i].x, expected.x ) && NearlyEqual( batch[i].y, expected.y ) );
+            CHECK( NearlyEqual( batch[i].z, expected.z ) && NearlyEqual( batch[i].w, expected.w ) );
+        }
+}
+
+TEST( math, transform_stack_without_context )
+{
+    // The stack belongs to the recording stream of a context, without one every call is a no-op
+    PushMatrix();
+    Translate( 10.0F, 20.0F );
+    Rotate( 45.0F );
+    CHECK( Matrix2DEquals( GetMatrix(), Matrix2DIdentity() ) );
+    PopMatrix();
+    PopMatrix();
+    CHECK( Matrix2DEquals( GetMatrix(), Matrix2DIdentity() ) );
+}
@@ -0,0 +1,79 @@
+#include "tau/tau.h"
+
+#include "lememory.h"
+
+#include "levegl/legl.h"
+#include "levegl/levegl.h"
+
+#define TRACKED_IDS 1000
+
+// Only their addresses are used, as context owners
+static int firstOwner;
+static int secondOwner;
+
+static size_t
+GetTrackedTextureBytes( void )
+{
+    return GetMemoryStats().gpuTextures.bytes;
+}
+
+TEST( memory, gpu_objects_survive_erasure )
+{
+    const size_t base     = GetTrackedTextureBytes();
+    size_t       expected = 0;
+
+    // Enough objects to grow the table several times, the same IDs under two owners
+    for( unsigned int id = 1; id <= TRACKED_IDS; ++id )
+        {
+            TrackGpuMemory( &firstOwner, LE_GPU_MEMORY_TEXTURE, id, id * 4 );
+            TrackGpuMemory( &secondOwner, LE_GPU_MEMORY_TEXTURE, id, id * 8 );
+            expected += id * 12;
+        }
+    CHECK_EQ( GetTrackedTextureBytes() - base, expected );
+
+    // Holes in the middle of probe chains, entries behind them shift back
+    for( unsigned int id = 1; id <= TRACKED_IDS; id += 3 )
+        {
+            TrackGpuMemory( &firstOwner, LE_GPU_MEMORY_TEXTURE, id, 0 );
+            expected -= id * 4;
+        }
+    CHECK_EQ( GetTrackedTextureBytes() - base, expected );
+
+    // Every remaining object must still be found, a lost one would be counted twice
+    for( unsigned int id = 1; id <= TRACKED_IDS; ++id )
+        {
+            if( 1 != id % 3 )
+                {
+                    TrackGpuMemory( &firstOwner, LE_GPU_MEMORY_TEXTURE, id, id * 4 + 1 );
+                    ++expected;
+                }
+            TrackGpuMemory( &secondOwner, LE_GPU_MEMORY_TEXTURE, id, id * 8 + 1 );
+            ++expected;
+        }
+    CHECK_EQ( GetTrackedTextureBytes() - base, expected );
+
+    // Releasing an object twice, or one never tracked, changes nothing
+    TrackGpuMemory( &firstOwner, LE_GPU_MEMORY_TEXTURE, 1, 0 );
+    TrackGpuMemory( &firstOwner, LE_GPU_MEMORY_BUFFER, 2, 0 );
+    CHECK_EQ( GetTrackedTextureBytes() - base, expected );
+
+    for( unsigned int id = 1; id <= TRACKED_IDS; ++id )
+        {
+            TrackGpuMemory( &firstOwner, LE_GPU_MEMORY_TEXTURE, id, 0 );
+            TrackGpuMemory( &secondOwner, LE_GPU_MEMORY_TEXTURE, id, 0 );
+        }
+    CHECK_EQ( GetTrackedTextureBytes(), base );
+    CHECK( GetMemoryStats().gpuTextures.peakBytes >= base + expected );
+}
+
+TEST( memory, cpu_categories )
+{
+    const MemoryStats before = GetMemoryStats();
+
+    TrackMemory( MEMORY_SCENES, 4096, true );
+    CHECK_EQ( GetMemoryStats().scenes.bytes, before.scenes.bytes + 4096 );
+    CHECK( GetMemoryStats().scenes.peakBytes >= before.scenes.bytes + 4096 );
+
+    TrackMemory( MEMORY_SCENES, 4096, false );
+    CHECK_EQ( GetMemoryStats().scenes.bytes, before.scenes.bytes );
+}
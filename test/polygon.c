@@ -0,0 +1,197 @@
+#include "tau/tau.h"
+
+#include "lepolygon.h"
+
+#include <math.h> /* fabsf, sinf, cosf */
+
+#define MAX_POINTS 64
+
+static bool
+IsInsidePolygon( Vector2 p, const Vector2 * points, int count )
+{
+    bool inside = false;
+    for( int i = 0, j = count - 1; i < count; j = i++ )
+        {
+            if( ( points[i].y > p.y ) != ( points[j].y > p.y )
+                && p.x < ( points[j].x - points[i].x ) * ( p.y - points[i].y ) / ( points[j].y - points[i].y )
+                             + points[i].x )
+                inside = !inside;
+        }
+    return inside;
+}
+
+// Triangles within bounds, wound like the outline, inside it and adding up to its area
+static bool
+IsValidTriangulation( const Vector2 * points, int count, const unsigned int * indices, int indexCount )
+{
+    if( indexCount <= 0 || 0 != indexCount % 3 || indexCount > 3 * ( count - 2 ) ) return false;
+
+    const float area  = GetPolygonArea( points, count );
+    float       total = 0.0F;
+    for( int i = 0; i < indexCount; i += 3 )
+        {
+            if( indices[i] >= (unsigned int)count || indices[i + 1] >= (unsigned int)count
+                || indices[i + 2] >= (unsigned int)count )
+                return false;
+
+            const Vector2 triangle[3] = { points[indices[i]], points[indices[i + 1]], points[indices[i + 2]] };
+            const float   part        = GetPolygonArea( triangle, 3 );
+            if( part * area <= 0.0F ) return false;
+
+            const Vector2 center = { ( triangle[0].x + triangle[1].x + triangle[2].x ) / 3.0F,
+                                     ( triangle[0].y + triangle[1].y + triangle[2].y ) / 3.0F };
+            if( !IsInsidePolygon( center, points, count ) ) return false;
+
+            total += part;
+        }
+
+    return fabsf( total - area ) <= 1e-3F * fabsf( area );
+}
+
+static void
+Reverse( Vector2 * points, int count )
+{
+    for( int i = 0, j = count - 1; i < j; ++i, --j )
+        {
+            const Vector2 swap = points[i];
+            points[i]          = points[j];
+            points[j]          = swap;
+        }
+}
+
+TEST( polygon, area_and_convexity )
+{
+    Vector2 square[4] = { { 0, 0 }, { 10, 0 }, { 10, 10 }, { 0, 10 } };
+    CHECK_EQ( GetPolygonArea( square, 4 ), 200.0F );
+    CHECK( IsPolygonConvex( square, 4 ) );
+
+    Reverse( square, 4 );
+    CHECK_EQ( GetPolygonArea( square, 4 ), -200.0F );
+    CHECK( IsPolygonConvex( square, 4 ) );
+
+    // Points along an edge do not make the outline concave
+    const Vector2 edged[6] = { { 0, 0 }, { 5, 0 }, { 10, 0 }, { 10, 10 }, { 5, 10 }, { 0, 10 } };
+    CHECK( IsPolygonConvex( edged, 6 ) );
+
+    const Vector2 notch[5] = { { 0, 0 }, { 10, 0 }, { 10, 10 }, { 5, 5 }, { 0, 10 } };
+    CHECK( !IsPolygonConvex( notch, 5 ) );
+}
+
+TEST( polygon, concave_outlines )
+{
+    unsigned int indices[3 * MAX_POINTS];
+
+    Vector2 shape[6] = { { 0, 0 }, { 20, 0 }, { 20, 10 }, { 10, 10 }, { 10, 20 }, { 0, 20 } };
+    CHECK( IsValidTriangulation( shape, 6, indices, TriangulatePolygon( shape, 6, indices ) ) );
+    Reverse( shape, 6 );
+    CHECK( IsValidTriangulation( shape, 6, indices, TriangulatePolygon( shape, 6, indices ) ) );
+
+    // Star, every other corner reflex
+    Vector2 star[10];
+    for( int i = 0; i < 10; ++i )
+        {
+            const float angle  = (float)i * PI / 5.0F;
+            const float radius = ( 0 == i % 2 ) ? 50.0F : 20.0F;
+            star[i]            = ( Vector2 ){ radius * cosf( angle ), radius * sinf( angle ) };
+        }
+    CHECK( IsValidTriangulation( star, 10, indices, TriangulatePolygon( star, 10, indices ) ) );
+
+    // Comb, the reflex corners at the bottom of the notches hide points from many corners
+    Vector2 comb[MAX_POINTS];
+    int     count = 0;
+    comb[count++] = ( Vector2 ){ 0, 0 };
+    comb[count++] = ( Vector2 ){ 90, 0 };
+    for( int tooth = 4; tooth >= 0; --tooth )
+        {
+            comb[count++] = ( Vector2 ){ (float)tooth * 20.0F + 10.0F, 50.0F };
+            comb[count++] = ( Vector2 ){ (float)tooth * 20.0F + 5.0F, 10.0F };
+            comb[count++] = ( Vector2 ){ (float)tooth * 20.0F, 50.0F };
+        }
+    CHECK( IsValidTriangulation( comb, count, indices, TriangulatePolygon( comb, count, indices ) ) );
+}
+
+TEST( polygon, collinear_points )
+{
+    unsigned int indices[3 * MAX_POINTS];
+
+    // Collinear corners never produce empty triangles, validation rejects those
+    const Vector2 edged[8] = { { 0, 0 }, { 5, 0 }, { 10, 0 }, { 10, 5 }, { 10, 10 }, { 5, 10 }, { 0, 10 }, { 0, 5 } };
+    CHECK( IsValidTriangulation( edged, 8, indices, TriangulatePolygon( edged, 8, indices ) ) );
+
+    const Vector2 flat[5] = { { 0, 0 }, { 10, 0 }, { 20, 0 }, { 20, 10 }, { 0, 10 } };
+    CHECK( IsValidTriangulation( flat, 5, indices, TriangulatePolygon( flat, 5, indices ) ) );
+}
+
+TEST( polygon, self_intersecting )
+{
+    unsigned int indices[3 * MAX_POINTS];
+
+    // No valid triangulation exists, it must still end within the index budget
+    const Vector2 bowtie[6] = { { 0, 0 }, { 10, 10 }, { 20, 0 }, { 20, 10 }, { 10, 0 }, { 0, 10 } };
+    const int     count     = TriangulatePolygon( bowtie, 6, indices );
+    CHECK( count > 0 && count <= 3 * 4 );
+    for( int i = 0; i < count; ++i ) CHECK( indices[i] < 6 );
+}
+
+// A distinct concave outline per index
+static void
+MakeNotch( int index, Vector2 * points )
+{
+    const float x = (float)( index % 256 ) * 20.0F;
+    const float y = (float)( index / 256 ) * 20.0F;
+    points[0]     = ( Vector2 ){ x, y };
+    points[1]     = ( Vector2 ){ x + 10.0F, y };
+    points[2]     = ( Vector2 ){ x + 10.0F, y + 10.0F };
+    points[3]     = ( Vector2 ){ x + 5.0F, y + 5.0F };
+    points[4]     = ( Vector2 ){ x, y + 10.0F };
+}
+
+static int
+CountCached( PolygonCache * cache, int first, int last, unsigned int frame )
+{
+    int found = 0;
+    for( int i = first; i < last; ++i )
+        {
+            Vector2 points[5];
+            MakeNotch( i, points );
+            if( NULL != FindPolygonEntry( cache, points, 5, HashPolygon( points, 5 ), frame ) ) ++found;
+        }
+    return found;
+}
+
+TEST( polygon, cache_keeps_outlines_of_the_frame )
+{
+    const size_t base  = GetMemoryStats().polygons.bytes;
+    PolygonCache cache = { 0 };
+    Vector2      points[5];
+
+    // Frame 1 fills the cache, one more outline cannot evict any drawn this frame
+    for( int i = 0; i < POLYGON_CACHE_SIZE; ++i )
+        {
+            MakeNotch( i, points );
+            const PolygonEntry * entry = GetPolygonEntry( &cache, points, 5, 1 );
+            REQUIRE( NULL != entry );
+            REQUIRE( IsValidTriangulation( points, 5, entry->indices, entry->indexCount ) );
+        }
+    CHECK_EQ( cache.used, POLYGON_CACHE_SIZE );
+
+    MakeNotch( POLYGON_CACHE_SIZE, points );
+    CHECK( NULL == GetPolygonEntry( &cache, points, 5, 1 ) );
+    CHECK_EQ( CountCached( &cache, 0, POLYGON_CACHE_SIZE, 1 ), POLYGON_CACHE_SIZE );
+
+    // Frame 2 draws the first half again, new outlines only replace ones it did not draw
+    const int half = POLYGON_CACHE_SIZE / 2;
+    CHECK_EQ( CountCached( &cache, 0, half, 2 ), half );
+    for( int i = 0; i < half; ++i )
+        {
+            MakeNotch( POLYGON_CACHE_SIZE + i, points );
+            CHECK( NULL != GetPolygonEntry( &cache, points, 5, 2 ) );
+        }
+    CHECK_EQ( cache.used, POLYGON_CACHE_SIZE );
+    CHECK_EQ( CountCached( &cache, 0, half, 2 ), half );
+    CHECK_EQ( CountCached( &cache, half, POLYGON_CACHE_SIZE, 2 ), 0 );
+    CHECK_EQ( CountCached( &cache, POLYGON_CACHE_SIZE, POLYGON_CACHE_SIZE + half, 2 ), half );
+
+    ReleasePolygonCache( &cache );
+    CHECK_EQ( GetMemoryStats().polygons.bytes, base );
+}
@@ -0,0 +1,202 @@
+#include "tau/tau.h"
+
+#include "levegl/levegl.h"
+
+#include <stdlib.h> /* qsort, rand */
+#include <string.h> /* memcmp */
+
+#define CELL_SIZE    32.0F
+#define RANDOM_ITEMS 500
+
+static const Color itemColor = { 1.0F, 0.0F, 0.0F, 1.0F };
+
+static int
+CompareIds( const void * a, const void * b )
+{
+    return *(const int *)a - *(const int *)b;
+}
+
+// Sorted IDs overlapping `area`, returns how many
+static int
+QuerySorted( Scene * scene, Rectangle area, int * ids, int maxIds )
+{
+    const int count = QueryScene( scene, area, ids, maxIds );
+    qsort( ids, (size_t)( ( count < maxIds ) ? count : maxIds ), sizeof( int ), CompareIds );
+    return count;
+}
+
+static bool
+Overlaps( Rectangle item, Rectangle area )
+{
+    const float minX = ( item.width < 0.0F ) ? item.x + item.width : item.x;
+    const float maxX = ( item.width < 0.0F ) ? item.x : item.x + item.width;
+    const float minY = ( item.height < 0.0F ) ? item.y + item.height : item.y;
+    const float maxY = ( item.height < 0.0F ) ? item.y : item.y + item.height;
+
+    return maxX >= area.x && minX <= area.x + area.width && maxY >= area.y && minY <= area.y + area.height;
+}
+
+static float
+RandomRange( float min, float max )
+{
+    return min + ( max - min ) * ( (float)rand() / (float)RAND_MAX );
+}
+
+TEST( scene, insert_and_query )
+{
+    Scene * scene = CreateScene( CELL_SIZE );
+    REQUIRE( NULL != scene );
+
+    const int left   = AddSceneItem( scene, SCENE_RECTANGLE, ( Rectangle ){ 0, 0, 10, 10 }, itemColor );
+    const int right  = AddSceneItem( scene, SCENE_CIRCLE, ( Rectangle ){ 200, 0, 10, 10 }, itemColor );
+    const int across = AddSceneItem( scene, SCENE_RECTANGLE_LINES, ( Rectangle ){ 20, 20, 100, 100 }, itemColor );
+    REQUIRE( left >= 0 && right >= 0 && across >= 0 );
+
+    int ids[8];
+    REQUIRE_EQ( QuerySorted( scene, ( Rectangle ){ -5, -5, 30, 30 }, ids, 8 ), 2 );
+    CHECK_EQ( ids[0], left );
+    CHECK_EQ( ids[1], across );
+
+    // Listed in several cells, reported once
+    REQUIRE_EQ( QuerySorted( scene, ( Rectangle ){ 0, 0, 150, 150 }, ids, 8 ), 2 );
+    CHECK_EQ( ids[1], across );
+
+    CHECK_EQ( QueryScene( scene, ( Rectangle ){ 500, 500, 10, 10 }, ids, 8 ), 0 );
+
+    // The total is returned even when fewer IDs fit
+    CHECK_EQ( QueryScene( scene, ( Rectangle ){ -50, -50, 400, 400 }, ids, 1 ), 3 );
+    CHECK_EQ( QueryScene( scene, ( Rectangle ){ -50, -50, 400, 400 }, NULL, 0 ), 3 );
+
+    DestroyScene( scene );
+}
+
+TEST( scene, move_and_remove )
+{
+    Scene * scene = CreateScene( CELL_SIZE );
+    REQUIRE( NULL != scene );
+
+    const int item = AddSceneItem( scene, SCENE_RECTANGLE, ( Rectangle ){ 0, 0, 10, 10 }, itemColor );
+
+    // Negative sizes describe the same box
+    MoveSceneItem( scene, item, ( Rectangle ){ 1010, 1010, -10, -10 } );
+
+    int ids[4];
+    CHECK_EQ( QueryScene( scene, ( Rectangle ){ 0, 0, 20, 20 }, ids, 4 ), 0 );
+    REQUIRE_EQ( QueryScene( scene, ( Rectangle ){ 995, 995, 10, 10 }, ids, 4 ), 1 );
+    CHECK_EQ( ids[0], item );
+
+    RemoveSceneItem( scene, item );
+    CHECK_EQ( QueryScene( scene, ( Rectangle ){ 995, 995, 10, 10 }, ids, 4 ), 0 );
+
+    // Removed IDs are reused, removing twice is harmless
+    RemoveSceneItem( scene, item );
+    CHECK_EQ( AddSceneItem( scene, SCENE_RECTANGLE, ( Rectangle ){ 5, 5, 1, 1 }, itemColor ), item );
+
+    DestroyScene( scene );
+}
+
+TEST( scene, oversized_items )
+{
+    Scene * scene = CreateScene( CELL_SIZE );
+    REQUIRE( NULL != scene );
+
+    // Far more cells than an item is listed in, kept aside and tested on every query
+    const int huge = AddSceneItem( scene, SCENE_RECTANGLE, ( Rectangle ){ -10000, -10000, 20000, 20000 }, itemColor );
+
+    int ids[4];
+    REQUIRE_EQ( QueryScene( scene, ( Rectangle ){ 9000, -9000, 1, 1 }, ids, 4 ), 1 );
+    CHECK_EQ( ids[0], huge );
+
+    MoveSceneItem( scene, huge, ( Rectangle ){ 0, 0, 10, 10 } );
+    CHECK_EQ( QueryScene( scene, ( Rectangle ){ 9000, -9000, 1, 1 }, ids, 4 ), 0 );
+    CHECK_EQ( QueryScene( scene, ( Rectangle ){ 0, 0, 1, 1 }, ids, 4 ), 1 );
+
+    DestroyScene( scene );
+}
+
+TEST( scene, empty_cells_are_released )
+{
+    Scene * scene = CreateScene( CELL_SIZE );
+    REQUIRE( NULL != scene );
+
+    const int    item   = AddSceneItem( scene, SCENE_RECTANGLE, ( Rectangle ){ 1, 1, 4, 4 }, itemColor );
+    const size_t placed = GetMemoryStats().scenes.bytes;
+
+    // Every step lands in a cell never used before, the one left behind is erased
+    for( int step = 1; step <= 1000; ++step )
+        {
+            MoveSceneItem( scene, item, ( Rectangle ){ step * CELL_SIZE + 1.0F, -step * CELL_SIZE + 1.0F, 4, 4 } );
+        }
+    CHECK_EQ( GetMemoryStats().scenes.bytes, placed );
+
+    int ids[4];
+    REQUIRE_EQ( QueryScene( scene, ( Rectangle ){ 1000 * CELL_SIZE, -1000 * CELL_SIZE, 8, 8 }, ids, 4 ), 1 );
+    CHECK_EQ( ids[0], item );
+
+    DestroyScene( scene );
+}
+
+TEST( scene, matches_brute_force )
+{
+    static Rectangle bounds[RANDOM_ITEMS];
+    static int       ids[RANDOM_ITEMS];
+    static bool      alive[RANDOM_ITEMS];
+    static int       found[RANDOM_ITEMS];
+    static int       expected[RANDOM_ITEMS];
+
+    Scene * scene = CreateScene( CELL_SIZE );
+    REQUIRE( NULL != scene );
+
+    srand( 1234 );
+    for( int i = 0; i < RANDOM_ITEMS; ++i )
+        {
+            bounds[i] = ( Rectangle ){ RandomRange( -1000, 1000 ), RandomRange( -1000, 1000 ), RandomRange( -60, 60 ),
+                                       RandomRange( 1, 60 ) };
+            ids[i]    = AddSceneItem( scene, SCENE_RECTANGLE, bounds[i], itemColor );
+            alive[i]  = true;
+            REQUIRE( ids[i] >= 0 );
+        }
+
+    int mismatches = 0;
+    for( int round = 0; round < 200; ++round )
+        {
+            // Erased cells shift their probe chains, every remaining cell must still be found
+            for( int change = 0; change < 50; ++change )
+                {
+                    const int i = rand() % RANDOM_ITEMS;
+                    if( !alive[i] )
+                        {
+                            ids[i]   = AddSceneItem( scene, SCENE_CIRCLE, bounds[i], itemColor );
+                            alive[i] = true;
+                        }
+                    else if( 0 == rand() % 3 )
+                        {
+                            RemoveSceneItem( scene, ids[i] );
+                            alive[i] = false;
+                        }
+                    else
+                        {
+                            bounds[i].x += RandomRange( -100, 100 );
+                            bounds[i].y += RandomRange( -100, 100 );
+                            MoveSceneItem( scene, ids[i], bounds[i] );
+                        }
+                }
+
+            const float     size = ( 0 == round % 10 ) ? 3000.0F : 300.0F;
+            const Rectangle area = { RandomRange( -1200, 1200 ), RandomRange( -1200, 1200 ), size, size };
+
+            int count = 0;
+            for( int i = 0; i < RANDOM_ITEMS; ++i )
+                {
+                    if( alive[i] && Overlaps( bounds[i], area ) ) expected[count++] = ids[i];
+                }
+            qsort( expected, (size_t)count, sizeof( int ), CompareIds );
+
+            if( count != QuerySorted( scene, area, found, RANDOM_ITEMS ) ) ++mismatches;
+            else if( 0 != memcmp( found, expected, (size_t)count * sizeof( int ) ) ) ++mismatches;
+        }
+
+    CHECK_EQ( mismatches, 0 );
+
+    DestroyScene( scene );
+}
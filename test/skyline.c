@@ -0,0 +1,140 @@
+#include "tau/tau.h"
+
+#include "leskyline.h"
+
+#include "levegl/levegl.h"
+
+#include <stdlib.h> /* rand */
+
+#define PAGE_SIZE   512
+#define RANDOM_FILL 400
+
+typedef struct Placed
+{
+    int x, y, width, height;
+} Placed;
+
+static bool
+Intersects( Placed a, Placed b )
+{
+    return a.x < b.x + b.width && b.x < a.x + a.width && a.y < b.y + b.height && b.y < a.y + a.height;
+}
+
+// Segments sorted by x, touching each other and covering the page width
+static bool
+CoversPage( const AtlasSkyline * skyline )
+{
+    int x = 0;
+    for( int i = 0; i < skyline->nodeCount; ++i )
+        {
+            if( skyline->nodes[i].x != x || skyline->nodes[i].width <= 0 ) return false;
+            if( i > 0 && skyline->nodes[i].y == skyline->nodes[i - 1].y ) return false;
+            x += skyline->nodes[i].width;
+        }
+
+    return x == skyline->size;
+}
+
+TEST( skyline, bottom_left )
+{
+    AtlasSkyline skyline;
+    REQUIRE( InitSkyline( &skyline, 256 ) );
+
+    int x = -1, y = -1;
+    REQUIRE( PackSkyline( &skyline, 64, 32, &x, &y ) );
+    CHECK( 0 == x && 0 == y );
+
+    REQUIRE( PackSkyline( &skyline, 32, 64, &x, &y ) );
+    CHECK( 64 == x && 0 == y );
+
+    // The floor to the right keeps its top lower than stacking on the first area
+    REQUIRE( PackSkyline( &skyline, 64, 16, &x, &y ) );
+    CHECK( 96 == x && 0 == y );
+
+    // Wider than the floor left on the right, rests on the highest segment it spans
+    REQUIRE( PackSkyline( &skyline, 100, 8, &x, &y ) );
+    CHECK( 96 == x && 16 == y );
+
+    CHECK( CoversPage( &skyline ) );
+
+    ReleaseSkyline( &skyline );
+}
+
+TEST( skyline, narrowest_segment_on_ties )
+{
+    AtlasSkyline skyline;
+    REQUIRE( InitSkyline( &skyline, 128 ) );
+
+    // Floors at height 16 of widths 32 and 64, split by a tall column
+    int x, y;
+    REQUIRE( PackSkyline( &skyline, 32, 16, &x, &y ) );
+    REQUIRE( PackSkyline( &skyline, 32, 128, &x, &y ) );
+    REQUIRE( PackSkyline( &skyline, 64, 16, &x, &y ) );
+    CHECK( 64 == x && 0 == y );
+
+    REQUIRE( PackSkyline( &skyline, 16, 16, &x, &y ) );
+    CHECK( 0 == x && 16 == y );
+
+    ReleaseSkyline( &skyline );
+}
+
+TEST( skyline, full_page )
+{
+    AtlasSkyline skyline;
+    REQUIRE( InitSkyline( &skyline, 64 ) );
+
+    int x, y;
+    CHECK( !PackSkyline( &skyline, 65, 1, &x, &y ) );
+    CHECK( !PackSkyline( &skyline, 1, 65, &x, &y ) );
+
+    // A row of equal areas leaves one flat segment
+    for( int i = 0; i < 4; ++i )
+        {
+            REQUIRE( PackSkyline( &skyline, 16, 16, &x, &y ) );
+            CHECK( 16 * i == x && 0 == y );
+        }
+    CHECK_EQ( skyline.nodeCount, 1 );
+    CHECK_EQ( skyline.nodes[0].y, 16 );
+
+    REQUIRE( PackSkyline( &skyline, 64, 48, &x, &y ) );
+    CHECK( 0 == x && 16 == y );
+    CHECK( !PackSkyline( &skyline, 1, 1, &x, &y ) );
+
+    ReleaseSkyline( &skyline );
+}
+
+TEST( skyline, random_fill )
+{
+    static Placed placed[RANDOM_FILL];
+
+    const size_t base = GetMemoryStats().images.bytes;
+
+    AtlasSkyline skyline;
+    REQUIRE( InitSkyline( &skyline, PAGE_SIZE ) );
+
+    srand( 4321 );
+    int count    = 0;
+    int overlaps = 0;
+    for( int attempt = 0; attempt < RANDOM_FILL; ++attempt )
+        {
+            Placed area = { 0, 0, 1 + rand() % 48, 1 + rand() % 48 };
+            if( !PackSkyline( &skyline, area.width, area.height, &area.x, &area.y ) ) continue;
+
+            CHECK( area.x >= 0 && area.x + area.width <= PAGE_SIZE );
+            CHECK( area.y >= 0 && area.y + area.height <= PAGE_SIZE );
+            for( int i = 0; i < count; ++i )
+                {
+                    if( Intersects( placed[i], area ) ) ++overlaps;
+                }
+            placed[count++] = area;
+        }
+
+    CHECK_EQ( overlaps, 0 );
+    CHECK( count > RANDOM_FILL / 2 );
+    CHECK( CoversPage( &skyline ) );
+
+    // Grown node arrays are accounted and given back
+    CHECK( skyline.nodeCapacity > LE_SKYLINE_INITIAL_NODES );
+    ReleaseSkyline( &skyline );
+    CHECK_EQ( GetMemoryStats().images.bytes, base );
+}
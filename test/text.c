@@ -0,0 +1,182 @@
+#include "tau/tau.h"
+
+#include "letruetype.h"
+
+#include <string.h> /* strlen */
+
+// Offsets of the subtables in the test 'cmap'
+#define FORMAT4_OFFSET  20
+#define FORMAT12_OFFSET 80
+#define CMAP_SIZE       120
+
+static void
+Put16( unsigned char * bytes, unsigned int value )
+{
+    bytes[0] = (unsigned char)( value >> 8 );
+    bytes[1] = (unsigned char)value;
+}
+
+static void
+Put32( unsigned char * bytes, unsigned int value )
+{
+    Put16( bytes, value >> 16 );
+    Put16( bytes + 2, value );
+}
+
+// A 'cmap' with a format 4 subtable (Windows BMP) and a format 12 one (Windows full repertoire)
+static void
+BuildCharacterMap( unsigned char * cmap, int tableCount )
+{
+    memset( cmap, 0, CMAP_SIZE );
+
+    Put16( cmap + 2, (unsigned int)tableCount );
+    Put16( cmap + 4, 3 );
+    Put16( cmap + 6, 1 );
+    Put32( cmap + 8, FORMAT4_OFFSET );
+    Put16( cmap + 12, 3 );
+    Put16( cmap + 14, 10 );
+    Put32( cmap + 16, FORMAT12_OFFSET );
+
+    // Three segments: A-C by delta, alpha-beta through the glyph array, and the closing 0xFFFF
+    unsigned char * format4 = cmap + FORMAT4_OFFSET;
+    Put16( format4, 4 );
+    Put16( format4 + 2, 44 );
+    Put16( format4 + 6, 6 );
+    Put16( format4 + 14, 'C' );
+    Put16( format4 + 16, 0x03B2 );
+    Put16( format4 + 18, 0xFFFF );
+    Put16( format4 + 22, 'A' );
+    Put16( format4 + 24, 0x03B1 );
+    Put16( format4 + 26, 0xFFFF );
+    Put16( format4 + 28, ( 10U - 'A' ) & 0xFFFF );
+    Put16( format4 + 32, 1 );
+    Put16( format4 + 36, 4 ); // From its own slot to the glyph array
+    Put16( format4 + 40, 20 );
+    Put16( format4 + 42, 0 );
+
+    unsigned char * format12 = cmap + FORMAT12_OFFSET;
+    Put16( format12, 12 );
+    Put32( format12 + 4, 40 );
+    Put32( format12 + 12, 2 );
+    Put32( format12 + 16, 'A' );
+    Put32( format12 + 20, 'Z' );
+    Put32( format12 + 24, 100 );
+    Put32( format12 + 28, 0x1F600 );
+    Put32( format12 + 32, 0x1F64F );
+    Put32( format12 + 36, 200 );
+}
+
+TEST( text, cmap_format12_first )
+{
+    unsigned char cmap[CMAP_SIZE];
+    BuildCharacterMap( cmap, 2 );
+
+    CharacterMap map;
+    REQUIRE( SelectCharacterMap( &map, cmap, CMAP_SIZE, 0, CMAP_SIZE ) );
+    CHECK_EQ( map.format, 12 );
+
+    CHECK_EQ( FindGlyphIndex( &map, 'A' ), 100 );
+    CHECK_EQ( FindGlyphIndex( &map, 'Z' ), 125 );
+    CHECK_EQ( FindGlyphIndex( &map, '@' ), 0 );
+    CHECK_EQ( FindGlyphIndex( &map, 0x1F600 ), 200 );
+    CHECK_EQ( FindGlyphIndex( &map, 0x1F64F ), 279 );
+    CHECK_EQ( FindGlyphIndex( &map, 0x1F650 ), 0 );
+}
+
+TEST( text, cmap_format4 )
+{
+    unsigned char cmap[CMAP_SIZE];
+    BuildCharacterMap( cmap, 1 );
+
+    CharacterMap map;
+    REQUIRE( SelectCharacterMap( &map, cmap, CMAP_SIZE, 0, CMAP_SIZE ) );
+    CHECK_EQ( map.format, 4 );
+
+    CHECK_EQ( FindGlyphIndex( &map, 'A' ), 10 );
+    CHECK_EQ( FindGlyphIndex( &map, 'C' ), 12 );
+    CHECK_EQ( FindGlyphIndex( &map, '@' ), 0 );
+    CHECK_EQ( FindGlyphIndex( &map, 'D' ), 0 );
+    CHECK_EQ( FindGlyphIndex( &map, 0x03B1 ), 20 );
+    CHECK_EQ( FindGlyphIndex( &map, 0x03B2 ), 0 );
+    CHECK_EQ( FindGlyphIndex( &map, 0xFFFF ), 0 );
+    CHECK_EQ( FindGlyphIndex( &map, 0x1F600 ), 0 );
+}
+
+TEST( text, cmap_bounds )
+{
+    unsigned char cmap[CMAP_SIZE];
+    BuildCharacterMap( cmap, 1 );
+
+    // The glyph array lies past the end of the data, lookups through it miss
+    CharacterMap map;
+    REQUIRE( SelectCharacterMap( &map, cmap, FORMAT4_OFFSET + 40, 0, FORMAT4_OFFSET + 40 ) );
+    CHECK_EQ( FindGlyphIndex( &map, 'B' ), 11 );
+    CHECK_EQ( FindGlyphIndex( &map, 0x03B1 ), 0 );
+
+    // Segments cut short
+    REQUIRE( SelectCharacterMap( &map, cmap, FORMAT4_OFFSET + 20, 0, FORMAT4_OFFSET + 20 ) );
+    CHECK_EQ( FindGlyphIndex( &map, 'B' ), 0 );
+
+    // Groups cut short
+    BuildCharacterMap( cmap, 2 );
+    REQUIRE( SelectCharacterMap( &map, cmap, CMAP_SIZE - 4, 0, CMAP_SIZE - 4 ) );
+    CHECK_EQ( map.format, 12 );
+    CHECK_EQ( FindGlyphIndex( &map, 'A' ), 0 );
+
+    // Only Macintosh encodings
+    Put16( cmap + 4, 1 );
+    Put16( cmap + 12, 1 );
+    CHECK( !SelectCharacterMap( &map, cmap, CMAP_SIZE, 0, CMAP_SIZE ) );
+    CHECK( !SelectCharacterMap( &map, cmap, CMAP_SIZE, 0, 2 ) );
+}
+
+// Codepoints of a whole string, returns how many
+static int
+DecodeString( const char * text, int * codepoints, int maxCodepoints )
+{
+    const int length = (int)strlen( text );
+    int       count  = 0;
+    for( int i = 0; i < length && count < maxCodepoints; )
+        {
+            int bytes           = 0;
+            codepoints[count++] = DecodeCodepoint( (const unsigned char *)text + i, length - i, &bytes );
+            i += bytes;
+        }
+
+    return count;
+}
+
+TEST( text, utf8_sequences )
+{
+    int bytes = 0;
+    CHECK_EQ( DecodeCodepoint( (const unsigned char *)"A", 1, &bytes ), 'A' );
+    CHECK_EQ( bytes, 1 );
+    CHECK_EQ( DecodeCodepoint( (const unsigned char *)"\xC3\xA9", 2, &bytes ), 0xE9 );
+    CHECK_EQ( bytes, 2 );
+    CHECK_EQ( DecodeCodepoint( (const unsigned char *)"\xE2\x82\xAC", 3, &bytes ), 0x20AC );
+    CHECK_EQ( bytes, 3 );
+    CHECK_EQ( DecodeCodepoint( (const unsigned char *)"\xF0\x9F\x98\x80", 4, &bytes ), 0x1F600 );
+    CHECK_EQ( bytes, 4 );
+}
+
+TEST( text, utf8_malformed )
+{
+    int bytes = 0;
+
+    // Sequences running past the end of the string are not read
+    CHECK_EQ( DecodeCodepoint( (const unsigned char *)"\xE2\x82\xAC", 2, &bytes ), 0xFFFD );
+    CHECK_EQ( bytes, 1 );
+
+    CHECK_EQ( DecodeCodepoint( (const unsigned char *)"\x80", 1, &bytes ), 0xFFFD );
+    CHECK_EQ( bytes, 1 );
+    CHECK_EQ( DecodeCodepoint( (const unsigned char *)"\xF8\x80\x80\x80\x80", 5, &bytes ), 0xFFFD );
+    CHECK_EQ( bytes, 1 );
+
+    // A broken sequence stops before the byte that broke it, which decodes on its own
+    int codepoints[8];
+    REQUIRE_EQ( DecodeString( "\xE2\x82" "A\xC3\xA9\xFF", codepoints, 8 ), 4 );
+    CHECK_EQ( codepoints[0], 0xFFFD );
+    CHECK_EQ( codepoints[1], 'A' );
+    CHECK_EQ( codepoints[2], 0xE9 );
+    CHECK_EQ( codepoints[3], 0xFFFD );
+}
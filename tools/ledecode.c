@@ -0,0 +1,285 @@
+/******************************* LEDECODE ********************************
+ * ledecode: Print a LOG_BINARY file as text
+ *
+ *                                NOTES
+ * ------------------------------------------------------------------------
+ * INFO:
+ *   - Usage: ledecode [levegl_log.bin]
+ *   - Lines are "[seconds] [LEVEL] message", seconds counted from the first
+ *     record of the file.
+ *   - Must be built for the same byte order and type sizes as the program
+ *     that wrote the file.
+ *
+ *                               LICENSE
+ * ------------------------------------------------------------------------
+ * Copyright (c) 2024-2025 SOHNE, Leandro Peres (@zschzen)
+ *
+ * This software is provided "as-is", without any express or implied warranty. In no event
+ * will the authors be held liable for any damages arising from the use of this software.
+ *
+ * Permission is granted to anyone to use this software for any purpose, including commercial
+ * applications, and to alter it and redistribute it freely, subject to the following restrictions:
+ *
+ *   1. The origin of this software must not be misrepresented; you must not claim that you
+ *   wrote the original software. If you use this software in a product, an acknowledgment
+ *   in the product documentation would be appreciated but is not required.
+ *
+ *   2. Altered source versions must be plainly marked as such, and must not be misrepresented
+ *   as being the original software.
+ *
+ *   3. This notice may not be removed or altered from any source distribution.
+ *
+ *************************************************************************/
+
+#include "lelogformat.h"
+
+#include <stddef.h> /* size_t */
+#include <stdint.h> /* uintptr_t */
+#include <stdio.h>  /* printf, fread, fopen */
+#include <stdlib.h> /* realloc, free */
+#include <string.h> /* memcpy, memcmp */
+
+//==============================================================================================================
+// TYPES
+//==============================================================================================================
+// Payload being decoded, reads past the end yield zeros
+typedef struct PayloadReader
+{
+    const unsigned char * data;
+    size_t                size;
+    size_t                offset;
+} PayloadReader;
+
+//==============================================================================================================
+// VARIABLES
+//==============================================================================================================
+static char **      formats     = NULL; // Format strings indexed by ID
+static unsigned int formatCount = 0;
+
+//==============================================================================================================
+// FUNCTIONS
+//==============================================================================================================
+static const char *
+GetLevelName( int level )
+{
+    static const char * names[] = { "ALL", "TRACE", "DEBUG", "INFO", "WARNING", "ERROR", "FATAL", "NONE" };
+    return ( level >= 0 && level < (int)( sizeof( names ) / sizeof( names[0] ) ) ) ? names[level] : "UNKNOWN";
+}
+
+static void
+ReadPayload( PayloadReader * reader, void * value, size_t size )
+{
+    memset( value, 0, size );
+    if( reader->offset + size > reader->size ) return;
+
+    memcpy( value, reader->data + reader->offset, size );
+    reader->offset += size;
+}
+
+static bool
+StoreFormat( unsigned int id, const unsigned char * text, size_t size )
+{
+    if( id >= formatCount )
+        {
+            char ** grown = (char **)realloc( formats, ( id + 1 ) * sizeof( char * ) );
+            if( NULL == grown ) return false;
+
+            memset( grown + formatCount, 0, ( id + 1 - formatCount ) * sizeof( char * ) );
+            formats     = grown;
+            formatCount = id + 1;
+        }
+
+    char * copy = (char *)malloc( size + 1 );
+    if( NULL == copy ) return false;
+
+    memcpy( copy, text, size );
+    copy[size] = '\0';
+
+    free( formats[id] );
+    formats[id] = copy;
+
+    return true;
+}
+
+// Print one conversion of `format`, with its '*' values and argument taken from the payload
+static void
+PrintConversion( const char * format, LogConversion conversion, PayloadReader * reader )
+{
+    char spec[64];
+    if( conversion.length >= (int)sizeof( spec ) ) return;
+
+    memcpy( spec, format, (size_t)conversion.length );
+    spec[conversion.length] = '\0';
+
+    int stars[2] = { 0, 0 };
+    for( int i = 0; i < conversion.stars; ++i )
+        {
+            long long star;
+            ReadPayload( reader, &star, sizeof( star ) );
+            stars[i] = (int)star;
+        }
+
+// Forward the stars in front of the value, as printf expects them
+#define PRINT_VALUE( value )                                                         \
+    ( ( 0 == conversion.stars )   ? printf( spec, value )                            \
+      : ( 1 == conversion.stars ) ? printf( spec, stars[0], value )                  \
+                                  : printf( spec, stars[0], stars[1], value ) )
+
+    long long integer = 0;
+    double    real    = 0.0;
+    switch( conversion.type )
+        {
+        case LOG_ARG_INT:
+            ReadPayload( reader, &integer, sizeof( integer ) );
+            PRINT_VALUE( (int)integer );
+            break;
+        case LOG_ARG_LONG:
+            ReadPayload( reader, &integer, sizeof( integer ) );
+            PRINT_VALUE( (long)integer );
+            break;
+        case LOG_ARG_LLONG:
+            ReadPayload( reader, &integer, sizeof( integer ) );
+            PRINT_VALUE( integer );
+            break;
+        case LOG_ARG_SIZE:
+            ReadPayload( reader, &integer, sizeof( integer ) );
+            PRINT_VALUE( (size_t)integer );
+            break;
+        case LOG_ARG_POINTER:
+            ReadPayload( reader, &integer, sizeof( integer ) );
+            PRINT_VALUE( (void *)(uintptr_t)integer );
+            break;
+        case LOG_ARG_DOUBLE:
+            ReadPayload( reader, &real, sizeof( real ) );
+            PRINT_VALUE( real );
+            break;
+        case LOG_ARG_LDOUBLE:
+            ReadPayload( reader, &real, sizeof( real ) );
+            PRINT_VALUE( (long double)real );
+            break;
+        case LOG_ARG_STRING:
+            {
+                unsigned short size = 0;
+                ReadPayload( reader, &size, sizeof( size ) );
+                if( reader->offset + size > reader->size ) size = 0;
+
+                char * string = (char *)malloc( (size_t)size + 1 );
+                if( NULL == string ) return;
+
+                memcpy( string, reader->data + reader->offset, size );
+                string[size] = '\0';
+                reader->offset += size;
+
+                PRINT_VALUE( string );
+                free( string );
+            }
+            break;
+        default: break;
+        }
+
+#undef PRINT_VALUE
+}
+
+// Rebuild the message of an EVENT record from its format string
+static void
+PrintEvent( const char * format, PayloadReader * reader )
+{
+    for( const char * cursor = format; '\0' != *cursor; )
+        {
+            if( '%' != *cursor )
+                {
+                    putchar( *cursor++ );
+                    continue;
+                }
+
+            const LogConversion conversion = ParseLogConversion( cursor );
+            if( LOG_ARG_NONE == conversion.type )
+                {
+                    if( '%' == conversion.specifier ) putchar( '%' );
+                }
+            else
+                {
+                    PrintConversion( cursor, conversion, reader );
+                }
+
+            cursor += conversion.length;
+        }
+}
+
+int
+main( int argc, char ** argv )
+{
+    const char * fileName = ( argc > 1 ) ? argv[1] : "levegl_log.bin";
+
+    FILE * file = fopen( fileName, "rb" );
+    if( NULL == file )
+        {
+            fprintf( stderr, "ledecode: cannot open %s\n", fileName );
+            return 1;
+        }
+
+    char magic[LE_LOG_BINARY_MAGIC_SIZE];
+    if( 1 != fread( magic, sizeof( magic ), 1, file ) || 0 != memcmp( magic, LE_LOG_BINARY_MAGIC, sizeof( magic ) ) )
+        {
+            fprintf( stderr, "ledecode: %s is not a LeveGL binary log\n", fileName );
+            fclose( file );
+            return 1;
+        }
+
+    static unsigned char payload[0x10000];
+    LogRecordHeader      header;
+    unsigned long long   start  = 0;
+    bool                 first  = true;
+    int                  result = 0;
+
+    while( 1 == fread( &header, sizeof( header ), 1, file ) )
+        {
+            if( header.size > 0 && 1 != fread( payload, header.size, 1, file ) )
+                {
+                    fprintf( stderr, "ledecode: truncated record\n" );
+                    result = 1;
+                    break;
+                }
+
+            if( LOG_RECORD_FORMAT == header.kind )
+                {
+                    if( !StoreFormat( header.formatId, payload, header.size ) )
+                        {
+                            fprintf( stderr, "ledecode: out of memory\n" );
+                            result = 1;
+                            break;
+                        }
+                    continue;
+                }
+
+            if( first )
+                {
+                    start = header.timestamp;
+                    first = false;
+                }
+
+            printf( "[%12.6f] [%s] ", (double)( header.timestamp - start ) / 1e9, GetLevelName( header.level ) );
+
+            if( LOG_RECORD_TEXT == header.kind )
+                {
+                    fwrite( payload, 1, header.size, stdout );
+                }
+            else if( header.formatId < formatCount && NULL != formats[header.formatId] )
+                {
+                    PayloadReader reader = { payload, header.size, 0 };
+                    PrintEvent( formats[header.formatId], &reader );
+                }
+            else
+                {
+                    printf( "<unknown format %u>", header.formatId );
+                }
+
+            putchar( '\n' );
+        }
+
+    for( unsigned int i = 0; i < formatCount; ++i ) free( formats[i] );
+    free( formats );
+    fclose( file );
+
+    return result;
+}